@@ -83,6 +83,86 @@ CREATE TABLE IF NOT EXISTS backup_history (
 
 CREATE INDEX IF NOT EXISTS idx_backup_history_task ON backup_history(task_id);
 CREATE INDEX IF NOT EXISTS idx_backup_history_start_time ON backup_history(start_time);
+CREATE INDEX IF NOT EXISTS idx_backup_history_task_time ON backup_history(task_id, start_time);
+
+-- 恢复日志表
+CREATE TABLE IF NOT EXISTS restore_journal (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    repository_id INTEGER NOT NULL,
+    snapshot_id TEXT NOT NULL,
+    target_path TEXT NOT NULL,
+    options TEXT,
+    status INTEGER DEFAULT 0,
+    start_time TEXT NOT NULL,
+    end_time TEXT,
+    total_files INTEGER DEFAULT 0,
+    files_restored INTEGER DEFAULT 0,
+    files_skipped INTEGER DEFAULT 0,
+    files_deleted INTEGER DEFAULT 0,
+    total_bytes INTEGER DEFAULT 0,
+    bytes_restored INTEGER DEFAULT 0,
+    bytes_skipped INTEGER DEFAULT 0,
+    error_message TEXT,
+    FOREIGN KEY (repository_id) REFERENCES repositories(id) ON DELETE CASCADE,
+    CHECK (status BETWEEN 0 AND 3)
+);
+
+CREATE INDEX IF NOT EXISTS idx_restore_journal_start_time ON restore_journal(start_time);
+
+-- 轮换验证计划表（每个仓库一行）
+CREATE TABLE IF NOT EXISTS verification_plans (
+    repository_id INTEGER PRIMARY KEY,
+    enabled INTEGER DEFAULT 0,
+    period_days INTEGER DEFAULT 30,
+    time_budget_minutes INTEGER DEFAULT 60,
+    bytes_budget INTEGER DEFAULT 0,
+    slice_count INTEGER DEFAULT 0,
+    next_slice INTEGER DEFAULT 1,
+    repository_bytes INTEGER DEFAULT 0,
+    cycle_started_at TEXT,
+    last_run_at TEXT,
+    last_cycle_completed_at TEXT,
+    FOREIGN KEY (repository_id) REFERENCES repositories(id) ON DELETE CASCADE
+);
+
+-- 切片验证记录表
+CREATE TABLE IF NOT EXISTS verification_runs (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    repository_id INTEGER NOT NULL,
+    slice_index INTEGER NOT NULL,
+    slice_count INTEGER NOT NULL,
+    start_time TEXT NOT NULL,
+    end_time TEXT,
+    success INTEGER DEFAULT 0,
+    bytes_checked INTEGER DEFAULT 0,
+    error_message TEXT,
+    FOREIGN KEY (repository_id) REFERENCES repositories(id) ON DELETE CASCADE
+);
+
+CREATE INDEX IF NOT EXISTS idx_verification_runs_repo_time ON verification_runs(repository_id, start_time);
+
+-- 维护历史表
+CREATE TABLE IF NOT EXISTS prune_history (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    repository_id INTEGER NOT NULL,
+    start_time TEXT NOT NULL,
+    end_time TEXT,
+    success INTEGER DEFAULT 0,
+    max_unused TEXT,
+    max_repack_size INTEGER DEFAULT 0,
+    repack_cacheable_only INTEGER DEFAULT 0,
+    removed_snapshots INTEGER DEFAULT 0,
+    repack_bytes INTEGER DEFAULT 0,
+    repack_removed_bytes INTEGER DEFAULT 0,
+    delete_bytes INTEGER DEFAULT 0,
+    reclaimed_bytes INTEGER DEFAULT 0,
+    remaining_bytes INTEGER DEFAULT 0,
+    unused_after_bytes INTEGER DEFAULT 0,
+    error_message TEXT,
+    FOREIGN KEY (repository_id) REFERENCES repositories(id) ON DELETE CASCADE
+);
+
+CREATE INDEX IF NOT EXISTS idx_prune_history_repo_time ON prune_history(repository_id, start_time);
 
 -- 设置表
 CREATE TABLE IF NOT EXISTS settings (
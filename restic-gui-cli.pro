@@ -0,0 +1,64 @@
+#-------------------------------------------------
+# Restic GUI - 命令行批量接口 qmake Project File
+# 不依赖 QtWidgets，可在没有图形会话的服务器和脚本中使用
+#-------------------------------------------------
+
+QT       = core
+
+TARGET = restic-gui-cli
+TEMPLATE = app
+
+# C++ 标准
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# 编译选项
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# MSVC 编码设置
+msvc {
+    QMAKE_CXXFLAGS += /utf-8
+}
+
+# 输出目录（中间文件与图形界面分开，两个工程可以并行构建）
+DESTDIR = $$PWD/bin
+OBJECTS_DIR = $$PWD/build/cli/obj
+MOC_DIR = $$PWD/build/cli/moc
+
+# ===== 源文件 =====
+
+SOURCES += \
+    src/cli/main.cpp \
+    src/cli/CliRunner.cpp
+
+HEADERS += \
+    src/cli/CliRunner.h
+
+# 数据模型、数据访问层、工具类和核心业务逻辑
+include(restic-gui-core.pri)
+
+# ===== 部署配置 =====
+
+qnx: target.path = /tmp/restic-gui/bin
+else: unix:!android: target.path = /opt/restic-gui/bin
+!isEmpty(target.path): INSTALLS += target
+
+# ===== 其他配置 =====
+
+# 禁用某些警告（仅非MSVC编译器）
+!msvc {
+    QMAKE_CXXFLAGS += -Wno-unused-parameter
+}
+
+# Release配置优化
+CONFIG(release, debug|release) {
+    DEFINES += QT_NO_DEBUG_OUTPUT
+    !msvc {
+        QMAKE_CXXFLAGS += -O2
+    }
+}
+
+# Debug配置
+CONFIG(debug, debug|release) {
+    DEFINES += DEBUG_MODE
+}
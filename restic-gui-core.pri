@@ -0,0 +1,122 @@
+#-------------------------------------------------
+# Restic GUI - 核心模块
+# 数据模型、数据访问层、工具类和核心业务逻辑，不依赖 QtWidgets
+# 由 restic-gui.pro 和 restic-gui-cli.pro 共同包含
+#-------------------------------------------------
+
+QT += core sql network concurrent
+
+# 数据模型
+SOURCES += \
+    $$PWD/src/models/Repository.cpp \
+    $$PWD/src/models/BackupTask.cpp \
+    $$PWD/src/models/Schedule.cpp \
+    $$PWD/src/models/Snapshot.cpp \
+    $$PWD/src/models/FileInfo.cpp \
+    $$PWD/src/models/BackupResult.cpp \
+    $$PWD/src/models/RestoreOptions.cpp \
+    $$PWD/src/models/RestoreJournal.cpp \
+    $$PWD/src/models/RepoStats.cpp \
+    $$PWD/src/models/TaskListEntry.cpp \
+    $$PWD/src/models/FileVersion.cpp \
+    $$PWD/src/models/SnapshotDiff.cpp \
+    $$PWD/src/models/MountSession.cpp \
+    $$PWD/src/models/RepositoryLock.cpp \
+    $$PWD/src/models/VerificationPlan.cpp \
+    $$PWD/src/models/PruneRecord.cpp
+
+# 数据访问层
+SOURCES += \
+    $$PWD/src/data/DatabaseManager.cpp \
+    $$PWD/src/data/ConfigManager.cpp \
+    $$PWD/src/data/PasswordManager.cpp \
+    $$PWD/src/data/CacheManager.cpp
+
+# 工具类
+SOURCES += \
+    $$PWD/src/utils/Logger.cpp \
+    $$PWD/src/utils/CryptoUtil.cpp \
+    $$PWD/src/utils/FileSystemUtil.cpp \
+    $$PWD/src/utils/NetworkUtil.cpp \
+    $$PWD/src/utils/Tracer.cpp \
+    $$PWD/src/utils/Metrics.cpp
+
+# 核心业务逻辑
+SOURCES += \
+    $$PWD/src/core/ResticWrapper.cpp \
+    $$PWD/src/core/ResticCapabilities.cpp \
+    $$PWD/src/core/RepositoryManager.cpp \
+    $$PWD/src/core/BackupManager.cpp \
+    $$PWD/src/core/RestoreManager.cpp \
+    $$PWD/src/core/SnapshotManager.cpp \
+    $$PWD/src/core/SchedulerManager.cpp \
+    $$PWD/src/core/SnapshotSearchIndex.cpp \
+    $$PWD/src/core/FileHistoryIndex.cpp \
+    $$PWD/src/core/SnapshotDiffEngine.cpp \
+    $$PWD/src/core/RestorePlanner.cpp \
+    $$PWD/src/core/RestoreEstimator.cpp \
+    $$PWD/src/core/MountManager.cpp \
+    $$PWD/src/core/RepositoryLockCoordinator.cpp \
+    $$PWD/src/core/VerificationScheduler.cpp \
+    $$PWD/src/core/PrunePlanner.cpp \
+    $$PWD/src/core/MetricsExporter.cpp \
+    $$PWD/src/core/DaemonServer.cpp \
+    $$PWD/src/core/DaemonClient.cpp \
+    $$PWD/src/core/DataStore.cpp
+
+HEADERS += \
+    $$PWD/src/models/Repository.h \
+    $$PWD/src/models/BackupTask.h \
+    $$PWD/src/models/Schedule.h \
+    $$PWD/src/models/Snapshot.h \
+    $$PWD/src/models/FileInfo.h \
+    $$PWD/src/models/BackupResult.h \
+    $$PWD/src/models/RestoreOptions.h \
+    $$PWD/src/models/RestoreJournal.h \
+    $$PWD/src/models/RepoStats.h \
+    $$PWD/src/models/TaskListEntry.h \
+    $$PWD/src/models/FileVersion.h \
+    $$PWD/src/models/SnapshotDiff.h \
+    $$PWD/src/models/MountSession.h \
+    $$PWD/src/models/RepositoryLock.h \
+    $$PWD/src/models/VerificationPlan.h \
+    $$PWD/src/models/PruneRecord.h \
+    $$PWD/src/data/DatabaseManager.h \
+    $$PWD/src/data/ConfigManager.h \
+    $$PWD/src/data/PasswordManager.h \
+    $$PWD/src/data/CacheManager.h \
+    $$PWD/src/utils/Logger.h \
+    $$PWD/src/utils/MpscRingBuffer.h \
+    $$PWD/src/utils/CryptoUtil.h \
+    $$PWD/src/utils/FileSystemUtil.h \
+    $$PWD/src/utils/NetworkUtil.h \
+    $$PWD/src/utils/Tracer.h \
+    $$PWD/src/utils/Metrics.h \
+    $$PWD/src/utils/SingleFlight.h \
+    $$PWD/src/core/ResticWrapper.h \
+    $$PWD/src/core/ResticCapabilities.h \
+    $$PWD/src/core/RepositoryManager.h \
+    $$PWD/src/core/BackupManager.h \
+    $$PWD/src/core/RestoreManager.h \
+    $$PWD/src/core/SnapshotManager.h \
+    $$PWD/src/core/SchedulerManager.h \
+    $$PWD/src/core/SnapshotSearchIndex.h \
+    $$PWD/src/core/FileHistoryIndex.h \
+    $$PWD/src/core/SnapshotDiffEngine.h \
+    $$PWD/src/core/RestorePlanner.h \
+    $$PWD/src/core/RestoreEstimator.h \
+    $$PWD/src/core/MountManager.h \
+    $$PWD/src/core/RepositoryLockCoordinator.h \
+    $$PWD/src/core/VerificationScheduler.h \
+    $$PWD/src/core/PrunePlanner.h \
+    $$PWD/src/core/MetricsExporter.h \
+    $$PWD/src/core/DaemonServer.h \
+    $$PWD/src/core/DaemonClient.h \
+    $$PWD/src/core/DataStore.h
+
+INCLUDEPATH += \
+    $$PWD/src \
+    $$PWD/src/core \
+    $$PWD/src/models \
+    $$PWD/src/data \
+    $$PWD/src/utils
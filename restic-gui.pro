@@ -34,39 +34,8 @@ UI_DIR = $$PWD/build/ui
 SOURCES += \
     src/main.cpp
 
-# 数据模型
-SOURCES += \
-    src/models/Repository.cpp \
-    src/models/BackupTask.cpp \
-    src/models/Schedule.cpp \
-    src/models/Snapshot.cpp \
-    src/models/FileInfo.cpp \
-    src/models/BackupResult.cpp \
-    src/models/RestoreOptions.cpp \
-    src/models/RepoStats.cpp
-
-# 数据访问层
-SOURCES += \
-    src/data/DatabaseManager.cpp \
-    src/data/ConfigManager.cpp \
-    src/data/PasswordManager.cpp \
-    src/data/CacheManager.cpp
-
-# 工具类
-SOURCES += \
-    src/utils/Logger.cpp \
-    src/utils/CryptoUtil.cpp \
-    src/utils/FileSystemUtil.cpp \
-    src/utils/NetworkUtil.cpp
-
-# 核心业务逻辑
-SOURCES += \
-    src/core/ResticWrapper.cpp \
-    src/core/RepositoryManager.cpp \
-    src/core/BackupManager.cpp \
-    src/core/RestoreManager.cpp \
-    src/core/SnapshotManager.cpp \
-    src/core/SchedulerManager.cpp
+# 数据模型、数据访问层、工具类和核心业务逻辑（与命令行程序共用）
+include(restic-gui-core.pri)
 
 # UI - 主窗口
 SOURCES += \
@@ -93,38 +62,26 @@ SOURCES += \
     src/ui/dialogs/CreateTaskDialog.cpp \
     src/ui/dialogs/SnapshotBrowserDialog.cpp \
     src/ui/dialogs/PruneOptionsDialog.cpp \
-    src/ui/dialogs/PasswordDialog.cpp
+    src/ui/dialogs/PasswordDialog.cpp \
+    src/ui/dialogs/FileHistoryDialog.cpp \
+    src/ui/dialogs/VerificationPlanDialog.cpp
 
 # UI - 自定义控件
 SOURCES += \
     src/ui/widgets/SnapshotListWidget.cpp \
     src/ui/widgets/FileTreeWidget.cpp
 
+# UI - 视图模型
+SOURCES += \
+    src/ui/models/TaskTableModel.cpp \
+    src/ui/models/SnapshotTableModel.cpp \
+    src/ui/models/SnapshotFileModel.cpp \
+    src/ui/models/SnapshotTreeSearch.cpp \
+    src/ui/models/SnapshotPrefetcher.cpp
+
 # ===== 头文件 =====
 
 HEADERS += \
-    src/models/Repository.h \
-    src/models/BackupTask.h \
-    src/models/Schedule.h \
-    src/models/Snapshot.h \
-    src/models/FileInfo.h \
-    src/models/BackupResult.h \
-    src/models/RestoreOptions.h \
-    src/models/RepoStats.h \
-    src/data/DatabaseManager.h \
-    src/data/ConfigManager.h \
-    src/data/PasswordManager.h \
-    src/data/CacheManager.h \
-    src/utils/Logger.h \
-    src/utils/CryptoUtil.h \
-    src/utils/FileSystemUtil.h \
-    src/utils/NetworkUtil.h \
-    src/core/ResticWrapper.h \
-    src/core/RepositoryManager.h \
-    src/core/BackupManager.h \
-    src/core/RestoreManager.h \
-    src/core/SnapshotManager.h \
-    src/core/SchedulerManager.h \
     src/ui/MainWindow.h \
     src/ui/pages/HomePage.h \
     src/ui/pages/RepositoryPage.h \
@@ -140,8 +97,15 @@ HEADERS += \
     src/ui/dialogs/SnapshotBrowserDialog.h \
     src/ui/dialogs/PruneOptionsDialog.h \
     src/ui/dialogs/PasswordDialog.h \
+    src/ui/dialogs/FileHistoryDialog.h \
+    src/ui/dialogs/VerificationPlanDialog.h \
     src/ui/widgets/SnapshotListWidget.h \
-    src/ui/widgets/FileTreeWidget.h
+    src/ui/widgets/FileTreeWidget.h \
+    src/ui/models/TaskTableModel.h \
+    src/ui/models/SnapshotTableModel.h \
+    src/ui/models/SnapshotFileModel.h \
+    src/ui/models/SnapshotTreeSearch.h \
+    src/ui/models/SnapshotPrefetcher.h
 
 # ===== UI 文件 =====
 
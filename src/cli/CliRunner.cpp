@@ -0,0 +1,529 @@
+/**
+ * @file CliRunner.cpp
+ * @brief 命令行批量接口的命令实现
+ */
+
+#include "CliRunner.h"
+#include "../core/BackupManager.h"
+#include "../core/ResticWrapper.h"
+#include "../core/DaemonClient.h"
+#include "../data/DatabaseManager.h"
+#include "../data/PasswordManager.h"
+#include "../data/CacheManager.h"
+#include "../utils/Logger.h"
+#include "../utils/Tracer.h"
+#include <QThreadPool>
+#include <QFuture>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QtConcurrent>
+#include <algorithm>
+
+namespace ResticGUI {
+namespace Cli {
+
+namespace {
+
+QString statusName(Models::BackupStatus status)
+{
+    switch (status) {
+    case Models::BackupStatus::Running:   return "running";
+    case Models::BackupStatus::Success:   return "success";
+    case Models::BackupStatus::Failed:    return "failed";
+    case Models::BackupStatus::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+QString isoTime(const QDateTime& time)
+{
+    return time.isValid() ? time.toString(Qt::ISODate) : QString();
+}
+
+// 在线程池中执行 work(item)，按输入顺序返回结果
+template <typename T, typename Work>
+QJsonArray runParallel(const QList<T>& items, int jobs, Work work)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs);
+
+    QList<QFuture<QJsonObject>> futures;
+    for (const T& item : items) {
+        futures.append(QtConcurrent::run(&pool, [work, item]() { return work(item); }));
+    }
+
+    QJsonArray results;
+    for (QFuture<QJsonObject>& future : futures) {
+        results.append(future.result());
+    }
+    return results;
+}
+
+int countFailures(const QJsonArray& results)
+{
+    return static_cast<int>(std::count_if(results.begin(), results.end(), [](const QJsonValue& value) {
+        return !value.toObject().value("success").toBool();
+    }));
+}
+
+} // namespace
+
+CliRunner::CliRunner(int jobs)
+    : m_jobs(qMax(1, jobs))
+{
+}
+
+// ========== run-task ==========
+
+int CliRunner::runTasks(const QList<int>& taskIds, bool all, bool useDaemon, QJsonObject& output)
+{
+    Data::DatabaseManager* db = Data::DatabaseManager::instance();
+
+    QList<int> ids = taskIds;
+    if (all) {
+        ids.clear();
+        for (const Models::BackupTask& task : db->getAllBackupTasks()) {
+            if (task.enabled) {
+                ids.append(task.id);
+            }
+        }
+    }
+    if (ids.isEmpty()) {
+        output["error"] = "没有指定要执行的任务";
+        return ExitUsageError;
+    }
+
+    if (useDaemon && Core::DaemonClient::instance()->connectToDaemon()) {
+        return runTasksViaDaemon(ids, output);
+    }
+
+    // 任务和密码都在主线程准备好，工作线程只执行备份
+    QJsonArray results;
+    QList<QPair<Models::BackupTask, Models::Repository>> jobs;
+    QList<Models::Repository> repos;
+    for (int id : ids) {
+        Models::BackupTask task = db->getBackupTask(id);
+        if (task.id < 0) {
+            results.append(QJsonObject{{"taskId", id}, {"success", false}, {"error", "备份任务不存在"}});
+            continue;
+        }
+        Models::Repository repo = db->getRepository(task.repositoryId);
+        if (repo.id < 0) {
+            results.append(QJsonObject{{"taskId", id}, {"success", false}, {"error", "仓库不存在"}});
+            continue;
+        }
+        jobs.append(qMakePair(task, repo));
+        repos.append(repo);
+    }
+
+    QHash<int, QString> passwords;
+    QJsonArray passwordErrors;
+    resolvePasswords(repos, passwords, passwordErrors);
+
+    QList<QPair<Models::BackupTask, Models::Repository>> runnable;
+    for (const auto& job : jobs) {
+        if (passwords.contains(job.second.id)) {
+            runnable.append(job);
+        } else {
+            results.append(QJsonObject{{"taskId", job.first.id}, {"success", false},
+                                       {"error", QString("仓库 %1 需要密码").arg(job.second.name)}});
+        }
+    }
+
+    Core::BackupManager* backupMgr = Core::BackupManager::instance();
+    const QJsonArray backupResults = runParallel(runnable, m_jobs,
+        [backupMgr, passwords](const QPair<Models::BackupTask, Models::Repository>& job) {
+            Utils::TraceSpan span("cli-run-task", "cli");
+            span.setDetail(job.first.name);
+
+            QElapsedTimer timer;
+            timer.start();
+            Models::BackupResult result;
+            result.taskName = job.first.name;
+            const bool success = backupMgr->executeBackup(job.first, job.second,
+                                                          passwords.value(job.second.id), result);
+
+            QJsonObject item = backupResultObject(result);
+            item["taskId"] = job.first.id;
+            item["repositoryId"] = job.second.id;
+            item["success"] = success;
+            item["elapsedMs"] = timer.elapsed();
+            return item;
+        });
+    for (const QJsonValue& value : backupResults) {
+        results.append(value);
+    }
+
+    const int failed = countFailures(results);
+    output["via"] = "local";
+    output["results"] = results;
+    output["failed"] = failed;
+
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("命令行执行 %1 个备份任务，失败 %2 个").arg(results.size()).arg(failed));
+    return failed > 0 ? ExitPartialFailure : ExitSuccess;
+}
+
+int CliRunner::runTasksViaDaemon(const QList<int>& taskIds, QJsonObject& output)
+{
+    // 后台服务一次只执行一个备份任务，逐个提交并等待完成事件
+    Core::DaemonClient* client = Core::DaemonClient::instance();
+    QJsonArray results;
+
+    for (int taskId : taskIds) {
+        QElapsedTimer timer;
+        timer.start();
+
+        QEventLoop loop;
+        bool finished = false;
+        bool success = false;
+        QMetaObject::Connection finishedConn = QObject::connect(client, &Core::DaemonClient::backupFinished,
+            &loop, [&](int finishedTaskId, bool ok) {
+                if (finishedTaskId == taskId) {
+                    finished = true;
+                    success = ok;
+                    loop.quit();
+                }
+            });
+        QMetaObject::Connection lostConn = QObject::connect(client, &Core::DaemonClient::connectionLost,
+            &loop, &QEventLoop::quit);
+
+        QString error;
+        if (client->runTask(taskId, &error)) {
+            // 完成事件可能在 runTask() 等待响应期间就已收到
+            if (!finished) {
+                loop.exec();
+            }
+            if (!finished) {
+                error = "与后台服务的连接已断开";
+            }
+        }
+        QObject::disconnect(finishedConn);
+        QObject::disconnect(lostConn);
+
+        QJsonObject item{{"taskId", taskId}, {"success", finished && success}, {"elapsedMs", timer.elapsed()}};
+        if (!error.isEmpty()) {
+            item["error"] = error;
+        }
+        results.append(item);
+
+        if (!client->isConnected()) {
+            break;
+        }
+    }
+
+    const int failed = countFailures(results) + (taskIds.size() - results.size());
+    output["via"] = "daemon";
+    output["results"] = results;
+    output["failed"] = failed;
+    return failed > 0 ? ExitPartialFailure : ExitSuccess;
+}
+
+// ========== sync-snapshots ==========
+
+int CliRunner::syncSnapshots(const QList<int>& repoIds, bool all, QJsonObject& output)
+{
+    QJsonArray results;
+    const QList<Models::Repository> repos = selectRepositories(repoIds, all, results);
+    if (repos.isEmpty() && results.isEmpty()) {
+        output["error"] = "没有指定要同步的仓库";
+        return ExitUsageError;
+    }
+
+    QHash<int, QString> passwords;
+    resolvePasswords(repos, passwords, results);
+
+    QList<Models::Repository> runnable;
+    for (const Models::Repository& repo : repos) {
+        if (passwords.contains(repo.id)) {
+            runnable.append(repo);
+        }
+    }
+
+    const QJsonArray synced = runParallel(runnable, m_jobs, [passwords](const Models::Repository& repo) {
+        Utils::TraceSpan span("cli-sync-snapshots", "cli");
+        span.setDetail(repo.name);
+
+        QElapsedTimer timer;
+        timer.start();
+        Core::ResticWrapper wrapper;
+        QList<Models::Snapshot> snapshots;
+        const bool success = wrapper.listSnapshots(repo, passwords.value(repo.id), snapshots);
+
+        QJsonObject item{{"repositoryId", repo.id}, {"repository", repo.name}, {"success", success}};
+        if (success) {
+            Data::CacheManager::instance()->cacheSnapshots(repo.id, snapshots);
+            item["snapshots"] = snapshots.size();
+            if (!snapshots.isEmpty()) {
+                auto latest = std::max_element(snapshots.begin(), snapshots.end(),
+                    [](const Models::Snapshot& a, const Models::Snapshot& b) { return a.time < b.time; });
+                item["latestSnapshot"] = latest->id;
+                item["latestTime"] = isoTime(latest->time);
+            }
+        } else {
+            item["error"] = wrapper.lastErrorOutput();
+        }
+        item["elapsedMs"] = timer.elapsed();
+        return item;
+    });
+    for (const QJsonValue& value : synced) {
+        results.append(value);
+    }
+
+    const int failed = countFailures(results);
+    output["results"] = results;
+    output["failed"] = failed;
+    return failed > 0 ? ExitPartialFailure : ExitSuccess;
+}
+
+// ========== warm-cache ==========
+
+int CliRunner::warmCache(const QList<int>& repoIds, bool all, QJsonObject& output)
+{
+    QJsonArray results;
+    const QList<Models::Repository> repos = selectRepositories(repoIds, all, results);
+    if (repos.isEmpty() && results.isEmpty()) {
+        output["error"] = "没有指定要预热的仓库";
+        return ExitUsageError;
+    }
+
+    QHash<int, QString> passwords;
+    resolvePasswords(repos, passwords, results);
+
+    QList<Models::Repository> runnable;
+    for (const Models::Repository& repo : repos) {
+        if (passwords.contains(repo.id)) {
+            runnable.append(repo);
+        }
+    }
+
+    const QJsonArray warmed = runParallel(runnable, m_jobs, [passwords](const Models::Repository& repo) {
+        Utils::TraceSpan span("cli-warm-cache", "cli");
+        span.setDetail(repo.name);
+
+        QElapsedTimer timer;
+        timer.start();
+        const QString password = passwords.value(repo.id);
+        Data::CacheManager* cache = Data::CacheManager::instance();
+        Core::ResticWrapper wrapper;
+        QJsonObject item{{"repositoryId", repo.id}, {"repository", repo.name}};
+
+        // 快照列表会读取全部索引，之后 stats/ls 只需下载树数据包
+        QList<Models::Snapshot> snapshots;
+        if (!wrapper.listSnapshots(repo, password, snapshots)) {
+            item["success"] = false;
+            item["error"] = wrapper.lastErrorOutput();
+            item["elapsedMs"] = timer.elapsed();
+            return item;
+        }
+        cache->cacheSnapshots(repo.id, snapshots);
+        item["snapshots"] = snapshots.size();
+
+        bool success = true;
+        Models::RepoStats stats;
+        if (wrapper.getStats(repo, password, stats)) {
+            cache->cacheRepoStats(repo.id, stats);
+            item["stats"] = true;
+        } else {
+            success = false;
+            item["stats"] = false;
+            item["error"] = wrapper.lastErrorOutput();
+        }
+
+        if (!snapshots.isEmpty()) {
+            auto latest = std::max_element(snapshots.begin(), snapshots.end(),
+                [](const Models::Snapshot& a, const Models::Snapshot& b) { return a.time < b.time; });
+            QList<Models::FileInfo> files;
+            if (wrapper.listFiles(repo, password, latest->id, "/", files)) {
+                cache->cacheFileTree(latest->id, "/", files);
+                item["latestSnapshot"] = latest->id;
+                item["rootEntries"] = files.size();
+            } else {
+                success = false;
+                item["error"] = wrapper.lastErrorOutput();
+            }
+        }
+
+        item["success"] = success;
+        item["elapsedMs"] = timer.elapsed();
+        return item;
+    });
+    for (const QJsonValue& value : warmed) {
+        results.append(value);
+    }
+
+    const int failed = countFailures(results);
+    output["results"] = results;
+    output["failed"] = failed;
+    return failed > 0 ? ExitPartialFailure : ExitSuccess;
+}
+
+// ========== export-history ==========
+
+int CliRunner::exportHistory(int taskId, int limit, const QString& format, QByteArray& data,
+                             QJsonObject& output)
+{
+    if (format != "csv" && format != "json") {
+        output["error"] = QString("不支持的导出格式: %1").arg(format);
+        return ExitUsageError;
+    }
+
+    Data::DatabaseManager* db = Data::DatabaseManager::instance();
+    QList<Models::BackupResult> history;
+    if (taskId >= 0) {
+        const Models::BackupTask task = db->getBackupTask(taskId);
+        if (task.id < 0) {
+            output["error"] = QString("备份任务 %1 不存在").arg(taskId);
+            return ExitUsageError;
+        }
+        history = db->getBackupHistory(taskId, limit);
+        for (Models::BackupResult& result : history) {
+            result.taskName = task.name;
+        }
+    } else {
+        history = db->getRecentBackupHistory(limit);
+    }
+
+    if (format == "csv") {
+        data = historyToCsv(history);
+    } else {
+        QJsonArray rows;
+        for (const Models::BackupResult& result : history) {
+            rows.append(backupResultObject(result));
+        }
+        data = QJsonDocument(rows).toJson(QJsonDocument::Indented);
+    }
+
+    output["format"] = format;
+    output["count"] = history.size();
+    return ExitSuccess;
+}
+
+// ========== list-tasks ==========
+
+int CliRunner::listTasks(QJsonObject& output)
+{
+    QJsonArray tasks;
+    for (const Models::BackupTask& task : Data::DatabaseManager::instance()->getAllBackupTasks()) {
+        QJsonObject item;
+        item["id"] = task.id;
+        item["name"] = task.name;
+        item["repositoryId"] = task.repositoryId;
+        item["enabled"] = task.enabled;
+        item["lastRun"] = isoTime(task.lastRun);
+        item["nextRun"] = isoTime(task.nextRun);
+        tasks.append(item);
+    }
+    output["tasks"] = tasks;
+    return ExitSuccess;
+}
+
+// ========== 辅助函数 ==========
+
+bool CliRunner::resolvePasswords(const QList<Models::Repository>& repos, QHash<int, QString>& passwords,
+                                 QJsonArray& errors)
+{
+    // 没有保存密码时使用 RESTIC_PASSWORD，便于在脚本中使用
+    const QString envPassword = qEnvironmentVariable("RESTIC_PASSWORD");
+    Data::PasswordManager* passwordMgr = Data::PasswordManager::instance();
+
+    bool allResolved = true;
+    for (const Models::Repository& repo : repos) {
+        if (passwords.contains(repo.id)) {
+            continue;
+        }
+        QString password;
+        if (passwordMgr->getPassword(repo.id, password)) {
+            passwords.insert(repo.id, password);
+        } else if (!envPassword.isEmpty()) {
+            passwords.insert(repo.id, envPassword);
+        } else {
+            errors.append(QJsonObject{{"repositoryId", repo.id}, {"repository", repo.name}, {"success", false},
+                                      {"error", "需要仓库密码（未保存密码且未设置 RESTIC_PASSWORD）"}});
+            allResolved = false;
+        }
+    }
+    return allResolved;
+}
+
+QList<Models::Repository> CliRunner::selectRepositories(const QList<int>& repoIds, bool all, QJsonArray& errors)
+{
+    Data::DatabaseManager* db = Data::DatabaseManager::instance();
+    if (all) {
+        return db->getAllRepositories();
+    }
+
+    QList<Models::Repository> repos;
+    for (int id : repoIds) {
+        Models::Repository repo = db->getRepository(id);
+        if (repo.id < 0) {
+            errors.append(QJsonObject{{"repositoryId", id}, {"success", false}, {"error", "仓库不存在"}});
+            continue;
+        }
+        repos.append(repo);
+    }
+    return repos;
+}
+
+QJsonObject CliRunner::backupResultObject(const Models::BackupResult& result)
+{
+    QJsonObject item;
+    item["taskId"] = result.taskId;
+    item["taskName"] = result.taskName;
+    item["status"] = statusName(result.status);
+    item["success"] = result.success;
+    item["snapshotId"] = result.snapshotId;
+    item["startTime"] = isoTime(result.startTime);
+    item["endTime"] = isoTime(result.endTime);
+    item["duration"] = result.duration;
+    item["filesNew"] = result.filesNew;
+    item["filesChanged"] = result.filesChanged;
+    item["filesUnmodified"] = result.filesUnmodified;
+    item["dataAdded"] = result.dataAdded;
+    item["totalBytesProcessed"] = result.totalBytesProcessed;
+    if (!result.errorMessage.isEmpty()) {
+        item["error"] = result.errorMessage;
+    }
+    return item;
+}
+
+QByteArray CliRunner::historyToCsv(const QList<Models::BackupResult>& history)
+{
+    QStringList lines;
+    lines << "task_id,task_name,status,snapshot_id,start_time,end_time,duration_secs,"
+             "files_new,files_changed,files_unmodified,data_added,total_bytes_processed,error";
+
+    for (const Models::BackupResult& result : history) {
+        QStringList fields;
+        fields << QString::number(result.taskId)
+               << csvField(result.taskName)
+               << statusName(result.status)
+               << csvField(result.snapshotId)
+               << isoTime(result.startTime)
+               << isoTime(result.endTime)
+               << QString::number(result.duration)
+               << QString::number(result.filesNew)
+               << QString::number(result.filesChanged)
+               << QString::number(result.filesUnmodified)
+               << QString::number(result.dataAdded)
+               << QString::number(result.totalBytesProcessed)
+               << csvField(result.errorMessage.trimmed());
+        lines << fields.join(',');
+    }
+    return (lines.join("\r\n") + "\r\n").toUtf8();
+}
+
+QString CliRunner::csvField(const QString& value)
+{
+    // RFC 4180：含逗号、引号或换行的字段加引号，引号加倍
+    if (value.contains(',') || value.contains('"') || value.contains('\n') || value.contains('\r')) {
+        QString escaped = value;
+        escaped.replace('"', "\"\"");
+        return '"' + escaped + '"';
+    }
+    return value;
+}
+
+} // namespace Cli
+} // namespace ResticGUI
@@ -0,0 +1,90 @@
+/**
+ * @file CliRunner.h
+ * @brief 命令行批量接口的命令实现
+ */
+
+#ifndef CLIRUNNER_H
+#define CLIRUNNER_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QJsonArray>
+#include "../models/Repository.h"
+#include "../models/BackupResult.h"
+
+namespace ResticGUI {
+namespace Cli {
+
+/**
+ * @brief 执行 restic-gui-cli 的各个子命令
+ *
+ * 每个命令把结果写入一个 JSON 对象，由 main 输出到标准输出。针对多个任务或
+ * 仓库的命令在一个大小为 jobs 的线程池中并行执行，仓库密码在派发前于主线程
+ * 取得（PasswordManager 的缓存计时器属于主线程）。
+ *
+ * 与图形界面共用同一个数据库和配置，备份历史、快照缓存对图形界面立即可见。
+ */
+class CliRunner
+{
+public:
+    enum ExitCode {
+        ExitSuccess = 0,        // 全部成功
+        ExitPartialFailure = 1, // 至少一项失败
+        ExitUsageError = 2,     // 参数错误
+        ExitStartupError = 3    // 数据库等初始化失败
+    };
+
+    explicit CliRunner(int jobs);
+
+    /**
+     * @brief 执行备份任务，有后台服务时交给后台服务逐个执行
+     */
+    int runTasks(const QList<int>& taskIds, bool all, bool useDaemon, QJsonObject& output);
+
+    /**
+     * @brief 刷新仓库的快照列表并写入快照缓存（数据库）
+     */
+    int syncSnapshots(const QList<int>& repoIds, bool all, QJsonObject& output);
+
+    /**
+     * @brief 预热缓存：快照列表、仓库统计和最新快照的根目录
+     *
+     * 内存缓存只属于当前进程，这里主要填充 restic 自己的本地缓存
+     * （索引和树数据包）以及数据库中的快照缓存，之后图形界面打开这些
+     * 仓库时不必再从远程仓库下载。
+     */
+    int warmCache(const QList<int>& repoIds, bool all, QJsonObject& output);
+
+    /**
+     * @brief 导出备份历史
+     * @param taskId 任务ID，小于0时导出所有任务的最近历史
+     * @param format csv 或 json
+     * @param data 输出参数，导出的内容
+     */
+    int exportHistory(int taskId, int limit, const QString& format, QByteArray& data, QJsonObject& output);
+
+    /**
+     * @brief 列出备份任务
+     */
+    int listTasks(QJsonObject& output);
+
+private:
+    bool resolvePasswords(const QList<Models::Repository>& repos, QHash<int, QString>& passwords,
+                          QJsonArray& errors);
+    QList<Models::Repository> selectRepositories(const QList<int>& repoIds, bool all, QJsonArray& errors);
+    int runTasksViaDaemon(const QList<int>& taskIds, QJsonObject& output);
+
+    static QJsonObject backupResultObject(const Models::BackupResult& result);
+    static QByteArray historyToCsv(const QList<Models::BackupResult>& history);
+    static QString csvField(const QString& value);
+
+    int m_jobs;
+};
+
+} // namespace Cli
+} // namespace ResticGUI
+
+#endif // CLIRUNNER_H
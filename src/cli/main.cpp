@@ -0,0 +1,195 @@
+/**
+ * @file main.cpp
+ * @brief restic-gui-cli 命令行批量接口入口
+ *
+ * 用法：
+ *   restic-gui-cli [--jobs N] run-task <任务ID...> | --all
+ *   restic-gui-cli [--jobs N] sync-snapshots <仓库ID...> | --all
+ *   restic-gui-cli [--jobs N] warm-cache <仓库ID...> | --all
+ *   restic-gui-cli export-history [--task ID] [--limit N] [--format csv|json] [--output 文件]
+ *   restic-gui-cli list-tasks
+ *
+ * 结果以一个 JSON 对象输出到标准输出，日志写入 restic-gui-cli.log。
+ * 退出码：0 全部成功，1 部分失败，2 参数错误，3 初始化失败。
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include "cli/CliRunner.h"
+#include "utils/Logger.h"
+#include "utils/Tracer.h"
+#include "data/DatabaseManager.h"
+#include "data/ConfigManager.h"
+#include "data/PasswordManager.h"
+#include "data/CacheManager.h"
+#include "core/BackupManager.h"
+#include "core/SchedulerManager.h"
+
+using namespace ResticGUI;
+
+namespace {
+
+void writeStdout(const QByteArray& data)
+{
+    QFile out;
+    out.open(stdout, QIODevice::WriteOnly);
+    out.write(data);
+    out.flush();
+}
+
+int finish(QJsonObject& output, int code, const QElapsedTimer& timer)
+{
+    output["ok"] = (code == Cli::CliRunner::ExitSuccess);
+    output["exitCode"] = code;
+    output["elapsedMs"] = timer.elapsed();
+    writeStdout(QJsonDocument(output).toJson(QJsonDocument::Compact) + "\n");
+    return code;
+}
+
+QList<int> parseIds(const QStringList& values, QStringList& invalid)
+{
+    QList<int> ids;
+    for (const QString& value : values) {
+        bool ok = false;
+        const int id = value.toInt(&ok);
+        if (ok && id >= 0) {
+            ids.append(id);
+        } else {
+            invalid.append(value);
+        }
+    }
+    return ids;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // 与图形界面使用相同的组织和应用名称，共用数据目录、数据库和配置
+    QCoreApplication::setOrganizationName("ResticGUI");
+    QCoreApplication::setOrganizationDomain("restic-gui.org");
+    QCoreApplication::setApplicationName("Restic GUI");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Restic GUI 命令行批量接口");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("command", "run-task | sync-snapshots | warm-cache | export-history | list-tasks");
+    parser.addPositionalArgument("ids", "任务ID或仓库ID", "[ids...]");
+
+    QCommandLineOption jobsOption(QStringList() << "j" << "jobs", "并行执行的数量（默认 1）", "N", "1");
+    QCommandLineOption allOption("all", "作用于所有启用的任务或所有仓库");
+    QCommandLineOption noDaemonOption("no-daemon", "即使后台服务在运行，也在本进程中执行备份");
+    QCommandLineOption taskOption("task", "export-history：只导出该任务的历史", "ID");
+    QCommandLineOption limitOption("limit", "export-history：最多导出的记录数（默认 1000）", "N", "1000");
+    QCommandLineOption formatOption("format", "export-history：csv 或 json（默认 csv）", "FORMAT", "csv");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "export-history：写入文件而不是标准输出", "FILE");
+    parser.addOptions({jobsOption, allOption, noDaemonOption, taskOption, limitOption, formatOption, outputOption});
+    parser.process(app);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QStringList positional = parser.positionalArguments();
+    const QString command = positional.value(0);
+    QJsonObject output{{"command", command}};
+
+    bool jobsOk = false;
+    const int jobs = parser.value(jobsOption).toInt(&jobsOk);
+    if (!jobsOk || jobs < 1) {
+        output["error"] = QString("无效的 --jobs: %1").arg(parser.value(jobsOption));
+        return finish(output, Cli::CliRunner::ExitUsageError, timer);
+    }
+    output["jobs"] = jobs;
+
+    QStringList invalid;
+    const QList<int> ids = parseIds(positional.mid(1), invalid);
+    if (!invalid.isEmpty()) {
+        output["error"] = QString("无效的ID: %1").arg(invalid.join(", "));
+        return finish(output, Cli::CliRunner::ExitUsageError, timer);
+    }
+
+    // 日志写入单独的文件，标准输出只留给 JSON 结果
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataPath + "/logs");
+    Data::ConfigManager* config = Data::ConfigManager::instance();
+    Utils::Logger::instance()->setFormat(config->getStructuredLogs() ? Utils::Logger::JsonLines : Utils::Logger::Text);
+    Utils::Logger::instance()->setRotation(config->getLogMaxFileSizeMB() * Q_INT64_C(1024) * 1024,
+                                           config->getLogRetentionDays(), config->getCompressRotatedLogs());
+    Utils::Logger::instance()->setLogFile(dataPath + "/logs/restic-gui-cli.log");
+    Utils::Logger::instance()->setLevel(Utils::Logger::Info);
+    Utils::Logger::instance()->info(QString("restic-gui-cli %1 启动，并行数 %2").arg(command).arg(jobs));
+
+    const QString traceFile = qEnvironmentVariable("RESTIC_GUI_TRACE");
+    if (!traceFile.isEmpty()) {
+        Utils::Tracer::instance()->setEnabled(true);
+    }
+
+    if (!Data::DatabaseManager::instance()->initialize(dataPath + "/restic-gui.db")) {
+        output["error"] = QString("数据库初始化失败: %1").arg(Data::DatabaseManager::instance()->lastError());
+        Utils::Logger::instance()->shutdown();
+        return finish(output, Cli::CliRunner::ExitStartupError, timer);
+    }
+
+    // 这些单例持有定时器，必须在主线程创建，之后才能在工作线程中使用
+    Data::PasswordManager::instance();
+    Data::CacheManager::instance();
+    Core::BackupManager::instance();
+    Core::SchedulerManager::instance();
+
+    Cli::CliRunner runner(jobs);
+    int code = Cli::CliRunner::ExitUsageError;
+
+    if (command == "run-task") {
+        code = runner.runTasks(ids, parser.isSet(allOption), !parser.isSet(noDaemonOption), output);
+    } else if (command == "sync-snapshots") {
+        code = runner.syncSnapshots(ids, parser.isSet(allOption), output);
+    } else if (command == "warm-cache") {
+        code = runner.warmCache(ids, parser.isSet(allOption), output);
+    } else if (command == "export-history") {
+        const int taskId = parser.isSet(taskOption) ? parser.value(taskOption).toInt() : -1;
+        QByteArray data;
+        code = runner.exportHistory(taskId, parser.value(limitOption).toInt(), parser.value(formatOption),
+                                    data, output);
+        if (code == Cli::CliRunner::ExitSuccess) {
+            if (!parser.isSet(outputOption)) {
+                // 导出内容直接写到标准输出，不再附加 JSON 结果
+                writeStdout(data);
+                Utils::Logger::instance()->shutdown();
+                return code;
+            }
+
+            QSaveFile file(parser.value(outputOption));
+            if (file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit()) {
+                output["output"] = file.fileName();
+            } else {
+                output["error"] = QString("无法写入 %1: %2").arg(file.fileName()).arg(file.errorString());
+                code = Cli::CliRunner::ExitPartialFailure;
+            }
+        }
+    } else if (command == "list-tasks") {
+        code = runner.listTasks(output);
+    } else {
+        output["error"] = command.isEmpty() ? QString("缺少命令") : QString("未知命令: %1").arg(command);
+    }
+
+    if (!traceFile.isEmpty()) {
+        Utils::Tracer::instance()->setEnabled(false);
+        Utils::Tracer::instance()->exportChromeTrace(traceFile);
+    }
+
+    Utils::Logger::instance()->info(QString("restic-gui-cli %1 结束，退出码 %2").arg(command).arg(code));
+    Utils::Logger::instance()->shutdown();
+
+    return finish(output, code, timer);
+}
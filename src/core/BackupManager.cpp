@@ -10,12 +10,43 @@
 #include "../data/DatabaseManager.h"
 #include "../data/PasswordManager.h"
 #include "../utils/Logger.h"
+#include "../utils/Metrics.h"
 #include <QMutexLocker>
+#include <QElapsedTimer>
 #include <QtConcurrent/QtConcurrent>
 
 namespace ResticGUI {
 namespace Core {
 
+namespace {
+
+// 按仓库记录备份结果，吞吐量下降可以从 files/s 和耗时的变化中发现
+void recordBackupMetrics(const Models::Repository& repo, const Models::BackupResult& result,
+                         bool success, qint64 elapsedMs)
+{
+    Utils::MetricsRegistry* registry = Utils::MetricsRegistry::instance();
+    const Utils::MetricsRegistry::Labels labels{{"repository", repo.name}};
+
+    registry->counter("resticgui_backups_total", "备份次数",
+                      {{"repository", repo.name}, {"result", success ? QString("success") : QString("failure")}})
+        ->inc();
+    if (!success) {
+        return;
+    }
+
+    const double seconds = elapsedMs / 1000.0;
+    registry->histogram("resticgui_backup_duration_seconds", "备份耗时（秒）",
+                        Utils::Histogram::durationBuckets(), labels)->observe(seconds);
+    registry->counter("resticgui_backup_bytes_added_total", "备份新增到仓库的字节数", labels)
+        ->inc(static_cast<quint64>(qMax<qint64>(0, result.dataAdded)));
+    registry->gauge("resticgui_backup_files_per_second", "最近一次备份处理文件的速度", labels)
+        ->set(seconds > 0 ? result.totalFilesProcessed / seconds : 0);
+    registry->gauge("resticgui_backup_last_success_timestamp_seconds", "最近一次成功备份的时间", labels)
+        ->set(static_cast<double>(QDateTime::currentSecsSinceEpoch()));
+}
+
+} // namespace
+
 BackupManager* BackupManager::s_instance = nullptr;
 QMutex BackupManager::s_instanceMutex;
 
@@ -153,65 +184,15 @@ bool BackupManager::runBackupTask(int taskId)
 
     // 异步执行备份，避免阻塞UI线程
     QtConcurrent::run([this, taskId, task, repo, password]() {
-        // 执行备份
-        ResticWrapper wrapper;
-        connect(&wrapper, &ResticWrapper::progressUpdated,
-                this, &BackupManager::backupProgress);
-
         Models::BackupResult result;
-        result.taskId = taskId;
-
-        // 连接错误信号以捕获错误消息
-        QString errorMessage;
-        connect(&wrapper, &ResticWrapper::commandError, [&errorMessage](const QString& error) {
-            errorMessage = error;
-        });
-        connect(&wrapper, &ResticWrapper::standardError, [&errorMessage](const QString& error) {
-            if (!error.isEmpty()) {
-                errorMessage += error;
-            }
-        });
-
-        bool success = wrapper.backup(repo, password, task, result);
-
-        // 如果备份失败且没有错误消息，使用捕获的错误消息
-        if (!success && result.errorMessage.isEmpty()) {
-            result.errorMessage = errorMessage;
-        }
-
-        // 保存备份历史
-        Data::DatabaseManager::instance()->insertBackupHistory(result);
-
-        // 更新任务的最后运行时间
-        Models::BackupTask updatedTask = task;
-        updatedTask.lastRun = QDateTime::currentDateTime();
-        Data::DatabaseManager::instance()->updateBackupTask(updatedTask);
-
-        // 如果任务有调度计划且启用，更新下次运行时间
-        if (task.enabled &&
-            task.schedule.type != Models::Schedule::None &&
-            task.schedule.type != Models::Schedule::Manual) {
-            SchedulerManager::instance()->updateTaskNextRun(taskId);
-        }
+        bool success = executeBackup(task, repo, password, result);
 
         m_running = false;
         m_currentTaskId = -1;
 
         emit backupFinished(taskId, success);
 
-        if (success) {
-            Utils::Logger::instance()->log(Utils::Logger::Info, "备份任务完成");
-
-            // 更新仓库的最后备份时间
-            Models::Repository updatedRepo = repo;
-            updatedRepo.lastBackup = QDateTime::currentDateTime();
-            RepositoryManager::instance()->updateRepository(updatedRepo);
-
-            Utils::Logger::instance()->log(Utils::Logger::Debug,
-                QString("已更新仓库 \"%1\" 的最后备份时间").arg(repo.name));
-        } else {
-            Utils::Logger::instance()->log(Utils::Logger::Error, "备份任务失败");
-
+        if (!success) {
             // 检查是否是密码错误
             if (result.errorMessage.contains("wrong password") ||
                 result.errorMessage.contains("no key found")) {
@@ -232,6 +213,77 @@ bool BackupManager::runBackupTask(int taskId)
     return true;
 }
 
+bool BackupManager::executeBackup(const Models::BackupTask& task, const Models::Repository& repo,
+                                  const QString& password, Models::BackupResult& result)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 执行备份
+    ResticWrapper wrapper;
+    connect(&wrapper, &ResticWrapper::progressUpdated,
+            this, &BackupManager::backupProgress);
+
+    result.taskId = task.id;
+
+    // 连接错误信号以捕获错误消息
+    QString errorMessage;
+    connect(&wrapper, &ResticWrapper::commandError, [&errorMessage](const QString& error) {
+        errorMessage = error;
+    });
+    connect(&wrapper, &ResticWrapper::standardError, [&errorMessage](const QString& error) {
+        if (!error.isEmpty()) {
+            errorMessage += error;
+        }
+    });
+
+    bool success = wrapper.backup(repo, password, task, result);
+
+    // 如果备份失败且没有错误消息，使用捕获的错误消息
+    if (!success && result.errorMessage.isEmpty()) {
+        result.errorMessage = errorMessage;
+    }
+
+    // 保存备份历史
+    Data::DatabaseManager::instance()->insertBackupHistory(result);
+
+    // 更新任务的最后运行时间
+    Models::BackupTask updatedTask = task;
+    updatedTask.lastRun = QDateTime::currentDateTime();
+    Data::DatabaseManager::instance()->updateBackupTask(updatedTask);
+
+    // 如果任务有调度计划且启用，更新下次运行时间
+    if (task.enabled &&
+        task.schedule.type != Models::Schedule::None &&
+        task.schedule.type != Models::Schedule::Manual) {
+        SchedulerManager::instance()->updateTaskNextRun(task.id);
+    }
+
+    Utils::Logger::LogContext context;
+    context.taskId = task.id;
+    context.repoId = task.repositoryId;
+    context.durationMs = timer.elapsed();
+    recordBackupMetrics(repo, result, success, context.durationMs);
+
+    if (success) {
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("备份任务 %1 完成").arg(task.name), context);
+
+        // 更新仓库的最后备份时间
+        Models::Repository updatedRepo = repo;
+        updatedRepo.lastBackup = QDateTime::currentDateTime();
+        RepositoryManager::instance()->updateRepository(updatedRepo);
+
+        Utils::Logger::instance()->log(Utils::Logger::Debug,
+            QString("已更新仓库 \"%1\" 的最后备份时间").arg(repo.name));
+    } else {
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("备份任务 %1 失败").arg(task.name), context);
+    }
+
+    return success;
+}
+
 bool BackupManager::runBackupNow(int repoId, const QStringList& sourcePaths,
                                 const QStringList& excludePatterns, const QStringList& tags)
 {
@@ -264,7 +316,10 @@ bool BackupManager::runBackupNow(int repoId, const QStringList& sourcePaths,
             this, &BackupManager::backupProgress);
 
     Models::BackupResult result;
+    QElapsedTimer timer;
+    timer.start();
     bool success = wrapper.backup(repo, password, tempTask, result);
+    recordBackupMetrics(repo, result, success, timer.elapsed());
 
     m_running = false;
 
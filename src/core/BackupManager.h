@@ -36,6 +36,18 @@ public:
                      const QStringList& excludePatterns, const QStringList& tags);
     void cancelBackup();
 
+    /**
+     * @brief 同步执行备份：运行 restic，写入备份历史，更新任务和仓库的时间
+     *
+     * 不占用 runBackupTask() 的单任务状态，也不发出 backupStarted/backupFinished，
+     * 可以在多个工作线程中并发调用（命令行批量执行）。
+     */
+    bool executeBackup(const Models::BackupTask& task, const Models::Repository& repo,
+                       const QString& password, Models::BackupResult& result);
+
+    bool isRunning() const { return m_running; }
+    int currentTaskId() const { return m_currentTaskId; }
+
     // ========== 备份历史 ==========
     QList<Models::BackupResult> getBackupHistory(int taskId, int limit = 100);
     Models::BackupResult getLastBackupResult(int taskId);
@@ -0,0 +1,195 @@
+#include "DaemonClient.h"
+#include "DaemonServer.h"
+#include "../utils/Logger.h"
+#include <QLocalSocket>
+#include <QJsonDocument>
+#include <QElapsedTimer>
+
+namespace ResticGUI {
+namespace Core {
+
+DaemonClient* DaemonClient::s_instance = nullptr;
+QMutex DaemonClient::s_instanceMutex;
+
+DaemonClient* DaemonClient::instance()
+{
+    if (!s_instance) {
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new DaemonClient();
+        }
+    }
+    return s_instance;
+}
+
+DaemonClient::DaemonClient(QObject* parent)
+    : QObject(parent)
+    , m_socket(nullptr)
+    , m_nextRequestId(1)
+{
+}
+
+DaemonClient::~DaemonClient()
+{
+    disconnectFromDaemon();
+}
+
+bool DaemonClient::connectToDaemon(int timeoutMs)
+{
+    if (isConnected()) {
+        return true;
+    }
+
+    m_socket = new QLocalSocket(this);
+    m_socket->connectToServer(DaemonServer::serverName());
+    if (!m_socket->waitForConnected(timeoutMs)) {
+        delete m_socket;
+        m_socket = nullptr;
+        return false;
+    }
+
+    m_buffer.clear();
+    m_responses.clear();
+    connect(m_socket, &QLocalSocket::readyRead, this, &DaemonClient::onReadyRead);
+    connect(m_socket, &QLocalSocket::disconnected, this, [this]() {
+        Utils::Logger::instance()->log(Utils::Logger::Warning, "与后台服务的连接已断开");
+        m_socket->deleteLater();
+        m_socket = nullptr;
+        emit connectionLost();
+    });
+
+    QJsonObject response;
+    if (!request(QJsonObject{{"command", "subscribe"}}, response)) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("后台服务没有响应订阅请求: %1").arg(response.value("error").toString()));
+        disconnectFromDaemon();
+        return false;
+    }
+
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("已连接到后台服务: %1").arg(m_socket->fullServerName()));
+    return true;
+}
+
+void DaemonClient::disconnectFromDaemon()
+{
+    if (!m_socket) {
+        return;
+    }
+
+    QLocalSocket* socket = m_socket;
+    m_socket = nullptr;
+    socket->disconnect(this);
+    socket->disconnectFromServer();
+    socket->deleteLater();
+}
+
+bool DaemonClient::isConnected() const
+{
+    return m_socket && m_socket->state() == QLocalSocket::ConnectedState;
+}
+
+bool DaemonClient::request(const QJsonObject& request, QJsonObject& response, int timeoutMs)
+{
+    response = QJsonObject();
+    if (!isConnected()) {
+        response["error"] = "未连接到后台服务";
+        return false;
+    }
+
+    const int id = m_nextRequestId++;
+    QJsonObject message = request;
+    message["id"] = id;
+    m_socket->write(QJsonDocument(message).toJson(QJsonDocument::Compact));
+    m_socket->write("\n");
+    m_socket->flush();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!m_responses.contains(id)) {
+        const qint64 remaining = timeoutMs - timer.elapsed();
+        if (remaining <= 0 || !isConnected()) {
+            response["error"] = "后台服务没有响应";
+            return false;
+        }
+        // readyRead 在等待中同步发出，响应由 onReadyRead() 放入 m_responses
+        m_socket->waitForReadyRead(static_cast<int>(remaining));
+    }
+
+    response = m_responses.take(id);
+    return response.value("ok").toBool();
+}
+
+QJsonObject DaemonClient::status()
+{
+    QJsonObject response;
+    request(QJsonObject{{"command", "status"}}, response);
+    return response;
+}
+
+QJsonObject DaemonClient::tasks()
+{
+    QJsonObject response;
+    request(QJsonObject{{"command", "tasks"}}, response);
+    return response;
+}
+
+bool DaemonClient::runTask(int taskId, QString* error)
+{
+    QJsonObject response;
+    const bool ok = request(QJsonObject{{"command", "run"}, {"taskId", taskId}}, response);
+    if (!ok && error) {
+        *error = response.value("error").toString();
+    }
+    return ok;
+}
+
+bool DaemonClient::unlock(int repoId, const QString& password)
+{
+    QJsonObject response;
+    return request(QJsonObject{{"command", "unlock"}, {"repoId", repoId}, {"password", password}}, response);
+}
+
+bool DaemonClient::shutdownDaemon()
+{
+    QJsonObject response;
+    return request(QJsonObject{{"command", "shutdown"}}, response);
+}
+
+void DaemonClient::onReadyRead()
+{
+    if (!m_socket) {
+        return;
+    }
+
+    m_buffer += m_socket->readAll();
+
+    int start = 0;
+    for (int newline = m_buffer.indexOf('\n'); newline >= 0; newline = m_buffer.indexOf('\n', start)) {
+        const QByteArray line = m_buffer.mid(start, newline - start);
+        start = newline + 1;
+
+        const QJsonObject message = QJsonDocument::fromJson(line).object();
+        if (message.contains("event")) {
+            dispatchEvent(message);
+        } else if (message.contains("id")) {
+            m_responses.insert(message.value("id").toInt(), message);
+        }
+    }
+    m_buffer.remove(0, start);
+}
+
+void DaemonClient::dispatchEvent(const QJsonObject& event)
+{
+    const QString name = event.value("event").toString();
+    if (name == "backupStarted") {
+        emit backupStarted(event.value("taskId").toInt());
+    } else if (name == "backupProgress") {
+        emit backupProgress(event.value("percent").toInt(), event.value("message").toString());
+    } else if (name == "backupFinished") {
+        emit backupFinished(event.value("taskId").toInt(), event.value("success").toBool());
+    }
+}
+
+} // namespace Core
+} // namespace ResticGUI
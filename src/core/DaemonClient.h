@@ -0,0 +1,79 @@
+#ifndef DAEMONCLIENT_H
+#define DAEMONCLIENT_H
+
+#include <QObject>
+#include <QMutex>
+#include <QHash>
+#include <QJsonObject>
+
+class QLocalSocket;
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief 连接后台服务控制套接字的客户端（单例）
+ *
+ * 图形界面启动时尝试连接：连上后计划任务由后台服务执行，界面通过
+ * 订阅的事件显示后台服务的备份状态。协议见 DaemonServer。
+ *
+ * 所有方法须在主线程调用。request() 是阻塞调用，等待期间收到的事件
+ * 照常通过信号发出。
+ */
+class DaemonClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DaemonClient* instance();
+
+    /**
+     * @brief 连接后台服务并订阅事件，没有后台服务时返回false
+     */
+    bool connectToDaemon(int timeoutMs = 500);
+    void disconnectFromDaemon();
+    bool isConnected() const;
+
+    /**
+     * @brief 发送请求并等待响应
+     * @return 收到响应且 ok 为 true 时返回true，错误信息在 response["error"] 中
+     */
+    bool request(const QJsonObject& request, QJsonObject& response, int timeoutMs = 5000);
+
+    // ========== 常用命令 ==========
+    QJsonObject status();
+    QJsonObject tasks();
+    bool runTask(int taskId, QString* error = nullptr);
+    bool unlock(int repoId, const QString& password);
+    bool shutdownDaemon();
+
+signals:
+    void connectionLost();
+    void backupStarted(int taskId);
+    void backupProgress(int percent, const QString& message);
+    void backupFinished(int taskId, bool success);
+
+private slots:
+    void onReadyRead();
+
+private:
+    explicit DaemonClient(QObject* parent = nullptr);
+    ~DaemonClient();
+    DaemonClient(const DaemonClient&) = delete;
+    DaemonClient& operator=(const DaemonClient&) = delete;
+
+    void dispatchEvent(const QJsonObject& event);
+
+    static DaemonClient* s_instance;
+    static QMutex s_instanceMutex;
+
+    QLocalSocket* m_socket;
+    QByteArray m_buffer;
+    int m_nextRequestId;
+    QHash<int, QJsonObject> m_responses;    // 已收到、尚未被 request() 取走的响应
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // DAEMONCLIENT_H
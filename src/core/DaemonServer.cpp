@@ -0,0 +1,325 @@
+#include "DaemonServer.h"
+#include "BackupManager.h"
+#include "../data/DatabaseManager.h"
+#include "../data/PasswordManager.h"
+#include "../utils/Logger.h"
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QSocketNotifier>
+#include <QJsonDocument>
+#include <QJsonArray>
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#endif
+
+namespace ResticGUI {
+namespace Core {
+
+namespace {
+
+#ifdef Q_OS_UNIX
+// 信号处理函数只往套接字对写一个字节，真正的处理在事件循环中进行
+int s_signalFds[2] = {-1, -1};
+
+void onTerminateSignal(int)
+{
+    const char byte = 1;
+    ssize_t written = ::write(s_signalFds[0], &byte, sizeof(byte));
+    Q_UNUSED(written);
+}
+#endif
+
+} // namespace
+
+DaemonServer* DaemonServer::s_instance = nullptr;
+QMutex DaemonServer::s_instanceMutex;
+
+DaemonServer* DaemonServer::instance()
+{
+    if (!s_instance) {
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new DaemonServer();
+        }
+    }
+    return s_instance;
+}
+
+DaemonServer::DaemonServer(QObject* parent)
+    : QObject(parent)
+    , m_server(nullptr)
+    , m_lastProgress(-1)
+    , m_signalNotifier(nullptr)
+{
+}
+
+DaemonServer::~DaemonServer()
+{
+    stop();
+}
+
+QString DaemonServer::serverName()
+{
+    QString user = qEnvironmentVariable("USER");
+    if (user.isEmpty()) {
+        user = qEnvironmentVariable("USERNAME");
+    }
+    return user.isEmpty() ? QString("restic-gui-daemon") : QString("restic-gui-daemon-%1").arg(user);
+}
+
+bool DaemonServer::start()
+{
+    if (m_server) {
+        return true;
+    }
+
+    const QString name = serverName();
+
+    // 能连上说明已有后台服务在运行；连不上时清除上次崩溃遗留的套接字文件
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(500)) {
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("后台服务已在运行（%1）").arg(name));
+        return false;
+    }
+    QLocalServer::removeServer(name);
+
+    m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_server->listen(name)) {
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("无法监听控制套接字 %1: %2").arg(name).arg(m_server->errorString()));
+        delete m_server;
+        m_server = nullptr;
+        return false;
+    }
+    connect(m_server, &QLocalServer::newConnection, this, &DaemonServer::onNewConnection);
+
+    BackupManager* backupMgr = BackupManager::instance();
+    connect(backupMgr, &BackupManager::backupStarted, this, &DaemonServer::onBackupStarted);
+    connect(backupMgr, &BackupManager::backupFinished, this, &DaemonServer::onBackupFinished);
+    connect(backupMgr, &BackupManager::backupProgress, this, &DaemonServer::onBackupProgress);
+
+    m_startedAt = QDateTime::currentDateTime();
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("后台服务控制套接字已启动: %1").arg(m_server->fullServerName()));
+    return true;
+}
+
+void DaemonServer::stop()
+{
+    if (!m_server) {
+        return;
+    }
+
+    disconnect(BackupManager::instance(), nullptr, this, nullptr);
+    for (QLocalSocket* socket : m_buffers.keys()) {
+        socket->disconnectFromServer();
+    }
+    m_buffers.clear();
+    m_subscribers.clear();
+
+    m_server->close();
+    delete m_server;
+    m_server = nullptr;
+}
+
+void DaemonServer::installSignalHandlers()
+{
+#ifdef Q_OS_UNIX
+    if (m_signalNotifier) {
+        return;
+    }
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, s_signalFds) != 0) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning, "无法创建信号通知套接字，终止信号将直接结束进程");
+        return;
+    }
+
+    m_signalNotifier = new QSocketNotifier(s_signalFds[1], QSocketNotifier::Read, this);
+    connect(m_signalNotifier, &QSocketNotifier::activated, this, [this]() {
+        char byte = 0;
+        ssize_t received = ::read(s_signalFds[1], &byte, sizeof(byte));
+        Q_UNUSED(received);
+        Utils::Logger::instance()->log(Utils::Logger::Info, "收到终止信号，后台服务正在退出");
+        emit shutdownRequested();
+    });
+
+    struct sigaction action = {};
+    action.sa_handler = onTerminateSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGTERM, &action, nullptr);
+    sigaction(SIGINT, &action, nullptr);
+#endif
+}
+
+// ========== 连接处理 ==========
+
+void DaemonServer::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            m_buffers.remove(socket);
+            m_subscribers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void DaemonServer::onReadyRead(QLocalSocket* socket)
+{
+    QByteArray& buffer = m_buffers[socket];
+    buffer += socket->readAll();
+
+    int start = 0;
+    for (int newline = buffer.indexOf('\n'); newline >= 0; newline = buffer.indexOf('\n', start)) {
+        const QByteArray line = buffer.mid(start, newline - start).trimmed();
+        start = newline + 1;
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            send(socket, QJsonObject{{"ok", false}, {"error", QString("无效的请求: %1").arg(error.errorString())}});
+            continue;
+        }
+
+        const QJsonObject request = doc.object();
+        QJsonObject response = handleCommand(request, socket);
+        response["id"] = request.value("id");
+        send(socket, response);
+    }
+    buffer.remove(0, start);
+
+    // 没有换行的超长输入不是合法客户端
+    if (buffer.size() > MaxLineBytes) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning, "控制连接的请求过长，断开连接");
+        socket->disconnectFromServer();
+    }
+}
+
+QJsonObject DaemonServer::handleCommand(const QJsonObject& request, QLocalSocket* socket)
+{
+    const QString command = request.value("command").toString();
+
+    if (command == "status") {
+        return statusObject();
+    }
+
+    if (command == "tasks") {
+        return tasksObject();
+    }
+
+    if (command == "run") {
+        const int taskId = request.value("taskId").toInt(-1);
+        if (!BackupManager::instance()->runBackupTask(taskId)) {
+            return QJsonObject{{"ok", false}, {"error", QString("任务 %1 无法启动").arg(taskId)}};
+        }
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("控制连接请求执行任务 %1").arg(taskId));
+        return QJsonObject{{"ok", true}};
+    }
+
+    if (command == "unlock") {
+        const int repoId = request.value("repoId").toInt(-1);
+        Data::PasswordManager* passwords = Data::PasswordManager::instance();
+        passwords->setPassword(repoId, request.value("password").toString());
+        if (!passwords->hasPassword(repoId)) {
+            return QJsonObject{{"ok", false}, {"error", "当前密码存储模式不保留密码"}};
+        }
+        return QJsonObject{{"ok", true}};
+    }
+
+    if (command == "subscribe") {
+        m_subscribers.insert(socket);
+        return QJsonObject{{"ok", true}};
+    }
+
+    if (command == "shutdown") {
+        Utils::Logger::instance()->log(Utils::Logger::Info, "控制连接请求停止后台服务");
+        // 先回应再退出
+        QMetaObject::invokeMethod(this, [this]() { emit shutdownRequested(); }, Qt::QueuedConnection);
+        return QJsonObject{{"ok", true}};
+    }
+
+    return QJsonObject{{"ok", false}, {"error", QString("未知命令: %1").arg(command)}};
+}
+
+QJsonObject DaemonServer::statusObject() const
+{
+    BackupManager* backupMgr = BackupManager::instance();
+
+    QJsonObject status;
+    status["ok"] = true;
+    status["protocol"] = ProtocolVersion;
+    status["version"] = QCoreApplication::applicationVersion();
+    status["pid"] = QCoreApplication::applicationPid();
+    status["uptimeSecs"] = m_startedAt.secsTo(QDateTime::currentDateTime());
+    status["backupRunning"] = backupMgr->isRunning();
+    status["currentTaskId"] = backupMgr->currentTaskId();
+    status["clients"] = m_buffers.size();
+    return status;
+}
+
+QJsonObject DaemonServer::tasksObject() const
+{
+    QJsonArray tasks;
+    for (const Models::BackupTask& task : Data::DatabaseManager::instance()->getAllBackupTasks()) {
+        QJsonObject item;
+        item["id"] = task.id;
+        item["name"] = task.name;
+        item["repositoryId"] = task.repositoryId;
+        item["enabled"] = task.enabled;
+        item["lastRun"] = task.lastRun.isValid() ? task.lastRun.toString(Qt::ISODate) : QString();
+        item["nextRun"] = task.nextRun.isValid() ? task.nextRun.toString(Qt::ISODate) : QString();
+        tasks.append(item);
+    }
+    return QJsonObject{{"ok", true}, {"tasks", tasks}};
+}
+
+void DaemonServer::send(QLocalSocket* socket, const QJsonObject& message)
+{
+    socket->write(QJsonDocument(message).toJson(QJsonDocument::Compact));
+    socket->write("\n");
+}
+
+void DaemonServer::broadcast(const QJsonObject& event)
+{
+    for (QLocalSocket* socket : qAsConst(m_subscribers)) {
+        send(socket, event);
+    }
+}
+
+// ========== 备份事件 ==========
+
+void DaemonServer::onBackupStarted(int taskId)
+{
+    m_lastProgress = -1;
+    broadcast(QJsonObject{{"event", "backupStarted"}, {"taskId", taskId}});
+}
+
+void DaemonServer::onBackupFinished(int taskId, bool success)
+{
+    broadcast(QJsonObject{{"event", "backupFinished"}, {"taskId", taskId}, {"success", success}});
+}
+
+void DaemonServer::onBackupProgress(int percent, const QString& message)
+{
+    if (percent == m_lastProgress) {
+        return;
+    }
+    m_lastProgress = percent;
+    broadcast(QJsonObject{{"event", "backupProgress"}, {"percent", percent}, {"message", message}});
+}
+
+} // namespace Core
+} // namespace ResticGUI
@@ -0,0 +1,96 @@
+#ifndef DAEMONSERVER_H
+#define DAEMONSERVER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
+#include <QDateTime>
+#include <QJsonObject>
+
+class QLocalServer;
+class QLocalSocket;
+class QSocketNotifier;
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief 后台服务的本地控制接口（单例）
+ *
+ * --daemon 模式下监听一个本地套接字（Unix 域套接字 / Windows 命名管道），
+ * 只允许当前用户连接。协议是每行一个 JSON 对象：
+ *   请求 {"id": 1, "command": "status"}
+ *   响应 {"id": 1, "ok": true, ...}
+ *   事件 {"event": "backupFinished", "taskId": 3, "success": true}
+ * 命令：status、tasks、run（taskId）、unlock（repoId, password）、
+ * subscribe（之后推送备份事件）、shutdown。
+ *
+ * 所有方法须在主线程调用。
+ */
+class DaemonServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DaemonServer* instance();
+
+    /**
+     * @brief 开始监听，已有后台服务在运行时返回false
+     */
+    bool start();
+    void stop();
+
+    /**
+     * @brief 收到 SIGTERM/SIGINT 时发出 shutdownRequested，而不是直接终止进程
+     */
+    void installSignalHandlers();
+
+    /**
+     * @brief 当前用户的控制套接字名称
+     */
+    static QString serverName();
+
+    static constexpr int ProtocolVersion = 1;
+    static constexpr int MaxLineBytes = 64 * 1024;
+
+signals:
+    /**
+     * @brief 收到 shutdown 命令或终止信号
+     */
+    void shutdownRequested();
+
+private slots:
+    void onNewConnection();
+    void onBackupStarted(int taskId);
+    void onBackupFinished(int taskId, bool success);
+    void onBackupProgress(int percent, const QString& message);
+
+private:
+    explicit DaemonServer(QObject* parent = nullptr);
+    ~DaemonServer();
+    DaemonServer(const DaemonServer&) = delete;
+    DaemonServer& operator=(const DaemonServer&) = delete;
+
+    void onReadyRead(QLocalSocket* socket);
+    QJsonObject handleCommand(const QJsonObject& request, QLocalSocket* socket);
+    QJsonObject statusObject() const;
+    QJsonObject tasksObject() const;
+    void send(QLocalSocket* socket, const QJsonObject& message);
+    void broadcast(const QJsonObject& event);
+
+    static DaemonServer* s_instance;
+    static QMutex s_instanceMutex;
+
+    QLocalServer* m_server;
+    QHash<QLocalSocket*, QByteArray> m_buffers;     // 每个连接未读完的行
+    QSet<QLocalSocket*> m_subscribers;
+    QDateTime m_startedAt;
+    int m_lastProgress;                             // 进度事件只在百分比变化时推送
+    QSocketNotifier* m_signalNotifier;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // DAEMONSERVER_H
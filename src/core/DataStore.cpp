@@ -0,0 +1,374 @@
+#include "DataStore.h"
+#include "BackupManager.h"
+#include "RepositoryManager.h"
+#include "SnapshotManager.h"
+#include "ResticWrapper.h"
+#include "../data/CacheManager.h"
+#include "../data/DatabaseManager.h"
+#include "../data/PasswordManager.h"
+#include "../utils/Logger.h"
+#include "../utils/Tracer.h"
+#include "../utils/Metrics.h"
+#include <QDateTime>
+#include <QtConcurrent>
+
+namespace ResticGUI {
+namespace Core {
+
+namespace {
+
+// 按查询类型（键的前缀）和结果计数：fetch 启动了后台刷新，coalesced 合并到进行中的刷新，fresh 数据仍新鲜
+void countRequest(const QString& key, const QString& result)
+{
+    static QHash<QString, Utils::Counter*> counters;    // 只在主线程访问
+    const QString query = key.section('/', 0, 0);
+    const QString cacheKey = query + '/' + result;
+
+    Utils::Counter* counter = counters.value(cacheKey);
+    if (!counter) {
+        counter = Utils::MetricsRegistry::instance()->counter("resticgui_datastore_requests_total",
+            "数据存储的刷新请求次数", {{"query", query}, {"result", result}});
+        counters.insert(cacheKey, counter);
+    }
+    counter->inc();
+}
+
+// 与 SnapshotTableModel::snapshotIdAt() 相同：优先使用完整ID
+QString snapshotKey(const Models::Snapshot& snapshot)
+{
+    return snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId;
+}
+
+bool sameEntry(const Models::TaskListEntry& a, const Models::TaskListEntry& b)
+{
+    return a.name == b.name
+        && a.repositoryId == b.repositoryId
+        && a.repositoryName == b.repositoryName
+        && a.firstSourcePath == b.firstSourcePath
+        && a.sourcePathCount == b.sourcePathCount
+        && a.scheduleType == b.scheduleType
+        && a.enabled == b.enabled
+        && a.lastRun == b.lastRun
+        && a.nextRun == b.nextRun
+        && a.hasLastStatus == b.hasLastStatus
+        && a.lastStatus == b.lastStatus;
+}
+
+} // namespace
+
+DataStore* DataStore::s_instance = nullptr;
+QMutex DataStore::s_instanceMutex;
+
+DataStore* DataStore::instance()
+{
+    if (!s_instance) {
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new DataStore();
+        }
+    }
+    return s_instance;
+}
+
+DataStore::DataStore(QObject* parent)
+    : QObject(parent)
+    , m_taskListLoaded(false)
+{
+    // 其他途径（SnapshotManager、命令行同步后的数据库缓存）更新快照缓存时同样发布差异
+    connect(Data::CacheManager::instance(), &Data::CacheManager::cacheUpdated,
+            this, &DataStore::onCacheUpdated);
+
+    // 备份完成后任务的最近运行状态和仓库的快照列表都已变化
+    connect(BackupManager::instance(), &BackupManager::backupFinished,
+            this, &DataStore::onBackupFinished);
+}
+
+// ========== 快照列表 ==========
+
+bool DataStore::snapshots(int repoId, QList<Models::Snapshot>& snapshots)
+{
+    auto it = m_snapshots.constFind(repoId);
+    if (it != m_snapshots.constEnd()) {
+        snapshots = it.value();
+        return true;
+    }
+
+    if (!Data::CacheManager::instance()->getCachedSnapshots(repoId, snapshots)) {
+        return false;
+    }
+    m_snapshots.insert(repoId, snapshots);
+    return true;
+}
+
+void DataStore::revalidateSnapshots(int repoId, bool force)
+{
+    const QString key = snapshotsKey(repoId);
+
+    // 密码必须在主线程取得（PasswordManager 的缓存计时器属于主线程）
+    QString password;
+    if (!Data::PasswordManager::instance()->getPassword(repoId, password)) {
+        emit snapshotsRefreshFinished(repoId, false, tr("需要仓库密码"));
+        return;
+    }
+
+    if (!beginFetch(key, force)) {
+        return;
+    }
+
+    const Models::Repository repo = RepositoryManager::instance()->getRepository(repoId);
+    QtConcurrent::run([this, repoId, repo, password, key]() {
+        Utils::TraceSpan span("DataStore::fetchSnapshots", "store");
+        span.setDetail(repo.name);
+
+        // 与 SnapshotManager::listSnapshots() 的其他调用者（统计页面等）合并为一次 restic 调用
+        QList<Models::Snapshot> snapshots;
+        QString error;
+        const bool success = SnapshotManager::instance()->fetchSnapshots(repo, password, snapshots, &error);
+
+        QMetaObject::invokeMethod(this, [this, repoId, snapshots, success, error, key]() {
+            if (success) {
+                publishSnapshots(repoId, snapshots);
+            } else {
+                Utils::Logger::instance()->log(Utils::Logger::Warning,
+                    QString("刷新仓库 %1 的快照列表失败: %2").arg(repoId).arg(error));
+            }
+
+            const bool rerun = endFetch(key, success);
+            emit snapshotsRefreshFinished(repoId, success, error);
+            if (rerun) {
+                revalidateSnapshots(repoId, true);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+bool DataStore::isRefreshingSnapshots(int repoId) const
+{
+    return m_inFlight.contains(snapshotsKey(repoId));
+}
+
+void DataStore::publishSnapshots(int repoId, const QList<Models::Snapshot>& snapshots)
+{
+    const bool known = m_snapshots.contains(repoId);
+    const QList<Models::Snapshot> previous = m_snapshots.value(repoId);
+
+    // 快照创建后不再改变，按ID比较即可
+    SnapshotDelta delta;
+    QSet<QString> previousIds;
+    for (const Models::Snapshot& snapshot : previous) {
+        previousIds.insert(snapshotKey(snapshot));
+    }
+    QSet<QString> currentIds;
+    for (const Models::Snapshot& snapshot : snapshots) {
+        currentIds.insert(snapshotKey(snapshot));
+        if (!previousIds.contains(snapshotKey(snapshot))) {
+            delta.added.append(snapshot);
+        }
+    }
+    for (const Models::Snapshot& snapshot : previous) {
+        if (!currentIds.contains(snapshotKey(snapshot))) {
+            delta.removedIds.append(snapshotKey(snapshot));
+        }
+    }
+
+    m_snapshots.insert(repoId, snapshots);
+    if (known && delta.isEmpty()) {
+        return;
+    }
+
+    Utils::Logger::instance()->log(Utils::Logger::Debug,
+        QString("仓库 %1 的快照列表已更新：新增 %2，删除 %3")
+            .arg(repoId).arg(delta.added.size()).arg(delta.removedIds.size()));
+    emit snapshotsChanged(repoId, snapshots, delta);
+}
+
+void DataStore::onCacheUpdated(int repoId)
+{
+    QList<Models::Snapshot> snapshots;
+    if (Data::CacheManager::instance()->getCachedSnapshots(repoId, snapshots)) {
+        publishSnapshots(repoId, snapshots);
+    }
+}
+
+// ========== 仓库统计 ==========
+
+bool DataStore::repoStats(int repoId, Models::RepoStats& stats)
+{
+    auto it = m_repoStats.constFind(repoId);
+    if (it != m_repoStats.constEnd()) {
+        stats = it.value();
+        return true;
+    }
+
+    if (!Data::CacheManager::instance()->getCachedRepoStats(repoId, stats)) {
+        return false;
+    }
+    m_repoStats.insert(repoId, stats);
+    return true;
+}
+
+void DataStore::revalidateRepoStats(int repoId, bool force)
+{
+    const QString key = statsKey(repoId);
+
+    QString password;
+    if (!Data::PasswordManager::instance()->getPassword(repoId, password)) {
+        emit repoStatsRefreshFinished(repoId, false, tr("需要仓库密码"));
+        return;
+    }
+
+    if (!beginFetch(key, force)) {
+        return;
+    }
+
+    const Models::Repository repo = RepositoryManager::instance()->getRepository(repoId);
+    QtConcurrent::run([this, repoId, repo, password, key]() {
+        Utils::TraceSpan span("DataStore::fetchRepoStats", "store");
+        span.setDetail(repo.name);
+
+        ResticWrapper wrapper;
+        Models::RepoStats stats;
+        const bool success = wrapper.getStats(repo, password, stats);
+        const QString error = success ? QString() : wrapper.lastErrorOutput();
+        if (success) {
+            Data::CacheManager::instance()->cacheRepoStats(repoId, stats);
+        }
+
+        QMetaObject::invokeMethod(this, [this, repoId, stats, success, error, key]() {
+            if (success) {
+                const bool known = m_repoStats.contains(repoId);
+                const Models::RepoStats previous = m_repoStats.value(repoId);
+                m_repoStats.insert(repoId, stats);
+
+                if (!known || previous.totalSize != stats.totalSize
+                    || previous.totalFileCount != stats.totalFileCount
+                    || previous.uniqueSize != stats.uniqueSize
+                    || previous.snapshotCount != stats.snapshotCount) {
+                    emit repoStatsChanged(repoId, stats);
+                }
+            }
+
+            const bool rerun = endFetch(key, success);
+            emit repoStatsRefreshFinished(repoId, success, error);
+            if (rerun) {
+                revalidateRepoStats(repoId, true);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+// ========== 任务列表 ==========
+
+bool DataStore::taskList(QList<Models::TaskListEntry>& entries) const
+{
+    if (!m_taskListLoaded) {
+        return false;
+    }
+    entries = m_taskList;
+    return true;
+}
+
+void DataStore::revalidateTaskList()
+{
+    const QString key = "tasks";
+    if (!beginFetch(key, true)) {
+        return;
+    }
+
+    QtConcurrent::run([this, key]() {
+        Utils::TraceSpan span("DataStore::fetchTaskList", "store");
+        const QList<Models::TaskListEntry> entries = Data::DatabaseManager::instance()->getTaskListEntries();
+
+        QMetaObject::invokeMethod(this, [this, entries, key]() {
+            publishTaskList(entries);
+            if (endFetch(key, true)) {
+                revalidateTaskList();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void DataStore::publishTaskList(const QList<Models::TaskListEntry>& entries)
+{
+    TaskListDelta delta;
+    QHash<int, int> previousRows;
+    for (int i = 0; i < m_taskList.size(); ++i) {
+        previousRows.insert(m_taskList.at(i).id, i);
+    }
+
+    QSet<int> currentIds;
+    for (const Models::TaskListEntry& entry : entries) {
+        currentIds.insert(entry.id);
+        auto it = previousRows.constFind(entry.id);
+        if (it == previousRows.constEnd()) {
+            delta.added.append(entry.id);
+        } else if (!sameEntry(m_taskList.at(it.value()), entry)) {
+            delta.changed.append(entry.id);
+        }
+    }
+    for (const Models::TaskListEntry& entry : qAsConst(m_taskList)) {
+        if (!currentIds.contains(entry.id)) {
+            delta.removed.append(entry.id);
+        }
+    }
+
+    const bool known = m_taskListLoaded;
+    m_taskList = entries;
+    m_taskListLoaded = true;
+    if (known && delta.isEmpty()) {
+        return;
+    }
+
+    emit taskListChanged(entries, delta);
+}
+
+void DataStore::onBackupFinished(int taskId, bool success)
+{
+    revalidateTaskList();
+
+    if (success) {
+        // 新快照已产生，下一次刷新不能再用“新鲜”的旧结果
+        const int repoId = BackupManager::instance()->getBackupTask(taskId).repositoryId;
+        m_fetchedAt.remove(snapshotsKey(repoId));
+        m_fetchedAt.remove(statsKey(repoId));
+    }
+}
+
+// ========== 请求合并 ==========
+
+bool DataStore::beginFetch(const QString& key, bool force)
+{
+    if (m_inFlight.contains(key)) {
+        // 已有刷新在进行，结果会通知所有订阅者；强制请求需要在它之后再刷新一次
+        if (force) {
+            m_rerun.insert(key);
+        }
+        countRequest(key, "coalesced");
+        return false;
+    }
+
+    if (!force) {
+        auto it = m_fetchedAt.constFind(key);
+        if (it != m_fetchedAt.constEnd()
+            && QDateTime::currentMSecsSinceEpoch() - it.value() < FreshSecs * 1000) {
+            countRequest(key, "fresh");
+            return false;
+        }
+    }
+
+    m_inFlight.insert(key);
+    countRequest(key, "fetch");
+    return true;
+}
+
+bool DataStore::endFetch(const QString& key, bool success)
+{
+    m_inFlight.remove(key);
+    if (success) {
+        m_fetchedAt.insert(key, QDateTime::currentMSecsSinceEpoch());
+    }
+    return m_rerun.remove(key);
+}
+
+} // namespace Core
+} // namespace ResticGUI
@@ -0,0 +1,146 @@
+#ifndef DATASTORE_H
+#define DATASTORE_H
+
+#include <QObject>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QStringList>
+#include "../models/Snapshot.h"
+#include "../models/RepoStats.h"
+#include "../models/TaskListEntry.h"
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief 界面共用的可观察数据存储（单例，stale-while-revalidate）
+ *
+ * 每种查询（快照列表、仓库统计、任务列表）都先同步返回已有的数据（内存或
+ * 数据库缓存），再由 revalidate*() 在后台刷新：
+ *   - 同一查询正在刷新时，其他页面的请求合并到这一次 restic 调用；
+ *     强制刷新会在当前刷新结束后再执行一次，保证看到请求之后的数据；
+ *   - 刷新结果与上次发布的数据比较，只在有变化时通过 *Changed 信号发出，
+ *     信号同时携带完整数据和差异，订阅者可以只更新变化的行；
+ *   - 每次刷新结束都发出 *RefreshFinished，用于结束加载提示。
+ *
+ * 所有方法须在主线程调用，信号也在主线程发出。
+ */
+class DataStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 快照列表的差异
+     */
+    struct SnapshotDelta
+    {
+        QList<Models::Snapshot> added;
+        QStringList removedIds;     // 完整快照ID
+
+        bool isEmpty() const { return added.isEmpty() && removedIds.isEmpty(); }
+    };
+
+    /**
+     * @brief 任务列表的差异（任务ID）
+     */
+    struct TaskListDelta
+    {
+        QList<int> added;
+        QList<int> removed;
+        QList<int> changed;
+
+        bool isEmpty() const { return added.isEmpty() && removed.isEmpty() && changed.isEmpty(); }
+    };
+
+    static DataStore* instance();
+
+    // ========== 快照列表 ==========
+
+    /**
+     * @brief 立即返回已知的快照列表（按时间升序），没有任何缓存时返回false
+     */
+    bool snapshots(int repoId, QList<Models::Snapshot>& snapshots);
+
+    /**
+     * @brief 在后台刷新快照列表
+     * @param force 为 false 时，最近 FreshSecs 秒内刷新过则不再刷新
+     */
+    void revalidateSnapshots(int repoId, bool force = false);
+
+    bool isRefreshingSnapshots(int repoId) const;
+
+    // ========== 仓库统计 ==========
+
+    bool repoStats(int repoId, Models::RepoStats& stats);
+    void revalidateRepoStats(int repoId, bool force = false);
+
+    // ========== 任务列表 ==========
+
+    bool taskList(QList<Models::TaskListEntry>& entries) const;
+
+    /**
+     * @brief 在后台重新查询任务列表（数据库查询，总是执行）
+     */
+    void revalidateTaskList();
+
+    // 结果在这段时间内视为新鲜，非强制的刷新请求直接忽略
+    static constexpr int FreshSecs = 30;
+
+signals:
+    void snapshotsChanged(int repoId, const QList<Models::Snapshot>& snapshots,
+                          const ResticGUI::Core::DataStore::SnapshotDelta& delta);
+    void snapshotsRefreshFinished(int repoId, bool success, const QString& error);
+
+    void repoStatsChanged(int repoId, const ResticGUI::Models::RepoStats& stats);
+    void repoStatsRefreshFinished(int repoId, bool success, const QString& error);
+
+    void taskListChanged(const QList<ResticGUI::Models::TaskListEntry>& entries,
+                         const ResticGUI::Core::DataStore::TaskListDelta& delta);
+
+private slots:
+    void onCacheUpdated(int repoId);
+    void onBackupFinished(int taskId, bool success);
+
+private:
+    explicit DataStore(QObject* parent = nullptr);
+    ~DataStore() = default;
+    DataStore(const DataStore&) = delete;
+    DataStore& operator=(const DataStore&) = delete;
+
+    /**
+     * @brief 登记一次刷新，返回false表示不需要启动新的后台任务
+     */
+    bool beginFetch(const QString& key, bool force);
+
+    /**
+     * @brief 刷新结束，返回true表示期间有强制刷新请求，需要再执行一次
+     */
+    bool endFetch(const QString& key, bool success);
+
+    void publishSnapshots(int repoId, const QList<Models::Snapshot>& snapshots);
+    void publishTaskList(const QList<Models::TaskListEntry>& entries);
+
+    static QString snapshotsKey(int repoId) { return QString("snapshots/%1").arg(repoId); }
+    static QString statsKey(int repoId) { return QString("stats/%1").arg(repoId); }
+
+    static DataStore* s_instance;
+    static QMutex s_instanceMutex;
+
+    // 最近一次发布的数据，用于计算差异
+    QHash<int, QList<Models::Snapshot>> m_snapshots;
+    QHash<int, Models::RepoStats> m_repoStats;
+    QList<Models::TaskListEntry> m_taskList;
+    bool m_taskListLoaded;
+
+    QSet<QString> m_inFlight;               // 正在刷新的查询
+    QSet<QString> m_rerun;                  // 刷新期间收到强制请求的查询
+    QHash<QString, qint64> m_fetchedAt;     // 最近一次成功刷新的时间（毫秒）
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // DATASTORE_H
@@ -0,0 +1,242 @@
+#include "FileHistoryIndex.h"
+#include <algorithm>
+
+namespace ResticGUI {
+namespace Core {
+
+FileHistoryIndex::FileHistoryIndex()
+    : m_indexedCount(0)
+{
+}
+
+// ========== 快照 ==========
+
+QString FileHistoryIndex::snapshotKey(const Models::Snapshot& snapshot)
+{
+    return snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId;
+}
+
+int FileHistoryIndex::snapshotNumber(const Models::Snapshot& snapshot)
+{
+    const QString key = snapshotKey(snapshot);
+    int number = m_snapshotNumbers.value(key, -1);
+    if (number >= 0) {
+        // 同一快照被删除后不会再出现，这里只更新快照信息
+        m_snapshots[number].snapshot = snapshot;
+        return number;
+    }
+
+    SnapshotRef ref;
+    ref.snapshot = snapshot;
+    ref.indexed = false;
+    ref.removed = false;
+    number = m_snapshots.size();
+    m_snapshots.append(ref);
+    m_snapshotNumbers.insert(key, number);
+    return number;
+}
+
+int FileHistoryIndex::findSnapshot(const QString& snapshotId) const
+{
+    int number = m_snapshotNumbers.value(snapshotId, -1);
+    if (number >= 0 || snapshotId.isEmpty()) {
+        return number;
+    }
+
+    // restic 输出的可能是完整ID，也可能是短ID
+    for (auto it = m_snapshotNumbers.constBegin(); it != m_snapshotNumbers.constEnd(); ++it) {
+        if (it.key().startsWith(snapshotId) || snapshotId.startsWith(it.key())) {
+            return it.value();
+        }
+    }
+    return -1;
+}
+
+int FileHistoryIndex::retainSnapshots(const QList<Models::Snapshot>& snapshots)
+{
+    QSet<QString> alive;
+    for (const Models::Snapshot& snapshot : snapshots) {
+        alive.insert(snapshotKey(snapshot));
+    }
+
+    QStringList stale;
+    for (auto it = m_snapshotNumbers.constBegin(); it != m_snapshotNumbers.constEnd(); ++it) {
+        if (!alive.contains(it.key()) && !m_snapshots.at(it.value()).removed) {
+            stale.append(it.key());
+        }
+    }
+
+    for (const QString& id : stale) {
+        removeSnapshot(id);
+    }
+    return stale.size();
+}
+
+void FileHistoryIndex::addSnapshot(const Models::Snapshot& snapshot, const QList<Models::FileInfo>& files)
+{
+    const int number = snapshotNumber(snapshot);
+    SnapshotRef& ref = m_snapshots[number];
+    if (ref.indexed || ref.removed) {
+        return;
+    }
+
+    for (const Models::FileInfo& file : files) {
+        if (file.path.isEmpty()) {
+            continue;
+        }
+
+        QVector<Version>& versions = m_versions[file.path];
+        // restic ls 可能返回重复项
+        if (!versions.isEmpty() && versions.last().snapshot == number) {
+            continue;
+        }
+        versions.append(makeVersion(number, file.type, file.size, file.mtime));
+    }
+
+    ref.indexed = true;
+    m_indexedCount++;
+}
+
+void FileHistoryIndex::removeSnapshot(const QString& snapshotId)
+{
+    const int number = findSnapshot(snapshotId);
+    if (number < 0 || m_snapshots.at(number).removed) {
+        return;
+    }
+
+    auto belongs = [number](const Version& version) { return version.snapshot == number; };
+
+    if (m_snapshots.at(number).indexed) {
+        for (auto it = m_versions.begin(); it != m_versions.end(); ) {
+            QVector<Version>& versions = it.value();
+            versions.erase(std::remove_if(versions.begin(), versions.end(), belongs), versions.end());
+            if (versions.isEmpty()) {
+                it = m_versions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_indexedCount--;
+    }
+
+    for (auto it = m_lookups.begin(); it != m_lookups.end(); ++it) {
+        QVector<Version>& versions = it.value().versions;
+        versions.erase(std::remove_if(versions.begin(), versions.end(), belongs), versions.end());
+        it.value().searched.remove(number);
+    }
+
+    // 编号保留以免其他版本的编号失效，只标记为已删除
+    m_snapshots[number].indexed = false;
+    m_snapshots[number].removed = true;
+}
+
+bool FileHistoryIndex::isSnapshotIndexed(const QString& snapshotId) const
+{
+    const int number = m_snapshotNumbers.value(snapshotId, -1);
+    return number >= 0 && m_snapshots.at(number).indexed;
+}
+
+// ========== 按路径查询 ==========
+
+void FileHistoryIndex::addPathVersions(const QString& path, const QList<Models::Snapshot>& searched,
+                                       const QList<Models::FileVersion>& found)
+{
+    PathLookup& lookup = m_lookups[path];
+
+    for (const Models::Snapshot& snapshot : searched) {
+        lookup.searched.insert(snapshotNumber(snapshot));
+    }
+
+    for (const Models::FileVersion& version : found) {
+        const int number = findSnapshot(version.snapshotId);
+        if (number < 0 || m_snapshots.at(number).removed) {
+            continue;
+        }
+
+        bool exists = false;
+        for (const Version& known : lookup.versions) {
+            if (known.snapshot == number) {
+                exists = true;
+                break;
+            }
+        }
+        if (!exists) {
+            lookup.versions.append(makeVersion(number, version.type, version.size, version.mtime));
+        }
+    }
+}
+
+QList<Models::Snapshot> FileHistoryIndex::uncoveredSnapshots(const QString& path,
+                                                             const QList<Models::Snapshot>& snapshots) const
+{
+    const PathLookup lookup = m_lookups.value(path);
+
+    QList<Models::Snapshot> uncovered;
+    for (const Models::Snapshot& snapshot : snapshots) {
+        const int number = m_snapshotNumbers.value(snapshotKey(snapshot), -1);
+        if (number >= 0 && (m_snapshots.at(number).indexed || lookup.searched.contains(number))) {
+            continue;
+        }
+        uncovered.append(snapshot);
+    }
+    return uncovered;
+}
+
+QList<Models::FileVersion> FileHistoryIndex::versionsOf(const QString& path) const
+{
+    QVector<Version> versions = m_versions.value(path);
+
+    // restic find 的结果只补充未完整收录的快照
+    const auto lookup = m_lookups.constFind(path);
+    if (lookup != m_lookups.constEnd()) {
+        for (const Version& version : lookup.value().versions) {
+            if (!m_snapshots.at(version.snapshot).indexed) {
+                versions.append(version);
+            }
+        }
+    }
+
+    QList<Models::FileVersion> result;
+    result.reserve(versions.size());
+    for (const Version& version : versions) {
+        result.append(toFileVersion(version));
+    }
+
+    std::sort(result.begin(), result.end(),
+              [](const Models::FileVersion& a, const Models::FileVersion& b) {
+                  return a.snapshotTime > b.snapshotTime;
+              });
+    return result;
+}
+
+// ========== 辅助函数 ==========
+
+FileHistoryIndex::Version FileHistoryIndex::makeVersion(int snapshot, Models::FileType type,
+                                                        qint64 size, const QDateTime& mtime)
+{
+    Version version;
+    version.snapshot = snapshot;
+    version.type = static_cast<quint8>(type);
+    version.size = size;
+    version.mtime = mtime.isValid() ? mtime.toMSecsSinceEpoch() : -1;
+    return version;
+}
+
+Models::FileVersion FileHistoryIndex::toFileVersion(const Version& version) const
+{
+    const Models::Snapshot& snapshot = m_snapshots.at(version.snapshot).snapshot;
+
+    Models::FileVersion result;
+    result.snapshotId = snapshotKey(snapshot);
+    result.snapshotTime = snapshot.time;
+    result.hostname = snapshot.hostname;
+    result.type = static_cast<Models::FileType>(version.type);
+    result.size = version.size;
+    if (version.mtime >= 0) {
+        result.mtime = QDateTime::fromMSecsSinceEpoch(version.mtime);
+    }
+    return result;
+}
+
+} // namespace Core
+} // namespace ResticGUI
@@ -0,0 +1,114 @@
+#ifndef FILEHISTORYINDEX_H
+#define FILEHISTORYINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include "../models/Snapshot.h"
+#include "../models/FileInfo.h"
+#include "../models/FileVersion.h"
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief 仓库的跨快照文件历史索引
+ *
+ * 记录每个路径出现在哪些快照中以及对应的大小和修改时间。
+ * 数据有两个来源：
+ * - 完整收录：快照的递归文件列表（已缓存的 restic ls 结果），收录后该快照
+ *   对所有路径都有答案
+ * - 按路径收录：restic find 针对单个路径的查询结果，只对查询过的路径有效
+ *
+ * 快照只需收录一次，新快照出现时增量加入，删除快照时移除对应版本。
+ * 非线程安全，由 SnapshotManager 加锁访问。
+ */
+class FileHistoryIndex
+{
+public:
+    FileHistoryIndex();
+
+    /**
+     * @brief 按仓库当前的快照列表同步，移除已不存在的快照
+     * @return 被移除的快照数
+     */
+    int retainSnapshots(const QList<Models::Snapshot>& snapshots);
+
+    /**
+     * @brief 收录快照的递归文件列表
+     */
+    void addSnapshot(const Models::Snapshot& snapshot, const QList<Models::FileInfo>& files);
+
+    /**
+     * @brief 移除快照的所有版本
+     */
+    void removeSnapshot(const QString& snapshotId);
+
+    /**
+     * @brief 快照是否已完整收录
+     */
+    bool isSnapshotIndexed(const QString& snapshotId) const;
+
+    /**
+     * @brief 收录 restic find 对单个路径的查询结果
+     * @param path 查询的路径
+     * @param searched 本次查询覆盖的快照
+     * @param found 查询到的版本，快照ID为完整ID
+     */
+    void addPathVersions(const QString& path, const QList<Models::Snapshot>& searched,
+                         const QList<Models::FileVersion>& found);
+
+    /**
+     * @brief 找出尚不能回答该路径的快照
+     */
+    QList<Models::Snapshot> uncoveredSnapshots(const QString& path,
+                                               const QList<Models::Snapshot>& snapshots) const;
+
+    /**
+     * @brief 查询路径的所有已知版本，按快照时间从新到旧排列
+     */
+    QList<Models::FileVersion> versionsOf(const QString& path) const;
+
+    int indexedSnapshotCount() const { return m_indexedCount; }
+    int pathCount() const { return m_versions.size(); }
+
+private:
+    // 一个版本只保存快照编号，快照信息集中在 m_snapshots 中
+    struct Version {
+        int snapshot;
+        quint8 type;
+        qint64 size;
+        qint64 mtime;           // 毫秒时间戳，-1 表示无效
+    };
+
+    struct SnapshotRef {
+        Models::Snapshot snapshot;
+        bool indexed;           // 已完整收录
+        bool removed;
+    };
+
+    // restic find 的按路径结果
+    struct PathLookup {
+        QSet<int> searched;     // 已查询过的快照编号
+        QVector<Version> versions;
+    };
+
+    static QString snapshotKey(const Models::Snapshot& snapshot);
+    static Version makeVersion(int snapshot, Models::FileType type, qint64 size, const QDateTime& mtime);
+    int snapshotNumber(const Models::Snapshot& snapshot);
+    int findSnapshot(const QString& snapshotId) const;
+    Models::FileVersion toFileVersion(const Version& version) const;
+
+    QVector<SnapshotRef> m_snapshots;
+    QHash<QString, int> m_snapshotNumbers;          // 快照ID -> 编号
+    QHash<QString, QVector<Version>> m_versions;    // 路径 -> 完整收录的版本
+    QHash<QString, PathLookup> m_lookups;           // 路径 -> restic find 结果
+    int m_indexedCount;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // FILEHISTORYINDEX_H
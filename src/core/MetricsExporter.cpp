@@ -0,0 +1,166 @@
+#include "MetricsExporter.h"
+#include "../data/ConfigManager.h"
+#include "../utils/Metrics.h"
+#include "../utils/Logger.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+
+namespace ResticGUI {
+namespace Core {
+
+MetricsExporter* MetricsExporter::s_instance = nullptr;
+QMutex MetricsExporter::s_instanceMutex;
+
+MetricsExporter* MetricsExporter::instance()
+{
+    if (!s_instance) {
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new MetricsExporter();
+        }
+    }
+    return s_instance;
+}
+
+MetricsExporter::MetricsExporter(QObject* parent)
+    : QObject(parent)
+    , m_server(nullptr)
+    , m_textfileTimer(new QTimer(this))
+{
+    m_textfileTimer->setInterval(TextfileIntervalMs);
+    connect(m_textfileTimer, &QTimer::timeout, this, &MetricsExporter::writeTextfile);
+}
+
+MetricsExporter::~MetricsExporter()
+{
+}
+
+void MetricsExporter::initialize()
+{
+    Data::ConfigManager* config = Data::ConfigManager::instance();
+
+    // HTTP 端点
+    const bool httpEnabled = config->getMetricsHttpEnabled();
+    const quint16 port = static_cast<quint16>(config->getMetricsHttpPort());
+    if (m_server && (!httpEnabled || m_server->serverPort() != port)) {
+        m_server->close();
+        m_server->deleteLater();
+        m_server = nullptr;
+    }
+    if (httpEnabled && !m_server) {
+        m_server = new QTcpServer(this);
+        connect(m_server, &QTcpServer::newConnection, this, &MetricsExporter::onNewConnection);
+        if (m_server->listen(QHostAddress::LocalHost, port)) {
+            Utils::Logger::instance()->log(Utils::Logger::Info,
+                QString("指标端点已启动: http://127.0.0.1:%1/metrics").arg(port));
+        } else {
+            Utils::Logger::instance()->log(Utils::Logger::Error,
+                QString("无法监听指标端口 %1: %2").arg(port).arg(m_server->errorString()));
+            m_server->deleteLater();
+            m_server = nullptr;
+        }
+    }
+
+    // 文本文件
+    m_textfilePath = config->getMetricsTextfilePath();
+    if (m_textfilePath.isEmpty()) {
+        m_textfileTimer->stop();
+    } else {
+        QDir().mkpath(QFileInfo(m_textfilePath).absolutePath());
+        writeTextfile();
+        m_textfileTimer->start();
+    }
+}
+
+void MetricsExporter::writeTextfile()
+{
+    if (m_textfilePath.isEmpty()) {
+        return;
+    }
+
+    updateDerivedMetrics();
+
+    // QSaveFile 写临时文件后改名，collector 不会读到写了一半的文件
+    QSaveFile file(m_textfilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("无法写入指标文件 %1: %2").arg(m_textfilePath).arg(file.errorString()));
+        return;
+    }
+    file.write(Utils::MetricsRegistry::instance()->exposition());
+    if (!file.commit()) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("无法写入指标文件 %1: %2").arg(m_textfilePath).arg(file.errorString()));
+    }
+}
+
+void MetricsExporter::updateDerivedMetrics()
+{
+    Utils::MetricsRegistry* registry = Utils::MetricsRegistry::instance();
+
+    for (const QString& cache : {QString("snapshots"), QString("file_tree"), QString("repo_stats")}) {
+        const quint64 hits = registry->counter("resticgui_cache_requests_total", "缓存查询次数",
+                                               {{"cache", cache}, {"result", "hit"}})->value();
+        const quint64 misses = registry->counter("resticgui_cache_requests_total", "缓存查询次数",
+                                                 {{"cache", cache}, {"result", "miss"}})->value();
+        const quint64 total = hits + misses;
+        registry->gauge("resticgui_cache_hit_ratio", "自启动以来的缓存命中率", {{"cache", cache}})
+            ->set(total > 0 ? static_cast<double>(hits) / total : 0);
+    }
+
+    registry->gauge("resticgui_log_dropped_messages", "因日志队列已满而丢弃的日志条数")
+        ->set(static_cast<double>(Utils::Logger::instance()->droppedCount()));
+}
+
+void MetricsExporter::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { handleRequest(socket); });
+    }
+}
+
+void MetricsExporter::handleRequest(QTcpSocket* socket)
+{
+    // 只需要请求行，等到请求头结束再回应
+    const QByteArray request = socket->peek(MaxRequestBytes);
+    if (!request.contains("\r\n\r\n") && request.size() < MaxRequestBytes) {
+        return;
+    }
+    socket->readAll();
+
+    const QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    const QByteArray method = requestLine.value(0);
+    const QByteArray path = requestLine.value(1);
+
+    QByteArray status;
+    QByteArray contentType = "text/plain; charset=utf-8";
+    QByteArray body;
+    if (method != "GET") {
+        status = "405 Method Not Allowed";
+        body = "method not allowed\n";
+    } else if (path == "/metrics" || path.startsWith("/metrics?")) {
+        updateDerivedMetrics();
+        status = "200 OK";
+        contentType = "text/plain; version=0.0.4; charset=utf-8";
+        body = Utils::MetricsRegistry::instance()->exposition();
+    } else {
+        status = "404 Not Found";
+        body = "not found\n";
+    }
+
+    QByteArray response = "HTTP/1.1 " + status + "\r\n"
+                          "Content-Type: " + contentType + "\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+} // namespace Core
+} // namespace ResticGUI
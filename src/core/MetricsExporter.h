@@ -0,0 +1,71 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QTimer>
+
+class QTcpServer;
+class QTcpSocket;
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief 指标输出（单例）
+ *
+ * 把 Utils::MetricsRegistry 中的指标提供给外部监控，两种方式可以同时启用：
+ * - 本地 HTTP 端点：只监听 127.0.0.1，GET /metrics 返回 Prometheus 文本格式；
+ * - 文本文件：定时原子地写入一个 .prom 文件，供 node_exporter 的
+ *   textfile collector 读取。
+ *
+ * 所有方法须在主线程调用。
+ */
+class MetricsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static MetricsExporter* instance();
+
+    /**
+     * @brief 按配置启动输出，设置修改后再次调用即可生效
+     */
+    void initialize();
+
+    /**
+     * @brief 立即写一次文本文件（程序退出时调用）
+     */
+    void writeTextfile();
+
+    /**
+     * @brief 采集时才计算的指标（例如缓存命中率）
+     */
+    static void updateDerivedMetrics();
+
+    static constexpr int TextfileIntervalMs = 15000;
+    static constexpr int MaxRequestBytes = 8192;
+
+private slots:
+    void onNewConnection();
+
+private:
+    explicit MetricsExporter(QObject* parent = nullptr);
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    void handleRequest(QTcpSocket* socket);
+
+    static MetricsExporter* s_instance;
+    static QMutex s_instanceMutex;
+
+    QTcpServer* m_server;
+    QTimer* m_textfileTimer;
+    QString m_textfilePath;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // METRICSEXPORTER_H
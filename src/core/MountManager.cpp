@@ -0,0 +1,380 @@
+#include "MountManager.h"
+#include "ResticWrapper.h"
+#include "RepositoryManager.h"
+#include "../data/PasswordManager.h"
+#include "../utils/Logger.h"
+#include <QMutexLocker>
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+#ifdef Q_OS_MACOS
+#include <sys/param.h>
+#include <sys/mount.h>
+#endif
+
+namespace ResticGUI {
+namespace Core {
+
+MountManager* MountManager::s_instance = nullptr;
+QMutex MountManager::s_instanceMutex;
+
+MountManager* MountManager::instance()
+{
+    if (!s_instance) {
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new MountManager();
+        }
+    }
+    return s_instance;
+}
+
+MountManager::MountManager(QObject* parent)
+    : QObject(parent)
+    , m_healthTimer(new QTimer(this))
+    , m_nextId(1)
+{
+    m_healthTimer->setInterval(HealthCheckIntervalMs);
+    connect(m_healthTimer, &QTimer::timeout, this, &MountManager::onHealthCheck);
+}
+
+MountManager::~MountManager()
+{
+    unmountAll();
+}
+
+void MountManager::initialize()
+{
+    // 程序退出时卸载，避免留下无进程服务的挂载点
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &MountManager::unmountAll);
+
+    Utils::Logger::instance()->log(Utils::Logger::Info, "挂载管理器初始化完成");
+}
+
+// ========== 挂载与卸载 ==========
+
+int MountManager::mount(int repoId, const QString& mountPoint)
+{
+    const int existing = findSession(repoId);
+    if (existing >= 0) {
+        return existing;
+    }
+
+    const QString path = QDir::cleanPath(QFileInfo(mountPoint).absoluteFilePath());
+    for (const Session& session : m_sessions) {
+        if (session.info.isActive() && session.info.mountPoint == path) {
+            Utils::Logger::instance()->log(Utils::Logger::Warning,
+                QString("挂载点已被使用: %1").arg(path));
+            return -1;
+        }
+    }
+
+    if (isMountPoint(path)) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("挂载点上已有其他文件系统: %1").arg(path));
+        return -1;
+    }
+
+    QDir().mkpath(path);
+
+    Models::Repository repo = RepositoryManager::instance()->getRepository(repoId);
+    QString password;
+    if (repo.id < 0 || !Data::PasswordManager::instance()->getPassword(repoId, password)) {
+        return -1;
+    }
+
+    const int sessionId = m_nextId++;
+    ResticWrapper* wrapper = new ResticWrapper(this);
+
+    connect(wrapper, &ResticWrapper::standardOutput, this, [this, sessionId](const QString& output) {
+        onOutput(sessionId, output);
+    });
+    connect(wrapper, &ResticWrapper::commandFinished, this, [this, sessionId](int exitCode, const QString&) {
+        onProcessFinished(sessionId, exitCode);
+    });
+
+    if (!wrapper->startMount(repo, password, path)) {
+        wrapper->deleteLater();
+        return -1;
+    }
+
+    Session session;
+    session.info.id = sessionId;
+    session.info.repositoryId = repoId;
+    session.info.mountPoint = path;
+    session.info.state = Models::MountState::Starting;
+    session.info.startedAt = QDateTime::currentDateTime();
+    session.wrapper = wrapper;
+    session.stateTimer.start();
+    m_sessions.insert(sessionId, session);
+
+    if (!m_healthTimer->isActive()) {
+        m_healthTimer->start();
+    }
+    return sessionId;
+}
+
+bool MountManager::unmount(int sessionId)
+{
+    auto it = m_sessions.find(sessionId);
+    if (it == m_sessions.end() || !it->info.isActive()) {
+        return false;
+    }
+
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("卸载: %1").arg(it->info.mountPoint));
+
+    it->info.state = Models::MountState::Unmounting;
+    it->stateTimer.restart();
+
+    // 卸载后 restic mount 自行退出；进程没有退出时由健康检查终止
+    if (!ResticWrapper::umount(it->info.mountPoint)) {
+        it->wrapper->terminate();
+    }
+    return true;
+}
+
+bool MountManager::unmountPath(const QString& mountPoint)
+{
+    const QString path = QDir::cleanPath(QFileInfo(mountPoint).absoluteFilePath());
+    for (const Session& session : m_sessions) {
+        if (session.info.isActive() && session.info.mountPoint == path) {
+            return unmount(session.info.id);
+        }
+    }
+
+    // 不是本程序管理的挂载点，直接卸载
+    return ResticWrapper::umount(path);
+}
+
+void MountManager::unmountAll()
+{
+    const QList<int> ids = m_sessions.keys();
+    for (int id : ids) {
+        auto it = m_sessions.find(id);
+        if (it == m_sessions.end()) {
+            continue;
+        }
+
+        // 退出时不再等待事件循环：卸载（忙时延迟卸载），然后结束进程
+        ResticWrapper* wrapper = it->wrapper;
+        const QString mountPoint = it->info.mountPoint;
+        m_sessions.erase(it);
+
+        wrapper->disconnect(this);
+        if (wrapper->isProcessRunning()) {
+            if (!ResticWrapper::umount(mountPoint)) {
+                ResticWrapper::umount(mountPoint, true);
+            }
+            wrapper->terminate();
+        }
+        delete wrapper;     // 析构时仍未退出的进程会被强制结束
+
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("已卸载: %1").arg(mountPoint));
+    }
+
+    m_healthTimer->stop();
+}
+
+// ========== 会话查询 ==========
+
+QList<Models::MountSession> MountManager::sessions() const
+{
+    QList<Models::MountSession> result;
+    for (const Session& session : m_sessions) {
+        result.append(session.info);
+    }
+    return result;
+}
+
+Models::MountSession MountManager::session(int sessionId) const
+{
+    auto it = m_sessions.constFind(sessionId);
+    return it == m_sessions.constEnd() ? Models::MountSession() : it->info;
+}
+
+int MountManager::findSession(int repoId) const
+{
+    for (const Session& session : m_sessions) {
+        if (session.info.repositoryId == repoId && session.info.isActive()) {
+            return session.info.id;
+        }
+    }
+    return -1;
+}
+
+// ========== 进程状态 ==========
+
+void MountManager::onOutput(int sessionId, const QString& output)
+{
+    auto it = m_sessions.find(sessionId);
+    if (it != m_sessions.end() && it->info.state == Models::MountState::Starting
+        && output.contains("Now serving the repository")) {
+        setMounted(sessionId);
+    }
+}
+
+void MountManager::onProcessFinished(int sessionId, int exitCode)
+{
+    auto it = m_sessions.find(sessionId);
+    if (it == m_sessions.end()) {
+        return;
+    }
+
+    const Models::MountState state = it->info.state;
+    const QString mountPoint = it->info.mountPoint;
+    const QString errorOutput = it->info.lastError.isEmpty()
+        ? it->wrapper->lastErrorOutput() : it->info.lastError;
+    it->wrapper->deleteLater();
+    m_sessions.erase(it);
+
+    if (state == Models::MountState::Unmounting) {
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("已卸载: %1").arg(mountPoint));
+        emit mountStopped(sessionId);
+    } else {
+        // 进程意外退出时挂载点可能残留，清理掉
+        if (isMountPoint(mountPoint)) {
+            ResticWrapper::umount(mountPoint, true);
+        }
+
+        QString error = errorOutput.isEmpty()
+            ? QString("restic mount 意外退出，退出码: %1").arg(exitCode)
+            : errorOutput;
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("挂载 %1 失败: %2").arg(mountPoint).arg(error));
+        emit mountFailed(sessionId, error);
+    }
+
+    if (m_sessions.isEmpty()) {
+        m_healthTimer->stop();
+    }
+}
+
+void MountManager::setMounted(int sessionId)
+{
+    auto it = m_sessions.find(sessionId);
+    it->info.state = Models::MountState::Mounted;
+    it->stateTimer.restart();
+
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("仓库已挂载到: %1").arg(it->info.mountPoint));
+    emit mountReady(sessionId);
+}
+
+void MountManager::fail(int sessionId, const QString& error)
+{
+    auto it = m_sessions.find(sessionId);
+    it->info.state = Models::MountState::Failed;
+    it->info.lastError = error;
+    it->stateTimer.restart();
+
+    // 进程退出后在 onProcessFinished 中移除会话并发出 mountFailed
+    ResticWrapper::umount(it->info.mountPoint, true);
+    it->wrapper->terminate();
+}
+
+void MountManager::onHealthCheck()
+{
+    const QList<int> ids = m_sessions.keys();
+    for (int id : ids) {
+        auto it = m_sessions.find(id);
+        if (it == m_sessions.end()) {
+            continue;
+        }
+
+        switch (it->info.state) {
+        case Models::MountState::Starting:
+            // 输出可能被缓冲，挂载表中出现挂载点同样视为就绪
+            if (isMountPoint(it->info.mountPoint)) {
+                setMounted(id);
+            } else if (it->stateTimer.elapsed() > ReadyTimeoutMs) {
+                fail(id, "等待挂载就绪超时");
+            }
+            break;
+
+        case Models::MountState::Mounted:
+            if (!isMountPoint(it->info.mountPoint)) {
+                // 挂载点被外部卸载，restic mount 随后会退出
+                Utils::Logger::instance()->log(Utils::Logger::Warning,
+                    QString("挂载点已失效: %1").arg(it->info.mountPoint));
+                it->info.state = Models::MountState::Unmounting;
+                it->stateTimer.restart();
+                it->wrapper->terminate();
+            }
+            break;
+
+        case Models::MountState::Unmounting:
+        case Models::MountState::Failed:
+            // 进程迟迟不退出：先 SIGTERM，再强制结束
+            if (it->stateTimer.elapsed() > StopTimeoutMs * 2) {
+                it->wrapper->cancel();
+            } else if (it->stateTimer.elapsed() > StopTimeoutMs) {
+                it->wrapper->terminate();
+            }
+            break;
+
+        case Models::MountState::Stopped:
+            break;
+        }
+    }
+}
+
+bool MountManager::isMountPoint(const QString& path)
+{
+    // 只读取系统挂载表，不访问挂载点本身，挂载失效时也不会阻塞。
+    // QStorageInfo::mountedVolumes() 会过滤掉设备名不以 / 开头的 FUSE 挂载，不能使用
+#if defined(Q_OS_LINUX)
+    QFile mounts("/proc/self/mounts");
+    if (!mounts.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    for (;;) {
+        const QByteArray line = mounts.readLine();
+        if (line.isEmpty()) {
+            break;
+        }
+
+        // 第二列为挂载点，空格等字符以 \ooo 八进制转义
+        const QList<QByteArray> fields = line.split(' ');
+        if (fields.size() < 2) {
+            continue;
+        }
+        const QByteArray& escaped = fields.at(1);
+        QByteArray decoded;
+        decoded.reserve(escaped.size());
+        for (int i = 0; i < escaped.size(); ++i) {
+            if (escaped.at(i) == '\\' && i + 3 < escaped.size()) {
+                decoded += static_cast<char>(escaped.mid(i + 1, 3).toInt(nullptr, 8));
+                i += 3;
+            } else {
+                decoded += escaped.at(i);
+            }
+        }
+
+        if (QDir::cleanPath(QString::fromLocal8Bit(decoded)) == path) {
+            return true;
+        }
+    }
+    return false;
+#elif defined(Q_OS_MACOS)
+    struct statfs* mounts = nullptr;
+    const int count = getmntinfo(&mounts, MNT_NOWAIT);
+    for (int i = 0; i < count; ++i) {
+        if (QDir::cleanPath(QString::fromLocal8Bit(mounts[i].f_mntonname)) == path) {
+            return true;
+        }
+    }
+    return false;
+#else
+    Q_UNUSED(path);
+    return false;
+#endif
+}
+
+} // namespace Core
+} // namespace ResticGUI
@@ -0,0 +1,104 @@
+#ifndef MOUNTMANAGER_H
+#define MOUNTMANAGER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QMap>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "../models/MountSession.h"
+
+namespace ResticGUI {
+namespace Core {
+
+class ResticWrapper;
+
+/**
+ * @brief 挂载会话管理器（仅Linux/macOS）
+ *
+ * 每个挂载是一个长期运行的 restic mount 进程：
+ * - 启动后根据输出和系统挂载表判断是否就绪，超时视为失败
+ * - 定时检查进程和挂载点，挂载失效时清理
+ * - 卸载时先 fusermount -u，进程未退出再终止
+ * - 程序退出时卸载所有挂载点
+ *
+ * 所有方法须在主线程调用。
+ */
+class MountManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    static MountManager* instance();
+    void initialize();
+
+    /**
+     * @brief 挂载仓库，同一仓库已挂载时直接返回已有会话
+     * @return 会话ID，失败返回 -1
+     */
+    int mount(int repoId, const QString& mountPoint);
+
+    /**
+     * @brief 卸载会话，卸载完成时发出 mountStopped
+     */
+    bool unmount(int sessionId);
+    bool unmountPath(const QString& mountPoint);
+
+    /**
+     * @brief 同步卸载所有挂载点（程序退出时调用）
+     */
+    void unmountAll();
+
+    QList<Models::MountSession> sessions() const;
+    Models::MountSession session(int sessionId) const;
+
+    /**
+     * @brief 查找仓库的活动会话，没有返回 -1
+     */
+    int findSession(int repoId) const;
+
+    // 等待挂载就绪的最长时间
+    static constexpr int ReadyTimeoutMs = 30000;
+    // 健康检查间隔
+    static constexpr int HealthCheckIntervalMs = 5000;
+    // 卸载后等待进程退出的时间，超时后终止进程
+    static constexpr int StopTimeoutMs = 10000;
+
+signals:
+    void mountReady(int sessionId);
+    void mountFailed(int sessionId, const QString& error);
+    void mountStopped(int sessionId);
+
+private slots:
+    void onHealthCheck();
+
+private:
+    explicit MountManager(QObject* parent = nullptr);
+    ~MountManager();
+    MountManager(const MountManager&) = delete;
+    MountManager& operator=(const MountManager&) = delete;
+
+    struct Session {
+        Models::MountSession info;
+        ResticWrapper* wrapper;
+        QElapsedTimer stateTimer;   // 进入当前状态后的时间
+    };
+
+    void onOutput(int sessionId, const QString& output);
+    void onProcessFinished(int sessionId, int exitCode);
+    void setMounted(int sessionId);
+    void fail(int sessionId, const QString& error);
+    static bool isMountPoint(const QString& path);
+
+    static MountManager* s_instance;
+    static QMutex s_instanceMutex;
+
+    QMap<int, Session> m_sessions;
+    QTimer* m_healthTimer;
+    int m_nextId;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // MOUNTMANAGER_H
@@ -0,0 +1,183 @@
+#include "PrunePlanner.h"
+#include "ResticWrapper.h"
+#include "../data/DatabaseManager.h"
+#include "../data/CacheManager.h"
+#include "../utils/Logger.h"
+#include <QDateTime>
+
+namespace ResticGUI {
+namespace Core {
+
+namespace {
+constexpr double BytesPerGiB = 1024.0 * 1024 * 1024;
+}
+
+PrunePlan PrunePlanner::plan(const Models::Repository& repo, const QString& password,
+                             const Models::PruneOptions& keepPolicy, const PrunePolicy& policy)
+{
+    PrunePlan result;
+    result.options = keepPolicy;
+    result.options.maxUnused.clear();
+    result.options.maxRepackSize = 0;
+    result.options.repackCacheableOnly = false;
+    result.bytesPerSecond = policy.bytesPerSecond > 0 ? policy.bytesPerSecond : historicalThroughput(repo.id);
+
+    ResticWrapper wrapper;
+
+    // 1. restic 默认参数
+    if (!wrapper.estimatePrune(repo, password, result.options, result.estimate)) {
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("仓库 %1 的维护试运行失败").arg(repo.name));
+        return result;
+    }
+    result.valid = true;
+    applyCostModel(result, policy);
+
+    if (result.withinBudget) {
+        result.rationale = policy.hasBudget() ? QString("默认参数在预算内") : QString("未设置预算，使用默认参数");
+        return result;
+    }
+
+    const PrunePlan defaultPlan = result;
+
+    // 2. 限制重新打包的数据量
+    const qint64 allowance = repackAllowance(defaultPlan.estimate, policy, result.bytesPerSecond);
+    if (allowance >= MinRepackAllowance) {
+        PrunePlan limited = defaultPlan;
+        limited.options.maxRepackSize = allowance;
+        if (wrapper.estimatePrune(repo, password, limited.options, limited.estimate)) {
+            applyCostModel(limited, policy);
+            if (limited.withinBudget) {
+                limited.rationale = QString("默认参数需要重新打包 %1 字节，超出预算，限制为 %2 字节")
+                                        .arg(defaultPlan.estimate.repackBytes).arg(allowance);
+                return limited;
+            }
+        }
+    }
+
+    // 3. 只删除完全未使用的数据包，重新打包可缓存的元数据
+    PrunePlan minimal = defaultPlan;
+    minimal.options.maxUnused = "unlimited";
+    minimal.options.repackCacheableOnly = true;
+    if (!wrapper.estimatePrune(repo, password, minimal.options, minimal.estimate)) {
+        return defaultPlan;
+    }
+    applyCostModel(minimal, policy);
+    minimal.rationale = minimal.withinBudget
+        ? QString("预算不足以重新打包数据，只删除完全未使用的数据包")
+        : QString("即使只删除未使用的数据包也超出预算");
+
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("仓库 %1 维护计划: %2（%3）")
+            .arg(repo.name).arg(describeOptions(minimal.options)).arg(minimal.rationale));
+    return minimal;
+}
+
+bool PrunePlanner::execute(const Models::Repository& repo, const QString& password, const PrunePlan& plan)
+{
+    Models::PruneRecord record;
+    record.repositoryId = repo.id;
+    record.options = plan.options;
+    record.startTime = QDateTime::currentDateTime();
+
+    ResticWrapper wrapper;
+    record.success = wrapper.prune(repo, password, plan.options, &record.stats);
+    record.endTime = QDateTime::currentDateTime();
+
+    if (!record.success) {
+        record.errorMessage = wrapper.lastErrorOutput();
+    } else if (!record.stats.valid) {
+        // --json 输出中可能没有 prune 统计，按试运行的估算记录
+        const int removedSnapshots = record.stats.removedSnapshots;
+        record.stats = plan.estimate;
+        record.stats.removedSnapshots = qMax(removedSnapshots, plan.estimate.removedSnapshots);
+    }
+
+    Data::DatabaseManager::instance()->insertPruneRecord(record);
+
+    if (record.success) {
+        Data::CacheManager::instance()->clearRepoStatsCache(repo.id);
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("仓库 %1 维护完成，用时 %2 秒，释放 %3 字节")
+                .arg(repo.name).arg(record.durationSecs()).arg(record.stats.reclaimedBytes));
+    }
+
+    return record.success;
+}
+
+void PrunePlanner::applyCostModel(PrunePlan& plan, const PrunePolicy& policy)
+{
+    const Models::PruneStats& stats = plan.estimate;
+
+    plan.estimatedSeconds = plan.bytesPerSecond > 0
+        ? static_cast<qint64>(stats.transferBytes() / plan.bytesPerSecond) : 0;
+    plan.estimatedCost = stats.downloadBytes() / BytesPerGiB * policy.egressCostPerGiB;
+
+    plan.withinBudget = true;
+    if (policy.timeBudgetMinutes > 0 && plan.estimatedSeconds > policy.timeBudgetMinutes * 60LL) {
+        plan.withinBudget = false;
+    }
+    if (policy.costBudget > 0 && plan.estimatedCost > policy.costBudget) {
+        plan.withinBudget = false;
+    }
+}
+
+qint64 PrunePlanner::repackAllowance(const Models::PruneStats& estimate, const PrunePolicy& policy,
+                                     double bytesPerSecond)
+{
+    if (estimate.repackBytes <= 0) {
+        return 0;
+    }
+
+    // 每重新打包 1 字节需要下载的量和总传输量（下载整个包，上传保留的部分）
+    const double downloadRatio = static_cast<double>(estimate.downloadBytes()) / estimate.repackBytes;
+    const double transferRatio = static_cast<double>(estimate.transferBytes()) / estimate.repackBytes;
+
+    qint64 allowance = 0;
+    if (policy.timeBudgetMinutes > 0 && bytesPerSecond > 0) {
+        allowance = static_cast<qint64>(bytesPerSecond * policy.timeBudgetMinutes * 60 / transferRatio);
+    }
+    if (policy.costBudget > 0 && policy.egressCostPerGiB > 0) {
+        const qint64 byCost = static_cast<qint64>(policy.costBudget / policy.egressCostPerGiB * BytesPerGiB
+                                                  / downloadRatio);
+        allowance = allowance > 0 ? qMin(allowance, byCost) : byCost;
+    }
+    return allowance;
+}
+
+double PrunePlanner::historicalThroughput(int repoId)
+{
+    const QList<Models::PruneRecord> records = Data::DatabaseManager::instance()->getPruneHistory(repoId);
+
+    qint64 bytes = 0;
+    qint64 seconds = 0;
+    int used = 0;
+    for (const Models::PruneRecord& record : records) {
+        if (!record.success || record.stats.transferBytes() < MinHistoryBytes || record.durationSecs() <= 0) {
+            continue;
+        }
+        bytes += record.stats.transferBytes();
+        seconds += record.durationSecs();
+        if (++used >= MaxHistoryEntries) {
+            break;
+        }
+    }
+
+    return seconds > 0 ? static_cast<double>(bytes) / seconds : DefaultBytesPerSecond;
+}
+
+QString PrunePlanner::describeOptions(const Models::PruneOptions& options)
+{
+    QStringList parts;
+    parts << QString("--max-unused %1").arg(options.maxUnused.isEmpty() ? QString("5%") : options.maxUnused);
+    if (options.maxRepackSize > 0) {
+        parts << QString("--max-repack-size %1 MiB").arg(options.maxRepackSize / (1024 * 1024));
+    }
+    if (options.repackCacheableOnly) {
+        parts << "--repack-cacheable-only";
+    }
+    return parts.join(' ');
+}
+
+} // namespace Core
+} // namespace ResticGUI
@@ -0,0 +1,99 @@
+#ifndef PRUNEPLANNER_H
+#define PRUNEPLANNER_H
+
+#include <QString>
+#include <QStringList>
+#include "../models/Repository.h"
+#include "../models/PruneRecord.h"
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief 维护的时间和费用预算
+ */
+struct PrunePolicy
+{
+    int timeBudgetMinutes = 0;      // 0 表示不限
+    double costBudget = 0;          // 每次维护的费用上限，0 表示不限
+    double egressCostPerGiB = 0;    // 存储服务每 GiB 下载（出站流量）费用
+    double bytesPerSecond = 0;      // 传输吞吐量，0 表示按历史记录估算
+
+    bool hasBudget() const {
+        return timeBudgetMinutes > 0 || (costBudget > 0 && egressCostPerGiB > 0);
+    }
+};
+
+/**
+ * @brief 维护计划：选定的参数和按该参数试运行得到的估算
+ */
+struct PrunePlan
+{
+    bool valid = false;
+    Models::PruneOptions options;
+    Models::PruneStats estimate;
+    double bytesPerSecond = 0;
+    qint64 estimatedSeconds = 0;
+    double estimatedCost = 0;
+    bool withinBudget = true;
+    QString rationale;              // 选择这组参数的原因，显示给用户
+};
+
+/**
+ * @brief 维护规划器
+ *
+ * 重新打包部分使用的数据包要下载整个包并上传保留的部分，在对象存储上
+ * 既产生出站流量费用又耗时。规划器先按 restic 默认参数试运行，估算
+ * 传输量、耗时和费用；超出预算时依次尝试：
+ *   1. 用 --max-repack-size 把重新打包的量限制在预算内；
+ *   2. --max-unused unlimited --repack-cacheable-only，只删除完全未使用的
+ *      数据包并重新打包元数据，未使用的数据留给以后的维护。
+ * 每次维护实际释放的空间记录在维护历史中，吞吐量也由历史记录推算。
+ *
+ * plan() 和 execute() 是阻塞调用，应在工作线程中执行。
+ */
+class PrunePlanner
+{
+public:
+    PrunePlan plan(const Models::Repository& repo, const QString& password,
+                   const Models::PruneOptions& keepPolicy, const PrunePolicy& policy);
+
+    /**
+     * @brief 按计划执行维护并写入维护历史
+     */
+    bool execute(const Models::Repository& repo, const QString& password, const PrunePlan& plan);
+
+    /**
+     * @brief 按吞吐量和下载费用计算计划的耗时、费用以及是否在预算内
+     */
+    static void applyCostModel(PrunePlan& plan, const PrunePolicy& policy);
+
+    /**
+     * @brief 预算允许重新打包的数据量，不限时返回 0
+     * @param estimate 默认参数下的估算，用于换算下载、上传与重新打包量的比例
+     */
+    static qint64 repackAllowance(const Models::PruneStats& estimate, const PrunePolicy& policy,
+                                  double bytesPerSecond);
+
+    /**
+     * @brief 最近几次成功维护的平均传输吞吐量（字节/秒），没有记录返回默认值
+     */
+    static double historicalThroughput(int repoId);
+
+    /**
+     * @brief 参数的简短描述，用于日志和确认对话框
+     */
+    static QString describeOptions(const Models::PruneOptions& options);
+
+    // 参与吞吐量统计的最少传输量，太小的维护主要是读取索引的开销
+    static constexpr qint64 MinHistoryBytes = Q_INT64_C(64) * 1024 * 1024;
+    static constexpr int MaxHistoryEntries = 10;
+    static constexpr double DefaultBytesPerSecond = 10.0 * 1024 * 1024;
+    // 小于一个数据包的重新打包上限没有意义，此时直接改为只删除未使用的包
+    static constexpr qint64 MinRepackAllowance = Q_INT64_C(16) * 1024 * 1024;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // PRUNEPLANNER_H
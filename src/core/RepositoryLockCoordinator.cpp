@@ -0,0 +1,248 @@
+#include "RepositoryLockCoordinator.h"
+#include "ResticWrapper.h"
+#include "../utils/Logger.h"
+#include "../utils/Metrics.h"
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QSysInfo>
+#include <QDateTime>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <signal.h>
+#include <errno.h>
+#endif
+
+namespace ResticGUI {
+namespace Core {
+
+RepositoryLockCoordinator* RepositoryLockCoordinator::s_instance = nullptr;
+QMutex RepositoryLockCoordinator::s_instanceMutex;
+
+RepositoryLockCoordinator* RepositoryLockCoordinator::instance()
+{
+    if (!s_instance) {
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new RepositoryLockCoordinator();
+        }
+    }
+    return s_instance;
+}
+
+RepositoryLockCoordinator::RepositoryLockCoordinator()
+{
+}
+
+RepositoryLockMode RepositoryLockCoordinator::lockModeFor(const QStringList& args)
+{
+    if (args.contains("--no-lock")) {
+        return RepositoryLockMode::None;
+    }
+
+    QString command;
+    for (const QString& arg : args) {
+        if (!arg.startsWith('-')) {
+            command = arg;
+            break;
+        }
+    }
+
+    static const QStringList unlocked = {
+        "init", "version", "help", "unlock", "cache", "generate", "self-update", "completion"
+    };
+    static const QStringList exclusive = {
+        "prune", "forget", "check", "repair", "rebuild-index", "migrate", "rewrite", "tag"
+    };
+
+    if (command.isEmpty() || unlocked.contains(command)) {
+        return RepositoryLockMode::None;
+    }
+    if (exclusive.contains(command)) {
+        // 试运行只读取仓库
+        if ((command == "forget" || command == "prune") && args.contains("--dry-run")) {
+            return RepositoryLockMode::Shared;
+        }
+        return RepositoryLockMode::Exclusive;
+    }
+    return RepositoryLockMode::Shared;
+}
+
+bool RepositoryLockCoordinator::canEnter(int repoId, RepositoryLockMode mode) const
+{
+    const RepoState state = m_states.value(repoId);
+    if (mode == RepositoryLockMode::Exclusive) {
+        return !state.writer && state.readers == 0;
+    }
+    // 有独占任务排队时共享任务也排队
+    return !state.writer && state.waitingWriters == 0;
+}
+
+bool RepositoryLockCoordinator::acquire(int repoId, RepositoryLockMode mode, const QString& job, int timeoutMs,
+                                        const std::function<bool()>& cancelled)
+{
+    if (mode == RepositoryLockMode::None || repoId < 0) {
+        return true;
+    }
+
+    const bool exclusive = mode == RepositoryLockMode::Exclusive;
+    QMutexLocker locker(&m_mutex);
+
+    if (!canEnter(repoId, mode)) {
+        if (timeoutMs == 0) {
+            Utils::Logger::instance()->log(Utils::Logger::Warning,
+                QString("仓库 %1 正在执行 %2，%3 未能执行")
+                    .arg(repoId).arg(m_states.value(repoId).jobs.join(", ")).arg(job));
+            return false;
+        }
+
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("%1 等待仓库 %2 上的 %3 完成")
+                .arg(job).arg(repoId).arg(m_states.value(repoId).jobs.join(", ")));
+
+        if (exclusive) {
+            m_states[repoId].waitingWriters++;
+        }
+
+        static Utils::Gauge* const waiting = Utils::MetricsRegistry::instance()->gauge(
+            "resticgui_repository_lock_queue_depth", "等待仓库锁的任务数");
+        waiting->inc();
+
+        QElapsedTimer timer;
+        timer.start();
+        while (!canEnter(repoId, mode)) {
+            const bool timedOut = timeoutMs > 0 && timer.elapsed() >= timeoutMs;
+            if (timedOut || (cancelled && cancelled())) {
+                if (exclusive) {
+                    m_states[repoId].waitingWriters--;
+                    m_changed.wakeAll();    // 排在它后面的共享任务可以继续
+                }
+                waiting->dec();
+                Utils::Logger::instance()->log(Utils::Logger::Warning,
+                    QString("%1 放弃等待仓库 %2").arg(job).arg(repoId));
+                return false;
+            }
+            m_changed.wait(&m_mutex, WaitSliceMs);
+        }
+
+        if (exclusive) {
+            m_states[repoId].waitingWriters--;
+        }
+        waiting->dec();
+        Utils::Logger::instance()->log(Utils::Logger::Debug,
+            QString("%1 等待 %2 ms 后获得仓库 %3").arg(job).arg(timer.elapsed()).arg(repoId));
+    }
+
+    RepoState& state = m_states[repoId];
+    if (exclusive) {
+        state.writer = true;
+    } else {
+        state.readers++;
+    }
+    state.jobs.append(job);
+    return true;
+}
+
+void RepositoryLockCoordinator::release(int repoId, RepositoryLockMode mode, const QString& job)
+{
+    if (mode == RepositoryLockMode::None || repoId < 0) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_states.find(repoId);
+    if (it == m_states.end()) {
+        return;
+    }
+
+    if (mode == RepositoryLockMode::Exclusive) {
+        it->writer = false;
+    } else if (it->readers > 0) {
+        it->readers--;
+    }
+    it->jobs.removeOne(job);
+
+    if (!it->writer && it->readers == 0 && it->waitingWriters == 0) {
+        m_states.erase(it);
+    }
+    m_changed.wakeAll();
+}
+
+QStringList RepositoryLockCoordinator::activeJobs(int repoId) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_states.value(repoId).jobs;
+}
+
+bool RepositoryLockCoordinator::clearStaleLocks(const Models::Repository& repo, const QString& password)
+{
+    ResticWrapper wrapper;
+    QList<Models::RepositoryLock> locks;
+    if (!wrapper.listLocks(repo, password, locks)) {
+        return false;
+    }
+
+    if (locks.isEmpty()) {
+        // 锁已被其持有者释放
+        return true;
+    }
+
+    int staleCount = 0;
+    for (const Models::RepositoryLock& lock : locks) {
+        if (isStale(lock)) {
+            staleCount++;
+        } else {
+            Utils::Logger::instance()->log(Utils::Logger::Info,
+                QString("仓库 %1 被 %2@%3（PID %4）%5锁定，锁仍然有效")
+                    .arg(repo.name).arg(lock.username).arg(lock.hostname).arg(lock.pid)
+                    .arg(lock.exclusive ? "独占" : "共享"));
+        }
+    }
+
+    if (staleCount == 0) {
+        return false;
+    }
+
+    Utils::Logger::instance()->log(Utils::Logger::Warning,
+        QString("清除仓库 %1 中 %2 个失效的锁").arg(repo.name).arg(staleCount));
+
+    if (!wrapper.unlockRepository(repo, password)) {
+        return false;
+    }
+    return staleCount == locks.size();
+}
+
+bool RepositoryLockCoordinator::isLockConflict(const QString& errorOutput)
+{
+    return errorOutput.contains("repository is already locked")
+        || errorOutput.contains("unable to create lock");
+}
+
+bool RepositoryLockCoordinator::isStale(const Models::RepositoryLock& lock)
+{
+    if (lock.hostname == QSysInfo::machineHostName() && lock.pid > 0 && !isProcessAlive(lock.pid)) {
+        return true;
+    }
+    return lock.time.isValid() && lock.time.secsTo(QDateTime::currentDateTimeUtc()) > StaleLockAgeSecs;
+}
+
+bool RepositoryLockCoordinator::isProcessAlive(qint64 pid)
+{
+#ifdef Q_OS_WIN
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (!process) {
+        return GetLastError() == ERROR_ACCESS_DENIED;
+    }
+    DWORD exitCode = 0;
+    const bool alive = GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE;
+    CloseHandle(process);
+    return alive;
+#else
+    // 信号 0 只检查进程是否存在；EPERM 表示进程存在但属于其他用户
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+} // namespace Core
+} // namespace ResticGUI
@@ -0,0 +1,119 @@
+#ifndef REPOSITORYLOCKCOORDINATOR_H
+#define REPOSITORYLOCKCOORDINATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <functional>
+#include "../models/Repository.h"
+#include "../models/RepositoryLock.h"
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief restic 命令对仓库加锁的方式
+ */
+enum class RepositoryLockMode
+{
+    None,           // 不加锁：init、unlock、version、带 --no-lock 的命令等
+    Shared,         // 共享锁：backup、restore、ls、snapshots 等
+    Exclusive       // 独占锁：prune、forget、check、repair 等
+};
+
+/**
+ * @brief 仓库锁协调器（单例模式）
+ *
+ * 在应用内为每个仓库维护一个读写锁，与 restic 在仓库中的锁语义一致：
+ * 共享任务可以并发，独占任务与其他任何任务互斥。冲突的任务排队等待，
+ * 而不是启动 restic 后因仓库已被锁定而失败。有独占任务排队时，新的
+ * 共享任务排在它之后，避免独占任务被持续的备份饿死。
+ *
+ * 应用外的进程（其他机器、崩溃后遗留的锁）仍可能挡住命令，这时由
+ * clearStaleLocks() 检查仓库中的锁，确认都已失效后清除。
+ */
+class RepositoryLockCoordinator
+{
+public:
+    static RepositoryLockCoordinator* instance();
+
+    /**
+     * @brief 按 restic 命令参数判断加锁方式
+     */
+    static RepositoryLockMode lockModeFor(const QStringList& args);
+
+    /**
+     * @brief 获取仓库锁，冲突时排队等待
+     * @param repoId 仓库ID
+     * @param mode 加锁方式，None 时直接返回
+     * @param job 任务描述，用于日志
+     * @param timeoutMs 最长等待时间，-1 表示一直等待，0 表示不等待
+     * @param cancelled 等待期间定期调用，返回 true 时放弃等待
+     * @return 获得锁返回true
+     */
+    bool acquire(int repoId, RepositoryLockMode mode, const QString& job, int timeoutMs = -1,
+                 const std::function<bool()>& cancelled = std::function<bool()>());
+
+    /**
+     * @brief 释放 acquire() 获得的锁
+     */
+    void release(int repoId, RepositoryLockMode mode, const QString& job);
+
+    /**
+     * @brief 正在使用仓库的任务
+     */
+    QStringList activeJobs(int repoId) const;
+
+    /**
+     * @brief 检查仓库中的 restic 锁，全部失效时清除
+     *
+     * 锁被视为失效：由本机创建且进程已不存在，或超过 StaleLockAgeSecs 没有刷新。
+     * 清除使用不带 --remove-all 的 restic unlock，restic 自身也只删除失效的锁。
+     * @return 清除了锁且没有仍然有效的锁（可以重试命令）时返回true
+     */
+    bool clearStaleLocks(const Models::Repository& repo, const QString& password);
+
+    /**
+     * @brief restic 错误输出是否表示仓库被锁定
+     */
+    static bool isLockConflict(const QString& errorOutput);
+
+    /**
+     * @brief 按上述策略判断锁是否失效
+     */
+    static bool isStale(const Models::RepositoryLock& lock);
+
+    // restic 每 5 分钟刷新一次锁，超过 30 分钟未刷新的锁 restic 自身也视为失效
+    static constexpr qint64 StaleLockAgeSecs = 30 * 60;
+    static constexpr int WaitSliceMs = 500;
+
+private:
+    RepositoryLockCoordinator();
+    RepositoryLockCoordinator(const RepositoryLockCoordinator&) = delete;
+    RepositoryLockCoordinator& operator=(const RepositoryLockCoordinator&) = delete;
+
+    struct RepoState
+    {
+        int readers = 0;
+        bool writer = false;
+        int waitingWriters = 0;
+        QStringList jobs;
+    };
+
+    bool canEnter(int repoId, RepositoryLockMode mode) const;
+    static bool isProcessAlive(qint64 pid);
+
+    static RepositoryLockCoordinator* s_instance;
+    static QMutex s_instanceMutex;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_changed;
+    QHash<int, RepoState> m_states;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // REPOSITORYLOCKCOORDINATOR_H
@@ -0,0 +1,231 @@
+#include "ResticCapabilities.h"
+#include "../data/ConfigManager.h"
+#include "../utils/Logger.h"
+#include <QMutexLocker>
+#include <QProcess>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+
+namespace ResticGUI {
+namespace Core {
+
+namespace {
+
+const char* const CacheConfigKey = "Restic/Capabilities";
+
+bool hasFlag(const QString& help, const QString& flag)
+{
+    // 精确匹配参数名，避免 --delete 匹配到 --delete-xxx
+    QRegularExpression re(QString("(^|\\s)%1(\\s|=|$)").arg(QRegularExpression::escape(flag)),
+                          QRegularExpression::MultilineOption);
+    return re.match(help).hasMatch();
+}
+
+} // namespace
+
+// ========== ResticFeatures ==========
+
+bool ResticFeatures::versionAtLeast(int reqMajor, int reqMinor, int reqPatch) const
+{
+    if (major < 0) {
+        // 开发版等无法解析版本号的构建按最新版本处理
+        return true;
+    }
+    if (major != reqMajor) {
+        return major > reqMajor;
+    }
+    if (minor != reqMinor) {
+        return minor > reqMinor;
+    }
+    return patch >= reqPatch;
+}
+
+QVariantMap ResticFeatures::toVariantMap() const
+{
+    QVariantMap map;
+    map["resticPath"] = resticPath;
+    map["mtime"] = mtime;
+    map["version"] = version;
+    map["major"] = major;
+    map["minor"] = minor;
+    map["patch"] = patch;
+    map["restoreJson"] = restoreJson;
+    map["restoreOverwrite"] = restoreOverwrite;
+    map["restoreDryRun"] = restoreDryRun;
+    map["restoreDelete"] = restoreDelete;
+    map["restoreSparse"] = restoreSparse;
+    map["lsNcdu"] = lsNcdu;
+    map["backupSkipIfUnchanged"] = backupSkipIfUnchanged;
+    map["backupReadConcurrency"] = backupReadConcurrency;
+    map["forgetJson"] = forgetJson;
+    return map;
+}
+
+ResticFeatures ResticFeatures::fromVariantMap(const QVariantMap& map)
+{
+    ResticFeatures features;
+    features.resticPath = map.value("resticPath").toString();
+    features.mtime = map.value("mtime", -1).toLongLong();
+    features.version = map.value("version").toString();
+    features.major = map.value("major", -1).toInt();
+    features.minor = map.value("minor", -1).toInt();
+    features.patch = map.value("patch", -1).toInt();
+    features.restoreJson = map.value("restoreJson", true).toBool();
+    features.restoreOverwrite = map.value("restoreOverwrite", true).toBool();
+    features.restoreDryRun = map.value("restoreDryRun", true).toBool();
+    features.restoreDelete = map.value("restoreDelete", true).toBool();
+    features.restoreSparse = map.value("restoreSparse", true).toBool();
+    features.lsNcdu = map.value("lsNcdu", true).toBool();
+    features.backupSkipIfUnchanged = map.value("backupSkipIfUnchanged", true).toBool();
+    features.backupReadConcurrency = map.value("backupReadConcurrency", true).toBool();
+    features.forgetJson = map.value("forgetJson", true).toBool();
+    features.probed = true;
+    return features;
+}
+
+// ========== ResticCapabilities ==========
+
+ResticCapabilities* ResticCapabilities::s_instance = nullptr;
+QMutex ResticCapabilities::s_instanceMutex;
+
+ResticCapabilities* ResticCapabilities::instance()
+{
+    if (!s_instance) {
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new ResticCapabilities();
+        }
+    }
+    return s_instance;
+}
+
+ResticCapabilities::ResticCapabilities()
+{
+}
+
+ResticFeatures ResticCapabilities::features(const QString& resticPath)
+{
+    ResticFeatures unknown;
+    unknown.resticPath = resticPath;
+
+    QFileInfo info(resticPath);
+    if (resticPath.isEmpty() || !info.exists()) {
+        return unknown;
+    }
+    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_cache.constFind(resticPath);
+    if (it != m_cache.constEnd() && it->mtime == mtime) {
+        return *it;
+    }
+
+    // 上次运行探测过的结果
+    Data::ConfigManager* config = Data::ConfigManager::instance();
+    QVariantMap stored = config->getValue(CacheConfigKey).toMap();
+    ResticFeatures features = ResticFeatures::fromVariantMap(stored.value(resticPath).toMap());
+    if (features.resticPath != resticPath || features.mtime != mtime) {
+        features = probe(resticPath, mtime);
+        if (features.probed) {
+            stored.insert(resticPath, features.toVariantMap());
+            config->setValue(CacheConfigKey, stored);
+        }
+    }
+
+    // 探测失败也缓存，避免每条命令都重新启动探测进程
+    m_cache.insert(resticPath, features);
+    return features;
+}
+
+void ResticCapabilities::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+    Data::ConfigManager::instance()->remove(CacheConfigKey);
+}
+
+ResticFeatures ResticCapabilities::probe(const QString& resticPath, qint64 mtime)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ResticFeatures features;
+    features.resticPath = resticPath;
+    features.mtime = mtime;
+
+    QString versionOutput;
+    if (!runProbeCommand(resticPath, QStringList() << "version", versionOutput)) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("无法探测 restic 版本，按最新版本的参数执行: %1").arg(resticPath));
+        return features;
+    }
+
+    // 例如 "restic 0.17.3 compiled with go1.23.1 on linux/amd64"
+    features.version = versionOutput.trimmed();
+    QRegularExpressionMatch match = QRegularExpression("restic\\s+v?(\\d+)\\.(\\d+)\\.(\\d+)").match(features.version);
+    if (match.hasMatch()) {
+        features.major = match.captured(1).toInt();
+        features.minor = match.captured(2).toInt();
+        features.patch = match.captured(3).toInt();
+    }
+
+    // 有专门参数的功能以 --help 为准，帮助中看不出来的按版本判断
+    QString restoreHelp;
+    QString lsHelp;
+    QString backupHelp;
+    if (runProbeCommand(resticPath, QStringList() << "restore" << "--help", restoreHelp)) {
+        features.restoreOverwrite = hasFlag(restoreHelp, "--overwrite");
+        features.restoreDryRun = hasFlag(restoreHelp, "--dry-run");
+        features.restoreDelete = hasFlag(restoreHelp, "--delete");
+        features.restoreSparse = hasFlag(restoreHelp, "--sparse");
+    }
+    if (runProbeCommand(resticPath, QStringList() << "ls" << "--help", lsHelp)) {
+        features.lsNcdu = hasFlag(lsHelp, "--ncdu");
+    }
+    if (runProbeCommand(resticPath, QStringList() << "backup" << "--help", backupHelp)) {
+        features.backupSkipIfUnchanged = hasFlag(backupHelp, "--skip-if-unchanged");
+        features.backupReadConcurrency = hasFlag(backupHelp, "--read-concurrency");
+    }
+
+    // --json 是全局参数，各命令何时开始输出 JSON 只能按版本判断
+    features.restoreJson = features.versionAtLeast(0, 16);
+    features.forgetJson = features.versionAtLeast(0, 10);
+
+    features.probed = true;
+
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("restic 功能探测完成（%1 ms）: %2，restore --json=%3, --overwrite=%4, ls --ncdu=%5, "
+                "backup --skip-if-unchanged=%6, --read-concurrency=%7")
+            .arg(timer.elapsed())
+            .arg(features.version)
+            .arg(features.restoreJson)
+            .arg(features.restoreOverwrite)
+            .arg(features.lsNcdu)
+            .arg(features.backupSkipIfUnchanged)
+            .arg(features.backupReadConcurrency));
+
+    return features;
+}
+
+bool ResticCapabilities::runProbeCommand(const QString& resticPath, const QStringList& args, QString& output)
+{
+    QProcess process;
+    process.start(resticPath, args);
+    if (!process.waitForStarted(ProbeTimeoutMs) || !process.waitForFinished(ProbeTimeoutMs)) {
+        process.kill();
+        process.waitForFinished(1000);
+        return false;
+    }
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        return false;
+    }
+
+    output = QString::fromUtf8(process.readAllStandardOutput());
+    return true;
+}
+
+} // namespace Core
+} // namespace ResticGUI
@@ -0,0 +1,89 @@
+#ifndef RESTICCAPABILITIES_H
+#define RESTICCAPABILITIES_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMutex>
+#include <QVariantMap>
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief 某个 restic 可执行文件支持的功能
+ *
+ * 各命令据此选择最高效的参数形式，不支持时退回旧版本也能执行的形式。
+ * 未能探测时所有功能视为可用，与引入探测前的行为一致。
+ */
+struct ResticFeatures
+{
+    QString resticPath;
+    qint64 mtime = -1;              // 可执行文件修改时间（毫秒），用于判断缓存是否过期
+    QString version;                // restic version 的完整输出
+    int major = -1;                 // 版本号，无法解析时为 -1
+    int minor = -1;
+    int patch = -1;
+    bool probed = false;
+
+    bool restoreJson = true;        // restore --json 输出进度和 summary（0.16+）
+    bool restoreOverwrite = true;   // restore --overwrite（0.17+）
+    bool restoreDryRun = true;      // restore --dry-run（0.17+）
+    bool restoreDelete = true;      // restore --delete（0.17+）
+    bool restoreSparse = true;      // restore --sparse（0.15+）
+    bool lsNcdu = true;             // ls --ncdu 紧凑的整树输出（0.15+）
+    bool backupSkipIfUnchanged = true;  // backup --skip-if-unchanged（0.17+）
+    bool backupReadConcurrency = true;  // backup --read-concurrency（0.15+）
+    bool forgetJson = true;         // forget --json 输出保留/删除分组
+
+    bool versionAtLeast(int reqMajor, int reqMinor, int reqPatch = 0) const;
+
+    QVariantMap toVariantMap() const;
+    static ResticFeatures fromVariantMap(const QVariantMap& map);
+};
+
+/**
+ * @brief restic 功能探测（单例模式）
+ *
+ * 每个 restic 可执行文件只探测一次：执行 version 和几个子命令的 --help，
+ * 按输出中的版本号和参数判断功能。结果按路径和修改时间缓存在内存和配置中，
+ * 替换 restic 后自动重新探测。
+ *
+ * features() 首次调用会启动子进程，应避免在界面线程中首次调用。
+ */
+class ResticCapabilities
+{
+public:
+    static ResticCapabilities* instance();
+
+    /**
+     * @brief 获取 restic 可执行文件的功能，未缓存时探测
+     */
+    ResticFeatures features(const QString& resticPath);
+
+    /**
+     * @brief 清除缓存，下次调用 features() 时重新探测
+     */
+    void invalidate();
+
+    static constexpr int ProbeTimeoutMs = 10000;
+
+private:
+    ResticCapabilities();
+    ResticCapabilities(const ResticCapabilities&) = delete;
+    ResticCapabilities& operator=(const ResticCapabilities&) = delete;
+
+    static ResticFeatures probe(const QString& resticPath, qint64 mtime);
+    static bool runProbeCommand(const QString& resticPath, const QStringList& args, QString& output);
+
+    static ResticCapabilities* s_instance;
+    static QMutex s_instanceMutex;
+
+    QMutex m_mutex;                 // 探测期间持有，并发调用者等待同一次探测
+    QHash<QString, ResticFeatures> m_cache;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // RESTICCAPABILITIES_H
@@ -6,6 +6,8 @@
 #include "ResticWrapper.h"
 #include "../utils/Logger.h"
 #include "../data/ConfigManager.h"
+#include "../utils/Tracer.h"
+#include "../utils/Metrics.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -13,10 +15,32 @@
 #include <QTimer>
 #include <QFile>
 #include <QFileInfo>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QPair>
+#include <QRegularExpression>
+#include <QThread>
+#include <QCoreApplication>
+#include <QMutexLocker>
 
 namespace ResticGUI {
 namespace Core {
 
+namespace {
+
+// 按子命令记录退出码和耗时，退出码 0 以外的增长可以直接在监控中告警
+void recordCommandMetrics(const QStringList& args, int exitCode, qint64 elapsedMs)
+{
+    Utils::MetricsRegistry* registry = Utils::MetricsRegistry::instance();
+    const QString command = args.value(0);
+    registry->counter("resticgui_restic_exit_codes_total", "restic 命令按退出码的次数",
+                      {{"command", command}, {"code", QString::number(exitCode)}})->inc();
+    registry->histogram("resticgui_restic_command_duration_seconds", "restic 命令耗时（秒）",
+                        Utils::Histogram::durationBuckets(), {{"command", command}})->observe(elapsedMs / 1000.0);
+}
+
+} // namespace
+
 ResticWrapper::ResticWrapper(QObject* parent)
     : QObject(parent)
     , m_process(nullptr)
@@ -27,6 +51,7 @@ ResticWrapper::ResticWrapper(QObject* parent)
 
 ResticWrapper::~ResticWrapper()
 {
+    QMutexLocker locker(&m_processMutex);
     if (m_process) {
         if (m_process->state() == QProcess::Running) {
             m_process->kill();
@@ -44,6 +69,12 @@ void ResticWrapper::setResticPath(const QString& path)
 
 QString ResticWrapper::getVersion()
 {
+    // 功能探测时已取得版本信息
+    const ResticFeatures caps = features();
+    if (caps.probed && !caps.version.isEmpty()) {
+        return caps.version;
+    }
+
     QString output;
     if (executeCommand(QStringList() << "version", output)) {
         return output.trimmed();
@@ -51,15 +82,56 @@ QString ResticWrapper::getVersion()
     return QString();
 }
 
+ResticFeatures ResticWrapper::features() const
+{
+    return ResticCapabilities::instance()->features(m_resticPath);
+}
+
 void ResticWrapper::cancel()
 {
+    // 先置标志：进程尚未启动时，startProcess() 在同一把锁下看到它后不再启动
     m_cancelled = true;
+
+    QMutexLocker locker(&m_processMutex);
     if (m_process && m_process->state() == QProcess::Running) {
         m_process->kill();
         Utils::Logger::instance()->log(Utils::Logger::Warning, "Restic操作已取消");
     }
 }
 
+QString ResticWrapper::escapePattern(const QString& path)
+{
+    QString pattern;
+    pattern.reserve(path.size());
+    for (const QChar ch : path) {
+        if (ch == '*' || ch == '?' || ch == '[' || ch == '\\') {
+            pattern += '\\';
+        }
+        pattern += ch;
+    }
+    return pattern;
+}
+
+bool ResticWrapper::patternToPath(const QString& pattern, QString& path)
+{
+    path.clear();
+    path.reserve(pattern.size());
+    for (int i = 0; i < pattern.size(); ++i) {
+        const QChar ch = pattern.at(i);
+        if (ch == '\\') {
+            if (++i >= pattern.size()) {
+                return false;
+            }
+            path += pattern.at(i);
+        } else if (ch == '*' || ch == '?' || ch == '[') {
+            return false;
+        } else {
+            path += ch;
+        }
+    }
+    return true;
+}
+
 // ========== 仓库操作 ==========
 
 bool ResticWrapper::initRepository(const Models::Repository& repo, const QString& password)
@@ -101,6 +173,25 @@ bool ResticWrapper::checkRepository(const Models::Repository& repo, const QStrin
     return false;
 }
 
+bool ResticWrapper::checkDataSubset(const Models::Repository& repo, const QString& password,
+                                    int slice, int sliceCount)
+{
+    QStringList args;
+    args << "check" << QString("--read-data-subset=%1/%2").arg(slice).arg(sliceCount);
+
+    QString output;
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("验证仓库 %1 的数据切片 %2/%3").arg(repo.name).arg(slice).arg(sliceCount));
+
+    if (executeCommand(args, output, true, password, &repo)) {
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("数据切片 %1/%2 验证通过").arg(slice).arg(sliceCount));
+        return true;
+    }
+
+    return false;
+}
+
 bool ResticWrapper::repairRepository(const Models::Repository& repo, const QString& password)
 {
     QStringList args;
@@ -146,10 +237,14 @@ bool ResticWrapper::unlockRepository(const Models::Repository& repo, const QStri
     return false;
 }
 
-bool ResticWrapper::getStats(const Models::Repository& repo, const QString& password, Models::RepoStats& stats)
+bool ResticWrapper::getStats(const Models::Repository& repo, const QString& password, Models::RepoStats& stats,
+                             const QString& mode)
 {
     QStringList args;
     args << "stats" << "--json";
+    if (!mode.isEmpty()) {
+        args << "--mode" << mode;
+    }
 
     QString output;
     if (!executeCommand(args, output, true, password, &repo)) {
@@ -163,38 +258,152 @@ bool ResticWrapper::getStats(const Models::Repository& repo, const QString& pass
 bool ResticWrapper::prune(const Models::Repository& repo, const QString& password,
                          int keepLast, int keepDaily, int keepWeekly,
                          int keepMonthly, int keepYearly)
+{
+    Models::PruneOptions options;
+    options.keepLast = keepLast;
+    options.keepDaily = keepDaily;
+    options.keepWeekly = keepWeekly;
+    options.keepMonthly = keepMonthly;
+    options.keepYearly = keepYearly;
+    return prune(repo, password, options);
+}
+
+bool ResticWrapper::prune(const Models::Repository& repo, const QString& password,
+                          const Models::PruneOptions& options, Models::PruneStats* stats)
+{
+    QStringList args = pruneArgs(options);
+
+    const bool json = features().forgetJson;
+    if (json) {
+        args << "--json";
+    }
+
+    QString output;
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("维护仓库: %1 (%2)").arg(repo.name).arg(args.mid(2).join(' ')));
+
+    if (executeCommandWithProgress(args, output, password, &repo)) {
+        Models::PruneStats result;
+        parsePruneStats(output, result);
+
+        int kept = 0;
+        int removed = 0;
+        if (json && parseForgetJson(output, kept, removed)) {
+            result.removedSnapshots = removed;
+            Utils::Logger::instance()->log(Utils::Logger::Info,
+                QString("仓库维护完成，保留 %1 个快照，删除 %2 个快照").arg(kept).arg(removed));
+        } else {
+            Utils::Logger::instance()->log(Utils::Logger::Info, "仓库维护完成");
+        }
+
+        if (result.valid) {
+            Utils::Logger::instance()->log(Utils::Logger::Info,
+                QString("重新打包 %1 字节，释放 %2 字节")
+                    .arg(result.repackBytes).arg(result.reclaimedBytes));
+        }
+        if (stats) {
+            *stats = result;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool ResticWrapper::estimatePrune(const Models::Repository& repo, const QString& password,
+                                  const Models::PruneOptions& options, Models::PruneStats& stats)
+{
+    // 不加 --json：forget 的 JSON 模式下 prune 统计不一定输出
+    QStringList args = pruneArgs(options);
+    args << "--dry-run";
+
+    QString output;
+    if (!executeCommand(args, output, true, password, &repo)) {
+        return false;
+    }
+
+    stats = Models::PruneStats();
+    parsePruneStats(output, stats);
+
+    // 没有快照需要删除时 restic 不执行 prune，也就没有统计
+    stats.valid = true;
+    return true;
+}
+
+QStringList ResticWrapper::pruneArgs(const Models::PruneOptions& options)
 {
     // 注意：保留策略参数应该用于 forget 命令，而不是 prune 命令
     // 正确的做法是使用 forget --prune 来一次性完成标记删除和清理操作
     QStringList args;
     args << "forget" << "--prune";
 
-    if (keepLast > 0) {
-        args << "--keep-last" << QString::number(keepLast);
+    if (options.keepLast > 0) {
+        args << "--keep-last" << QString::number(options.keepLast);
     }
-    if (keepDaily > 0) {
-        args << "--keep-daily" << QString::number(keepDaily);
+    if (options.keepDaily > 0) {
+        args << "--keep-daily" << QString::number(options.keepDaily);
     }
-    if (keepWeekly > 0) {
-        args << "--keep-weekly" << QString::number(keepWeekly);
+    if (options.keepWeekly > 0) {
+        args << "--keep-weekly" << QString::number(options.keepWeekly);
     }
-    if (keepMonthly > 0) {
-        args << "--keep-monthly" << QString::number(keepMonthly);
+    if (options.keepMonthly > 0) {
+        args << "--keep-monthly" << QString::number(options.keepMonthly);
     }
-    if (keepYearly > 0) {
-        args << "--keep-yearly" << QString::number(keepYearly);
+    if (options.keepYearly > 0) {
+        args << "--keep-yearly" << QString::number(options.keepYearly);
     }
 
+    if (!options.maxUnused.isEmpty()) {
+        args << "--max-unused" << options.maxUnused;
+    }
+    if (options.maxRepackSize > 0) {
+        // restic 的大小参数不接受 B 后缀，按 KiB 向下取整
+        args << "--max-repack-size" << QString("%1K").arg(qMax<qint64>(1, options.maxRepackSize / 1024));
+    }
+    if (options.repackCacheableOnly) {
+        args << "--repack-cacheable-only";
+    }
+
+    return args;
+}
+
+bool ResticWrapper::listLocks(const Models::Repository& repo, const QString& password,
+                              QList<Models::RepositoryLock>& locks)
+{
     QString output;
-    Utils::Logger::instance()->log(Utils::Logger::Info,
-        QString("维护仓库: %1").arg(repo.name));
+    if (!executeCommand(QStringList() << "list" << "locks" << "--no-lock", output, true, password, &repo)) {
+        return false;
+    }
 
-    if (executeCommandWithProgress(args, output, password, &repo)) {
-        Utils::Logger::instance()->log(Utils::Logger::Info, "仓库维护完成");
-        return true;
+    locks.clear();
+    for (const QString& line : output.split('\n', Qt::SkipEmptyParts)) {
+        const QString lockId = line.trimmed();
+
+        QString lockJson;
+        if (!executeCommand(QStringList() << "cat" << "lock" << lockId << "--no-lock",
+                            lockJson, true, password, &repo)) {
+            continue;   // 读取期间锁已被删除
+        }
+
+        QJsonObject obj = QJsonDocument::fromJson(lockJson.toUtf8()).object();
+        if (obj.isEmpty()) {
+            continue;
+        }
+
+        Models::RepositoryLock lock;
+        lock.id = lockId;
+        // restic 输出纳秒精度的时间，Qt 只解析到毫秒
+        QString time = obj["time"].toString();
+        time.replace(QRegularExpression("(\\.\\d{3})\\d+"), "\\1");
+        lock.time = QDateTime::fromString(time, Qt::ISODateWithMs);
+        lock.exclusive = obj["exclusive"].toBool();
+        lock.hostname = obj["hostname"].toString();
+        lock.username = obj["username"].toString();
+        lock.pid = obj["pid"].toVariant().toLongLong();
+        locks.append(lock);
     }
 
-    return false;
+    return true;
 }
 
 // ========== 备份操作 ==========
@@ -277,10 +486,27 @@ bool ResticWrapper::backup(const Models::Repository& repo, const QString& passwo
         Utils::Logger::instance()->log(Utils::Logger::Debug, "禁用额外验证");
     }
 
+    const ResticFeatures caps = features();
+
     if (task.readConcurrency > 0) {
-        args << "--read-concurrency" << QString::number(task.readConcurrency);
-        Utils::Logger::instance()->log(Utils::Logger::Debug,
-            QString("文件读取并发数: %1").arg(task.readConcurrency));
+        if (caps.backupReadConcurrency) {
+            args << "--read-concurrency" << QString::number(task.readConcurrency);
+            Utils::Logger::instance()->log(Utils::Logger::Debug,
+                QString("文件读取并发数: %1").arg(task.readConcurrency));
+        } else {
+            Utils::Logger::instance()->log(Utils::Logger::Warning,
+                "当前 restic 版本不支持 --read-concurrency，使用默认读取并发数");
+        }
+    }
+
+    // 没有变化时不创建新快照，省去写入快照和之后清理的开销
+    if (task.skipIfUnchanged) {
+        if (caps.backupSkipIfUnchanged) {
+            args << "--skip-if-unchanged";
+        } else {
+            Utils::Logger::instance()->log(Utils::Logger::Debug,
+                "当前 restic 版本不支持 --skip-if-unchanged，总是创建快照");
+        }
     }
 
     if (task.packSize > 0) {
@@ -309,8 +535,12 @@ bool ResticWrapper::backup(const Models::Repository& repo, const QString& passwo
 
     if (success) {
         result = parseBackupResultJson(output);
-        Utils::Logger::instance()->log(Utils::Logger::Info,
-            QString("备份完成，快照ID: %1").arg(result.snapshotId));
+        if (result.snapshotId.isEmpty() && task.skipIfUnchanged) {
+            Utils::Logger::instance()->log(Utils::Logger::Info, "备份完成，数据没有变化，未创建新快照");
+        } else {
+            Utils::Logger::instance()->log(Utils::Logger::Info,
+                QString("备份完成，快照ID: %1").arg(result.snapshotId));
+        }
     }
 
     return success;
@@ -360,8 +590,11 @@ bool ResticWrapper::listFiles(const Models::Repository& repo, const QString& pas
                              const QString& snapshotId, const QString& path,
                              QList<Models::FileInfo>& files)
 {
+    // 整个快照的递归列表使用 ncdu 格式：嵌套数组不重复父路径，输出量小很多
+    const bool ncdu = path.isEmpty() && features().lsNcdu;
+
     QStringList args;
-    args << "ls" << snapshotId << "--json";
+    args << "ls" << snapshotId << (ncdu ? "--ncdu" : "--json");
 
     if (!path.isEmpty()) {
         args << path;
@@ -372,7 +605,119 @@ bool ResticWrapper::listFiles(const Models::Repository& repo, const QString& pas
         return false;
     }
 
-    files = parseFilesJson(output);
+    files = ncdu ? parseNcduJson(output) : parseFilesJson(output);
+    return true;
+}
+
+bool ResticWrapper::findPath(const Models::Repository& repo, const QString& password,
+                            const QString& path, const QStringList& snapshotIds,
+                            QList<Models::FileVersion>& versions)
+{
+    QStringList args;
+    args << "find" << "--json";
+    for (const QString& snapshotId : snapshotIds) {
+        args << "--snapshot" << snapshotId;
+    }
+    // restic find 的参数是匹配模式，转义通配符后以 / 开头即按完整路径匹配
+    args << escapePattern(path);
+
+    QString output;
+    if (!executeCommand(args, output, true, password, &repo)) {
+        return false;
+    }
+
+    // 输出为 [{"snapshot": ..., "matches": [...]}, ...]，旧版本为每行一个对象
+    QList<QJsonObject> results;
+    QJsonDocument doc = QJsonDocument::fromJson(output.toUtf8());
+    if (doc.isArray()) {
+        for (const QJsonValue& value : doc.array()) {
+            results.append(value.toObject());
+        }
+    } else {
+        for (const QString& line : output.split('\n', Qt::SkipEmptyParts)) {
+            QJsonDocument lineDoc = QJsonDocument::fromJson(line.toUtf8());
+            if (lineDoc.isObject()) {
+                results.append(lineDoc.object());
+            }
+        }
+    }
+
+    versions.clear();
+    for (const QJsonObject& result : results) {
+        const QString snapshotId = result["snapshot"].toString();
+        for (const QJsonValue& match : result["matches"].toArray()) {
+            Models::FileInfo file = parseFileJson(match.toObject());
+            if (file.path != path) {
+                continue;
+            }
+
+            Models::FileVersion version;
+            version.snapshotId = snapshotId;
+            version.type = file.type;
+            version.size = file.size;
+            version.mtime = file.mtime;
+            versions.append(version);
+        }
+    }
+
+    Utils::Logger::instance()->log(Utils::Logger::Debug,
+        QString("restic find: %1 在 %2 个快照中找到")
+            .arg(path).arg(versions.size()));
+    return true;
+}
+
+bool ResticWrapper::diffSnapshots(const Models::Repository& repo, const QString& password,
+                                 const QString& oldSnapshotId, const QString& newSnapshotId,
+                                 const std::function<void(const Models::FileChange&)>& onChange)
+{
+    QStringList args;
+    args << "diff" << oldSnapshotId << newSnapshotId << "--json";
+
+    int changeCount = 0;
+    auto onLine = [&](const QByteArray& line) {
+        // 每行一个对象：{"message_type":"change","path":"/a/b/","modifier":"+"}
+        QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (!doc.isObject()) {
+            return;
+        }
+
+        QJsonObject obj = doc.object();
+        if (obj["message_type"].toString() != "change") {
+            return;
+        }
+
+        Models::FileChange change;
+        change.path = obj["path"].toString();
+        const QString modifier = obj["modifier"].toString();
+
+        // 目录路径以 / 结尾
+        if (change.path.size() > 1 && change.path.endsWith('/')) {
+            change.path.chop(1);
+            change.type = Models::FileType::Directory;
+        }
+
+        if (modifier.contains('+')) {
+            change.change = Models::ChangeType::Added;
+        } else if (modifier.contains('-')) {
+            change.change = Models::ChangeType::Removed;
+        } else if (change.type == Models::FileType::Directory && !modifier.contains('T')) {
+            // 目录只有元数据变化，与文件树比较的结果保持一致
+            return;
+        } else {
+            change.change = Models::ChangeType::Modified;
+        }
+
+        changeCount++;
+        onChange(change);
+    };
+
+    if (!executeCommandStreaming(args, password, &repo, onLine)) {
+        return false;
+    }
+
+    Utils::Logger::instance()->log(Utils::Logger::Debug,
+        QString("restic diff: %1 -> %2，%3 个变化")
+            .arg(oldSnapshotId.left(8)).arg(newSnapshotId.left(8)).arg(changeCount));
     return true;
 }
 
@@ -384,12 +729,23 @@ bool ResticWrapper::deleteSnapshots(const Models::Repository& repo, const QStrin
     args << snapshotIds;
     args << "--prune"; // 同时清理数据
 
+    const bool json = features().forgetJson;
+    if (json) {
+        args << "--json";
+    }
+
     QString output;
     Utils::Logger::instance()->log(Utils::Logger::Info,
         QString("删除快照，数量: %1").arg(snapshotIds.size()));
 
     if (executeCommandWithProgress(args, output, password, &repo)) {
-        Utils::Logger::instance()->log(Utils::Logger::Info, "快照已删除");
+        int kept = 0;
+        int removed = 0;
+        if (json && parseForgetJson(output, kept, removed)) {
+            Utils::Logger::instance()->log(Utils::Logger::Info, QString("快照已删除，数量: %1").arg(removed));
+        } else {
+            Utils::Logger::instance()->log(Utils::Logger::Info, "快照已删除");
+        }
         return true;
     }
 
@@ -399,32 +755,93 @@ bool ResticWrapper::deleteSnapshots(const Models::Repository& repo, const QStrin
 // ========== 恢复操作 ==========
 
 bool ResticWrapper::restore(const Models::Repository& repo, const QString& password,
-                           const QString& snapshotId, const Models::RestoreOptions& options)
+                           const QString& snapshotId, const Models::RestoreOptions& options,
+                           Models::RestoreSummary* summary)
 {
+    const ResticFeatures caps = features();
+
+    // 旧版本 restic 不支持的选项：试运行无法退化，直接报告不可用；其余选项退回旧版本的行为
+    if (options.dryRun && !caps.restoreDryRun) {
+        Utils::Logger::instance()->log(Utils::Logger::Debug, "当前 restic 版本不支持 restore --dry-run");
+        return false;
+    }
+
     QStringList args;
     args << "restore" << snapshotId;
     args << "--target" << options.targetPath;
+    if (caps.restoreJson) {
+        args << "--json";   // 输出进度状态行
+    }
+
+    // 包含/排除路径，数量较多时写入模式文件，控制命令行长度
+    QTemporaryFile includeFile;
+    QTemporaryFile excludeFile;
+    appendPatternArgs(args, "include", options.includePaths, includeFile);
+    appendPatternArgs(args, "exclude", options.excludePaths, excludeFile);
+
+    // 覆盖策略：if-changed 会跳过内容已正确的文件，中断后重跑只恢复剩余部分
+    if (caps.restoreOverwrite) {
+        switch (options.overwritePolicy) {
+        case Models::RestoreOptions::Always:
+            args << "--overwrite" << "always";
+            break;
+        case Models::RestoreOptions::IfChanged:
+            args << "--overwrite" << "if-changed";
+            break;
+        case Models::RestoreOptions::IfNewer:
+            args << "--overwrite" << "if-newer";
+            break;
+        case Models::RestoreOptions::Never:
+        case Models::RestoreOptions::Ask:
+            // 命令行无法逐个询问，按不覆盖处理
+            args << "--overwrite" << "never";
+            break;
+        }
+    } else if (options.overwritePolicy != Models::RestoreOptions::Always) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            "当前 restic 版本不支持 --overwrite，将覆盖目标中的所有文件");
+    }
 
-    // 添加包含路径
-    for (const QString& include : options.includePaths) {
-        args << "--include" << include;
+    if (options.sparse && caps.restoreSparse) {
+        args << "--sparse";
     }
 
-    // 添加排除路径
-    for (const QString& exclude : options.excludePaths) {
-        args << "--exclude" << exclude;
+    if (options.deleteExtraneous) {
+        if (caps.restoreDelete) {
+            args << "--delete";
+        } else {
+            Utils::Logger::instance()->log(Utils::Logger::Warning,
+                "当前 restic 版本不支持 --delete，目标中多余的文件不会被删除");
+        }
     }
 
-    if (options.verify) {
+    if (options.verify && !options.dryRun) {
         args << "--verify";
     }
 
+    if (options.dryRun) {
+        args << "--dry-run";
+    }
+
     QString output;
     Utils::Logger::instance()->log(Utils::Logger::Info,
-        QString("开始恢复，快照: %1, 目标: %2").arg(snapshotId).arg(options.targetPath));
+        QString("%1，快照: %2, 目标: %3")
+            .arg(options.dryRun ? "试运行恢复" : "开始恢复")
+            .arg(snapshotId).arg(options.targetPath));
 
-    if (executeCommandWithProgress(args, output, password, &repo)) {
-        Utils::Logger::instance()->log(Utils::Logger::Info, "恢复完成");
+    const bool success = executeCommandWithProgress(args, output, password, &repo);
+
+    // 失败时 restic 也可能已输出部分统计
+    Models::RestoreSummary result = parseRestoreSummaryJson(output);
+    if (summary) {
+        *summary = result;
+    }
+
+    if (success) {
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("%1，恢复 %2 个文件，跳过 %3 个文件")
+                .arg(options.dryRun ? "试运行完成" : "恢复完成")
+                .arg(result.filesRestored).arg(result.filesSkipped));
         return true;
     }
 
@@ -433,47 +850,358 @@ bool ResticWrapper::restore(const Models::Repository& repo, const QString& passw
 
 // ========== 挂载操作 ==========
 
-bool ResticWrapper::mount(const Models::Repository& repo, const QString& password,
-                         const QString& mountPoint, const QString& snapshotId)
+bool ResticWrapper::startMount(const Models::Repository& repo, const QString& password,
+                               const QString& mountPoint)
 {
+#ifdef Q_OS_WIN
+    // Windows不支持挂载
+    Utils::Logger::instance()->log(Utils::Logger::Error, "Windows不支持挂载功能");
+    return false;
+#else
+    // 挂载期间 restic 一直持有共享锁，但不登记到锁协调器：
+    // 否则排队的独占任务及其后的所有任务都要等到卸载
     QStringList args;
     args << "mount" << mountPoint;
 
-    if (!snapshotId.isEmpty()) {
-        args << snapshotId;
-    }
-
-    QString output;
     Utils::Logger::instance()->log(Utils::Logger::Info,
         QString("挂载仓库到: %1").arg(mountPoint));
 
-    // mount命令需要在后台运行
-    // TODO: 需要特殊处理，在后台进程中运行
-    return executeCommand(args, output, true, password, &repo);
+    if (!startProcess(args, true, password, &repo, true)) {
+        return false;
+    }
+
+    // 进程一直运行到卸载，结束时再通知调用者
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, [this](int exitCode, QProcess::ExitStatus) {
+        emit commandFinished(exitCode, m_currentOutput);
+    });
+    return true;
+#endif
+}
+
+bool ResticWrapper::isProcessRunning() const
+{
+    QMutexLocker locker(&m_processMutex);
+    return m_process && m_process->state() != QProcess::NotRunning;
+}
+
+void ResticWrapper::terminate()
+{
+    QMutexLocker locker(&m_processMutex);
+    if (m_process && m_process->state() != QProcess::NotRunning) {
+        m_process->terminate();
+    }
 }
 
-bool ResticWrapper::umount(const QString& mountPoint)
+bool ResticWrapper::umount(const QString& mountPoint, bool lazy)
 {
 #ifdef Q_OS_WIN
     // Windows不支持挂载
     Utils::Logger::instance()->log(Utils::Logger::Error, "Windows不支持挂载功能");
     return false;
 #else
-    QProcess umountProcess;
-    umountProcess.start("umount", QStringList() << mountPoint);
-    umountProcess.waitForFinished();
+    QList<QPair<QString, QStringList>> commands;
+#ifdef Q_OS_MACOS
+    commands << qMakePair(QString("umount"), QStringList() << mountPoint);
+#else
+    // FUSE 挂载由普通用户卸载需要 fusermount，新系统上可能只有 fusermount3
+    const QString flag = lazy ? "-uz" : "-u";
+    commands << qMakePair(QString("fusermount"), QStringList() << flag << mountPoint)
+             << qMakePair(QString("fusermount3"), QStringList() << flag << mountPoint)
+             << qMakePair(QString("umount"), lazy ? QStringList() << "-l" << mountPoint
+                                                  : QStringList() << mountPoint);
+#endif
+
+    QString lastError;
+    for (const auto& command : commands) {
+        QProcess umountProcess;
+        umountProcess.start(command.first, command.second);
+        if (!umountProcess.waitForStarted(3000)) {
+            continue;   // 命令不存在，尝试下一个
+        }
+        umountProcess.waitForFinished(10000);
+        if (umountProcess.exitStatus() == QProcess::NormalExit && umountProcess.exitCode() == 0) {
+            return true;
+        }
+        lastError = QString::fromUtf8(umountProcess.readAllStandardError()).trimmed();
+    }
 
-    return umountProcess.exitCode() == 0;
+    Utils::Logger::instance()->log(Utils::Logger::Warning,
+        QString("卸载 %1 失败: %2").arg(mountPoint).arg(lastError));
+    return false;
 #endif
 }
 
 // ========== 私有辅助函数 ==========
 
+void ResticWrapper::appendPatternArgs(QStringList& args, const QString& option, const QStringList& patterns,
+                                      QTemporaryFile& spillFile)
+{
+    int inlineChars = 0;
+    for (const QString& pattern : patterns) {
+        inlineChars += pattern.size();
+    }
+
+    if (patterns.size() <= MaxInlinePatterns && inlineChars <= MaxInlinePatternChars) {
+        for (const QString& pattern : patterns) {
+            args << "--" + option << pattern;
+        }
+        return;
+    }
+
+    // restic 读取模式文件时会去掉首尾空白、跳过 # 开头的行并展开 $ 环境变量，
+    // 这些路径仍然放在命令行上
+    QStringList inlinePatterns;
+    QByteArray content;
+    for (const QString& pattern : patterns) {
+        const bool unsafe = pattern.contains('$') || pattern.contains('\n') || pattern.contains('\r')
+                            || pattern.trimmed() != pattern || pattern.startsWith('#');
+        if (unsafe) {
+            inlinePatterns.append(pattern);
+        } else {
+            content += pattern.toUtf8();
+            content += '\n';
+        }
+    }
+
+    spillFile.setFileTemplate(QDir::tempPath() + "/restic-gui-" + option + "-XXXXXX.txt");
+    if (!content.isEmpty() && spillFile.open() && spillFile.write(content) == content.size()
+        && spillFile.flush()) {
+        spillFile.close();
+        args << "--" + option + "-file" << spillFile.fileName();
+        Utils::Logger::instance()->log(Utils::Logger::Debug,
+            QString("%1 个%2模式写入文件: %3")
+                .arg(patterns.size() - inlinePatterns.size())
+                .arg(option == "include" ? "包含" : "排除")
+                .arg(spillFile.fileName()));
+    } else {
+        if (!content.isEmpty()) {
+            Utils::Logger::instance()->log(Utils::Logger::Warning,
+                QString("无法写入模式文件，改为在命令行中传递: %1").arg(spillFile.errorString()));
+        }
+        inlinePatterns = patterns;
+    }
+
+    for (const QString& pattern : inlinePatterns) {
+        args << "--" + option << pattern;
+    }
+}
+
 bool ResticWrapper::executeCommand(const QStringList& args, QString& output,
                                   bool usePassword, const QString& password,
                                   const Models::Repository* repo)
 {
-    m_cancelled = false;
+    const RepositoryLockMode mode = RepositoryLockCoordinator::lockModeFor(args);
+    const int repoId = repo ? repo->id : -1;
+    const QString job = args.mid(0, 2).join(' ');
+
+    if (!acquireRepositoryLock(repoId, mode, job)) {
+        return false;
+    }
+
+    bool success = runCommand(args, output, usePassword, password, repo);
+    if (!success && recoverFromStaleLock(mode, repo, password)) {
+        success = runCommand(args, output, usePassword, password, repo);
+    }
+
+    RepositoryLockCoordinator::instance()->release(repoId, mode, job);
+    return success;
+}
+
+bool ResticWrapper::runCommand(const QStringList& args, QString& output,
+                               bool usePassword, const QString& password,
+                               const Models::Repository* repo)
+{
+    Utils::TraceSpan span("restic", "process");
+    span.setDetail(args.join(' '));
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!startProcess(args, usePassword, password, repo, true)) {
+        return false;
+    }
+
+    // 等待进程完成（最长等待时间：1小时）
+    if (!m_process->waitForFinished(3600000)) {
+        if (!m_cancelled) {
+            QString error = "命令执行超时";
+            Utils::Logger::instance()->log(Utils::Logger::Error, error);
+            emit commandError(error);
+            m_process->kill();
+        }
+        return false;
+    }
+
+    int exitCode = m_process->exitCode();
+    output = m_currentOutput;
+    Utils::Tracer::instance()->instant("exit", "process", QString::number(exitCode));
+
+    Utils::Logger::LogContext context;
+    context.repoId = repo ? repo->id : -1;
+    context.durationMs = timer.elapsed();
+    Utils::Logger::instance()->log(Utils::Logger::Debug,
+        QString("命令 %1 完成，退出码: %2").arg(args.value(0)).arg(exitCode), context);
+    recordCommandMetrics(args, exitCode, context.durationMs);
+
+    emit commandFinished(exitCode, output);
+
+    if (exitCode != 0) {
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("命令执行失败: %1").arg(m_currentError));
+        return false;
+    }
+
+    return true;
+}
+
+bool ResticWrapper::executeCommandStreaming(const QStringList& args, const QString& password,
+                                           const Models::Repository* repo,
+                                           const LineHandler& onLine)
+{
+    const RepositoryLockMode mode = RepositoryLockCoordinator::lockModeFor(args);
+    const int repoId = repo ? repo->id : -1;
+    const QString job = args.mid(0, 2).join(' ');
+
+    if (!acquireRepositoryLock(repoId, mode, job)) {
+        return false;
+    }
+
+    // 被锁挡住时 restic 还没有输出任何内容，可以直接重试
+    bool success = runCommandStreaming(args, password, repo, onLine);
+    if (!success && recoverFromStaleLock(mode, repo, password)) {
+        success = runCommandStreaming(args, password, repo, onLine);
+    }
+
+    RepositoryLockCoordinator::instance()->release(repoId, mode, job);
+    return success;
+}
+
+bool ResticWrapper::acquireRepositoryLock(int repoId, RepositoryLockMode mode, const QString& job)
+{
+    if (m_cancelled) {
+        return false;
+    }
+
+    // 界面线程中排队会卡住界面，冲突时直接报告
+    QCoreApplication* app = QCoreApplication::instance();
+    const bool guiThread = app && QThread::currentThread() == app->thread();
+
+    RepositoryLockCoordinator* coordinator = RepositoryLockCoordinator::instance();
+    if (coordinator->acquire(repoId, mode, job, guiThread ? 0 : -1, [this]() { return m_cancelled.load(); })) {
+        return true;
+    }
+
+    if (!m_cancelled) {
+        QString error = QString("仓库正在执行其他操作（%1），请稍后再试")
+                            .arg(coordinator->activeJobs(repoId).join(", "));
+        Utils::Logger::instance()->log(Utils::Logger::Warning, error);
+        emit commandError(error);
+    }
+    return false;
+}
+
+bool ResticWrapper::recoverFromStaleLock(RepositoryLockMode mode, const Models::Repository* repo,
+                                         const QString& password)
+{
+    if (m_cancelled || !repo || mode == RepositoryLockMode::None
+        || !RepositoryLockCoordinator::isLockConflict(m_currentError)) {
+        return false;
+    }
+
+    // 应用内的任务已由协调器排好队，挡住命令的锁来自其他进程或崩溃后的遗留
+    if (!RepositoryLockCoordinator::instance()->clearStaleLocks(*repo, password)) {
+        return false;
+    }
+
+    Utils::Logger::instance()->log(Utils::Logger::Info, "已清除失效的仓库锁，重新执行命令");
+    return true;
+}
+
+bool ResticWrapper::runCommandStreaming(const QStringList& args, const QString& password,
+                                        const Models::Repository* repo,
+                                        const LineHandler& onLine)
+{
+    Utils::TraceSpan span("restic", "process");
+    span.setDetail(args.join(' '));
+
+    // 标准输出不累积到 m_currentOutput，逐行交给调用者处理
+    if (!startProcess(args, !password.isEmpty(), password, repo, false)) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray pending;
+    bool firstByteSeen = false;
+
+    for (;;) {
+        const bool running = m_process->state() != QProcess::NotRunning;
+        if (running) {
+            m_process->waitForReadyRead(1000);
+        }
+
+        const QByteArray chunk = m_process->readAllStandardOutput();
+        if (!firstByteSeen && !chunk.isEmpty()) {
+            firstByteSeen = true;
+            Utils::Tracer::instance()->instant("first-byte", "process");
+        }
+        pending += chunk;
+        int start = 0;
+        for (int newline = pending.indexOf('\n'); newline >= 0; newline = pending.indexOf('\n', start)) {
+            if (newline > start) {
+                onLine(pending.mid(start, newline - start));
+            }
+            start = newline + 1;
+        }
+        pending.remove(0, start);
+
+        if (!running) {
+            break;
+        }
+
+        // 与 executeCommand 相同的 1 小时上限
+        if (timer.elapsed() > 3600000) {
+            QString error = "命令执行超时";
+            Utils::Logger::instance()->log(Utils::Logger::Error, error);
+            emit commandError(error);
+            m_process->kill();
+            m_process->waitForFinished(3000);
+            return false;
+        }
+    }
+
+    if (!pending.trimmed().isEmpty()) {
+        onLine(pending);
+    }
+
+    if (m_cancelled || m_process->exitStatus() != QProcess::NormalExit) {
+        return false;
+    }
+
+    int exitCode = m_process->exitCode();
+    Utils::Tracer::instance()->instant("exit", "process", QString::number(exitCode));
+    Utils::Logger::LogContext context;
+    context.repoId = repo ? repo->id : -1;
+    context.durationMs = timer.elapsed();
+    Utils::Logger::instance()->log(Utils::Logger::Debug,
+        QString("命令 %1 完成，退出码: %2").arg(args.value(0)).arg(exitCode), context);
+    recordCommandMetrics(args, exitCode, context.durationMs);
+
+    emit commandFinished(exitCode, QString());
+
+    if (exitCode != 0) {
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("命令执行失败: %1").arg(m_currentError));
+        return false;
+    }
+
+    return true;
+}
+
+bool ResticWrapper::startProcess(const QStringList& args, bool usePassword, const QString& password,
+                                 const Models::Repository* repo, bool captureOutput)
+{
+    TRACE_SCOPE_CAT("ResticWrapper::startProcess", "process");
 
     // 检查 restic 可执行文件是否存在
     if (m_resticPath.isEmpty()) {
@@ -498,12 +1226,6 @@ bool ResticWrapper::executeCommand(const QStringList& args, QString& output,
         return false;
     }
 
-    // 创建进程
-    if (m_process) {
-        delete m_process;
-    }
-    m_process = new QProcess(this);
-
     // 设置环境变量
     QProcessEnvironment env;
     if (repo) {
@@ -516,59 +1238,52 @@ bool ResticWrapper::executeCommand(const QStringList& args, QString& output,
             env.insert("RESTIC_PASSWORD", password);
         }
     }
-    m_process->setProcessEnvironment(env);
-
-    // 连接信号
-    connect(m_process, &QProcess::readyReadStandardOutput,
-            this, &ResticWrapper::onReadyReadStandardOutput);
-    connect(m_process, &QProcess::readyReadStandardError,
-            this, &ResticWrapper::onReadyReadStandardError);
-
-    // 启动进程
-    m_currentOutput.clear();
-    m_currentError.clear();
 
     QString command = m_resticPath + " " + args.join(" ");
     Utils::Logger::instance()->log(Utils::Logger::Debug,
         QString("执行命令: %1").arg(command));
 
-    emit commandStarted(command);
-
-    m_process->start(m_resticPath, args);
-
-    if (!m_process->waitForStarted()) {
-        QString error = m_process->errorString();
-        Utils::Logger::instance()->log(Utils::Logger::Error,
-            QString("无法启动restic: %1").arg(error));
-        emit commandError(error);
-        return false;
-    }
+    // 创建和启动进程与其他线程的 cancel() 互斥：取消要么在启动前被看到，
+    // 要么能结束已启动的进程；信号在锁外发出，槽函数中可以调用 cancel()
+    QString error;
+    {
+        QMutexLocker locker(&m_processMutex);
+        if (m_cancelled) {
+            return false;
+        }
 
-    // 等待进程完成（最长等待时间：1小时）
-    if (!m_process->waitForFinished(3600000)) {
-        if (!m_cancelled) {
-            QString error = "命令执行超时";
-            Utils::Logger::instance()->log(Utils::Logger::Error, error);
-            emit commandError(error);
-            m_process->kill();
+        if (m_process) {
+            delete m_process;
         }
-        return false;
-    }
+        m_process = new QProcess(this);
+        m_process->setProcessEnvironment(env);
 
-    int exitCode = m_process->exitCode();
-    output = m_currentOutput;
+        // 连接信号
+        if (captureOutput) {
+            connect(m_process, &QProcess::readyReadStandardOutput,
+                    this, &ResticWrapper::onReadyReadStandardOutput);
+        }
+        connect(m_process, &QProcess::readyReadStandardError,
+                this, &ResticWrapper::onReadyReadStandardError);
 
-    Utils::Logger::instance()->log(Utils::Logger::Debug,
-        QString("命令完成，退出码: %1").arg(exitCode));
+        // 启动进程
+        m_currentOutput.clear();
+        m_currentError.clear();
 
-    emit commandFinished(exitCode, output);
+        m_process->start(m_resticPath, args);
+        if (!m_process->waitForStarted()) {
+            error = m_process->errorString();
+        }
+    }
 
-    if (exitCode != 0) {
+    if (!error.isEmpty()) {
         Utils::Logger::instance()->log(Utils::Logger::Error,
-            QString("命令执行失败: %1").arg(m_currentError));
+            QString("无法启动restic: %1").arg(error));
+        emit commandError(error);
         return false;
     }
 
+    emit commandStarted(command);
     return true;
 }
 
@@ -615,6 +1330,8 @@ QProcessEnvironment ResticWrapper::buildEnvironment(const Models::Repository& re
 
 QVariant ResticWrapper::parseJsonOutput(const QString& output)
 {
+    TRACE_SCOPE_CAT("ResticWrapper::parseJsonOutput", "parse");
+
     QJsonParseError error;
     QJsonDocument doc = QJsonDocument::fromJson(output.toUtf8(), &error);
 
@@ -635,6 +1352,8 @@ QVariant ResticWrapper::parseJsonOutput(const QString& output)
 
 QList<Models::Snapshot> ResticWrapper::parseSnapshotsJson(const QString& json)
 {
+    TRACE_SCOPE_CAT("ResticWrapper::parseSnapshotsJson", "parse");
+
     QList<Models::Snapshot> snapshots;
 
     QJsonParseError error;
@@ -680,13 +1399,18 @@ QList<Models::Snapshot> ResticWrapper::parseSnapshotsJson(const QString& json)
 
 QList<Models::FileInfo> ResticWrapper::parseFilesJson(const QString& json)
 {
+    TRACE_SCOPE_CAT("ResticWrapper::parseFilesJson", "parse");
+
     QList<Models::FileInfo> files;
 
     // 解析ls命令的JSON输出
     // restic ls输出是每行一个JSON对象
     QStringList lines = json.split('\n', Qt::SkipEmptyParts);
 
-    Utils::Logger::instance()->log(Utils::Logger::Debug,
+    Utils::Logger* logger = Utils::Logger::instance();
+    const bool debugEnabled = logger->isEnabled(Utils::Logger::Debug);
+
+    logger->log(Utils::Logger::Debug,
         QString("parseFilesJson: 共 %1 行JSON数据").arg(lines.size()));
 
     for (const QString& line : lines) {
@@ -694,50 +1418,218 @@ QList<Models::FileInfo> ResticWrapper::parseFilesJson(const QString& json)
         QJsonDocument doc = QJsonDocument::fromJson(line.toUtf8(), &error);
 
         if (error.error != QJsonParseError::NoError || !doc.isObject()) {
-            Utils::Logger::instance()->log(Utils::Logger::Debug,
-                QString("JSON解析失败: %1").arg(error.errorString()));
+            if (debugEnabled) {
+                logger->log(Utils::Logger::Debug,
+                    QString("JSON解析失败: %1").arg(error.errorString()));
+            }
             continue;
         }
 
-        QJsonObject obj = doc.object();
-        Models::FileInfo file;
+        Models::FileInfo file = parseFileJson(doc.object());
 
-        file.name = obj["name"].toString();
-        file.path = obj["path"].toString();
-
-        // 解析类型
-        QString typeStr = obj["type"].toString();
-        if (typeStr == "dir") {
-            file.type = Models::FileType::Directory;
-        } else if (typeStr == "symlink") {
-            file.type = Models::FileType::Symlink;
-        } else {
-            file.type = Models::FileType::File;
+        // 每个文件一条日志，先判断级别，避免关闭调试日志时仍然格式化
+        if (debugEnabled) {
+            logger->log(Utils::Logger::Debug,
+                QString("解析文件: name=%1, type=%2, path=%3")
+                    .arg(file.name).arg(static_cast<int>(file.type)).arg(file.path));
         }
 
-        file.size = obj["size"].toVariant().toLongLong();
-        file.mode = QString::number(obj["mode"].toInt(), 8); // 转换为八进制字符串
-        file.mtime = QDateTime::fromString(obj["mtime"].toString(), Qt::ISODate);
-        file.uid = obj["uid"].toInt();
-        file.gid = obj["gid"].toInt();
-        file.user = obj["user"].toString();
-        file.group = obj["group"].toString();
+        files.append(file);
+    }
 
-        Utils::Logger::instance()->log(Utils::Logger::Debug,
-            QString("解析文件: name=%1, type=%2, path=%3")
-                .arg(file.name).arg(typeStr).arg(file.path));
+    logger->log(Utils::Logger::Debug,
+        QString("parseFilesJson: 成功解析 %1 个文件").arg(files.size()));
 
-        files.append(file);
+    return files;
+}
+
+QList<Models::FileInfo> ResticWrapper::parseNcduJson(const QString& json)
+{
+    TRACE_SCOPE_CAT("ResticWrapper::parseNcduJson", "parse");
+
+    QList<Models::FileInfo> files;
+
+    // [1, 2, {元信息}, [{根目录}, 子项...]]：目录是以自身信息开头的数组，其他条目是对象
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8(), &error);
+    if (error.error != QJsonParseError::NoError || !doc.isArray()
+        || doc.array().size() < 4 || !doc.array().at(3).isArray()) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("ncdu 格式文件列表解析失败: %1").arg(error.errorString()));
+        return files;
     }
 
+    auto parseNode = [](const QJsonObject& obj, const QString& parentPath) {
+        Models::FileInfo file;
+        file.name = obj["name"].toString();
+        file.path = (parentPath == "/" ? QString() : parentPath) + "/" + file.name;
+        file.size = obj["asize"].toVariant().toLongLong();
+        file.mode = QString::number(obj["mode"].toVariant().toLongLong() & 07777, 8);
+        file.mtime = QDateTime::fromSecsSinceEpoch(obj["mtime"].toVariant().toLongLong());
+        file.uid = obj["uid"].toInt();
+        file.gid = obj["gid"].toInt();
+        return file;
+    };
+
+    // 与 ls --json 相同按先序输出，父目录在子项之前
+    std::function<void(const QJsonArray&, const QString&)> walk =
+        [&](const QJsonArray& dir, const QString& dirPath) {
+        for (int i = 1; i < dir.size(); ++i) {
+            const QJsonValue child = dir.at(i);
+            if (child.isArray()) {
+                const QJsonArray childDir = child.toArray();
+                Models::FileInfo file = parseNode(childDir.at(0).toObject(), dirPath);
+                file.type = Models::FileType::Directory;
+                file.size = 0;
+                files.append(file);
+                walk(childDir, file.path);
+            } else if (child.isObject()) {
+                const QJsonObject obj = child.toObject();
+                Models::FileInfo file = parseNode(obj, dirPath);
+                // 非普通文件带 notreg 标记（符号链接、设备、管道、套接字等）；mode 不一定带
+                // st_mode 的类型位，只有能确认是符号链接时才标为链接，其余都归为其他类型
+                if (!obj["notreg"].toBool()) {
+                    file.type = Models::FileType::File;
+                } else if ((obj["mode"].toVariant().toLongLong() & 0170000) == 0120000) {
+                    file.type = Models::FileType::Symlink;
+                } else {
+                    file.type = Models::FileType::Other;
+                }
+                files.append(file);
+            }
+        }
+    };
+    walk(doc.array().at(3).toArray(), "/");
+
     Utils::Logger::instance()->log(Utils::Logger::Debug,
-        QString("parseFilesJson: 成功解析 %1 个文件").arg(files.size()));
+        QString("parseNcduJson: 成功解析 %1 个文件").arg(files.size()));
 
     return files;
 }
 
+bool ResticWrapper::parseForgetJson(const QString& output, int& kept, int& removed)
+{
+    TRACE_SCOPE_CAT("ResticWrapper::parseForgetJson", "parse");
+
+    // 每个分组一项 {"host": ..., "keep": [...], "remove": [...]}，后面可能跟着 prune 的文本输出
+    for (const QString& line : output.split('\n', Qt::SkipEmptyParts)) {
+        if (!line.startsWith('[')) {
+            continue;
+        }
+        QJsonDocument doc = QJsonDocument::fromJson(line.toUtf8());
+        if (!doc.isArray()) {
+            continue;
+        }
+
+        kept = 0;
+        removed = 0;
+        for (const QJsonValue& group : doc.array()) {
+            const QJsonObject obj = group.toObject();
+            kept += obj["keep"].toArray().size();
+            removed += obj["remove"].toArray().size();
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool ResticWrapper::parsePruneStats(const QString& output, Models::PruneStats& stats)
+{
+    TRACE_SCOPE_CAT("ResticWrapper::parsePruneStats", "parse");
+
+    // 形如 "to repack:        120 blobs / 1.012 GiB"，大小由 restic 格式化为 B/KiB/MiB/GiB/TiB
+    static const QRegularExpression statRe(
+        "^\\s*(to repack|this removes|to delete|total prune|remaining):\\s+\\d+ blobs / ([\\d.]+) ([KMGT]i)?B\\s*$");
+    static const QRegularExpression unusedRe(
+        "^\\s*unused size after prune: ([\\d.]+) ([KMGT]i)?B");
+    static const QRegularExpression removeRe("remove (\\d+) snapshots?");
+
+    auto toBytes = [](const QString& number, const QString& unit) {
+        static const QString units = "KMGT";
+        double value = number.toDouble();
+        if (!unit.isEmpty()) {
+            for (int i = 0; i <= units.indexOf(unit.at(0)); ++i) {
+                value *= 1024;
+            }
+        }
+        return static_cast<qint64>(value);
+    };
+
+    bool found = false;
+    for (const QString& line : output.split('\n', Qt::SkipEmptyParts)) {
+        QRegularExpressionMatch match = statRe.match(line);
+        if (match.hasMatch()) {
+            const QString key = match.captured(1);
+            const qint64 bytes = toBytes(match.captured(2), match.captured(3));
+            if (key == "to repack") {
+                stats.repackBytes = bytes;
+            } else if (key == "this removes") {
+                stats.repackRemovedBytes = bytes;
+            } else if (key == "to delete") {
+                stats.deleteBytes = bytes;
+            } else if (key == "total prune") {
+                stats.reclaimedBytes = bytes;
+            } else {
+                stats.remainingBytes = bytes;
+            }
+            found = true;
+            continue;
+        }
+
+        match = unusedRe.match(line);
+        if (match.hasMatch()) {
+            stats.unusedAfterBytes = toBytes(match.captured(1), match.captured(2));
+            continue;
+        }
+
+        match = removeRe.match(line);
+        if (match.hasMatch()) {
+            stats.removedSnapshots += match.captured(1).toInt();
+        }
+    }
+
+    stats.valid = found;
+    return found;
+}
+
+Models::FileInfo ResticWrapper::parseFileJson(const QJsonObject& obj)
+{
+    Models::FileInfo file;
+
+    file.name = obj["name"].toString();
+    file.path = obj["path"].toString();
+    if (file.name.isEmpty()) {
+        // restic find 的匹配项不带 name 字段
+        file.name = file.path.mid(file.path.lastIndexOf('/') + 1);
+    }
+
+    // 解析类型
+    QString typeStr = obj["type"].toString();
+    if (typeStr == "dir") {
+        file.type = Models::FileType::Directory;
+    } else if (typeStr == "symlink") {
+        file.type = Models::FileType::Symlink;
+    } else {
+        file.type = Models::FileType::File;
+    }
+
+    file.size = obj["size"].toVariant().toLongLong();
+    // mode 为 Go 的 os.FileMode，目录带有超出 int 范围的类型位，只保留权限位
+    file.mode = QString::number(obj["mode"].toVariant().toLongLong() & 07777, 8); // 转换为八进制字符串
+    file.mtime = QDateTime::fromString(obj["mtime"].toString(), Qt::ISODate);
+    file.uid = obj["uid"].toInt();
+    file.gid = obj["gid"].toInt();
+    file.user = obj["user"].toString();
+    file.group = obj["group"].toString();
+
+    return file;
+}
+
 Models::RepoStats ResticWrapper::parseStatsJson(const QString& json)
 {
+    TRACE_SCOPE_CAT("ResticWrapper::parseStatsJson", "parse");
+
     Models::RepoStats stats;
 
     QJsonParseError error;
@@ -758,6 +1650,8 @@ Models::RepoStats ResticWrapper::parseStatsJson(const QString& json)
 
 Models::BackupResult ResticWrapper::parseBackupResultJson(const QString& json)
 {
+    TRACE_SCOPE_CAT("ResticWrapper::parseBackupResultJson", "parse");
+
     Models::BackupResult result;
 
     // restic backup输出多行JSON，最后一行是summary
@@ -806,7 +1700,10 @@ void ResticWrapper::parseProgressJson(const QString& json)
 
     if (messageType == "status") {
         double percentDone = obj["percent_done"].toDouble();
-        quint64 bytesProcessed = obj["bytes_done"].toVariant().toULongLong();
+        // 备份为 bytes_done，恢复为 bytes_restored；跳过的已正确文件也计入完成量
+        quint64 bytesProcessed = obj.contains("bytes_restored")
+            ? obj["bytes_restored"].toVariant().toULongLong() + obj["bytes_skipped"].toVariant().toULongLong()
+            : obj["bytes_done"].toVariant().toULongLong();
         quint64 totalBytes = obj["total_bytes"].toVariant().toULongLong();
 
         emit progressUpdated(static_cast<int>(percentDone * 100), QString());
@@ -814,6 +1711,39 @@ void ResticWrapper::parseProgressJson(const QString& json)
     }
 }
 
+Models::RestoreSummary ResticWrapper::parseRestoreSummaryJson(const QString& json)
+{
+    TRACE_SCOPE_CAT("ResticWrapper::parseRestoreSummaryJson", "parse");
+
+    Models::RestoreSummary summary;
+
+    // 与备份相同，多行状态JSON后跟一行summary
+    QStringList lines = json.split('\n', Qt::SkipEmptyParts);
+
+    for (const QString& line : lines) {
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(line.toUtf8(), &error);
+
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            continue;
+        }
+
+        QJsonObject obj = doc.object();
+
+        if (obj["message_type"].toString() == "summary") {
+            summary.totalFiles = obj["total_files"].toVariant().toULongLong();
+            summary.filesRestored = obj["files_restored"].toVariant().toULongLong();
+            summary.filesSkipped = obj["files_skipped"].toVariant().toULongLong();
+            summary.filesDeleted = obj["files_deleted"].toVariant().toULongLong();
+            summary.totalBytes = obj["total_bytes"].toVariant().toULongLong();
+            summary.bytesRestored = obj["bytes_restored"].toVariant().toULongLong();
+            summary.bytesSkipped = obj["bytes_skipped"].toVariant().toULongLong();
+        }
+    }
+
+    return summary;
+}
+
 // ========== 槽函数 ==========
 
 void ResticWrapper::onReadyReadStandardOutput()
@@ -823,6 +1753,9 @@ void ResticWrapper::onReadyReadStandardOutput()
     }
 
     QString output = QString::fromUtf8(m_process->readAllStandardOutput());
+    if (m_currentOutput.isEmpty() && !output.isEmpty()) {
+        Utils::Tracer::instance()->instant("first-byte", "process");
+    }
     m_currentOutput += output;
 
     // 尝试解析进度信息
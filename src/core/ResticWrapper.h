@@ -4,13 +4,25 @@
 #include <QObject>
 #include <QProcess>
 #include <QStringList>
+#include <QJsonObject>
+#include <QTemporaryFile>
+#include <QMutex>
+#include <atomic>
+#include <functional>
 #include "../models/Repository.h"
 #include "../models/Snapshot.h"
 #include "../models/FileInfo.h"
+#include "../models/FileVersion.h"
+#include "../models/SnapshotDiff.h"
 #include "../models/BackupResult.h"
 #include "../models/BackupTask.h"
 #include "../models/RestoreOptions.h"
+#include "../models/RestoreJournal.h"
 #include "../models/RepoStats.h"
+#include "../models/RepositoryLock.h"
+#include "../models/PruneRecord.h"
+#include "ResticCapabilities.h"
+#include "RepositoryLockCoordinator.h"
 
 namespace ResticGUI {
 namespace Core {
@@ -40,10 +52,38 @@ public:
     QString getVersion();
 
     /**
-     * @brief 取消当前操作
+     * @brief 当前 restic 可执行文件支持的功能（首次调用时探测）
+     */
+    ResticFeatures features() const;
+
+    /**
+     * @brief 取消当前操作，可从其他线程调用
+     *
+     * 取消标志不会被重置：进程启动前到达的取消同样生效，之后在该包装器上
+     * 执行的命令都直接返回失败。
      */
     void cancel();
 
+    /**
+     * @brief 最近一次命令的标准错误输出
+     */
+    QString lastErrorOutput() const { return m_currentError.trimmed(); }
+
+    /**
+     * @brief 转义路径中的通配符，使其作为 restic 匹配模式时只匹配该路径本身
+     */
+    static QString escapePattern(const QString& path);
+
+    /**
+     * @brief escapePattern() 的逆操作：模式不含未转义的通配符时取得它匹配的路径
+     * @return 模式含有通配符、可能匹配多个路径时返回 false
+     */
+    static bool patternToPath(const QString& pattern, QString& path);
+
+    // 命令行中最多直接传递的包含/排除模式数和总长度，超出部分写入模式文件
+    static constexpr int MaxInlinePatterns = 256;
+    static constexpr int MaxInlinePatternChars = 16 * 1024;
+
     // ========== 仓库操作 ==========
 
     /**
@@ -63,6 +103,16 @@ public:
      */
     bool checkRepository(const Models::Repository& repo, const QString& password, bool readData = false);
 
+    /**
+     * @brief 检查仓库并读取一部分数据包（check --read-data-subset=n/N）
+     * @param repo 仓库信息
+     * @param password 仓库密码
+     * @param slice 切片序号，1..sliceCount
+     * @param sliceCount 切片总数
+     * @return 成功返回true
+     */
+    bool checkDataSubset(const Models::Repository& repo, const QString& password, int slice, int sliceCount);
+
     /**
      * @brief 修复仓库
      * @param repo 仓库信息
@@ -78,14 +128,27 @@ public:
      */
     bool unlockRepository(const Models::Repository& repo, const QString& password);
 
+    /**
+     * @brief 列出仓库中的 restic 锁（list locks + cat lock，不加锁）
+     * @param repo 仓库信息
+     * @param password 仓库密码
+     * @param locks 输出参数，锁列表（读取时已被删除的锁不包含在内）
+     * @return 成功返回true
+     */
+    bool listLocks(const Models::Repository& repo, const QString& password,
+                   QList<Models::RepositoryLock>& locks);
+
     /**
      * @brief 获取仓库统计信息
      * @param repo 仓库信息
      * @param password 仓库密码
      * @param stats 输出参数，统计信息
+     * @param mode 统计模式（--mode），为空时使用 restic 默认的 restore-size；
+     *             raw-data 统计仓库中数据包的实际大小
      * @return 成功返回true
      */
-    bool getStats(const Models::Repository& repo, const QString& password, Models::RepoStats& stats);
+    bool getStats(const Models::Repository& repo, const QString& password, Models::RepoStats& stats,
+                  const QString& mode = QString());
 
     /**
      * @brief 维护仓库（prune）
@@ -102,6 +165,29 @@ public:
                int keepLast = 0, int keepDaily = 0, int keepWeekly = 0,
                int keepMonthly = 0, int keepYearly = 0);
 
+    /**
+     * @brief 按保留策略和 prune 调优参数维护仓库（forget --prune）
+     * @param stats 不为空时返回 restic 输出的 prune 统计
+     * @return 成功返回true
+     */
+    bool prune(const Models::Repository& repo, const QString& password,
+               const Models::PruneOptions& options, Models::PruneStats* stats = nullptr);
+
+    /**
+     * @brief 试运行维护（forget --prune --dry-run），估算重新打包和释放的数据量
+     *
+     * restic 在试运行中把将被删除的快照视为已删除，统计与实际执行一致。
+     * 没有快照需要删除时 restic 不执行 prune，stats 中各项为 0。
+     * @return 成功返回true
+     */
+    bool estimatePrune(const Models::Repository& repo, const QString& password,
+                       const Models::PruneOptions& options, Models::PruneStats& stats);
+
+    /**
+     * @brief 解析 restic prune 输出的统计信息（to repack、total prune 等）
+     */
+    static bool parsePruneStats(const QString& output, Models::PruneStats& stats);
+
     // ========== 备份操作 ==========
 
     /**
@@ -152,6 +238,32 @@ public:
                   const QString& snapshotId, const QString& path,
                   QList<Models::FileInfo>& files);
 
+    /**
+     * @brief 查找路径在各快照中的版本（restic find）
+     * @param repo 仓库信息
+     * @param password 仓库密码
+     * @param path 完整路径
+     * @param snapshotIds 要查找的快照，为空则查找全部快照
+     * @param versions 输出参数，每个包含该路径的快照一项（不含快照时间）
+     * @return 成功返回true
+     */
+    bool findPath(const Models::Repository& repo, const QString& password,
+                 const QString& path, const QStringList& snapshotIds,
+                 QList<Models::FileVersion>& versions);
+
+    /**
+     * @brief 比较两个快照（restic diff），边读取输出边回调
+     * @param repo 仓库信息
+     * @param password 仓库密码
+     * @param oldSnapshotId 旧快照ID
+     * @param newSnapshotId 新快照ID
+     * @param onChange 每个变化条目的回调（restic diff 不输出文件大小，大小为 -1）
+     * @return 成功返回true
+     */
+    bool diffSnapshots(const Models::Repository& repo, const QString& password,
+                      const QString& oldSnapshotId, const QString& newSnapshotId,
+                      const std::function<void(const Models::FileChange&)>& onChange);
+
     /**
      * @brief 删除快照
      * @param repo 仓库信息
@@ -170,29 +282,44 @@ public:
      * @param password 仓库密码
      * @param snapshotId 快照ID
      * @param options 恢复选项
+     * @param summary 输出参数（可选），restic 报告的恢复/跳过统计
      * @return 成功返回true
      */
     bool restore(const Models::Repository& repo, const QString& password,
-                const QString& snapshotId, const Models::RestoreOptions& options);
+                const QString& snapshotId, const Models::RestoreOptions& options,
+                Models::RestoreSummary* summary = nullptr);
 
     // ========== 挂载操作 ==========
 
     /**
-     * @brief 挂载仓库（仅Linux/macOS）
+     * @brief 在后台启动 restic mount（仅Linux/macOS）
+     *
+     * restic mount 在卸载前不会退出，进程启动后立即返回，进程归本对象所有。
+     * 挂载就绪时标准输出出现 "Now serving the repository at"，进程结束时
+     * 发出 commandFinished。生命周期由 MountManager 管理。
      * @param repo 仓库信息
      * @param password 仓库密码
-     * @param mountPoint 挂载点
-     * @param snapshotId 快照ID（可选，为空则挂载所有快照）
-     * @return 成功返回true
+     * @param mountPoint 挂载点，快照位于其下的 ids/、snapshots/ 等目录
+     * @return 进程启动成功返回true
      */
-    bool mount(const Models::Repository& repo, const QString& password,
-              const QString& mountPoint, const QString& snapshotId = QString());
+    bool startMount(const Models::Repository& repo, const QString& password, const QString& mountPoint);
 
     /**
-     * @brief 卸载仓库
+     * @brief 当前进程是否仍在运行
+     */
+    bool isProcessRunning() const;
+
+    /**
+     * @brief 请求当前进程退出（SIGTERM），restic mount 收到后自行卸载
+     */
+    void terminate();
+
+    /**
+     * @brief 卸载挂载点（Linux 使用 fusermount -u，macOS 使用 umount）
      * @param mountPoint 挂载点
+     * @param lazy 挂载点忙时延迟卸载（仅Linux），用于程序退出时的清理
      */
-    bool umount(const QString& mountPoint);
+    static bool umount(const QString& mountPoint, bool lazy = false);
 
 signals:
     /**
@@ -245,6 +372,51 @@ private:
                        bool usePassword = false, const QString& password = QString(),
                        const Models::Repository* repo = nullptr);
 
+    /**
+     * @brief 执行一次restic命令（不协调仓库锁）
+     */
+    bool runCommand(const QStringList& args, QString& output,
+                    bool usePassword, const QString& password,
+                    const Models::Repository* repo);
+
+    typedef std::function<void(const QByteArray& line)> LineHandler;
+
+    /**
+     * @brief 执行restic命令，标准输出逐行交给回调而不在内存中累积
+     * @param args 命令参数
+     * @param password 密码
+     * @param repo 仓库信息
+     * @param onLine 每行输出的回调（在调用线程中执行）
+     * @return 成功返回true
+     */
+    bool executeCommandStreaming(const QStringList& args, const QString& password,
+                                const Models::Repository* repo, const LineHandler& onLine);
+
+    /**
+     * @brief 以流式输出执行一次restic命令（不协调仓库锁）
+     */
+    bool runCommandStreaming(const QStringList& args, const QString& password,
+                             const Models::Repository* repo, const LineHandler& onLine);
+
+    /**
+     * @brief 通过锁协调器获取命令所需的仓库锁，界面线程中不等待
+     */
+    bool acquireRepositoryLock(int repoId, RepositoryLockMode mode, const QString& job);
+
+    /**
+     * @brief 命令因仓库被锁定而失败时，按策略清除失效的锁
+     * @return 已清除、可以重试时返回true
+     */
+    bool recoverFromStaleLock(RepositoryLockMode mode, const Models::Repository* repo,
+                              const QString& password);
+
+    /**
+     * @brief 检查并启动restic进程
+     * @param captureOutput 是否把标准输出累积到 m_currentOutput
+     */
+    bool startProcess(const QStringList& args, bool usePassword, const QString& password,
+                     const Models::Repository* repo, bool captureOutput);
+
     /**
      * @brief 执行restic命令（带进度监控）
      * @param args 命令参数
@@ -273,11 +445,40 @@ private:
      */
     QList<Models::Snapshot> parseSnapshotsJson(const QString& json);
 
+    /**
+     * @brief 添加包含/排除模式参数，模式较多时写入 --include-file/--exclude-file
+     * @param option 选项名，"include" 或 "exclude"
+     * @param patterns 模式列表
+     * @param spillFile 模式文件，须保留到命令结束
+     */
+    void appendPatternArgs(QStringList& args, const QString& option, const QStringList& patterns,
+                           QTemporaryFile& spillFile);
+
     /**
      * @brief 解析文件列表JSON
      */
     QList<Models::FileInfo> parseFilesJson(const QString& json);
 
+    /**
+     * @brief 解析 ls --ncdu 输出的整棵文件树（嵌套数组，没有用户名和组名）
+     */
+    QList<Models::FileInfo> parseNcduJson(const QString& json);
+
+    /**
+     * @brief 解析 forget --json 输出，统计保留和删除的快照数
+     */
+    bool parseForgetJson(const QString& output, int& kept, int& removed);
+
+    /**
+     * @brief forget --prune 的参数（不含 --json 和 --dry-run）
+     */
+    static QStringList pruneArgs(const Models::PruneOptions& options);
+
+    /**
+     * @brief 解析单个文件节点JSON（ls 与 find 输出格式相同）
+     */
+    Models::FileInfo parseFileJson(const QJsonObject& obj);
+
     /**
      * @brief 解析统计信息JSON
      */
@@ -288,6 +489,11 @@ private:
      */
     Models::BackupResult parseBackupResultJson(const QString& json);
 
+    /**
+     * @brief 解析恢复结果JSON（summary 行）
+     */
+    Models::RestoreSummary parseRestoreSummaryJson(const QString& json);
+
     /**
      * @brief 解析进度JSON
      */
@@ -316,10 +522,11 @@ private slots:
 
 private:
     QProcess* m_process;
+    mutable QMutex m_processMutex;      // 保护 m_process 的替换与其他线程的 cancel()/terminate()
     QString m_resticPath;
     QString m_currentOutput;
     QString m_currentError;
-    bool m_cancelled;
+    std::atomic<bool> m_cancelled;
 };
 
 } // namespace Core
@@ -0,0 +1,250 @@
+#include "RestoreEstimator.h"
+#include "ResticWrapper.h"
+#include "RepositoryManager.h"
+#include "SnapshotManager.h"
+#include "SnapshotSearchIndex.h"
+#include "../data/DatabaseManager.h"
+#include "../data/PasswordManager.h"
+#include "../utils/Logger.h"
+#include <QMutexLocker>
+#include <QStorageInfo>
+#include <QFileInfo>
+#include <QDir>
+#include <QVector>
+#include <QPair>
+#include <algorithm>
+
+namespace ResticGUI {
+namespace Core {
+
+namespace {
+
+typedef QPair<int, int> EntryRange;     // [begin, end)
+
+// 把包含/排除模式映射为索引中的子树区间；子树区间要么嵌套要么不相交，嵌套的只保留最外层。
+// 每个模式用 findEntry() 按路径深度定位，与兄弟目录数量无关，勾选上万项也不会变慢
+QVector<EntryRange> resolveRanges(const SnapshotSearchIndex& index, const QStringList& patterns, bool& allFound)
+{
+    QVector<EntryRange> ranges;
+    ranges.reserve(patterns.size());
+    for (const QString& pattern : patterns) {
+        QString path;
+        const int entry = ResticWrapper::patternToPath(pattern, path) ? index.findEntry(path) : -1;
+        if (entry < 0) {
+            // 用户输入的通配符模式等无法在索引中定位
+            allFound = false;
+            continue;
+        }
+        ranges.append(qMakePair(entry, index.subtreeEnd(entry)));
+    }
+
+    std::sort(ranges.begin(), ranges.end());
+
+    QVector<EntryRange> outermost;
+    for (const EntryRange& range : ranges) {
+        if (!outermost.isEmpty() && range.first < outermost.last().second) {
+            continue;
+        }
+        outermost.append(range);
+    }
+    return outermost;
+}
+
+} // namespace
+
+RestoreEstimator::RestoreEstimator()
+    : m_wrapper(nullptr), m_cancelled(false)
+{
+}
+
+RestoreEstimate RestoreEstimator::estimate(int repoId, const QString& snapshotId,
+                                           const Models::RestoreOptions& options)
+{
+    RestoreEstimate result;
+
+    QSharedPointer<const SnapshotSearchIndex> index =
+        SnapshotManager::instance()->getSearchIndex(repoId, snapshotId);
+    if (index) {
+        result = estimateFromIndex(*index, options.includePaths, options.excludePaths);
+    }
+
+    // 索引只知道快照内容；目标中已有的文件是否会被跳过需要 restic 比对
+    const bool maySkip = options.overwritePolicy != Models::RestoreOptions::Always
+                         && QDir(options.targetPath).exists() && !QDir(options.targetPath).isEmpty();
+    if (!result.isValid() || !result.exact || maySkip) {
+        if (m_cancelled) {
+            return result;
+        }
+        runDryRun(repoId, snapshotId, options, result);
+    }
+
+    result.freeBytes = availableSpace(options.targetPath);
+    result.bytesPerSecond = historicalThroughput(repoId);
+    if (result.isValid() && result.bytesPerSecond > 0) {
+        result.estimatedSeconds = static_cast<qint64>(result.bytesToRestore() / result.bytesPerSecond);
+    }
+
+    return result;
+}
+
+void RestoreEstimator::cancel()
+{
+    m_cancelled = true;
+
+    // 包装器的取消标志不会被重置，试运行的进程尚未启动时同样生效
+    QMutexLocker locker(&m_mutex);
+    if (m_wrapper) {
+        m_wrapper->cancel();
+    }
+}
+
+bool RestoreEstimator::runDryRun(int repoId, const QString& snapshotId, const Models::RestoreOptions& options,
+                                 RestoreEstimate& estimate)
+{
+    Models::Repository repo = RepositoryManager::instance()->getRepository(repoId);
+    QString password;
+    if (repo.id < 0 || !Data::PasswordManager::instance()->getPassword(repoId, password)) {
+        return false;
+    }
+
+    Models::RestoreOptions dryRunOptions = options;
+    dryRunOptions.dryRun = true;
+
+    ResticWrapper wrapper;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_cancelled) {
+            return false;
+        }
+        m_wrapper = &wrapper;
+    }
+
+    Models::RestoreSummary summary;
+    const bool ok = wrapper.restore(repo, password, snapshotId, dryRunOptions, &summary);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_wrapper = nullptr;
+    }
+
+    // 旧版本 restic 不支持 restore --dry-run，保留索引的统计
+    if (!ok || (summary.totalFiles == 0 && summary.totalBytes == 0)) {
+        Utils::Logger::instance()->log(Utils::Logger::Debug, "恢复试运行不可用，使用索引估算");
+        return false;
+    }
+
+    estimate.totalBytes = static_cast<qint64>(summary.totalBytes);
+    estimate.fileCount = static_cast<qint64>(summary.totalFiles);
+    estimate.skippedBytes = static_cast<qint64>(summary.bytesSkipped);
+    estimate.skippedFiles = static_cast<qint64>(summary.filesSkipped);
+    estimate.exact = true;
+    estimate.fromDryRun = true;
+    return true;
+}
+
+RestoreEstimate RestoreEstimator::estimateFromIndex(const SnapshotSearchIndex& index,
+                                                    const QStringList& includes, const QStringList& excludes)
+{
+    RestoreEstimate result;
+    result.exact = true;
+
+    QVector<EntryRange> selected;
+    if (includes.isEmpty()) {
+        selected.append(qMakePair(0, index.entryCount()));
+    } else {
+        selected = resolveRanges(index, includes, result.exact);
+    }
+    const QVector<EntryRange> excluded = resolveRanges(index, excludes, result.exact);
+
+    qint64 files = 0;
+    qint64 dirs = 0;
+    qint64 bytes = 0;
+
+    // 选中区间减去其中的排除区间；排除了上级目录的选中区间整体跳过
+    int next = 0;
+    for (const EntryRange& range : selected) {
+        int cursor = range.first;
+        while (next < excluded.size() && excluded.at(next).second <= range.first) {
+            next++;
+        }
+        for (int i = next; i < excluded.size() && excluded.at(i).first < range.second; ++i) {
+            const int begin = qMax(excluded.at(i).first, cursor);
+            if (begin > cursor) {
+                index.rangeStats(cursor, begin, files, dirs, bytes);
+            }
+            cursor = qMax(cursor, excluded.at(i).second);
+        }
+        if (cursor < range.second) {
+            index.rangeStats(cursor, range.second, files, dirs, bytes);
+        }
+    }
+
+    result.totalBytes = bytes;
+    result.fileCount = files;
+    result.dirCount = dirs;
+    return result;
+}
+
+double RestoreEstimator::historicalThroughput(int repoId)
+{
+    const QList<Models::RestoreJournalEntry> journal =
+        Data::DatabaseManager::instance()->getRecentRestoreJournal(MaxHistoryEntries * 5);
+
+    // 优先使用同一仓库的记录，没有时用所有仓库的记录
+    for (int pass = 0; pass < 2; ++pass) {
+        qint64 bytes = 0;
+        qint64 seconds = 0;
+        int used = 0;
+
+        for (const Models::RestoreJournalEntry& entry : journal) {
+            if (used >= MaxHistoryEntries) {
+                break;
+            }
+            if (entry.status != Models::RestoreStatus::Completed
+                || (pass == 0 && entry.repositoryId != repoId)
+                || entry.summary.bytesRestored < static_cast<quint64>(MinHistoryBytes)) {
+                continue;
+            }
+
+            const qint64 elapsed = entry.startTime.secsTo(entry.endTime);
+            if (elapsed <= 0) {
+                continue;
+            }
+
+            bytes += static_cast<qint64>(entry.summary.bytesRestored);
+            seconds += elapsed;
+            used++;
+        }
+
+        if (seconds > 0) {
+            return static_cast<double>(bytes) / seconds;
+        }
+    }
+
+    return 0;
+}
+
+qint64 RestoreEstimator::availableSpace(const QString& targetPath)
+{
+    if (targetPath.isEmpty()) {
+        return -1;
+    }
+
+    QString path = QDir::cleanPath(QFileInfo(targetPath).absoluteFilePath());
+    while (!QFileInfo::exists(path)) {
+        const QString parent = QFileInfo(path).path();
+        if (parent == path) {
+            return -1;
+        }
+        path = parent;
+    }
+
+    QStorageInfo storage(path);
+    if (!storage.isValid() || !storage.isReady()) {
+        return -1;
+    }
+    return storage.bytesAvailable();
+}
+
+} // namespace Core
+} // namespace ResticGUI
@@ -0,0 +1,90 @@
+#ifndef RESTOREESTIMATOR_H
+#define RESTOREESTIMATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QMutex>
+#include <atomic>
+#include "../models/RestoreOptions.h"
+
+namespace ResticGUI {
+namespace Core {
+
+class ResticWrapper;
+class SnapshotSearchIndex;
+
+/**
+ * @brief 恢复前的数据量和耗时估算
+ */
+struct RestoreEstimate
+{
+    qint64 totalBytes = -1;         // 选择中文件的总大小，-1 表示未知
+    qint64 fileCount = -1;
+    qint64 dirCount = -1;
+    qint64 skippedBytes = 0;        // 目标中已正确、将被跳过的数据量（来自试运行）
+    qint64 skippedFiles = 0;
+    bool exact = false;             // 所有选择都能在快照索引中找到
+    bool fromDryRun = false;
+    qint64 freeBytes = -1;          // 目标所在磁盘的可用空间，-1 表示未知
+    double bytesPerSecond = 0;      // 历史恢复的平均吞吐量，0 表示没有记录
+    qint64 estimatedSeconds = -1;
+
+    bool isValid() const { return totalBytes >= 0; }
+    qint64 bytesToRestore() const { return qMax<qint64>(totalBytes - skippedBytes, 0); }
+    bool hasEnoughSpace() const {
+        return freeBytes < 0 || !isValid() || freeBytes >= bytesToRestore();
+    }
+};
+
+/**
+ * @brief 恢复估算器
+ *
+ * 数据量优先由快照搜索索引精确统计（包含与排除两种选择形式都支持）；
+ * 索引不可用，或目标中已有文件可能被跳过时，再用 restic restore --dry-run
+ * 取得实际需要恢复的量。耗时按恢复日志中该仓库最近几次恢复的吞吐量推算。
+ *
+ * estimate() 是阻塞调用，应在工作线程中执行；cancel() 可从其他线程调用。
+ */
+class RestoreEstimator
+{
+public:
+    RestoreEstimator();
+
+    RestoreEstimate estimate(int repoId, const QString& snapshotId, const Models::RestoreOptions& options);
+    void cancel();
+
+    /**
+     * @brief 按快照索引统计选择的文件数和大小
+     * @param includes 包含模式（restic 规则，字面路径可转义），为空时表示整个快照
+     * @param excludes 排除模式
+     */
+    static RestoreEstimate estimateFromIndex(const SnapshotSearchIndex& index,
+                                             const QStringList& includes, const QStringList& excludes);
+
+    /**
+     * @brief 最近几次已完成恢复的平均吞吐量（字节/秒），没有记录返回 0
+     */
+    static double historicalThroughput(int repoId);
+
+    /**
+     * @brief 目标路径所在磁盘的可用空间，路径不存在时取最近的已存在上级目录
+     */
+    static qint64 availableSpace(const QString& targetPath);
+
+    // 参与吞吐量统计的最少数据量，太小的恢复主要是进程启动开销
+    static constexpr qint64 MinHistoryBytes = Q_INT64_C(64) * 1024 * 1024;
+    static constexpr int MaxHistoryEntries = 10;
+
+private:
+    bool runDryRun(int repoId, const QString& snapshotId, const Models::RestoreOptions& options,
+                   RestoreEstimate& estimate);
+
+    QMutex m_mutex;                 // 保护 m_wrapper
+    ResticWrapper* m_wrapper;       // 试运行期间的 restic 包装器，用于取消
+    std::atomic<bool> m_cancelled;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // RESTOREESTIMATOR_H
@@ -1,9 +1,24 @@
 #include "RestoreManager.h"
 #include "ResticWrapper.h"
 #include "RepositoryManager.h"
+#include "SnapshotManager.h"
+#include "SnapshotSearchIndex.h"
+#include "RestorePlanner.h"
+#include "MountManager.h"
 #include "../data/PasswordManager.h"
+#include "../data/DatabaseManager.h"
 #include "../utils/Logger.h"
+#include "../utils/FileSystemUtil.h"
 #include <QMutexLocker>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QLocale>
+#include <QSet>
+#include <QDir>
+#include <QDateTime>
+#include <QtConcurrent>
+#include <QFutureWatcher>
+#include <algorithm>
 
 namespace ResticGUI {
 namespace Core {
@@ -29,6 +44,13 @@ RestoreManager::~RestoreManager() {}
 
 void RestoreManager::initialize()
 {
+    // 上次退出时仍在运行的恢复视为中断，可在恢复页面继续
+    int interrupted = Data::DatabaseManager::instance()->markInterruptedRestores();
+    if (interrupted > 0) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("发现 %1 个被中断的恢复任务").arg(interrupted));
+    }
+
     Utils::Logger::instance()->log(Utils::Logger::Info, "恢复管理器初始化完成");
 }
 
@@ -55,11 +77,79 @@ bool RestoreManager::restore(int repoId, const QString& snapshotId, const Models
     Utils::Logger::instance()->log(Utils::Logger::Info,
         QString("开始恢复，快照: %1, 目标: %2").arg(snapshotId).arg(options.targetPath));
 
-    ResticWrapper wrapper;
-    connect(&wrapper, &ResticWrapper::progressUpdated,
-            this, &RestoreManager::restoreProgress);
+    // 先写入恢复日志，进程被强制结束时记录保持运行中状态，下次启动标记为中断
+    Models::RestoreJournalEntry journal;
+    journal.repositoryId = repoId;
+    journal.snapshotId = snapshotId;
+    journal.options = options;
+    journal.status = Models::RestoreStatus::Running;
+    journal.startTime = QDateTime::currentDateTime();
+    journal.id = Data::DatabaseManager::instance()->insertRestoreJournal(journal);
+
+    // 建立索引和等待各分片都可能很久，在工作线程中执行，界面线程只接收进度和结束信号
+    QFutureWatcher<Models::RestoreJournalEntry>* watcher = new QFutureWatcher<Models::RestoreJournalEntry>(this);
+    connect(watcher, &QFutureWatcher<Models::RestoreJournalEntry>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        finishRestore(watcher->result());
+    });
+    watcher->setFuture(QtConcurrent::run([this, repo, password, journal]() {
+        return runRestore(repo, password, journal);
+    }));
+
+    return true;
+}
+
+Models::RestoreJournalEntry RestoreManager::runRestore(const Models::Repository& repo, const QString& password,
+                                                       Models::RestoreJournalEntry journal)
+{
+    const int repoId = journal.repositoryId;
+    const QString snapshotId = journal.snapshotId;
+    const Models::RestoreOptions& options = journal.options;
+
+    // 大型恢复按快照索引拆分成多个并行进程；排除形式的选择无法按包含路径拆分。
+    // --delete 只作用于各分片的包含范围，目标根目录和分片之外的多余文件不会被删除，只能单进程恢复
+    RestorePlan plan;
+    if (options.parallelJobs > 1 && options.excludePaths.isEmpty() && !options.deleteExtraneous) {
+        QSharedPointer<const SnapshotSearchIndex> index =
+            SnapshotManager::instance()->getSearchIndex(repoId, snapshotId);
+        if (index) {
+            plan = RestorePlanner::plan(*index, options.includePaths, options.parallelJobs);
+        }
+    }
+
+    bool success = false;
+    if (plan.shards.size() > 1) {
+        success = restoreParallel(repoId, repo, password, snapshotId, options, plan,
+                                  journal.summary, journal.errorMessage);
+    } else {
+        ResticWrapper wrapper;
+        connect(&wrapper, &ResticWrapper::progressUpdated,
+                this, &RestoreManager::restoreProgress);
+
+        success = wrapper.restore(repo, password, snapshotId, options, &journal.summary);
+        if (!success) {
+            journal.errorMessage = wrapper.lastErrorOutput();
+        }
+    }
+
+    journal.status = success ? Models::RestoreStatus::Completed : Models::RestoreStatus::Failed;
+    journal.endTime = QDateTime::currentDateTime();
+    return journal;
+}
+
+void RestoreManager::finishRestore(const Models::RestoreJournalEntry& journal)
+{
+    const bool success = journal.status == Models::RestoreStatus::Completed;
+    if (journal.id >= 0) {
+        Data::DatabaseManager::instance()->updateRestoreJournal(journal);
+    }
 
-    bool success = wrapper.restore(repo, password, snapshotId, options);
+    if (journal.summary.filesSkipped > 0) {
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("跳过 %1 个已存在且未变化的文件（%2）")
+                .arg(journal.summary.filesSkipped)
+                .arg(QLocale().formattedDataSize(journal.summary.bytesSkipped)));
+    }
 
     m_running = false;
     emit restoreFinished(success);
@@ -69,33 +159,194 @@ bool RestoreManager::restore(int repoId, const QString& snapshotId, const Models
     } else {
         Utils::Logger::instance()->log(Utils::Logger::Error, "恢复失败");
     }
+}
+
+bool RestoreManager::restoreParallel(int repoId, const Models::Repository& repo, const QString& password,
+                                     const QString& snapshotId, const Models::RestoreOptions& options,
+                                     const RestorePlan& plan, Models::RestoreSummary& summary,
+                                     QString& errorMessage)
+{
+    const int shardCount = plan.shards.size();
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("并行恢复: %1 个进程，共 %2，拆分了 %3 个目录")
+            .arg(shardCount).arg(QLocale().formattedDataSize(plan.totalBytes))
+            .arg(plan.splitDirectories.size()));
+
+    // 各进程的进度，restic 报告总量之前用计划中的字节数
+    QMutex progressMutex;
+    QVector<qint64> bytesDone(shardCount, 0);
+    QVector<qint64> bytesTotal(shardCount, 0);
+    for (int i = 0; i < shardCount; ++i) {
+        bytesTotal[i] = plan.shards.at(i).bytes;
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    qint64 lastReport = -1;
+
+    auto reportProgress = [&]() {
+        // 调用前应已锁定 progressMutex；最多每 500 ms 报告一次
+        if (lastReport >= 0 && elapsed.elapsed() - lastReport < 500) {
+            return;
+        }
+        lastReport = elapsed.elapsed();
+
+        qint64 done = 0;
+        qint64 total = 0;
+        for (int i = 0; i < shardCount; ++i) {
+            done += bytesDone.at(i);
+            total += bytesTotal.at(i);
+        }
+
+        const int percent = total > 0 ? static_cast<int>(done * 100 / total) : 0;
+        const qint64 throughput = lastReport > 0 ? done * 1000 / lastReport : 0;
+        emit restoreProgress(qMin(percent, 100),
+            tr("已恢复 %1 / %2，%3/s（%4 个进程）")
+                .arg(QLocale().formattedDataSize(done))
+                .arg(QLocale().formattedDataSize(total))
+                .arg(QLocale().formattedDataSize(throughput))
+                .arg(shardCount));
+    };
+
+    // 独立的线程池，避免占满全局线程池
+    QThreadPool pool;
+    pool.setMaxThreadCount(shardCount);
+
+    QList<QFuture<bool>> futures;
+    for (int i = 0; i < shardCount; ++i) {
+        Models::RestoreOptions shardOptions = options;
+        shardOptions.includePaths = plan.shards.at(i).includePaths;
+        shardOptions.parallelJobs = 1;
+
+        futures.append(QtConcurrent::run(&pool, [&, i, shardOptions]() {
+            ResticWrapper wrapper;
+            QObject::connect(&wrapper, &ResticWrapper::backupProgress,
+                [&, i](quint64, quint64 bytesProcessed, quint64, quint64 totalBytes) {
+                    QMutexLocker locker(&progressMutex);
+                    bytesDone[i] = static_cast<qint64>(bytesProcessed);
+                    if (totalBytes > 0) {
+                        bytesTotal[i] = static_cast<qint64>(totalBytes);
+                    }
+                    reportProgress();
+                });
+
+            Models::RestoreSummary shardSummary;
+            const bool ok = wrapper.restore(repo, password, snapshotId, shardOptions, &shardSummary);
+            {
+                QMutexLocker locker(&progressMutex);
+                summary += shardSummary;
+                if (!ok && errorMessage.isEmpty()) {
+                    errorMessage = wrapper.lastErrorOutput();
+                }
+            }
+            Utils::Logger::instance()->log(ok ? Utils::Logger::Info : Utils::Logger::Error,
+                QString("恢复分片 %1/%2 %3，%4 个路径")
+                    .arg(i + 1).arg(shardCount).arg(ok ? "完成" : "失败")
+                    .arg(shardOptions.includePaths.size()));
+            return ok;
+        }));
+    }
+
+    bool success = true;
+    for (QFuture<bool>& future : futures) {
+        future.waitForFinished();
+        success = success && future.result();
+    }
+
+    if (success) {
+        restoreSplitDirectories(repoId, snapshotId, options.targetPath, plan.splitDirectories);
+    }
+
+    const qint64 seconds = qMax<qint64>(elapsed.elapsed() / 1000, 1);
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("并行恢复结束，耗时 %1 秒，平均 %2/s")
+            .arg(seconds).arg(QLocale().formattedDataSize(plan.totalBytes / seconds)));
 
     return success;
 }
 
-void RestoreManager::cancelRestore()
+void RestoreManager::restoreSplitDirectories(int repoId, const QString& snapshotId, const QString& targetPath,
+                                             const QStringList& directories)
 {
-    Utils::Logger::instance()->log(Utils::Logger::Warning, "取消恢复");
-    // TODO: 实现取消功能
+    if (directories.isEmpty()) {
+        return;
+    }
+
+    // 被拆分的目录在各分片中只作为父目录创建，按快照中的记录补上其元数据
+    const QSet<QString> wanted(directories.begin(), directories.end());
+    QList<Models::FileInfo> dirInfos;
+    for (const Models::FileInfo& file : SnapshotManager::instance()->listFiles(repoId, snapshotId, QString())) {
+        if (file.type == Models::FileType::Directory && wanted.contains(file.path)) {
+            dirInfos.append(file);
+        }
+    }
+
+    // 先处理深层目录，父目录的修改时间最后设置
+    std::sort(dirInfos.begin(), dirInfos.end(), [](const Models::FileInfo& a, const Models::FileInfo& b) {
+        return a.path.count('/') > b.path.count('/');
+    });
+
+    int failed = 0;
+    for (const Models::FileInfo& dir : dirInfos) {
+        const QString localPath = QDir::cleanPath(targetPath + "/" + dir.path);
+        if (!Utils::FileSystemUtil::restoreDirectoryMetadata(localPath, dir.mtime, dir.mode.toUInt(nullptr, 8),
+                                                             dir.uid, dir.gid)) {
+            failed++;
+        }
+    }
+
+    if (failed > 0) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("%1 个拆分目录的元数据恢复失败").arg(failed));
+    }
 }
 
-bool RestoreManager::mountRepository(int repoId, const QString& mountPoint, const QString& snapshotId)
+bool RestoreManager::resumeRestore(int journalId)
 {
-    Models::Repository repo = RepositoryManager::instance()->getRepository(repoId);
-    QString password;
+    Models::RestoreJournalEntry entry = Data::DatabaseManager::instance()->getRestoreJournal(journalId);
+    if (entry.id < 0) {
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("恢复日志不存在: %1").arg(journalId));
+        return false;
+    }
 
-    if (!Data::PasswordManager::instance()->getPassword(repoId, password)) {
+    if (!entry.canResume()) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("恢复日志 %1 无需继续").arg(journalId));
         return false;
     }
 
-    ResticWrapper wrapper;
-    return wrapper.mount(repo, password, mountPoint, snapshotId);
+    // 全部覆盖会重写已完成的部分；其他策略本身就不会重复传输已正确的文件
+    Models::RestoreOptions options = entry.options;
+    if (options.overwritePolicy == Models::RestoreOptions::Always) {
+        options.overwritePolicy = Models::RestoreOptions::IfChanged;
+    }
+
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("继续恢复，快照: %1, 目标: %2").arg(entry.snapshotId).arg(options.targetPath));
+
+    return restore(entry.repositoryId, entry.snapshotId, options);
+}
+
+QList<Models::RestoreJournalEntry> RestoreManager::getRestoreJournal(int limit)
+{
+    return Data::DatabaseManager::instance()->getRecentRestoreJournal(limit);
+}
+
+void RestoreManager::cancelRestore()
+{
+    Utils::Logger::instance()->log(Utils::Logger::Warning, "取消恢复");
+    // TODO: 实现取消功能
+}
+
+bool RestoreManager::mountRepository(int repoId, const QString& mountPoint)
+{
+    return MountManager::instance()->mount(repoId, mountPoint) >= 0;
 }
 
 bool RestoreManager::unmountRepository(const QString& mountPoint)
 {
-    ResticWrapper wrapper;
-    return wrapper.umount(mountPoint);
+    return MountManager::instance()->unmountPath(mountPoint);
 }
 
 } // namespace Core
@@ -4,10 +4,14 @@
 #include <QObject>
 #include <QMutex>
 #include "../models/RestoreOptions.h"
+#include "../models/RestoreJournal.h"
+#include "../models/Repository.h"
 
 namespace ResticGUI {
 namespace Core {
 
+struct RestorePlan;
+
 class RestoreManager : public QObject
 {
     Q_OBJECT
@@ -16,12 +20,28 @@ public:
     static RestoreManager* instance();
     void initialize();
 
-    // 恢复操作
+    /**
+     * @brief 在后台开始恢复（options.parallelJobs > 1 时按计划拆分为多个并行进程）
+     *
+     * 返回 true 表示已开始，结束时发出 restoreFinished；进度通过 restoreProgress 发出。
+     * 须在界面线程调用。
+     */
     bool restore(int repoId, const QString& snapshotId, const Models::RestoreOptions& options);
     void cancelRestore();
 
-    // 挂载操作（仅Linux/macOS）
-    bool mountRepository(int repoId, const QString& mountPoint, const QString& snapshotId = QString());
+    /**
+     * @brief 继续被中断或失败的恢复
+     *
+     * 按日志中的原选项重新运行，覆盖策略改为“有变化才覆盖”，
+     * 目标中已恢复完整的文件由 restic 跳过，只传输剩余部分。与 restore() 一样在后台执行。
+     */
+    bool resumeRestore(int journalId);
+
+    // 最近的恢复日志
+    QList<Models::RestoreJournalEntry> getRestoreJournal(int limit = 20);
+
+    // 挂载操作（仅Linux/macOS），由 MountManager 在后台管理 restic mount 进程
+    bool mountRepository(int repoId, const QString& mountPoint);
     bool unmountRepository(const QString& mountPoint);
 
 signals:
@@ -36,10 +56,34 @@ private:
     RestoreManager(const RestoreManager&) = delete;
     RestoreManager& operator=(const RestoreManager&) = delete;
 
+    /**
+     * @brief 规划并执行恢复（在工作线程中运行），返回填好状态和摘要的日志
+     */
+    Models::RestoreJournalEntry runRestore(const Models::Repository& repo, const QString& password,
+                                           Models::RestoreJournalEntry journal);
+
+    /**
+     * @brief 恢复结束后在界面线程中更新日志并发出 restoreFinished
+     */
+    void finishRestore(const Models::RestoreJournalEntry& journal);
+
+    /**
+     * @brief 按计划并行运行多个 restic restore，合并进度
+     */
+    bool restoreParallel(int repoId, const Models::Repository& repo, const QString& password,
+                         const QString& snapshotId, const Models::RestoreOptions& options,
+                         const RestorePlan& plan, Models::RestoreSummary& summary, QString& errorMessage);
+
+    /**
+     * @brief 恢复被拆分目录自身的元数据（各分片只恢复了其子项）
+     */
+    void restoreSplitDirectories(int repoId, const QString& snapshotId, const QString& targetPath,
+                                 const QStringList& directories);
+
     static RestoreManager* s_instance;
     static QMutex s_instanceMutex;
     mutable QMutex m_mutex;
-    bool m_running;
+    bool m_running;             // 只在界面线程访问
 };
 
 } // namespace Core
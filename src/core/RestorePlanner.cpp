@@ -0,0 +1,139 @@
+#include "RestorePlanner.h"
+#include "SnapshotSearchIndex.h"
+#include "ResticWrapper.h"
+#include <QVector>
+#include <algorithm>
+
+namespace ResticGUI {
+namespace Core {
+
+namespace {
+
+struct PlanUnit
+{
+    int entry;
+    qint64 bytes;
+    bool splittable;
+};
+
+RestorePlan singleShard(const QStringList& includePaths, qint64 totalBytes)
+{
+    RestorePlan plan;
+    RestoreShard shard;
+    shard.includePaths = includePaths;
+    shard.bytes = totalBytes;
+    plan.shards.append(shard);
+    plan.totalBytes = totalBytes;
+    return plan;
+}
+
+} // namespace
+
+RestorePlan RestorePlanner::plan(const SnapshotSearchIndex& index, const QStringList& includePaths, int maxShards)
+{
+    QVector<PlanUnit> units;
+
+    if (includePaths.isEmpty()) {
+        // 恢复整个快照：从顶层条目开始
+        for (int entry : index.childEntries(-1)) {
+            units.append({entry, index.subtreeSize(entry), true});
+        }
+    } else {
+        // 包含路径是 restic 模式（勾选的路径已转义），按其匹配的路径在索引中定位
+        QVector<int> selected;
+        for (const QString& pattern : includePaths) {
+            QString path;
+            const int entry = ResticWrapper::patternToPath(pattern, path) ? index.findEntry(path) : -1;
+            if (entry < 0) {
+                // 不是快照中的路径（例如手工输入的通配符模式），无法估算，按单进程恢复
+                return singleShard(includePaths, 0);
+            }
+            selected.append(entry);
+        }
+
+        // 去掉已被其他选择包含的路径，保证各分片互不重叠
+        std::sort(selected.begin(), selected.end());
+        int coveredEnd = -1;
+        for (int entry : selected) {
+            if (entry < coveredEnd) {
+                continue;
+            }
+            coveredEnd = index.subtreeEnd(entry);
+            units.append({entry, index.subtreeSize(entry), true});
+        }
+    }
+
+    qint64 totalBytes = 0;
+    for (const PlanUnit& unit : units) {
+        totalBytes += unit.bytes;
+    }
+
+    const int shardCount = static_cast<int>(qMin<qint64>(maxShards, totalBytes / MinShardBytes));
+    if (shardCount < 2) {
+        return singleShard(includePaths, totalBytes);
+    }
+
+    // 拆分最大的目录，直到每个单元都不超过目标分片大小的一半
+    const qint64 target = totalBytes / shardCount;
+    const int maxUnits = shardCount * MaxPathsPerShard;
+    QStringList splitDirectories;
+
+    for (;;) {
+        int largest = -1;
+        for (int i = 0; i < units.size(); ++i) {
+            if (units.at(i).splittable && index.isDirectory(units.at(i).entry) &&
+                (largest < 0 || units.at(i).bytes > units.at(largest).bytes)) {
+                largest = i;
+            }
+        }
+        if (largest < 0 || units.at(largest).bytes <= target / 2) {
+            break;
+        }
+
+        const QVector<int> children = index.childEntries(units.at(largest).entry);
+        if (children.isEmpty() || units.size() - 1 + children.size() > maxUnits) {
+            units[largest].splittable = false;
+            continue;
+        }
+
+        const PlanUnit parent = units.takeAt(largest);
+        splitDirectories.append(index.pathOf(parent.entry));
+        for (int child : children) {
+            units.append({child, index.subtreeSize(child), true});
+        }
+    }
+
+    // 最长处理时间优先：从大到小放入当前最小的分片
+    std::sort(units.begin(), units.end(),
+              [](const PlanUnit& a, const PlanUnit& b) { return a.bytes > b.bytes; });
+
+    QVector<RestoreShard> shards(shardCount);
+    for (const PlanUnit& unit : units) {
+        int smallest = 0;
+        for (int i = 1; i < shards.size(); ++i) {
+            if (shards.at(i).bytes < shards.at(smallest).bytes) {
+                smallest = i;
+            }
+        }
+        // 所有分片路径都在这里统一转义为模式，且只转义一次
+        shards[smallest].includePaths.append(ResticWrapper::escapePattern(index.pathOf(unit.entry)));
+        shards[smallest].bytes += unit.bytes;
+    }
+
+    RestorePlan plan;
+    for (const RestoreShard& shard : shards) {
+        if (!shard.includePaths.isEmpty()) {
+            plan.shards.append(shard);
+        }
+    }
+    if (plan.shards.size() < 2) {
+        return singleShard(includePaths, totalBytes);
+    }
+
+    plan.splitDirectories = splitDirectories;
+    plan.totalBytes = totalBytes;
+    return plan;
+}
+
+} // namespace Core
+} // namespace ResticGUI
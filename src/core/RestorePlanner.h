@@ -0,0 +1,65 @@
+#ifndef RESTOREPLANNER_H
+#define RESTOREPLANNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+namespace ResticGUI {
+namespace Core {
+
+class SnapshotSearchIndex;
+
+/**
+ * @brief 一个恢复分片：由一个 restic restore 进程恢复
+ */
+struct RestoreShard
+{
+    QStringList includePaths;
+    qint64 bytes = 0;
+};
+
+/**
+ * @brief 并行恢复计划
+ */
+struct RestorePlan
+{
+    QList<RestoreShard> shards;
+    QStringList splitDirectories;   // 被拆分的目录，各分片都不会恢复其自身的元数据
+    qint64 totalBytes = 0;
+};
+
+/**
+ * @brief 并行恢复计划器
+ *
+ * 根据快照搜索索引中的子树大小，把恢复选择拆成若干按字节数均衡的分片。
+ * 过大的目录被替换为其子项，直到最大的单元不超过每个分片目标大小的一半，
+ * 然后按最长处理时间优先（LPT）分配到各分片。各分片的包含路径互不重叠，
+ * 合起来与原选择完全相同。
+ */
+class RestorePlanner
+{
+public:
+    /**
+     * @brief 生成恢复计划
+     * @param index 快照搜索索引
+     * @param includePaths 包含模式（勾选的路径已转义），为空表示整个快照
+     * @param maxShards 最多分片数（并行进程数）
+     * @return 计划；选择较小或无法拆分时只有一个分片，包含原始路径
+     */
+    static RestorePlan plan(const SnapshotSearchIndex& index, const QStringList& includePaths, int maxShards);
+
+    // 每个分片至少的数据量，避免为小型恢复启动多个进程
+    static constexpr qint64 MinShardBytes = Q_INT64_C(1024) * 1024 * 1024;
+
+    // 每个分片最多的包含路径数，控制命令行长度
+    static constexpr int MaxPathsPerShard = 64;
+
+private:
+    RestorePlanner() = delete;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // RESTOREPLANNER_H
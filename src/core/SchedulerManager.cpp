@@ -2,7 +2,9 @@
 #include "BackupManager.h"
 #include "../data/DatabaseManager.h"
 #include "../utils/Logger.h"
+#include "../utils/Tracer.h"
 #include <QMutexLocker>
+#include <QtConcurrent>
 
 namespace ResticGUI {
 namespace Core {
@@ -38,17 +40,56 @@ void SchedulerManager::initialize()
 {
     Utils::Logger::instance()->log(Utils::Logger::Info, "调度管理器初始化中...");
 
-    // 加载所有启用的任务并计算下次运行时间
+    const QMap<int, QDateTime> nextRunTimes = loadNextRunTimes();
+    {
+        QMutexLocker locker(&m_mutex);
+        m_nextRunTimes = nextRunTimes;
+    }
+
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("调度管理器初始化完成，已加载 %1 个定时任务").arg(nextRunTimes.size()));
+    emit initialized(nextRunTimes.size());
+}
+
+void SchedulerManager::initializeAsync()
+{
+    Utils::Logger::instance()->log(Utils::Logger::Info, "调度管理器在后台加载任务...");
+
+    QtConcurrent::run([this]() {
+        const QMap<int, QDateTime> nextRunTimes = loadNextRunTimes();
+
+        // 回到调度器所在线程合并结果，加载期间更新过的任务保留新值
+        QMetaObject::invokeMethod(this, [this, nextRunTimes]() {
+            {
+                QMutexLocker locker(&m_mutex);
+                for (auto it = nextRunTimes.constBegin(); it != nextRunTimes.constEnd(); ++it) {
+                    if (!m_nextRunTimes.contains(it.key())) {
+                        m_nextRunTimes.insert(it.key(), it.value());
+                    }
+                }
+            }
+
+            Utils::Logger::instance()->log(Utils::Logger::Info,
+                QString("调度管理器初始化完成，已加载 %1 个定时任务").arg(nextRunTimes.size()));
+            emit initialized(nextRunTimes.size());
+        }, Qt::QueuedConnection);
+    });
+}
+
+QMap<int, QDateTime> SchedulerManager::loadNextRunTimes()
+{
+    TRACE_SCOPE_CAT("SchedulerManager::loadNextRunTimes", "startup");
+
+    // 启用的任务一次读出，直接用任务本身计算，不再逐个按ID查询
     QList<Models::BackupTask> tasks = Data::DatabaseManager::instance()->getEnabledBackupTasks();
-    int scheduledCount = 0;
+    QMap<int, QDateTime> nextRunTimes;
 
     for (const Models::BackupTask& task : tasks) {
         // 只加载有调度计划的任务（非手动任务）
         if (task.schedule.type != Models::Schedule::None &&
             task.schedule.type != Models::Schedule::Manual) {
-            QDateTime nextRun = calculateNextRun(task.id);
-            m_nextRunTimes[task.id] = nextRun;
-            scheduledCount++;
+            QDateTime nextRun = calculateNextRun(task);
+            nextRunTimes[task.id] = nextRun;
 
             Utils::Logger::instance()->log(Utils::Logger::Debug,
                 QString("加载任务 %1 (%2)，下次运行: %3")
@@ -58,8 +99,7 @@ void SchedulerManager::initialize()
         }
     }
 
-    Utils::Logger::instance()->log(Utils::Logger::Info,
-        QString("调度管理器初始化完成，已加载 %1 个定时任务").arg(scheduledCount));
+    return nextRunTimes;
 }
 
 void SchedulerManager::start()
@@ -131,6 +171,12 @@ void SchedulerManager::removeTask(int taskId)
     }
 }
 
+void SchedulerManager::setRunGuard(const std::function<bool()>& guard)
+{
+    QMutexLocker locker(&m_mutex);
+    m_runGuard = guard;
+}
+
 void SchedulerManager::onTimerTimeout()
 {
     checkAndRunTasks();
@@ -165,6 +211,13 @@ void SchedulerManager::checkAndRunTasks()
         m_nextRunTimes.remove(taskId);
     }
 
+    // 到期的任务由其他进程执行时保留原来的时间，接管后仍会触发
+    if (!tasksToRun.isEmpty() && m_runGuard && !m_runGuard()) {
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("%1 个到期任务交由后台服务执行").arg(tasksToRun.size()));
+        return;
+    }
+
     // 运行任务
     for (int taskId : tasksToRun) {
         Utils::Logger::instance()->log(Utils::Logger::Info,
@@ -190,7 +243,11 @@ QDateTime SchedulerManager::calculateNextRun(int taskId)
     if (task.id < 0) {
         return QDateTime();
     }
+    return calculateNextRun(task);
+}
 
+QDateTime SchedulerManager::calculateNextRun(const Models::BackupTask& task)
+{
     QDateTime now = QDateTime::currentDateTime();
     QDateTime nextRun = now;
 
@@ -5,6 +5,9 @@
 #include <QTimer>
 #include <QMutex>
 #include <QMap>
+#include <QDateTime>
+#include <functional>
+#include "../models/BackupTask.h"
 
 namespace ResticGUI {
 namespace Core {
@@ -17,6 +20,14 @@ public:
     static SchedulerManager* instance();
     void initialize();
 
+    /**
+     * @brief 在后台线程加载任务并计算下次运行时间，完成后发出 initialized()
+     *
+     * 启动时使用，避免在主窗口显示之前查询数据库。加载期间 updateTaskNextRun()
+     * 写入的时间优先于加载结果。
+     */
+    void initializeAsync();
+
     // 调度控制
     void start();
     void stop();
@@ -31,9 +42,18 @@ public:
     // 移除任务的调度
     void removeTask(int taskId);
 
+    /**
+     * @brief 设置触发到期任务前的检查，返回 false 时本进程不执行这些任务
+     *
+     * 图形界面用它在每次触发前确认计划任务没有被后台服务接管。检查在调度器
+     * 持有内部锁时调用，不能再调用调度器的方法。
+     */
+    void setRunGuard(const std::function<bool()>& guard);
+
 signals:
     void taskScheduled(int taskId, const QDateTime& nextRun);
     void taskTriggered(int taskId);
+    void initialized(int scheduledCount);
 
 private slots:
     void onTimerTimeout();
@@ -46,6 +66,12 @@ private:
     SchedulerManager& operator=(const SchedulerManager&) = delete;
 
     QDateTime calculateNextRun(int taskId);
+    static QDateTime calculateNextRun(const Models::BackupTask& task);
+
+    /**
+     * @brief 读取所有启用的定时任务并计算下次运行时间（一次查询）
+     */
+    static QMap<int, QDateTime> loadNextRunTimes();
 
     static SchedulerManager* s_instance;
     static QMutex s_instanceMutex;
@@ -53,6 +79,7 @@ private:
     QTimer* m_timer;
     QMap<int, QDateTime> m_nextRunTimes; // taskId -> nextRunTime
     bool m_running;
+    std::function<bool()> m_runGuard;
     mutable QMutex m_mutex;
 };
 
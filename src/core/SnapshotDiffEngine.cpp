@@ -0,0 +1,201 @@
+#include "SnapshotDiffEngine.h"
+#include <algorithm>
+
+namespace ResticGUI {
+namespace Core {
+
+SnapshotDiffEngine::SnapshotDiffEngine(const QString& oldSnapshotId, const QString& newSnapshotId)
+    : m_sizesComplete(true)
+{
+    m_diff.oldSnapshotId = oldSnapshotId;
+    m_diff.newSnapshotId = newSnapshotId;
+}
+
+// ========== 文件树归并 ==========
+
+int SnapshotDiffEngine::comparePaths(const QString& a, const QString& b)
+{
+    const int length = qMin(a.size(), b.size());
+    for (int i = 0; i < length; ++i) {
+        const QChar ca = a.at(i);
+        const QChar cb = b.at(i);
+        if (ca == cb) {
+            continue;
+        }
+        // 目录的子项紧跟在目录之后，先于同级的 "a-b"、"a.b" 等名称
+        if (ca == '/') {
+            return -1;
+        }
+        if (cb == '/') {
+            return 1;
+        }
+        return ca < cb ? -1 : 1;
+    }
+    return a.size() - b.size();
+}
+
+QVector<int> SnapshotDiffEngine::sortedOrder(const QList<Models::FileInfo>& files)
+{
+    QVector<int> order(files.size());
+    for (int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+
+    auto less = [&files](int x, int y) {
+        return comparePaths(files.at(x).path, files.at(y).path) < 0;
+    };
+
+    // restic ls 的输出本身就是深度优先、名称有序的，通常不需要排序
+    if (!std::is_sorted(order.begin(), order.end(), less)) {
+        std::stable_sort(order.begin(), order.end(), less);
+    }
+    return order;
+}
+
+Models::SnapshotDiff SnapshotDiffEngine::compareTrees(const QString& oldSnapshotId, const QString& newSnapshotId,
+                                                      const QList<Models::FileInfo>& oldFiles,
+                                                      const QList<Models::FileInfo>& newFiles)
+{
+    SnapshotDiffEngine engine(oldSnapshotId, newSnapshotId);
+
+    const QVector<int> oldOrder = sortedOrder(oldFiles);
+    const QVector<int> newOrder = sortedOrder(newFiles);
+
+    auto makeChange = [](const Models::FileInfo& file, Models::ChangeType change) {
+        Models::FileChange result;
+        result.path = file.path;
+        result.change = change;
+        result.type = file.type;
+        return result;
+    };
+
+    int i = 0;
+    int j = 0;
+    while (i < oldOrder.size() || j < newOrder.size()) {
+        const Models::FileInfo* oldFile = i < oldOrder.size() ? &oldFiles.at(oldOrder.at(i)) : nullptr;
+        const Models::FileInfo* newFile = j < newOrder.size() ? &newFiles.at(newOrder.at(j)) : nullptr;
+
+        // 跳过重复项
+        if (oldFile && i > 0 && oldFiles.at(oldOrder.at(i - 1)).path == oldFile->path) {
+            ++i;
+            continue;
+        }
+        if (newFile && j > 0 && newFiles.at(newOrder.at(j - 1)).path == newFile->path) {
+            ++j;
+            continue;
+        }
+
+        const int cmp = !oldFile ? 1 : !newFile ? -1 : comparePaths(oldFile->path, newFile->path);
+
+        if (cmp < 0) {
+            Models::FileChange change = makeChange(*oldFile, Models::ChangeType::Removed);
+            change.oldSize = oldFile->type == Models::FileType::Directory ? 0 : oldFile->size;
+            engine.addChange(change);
+            ++i;
+        } else if (cmp > 0) {
+            Models::FileChange change = makeChange(*newFile, Models::ChangeType::Added);
+            change.newSize = newFile->type == Models::FileType::Directory ? 0 : newFile->size;
+            engine.addChange(change);
+            ++j;
+        } else {
+            // 目录的修改时间随子项变化，只比较类型；文件比较大小和修改时间
+            const bool typeChanged = oldFile->type != newFile->type;
+            const bool isDir = newFile->type == Models::FileType::Directory;
+            if (typeChanged || (!isDir && (oldFile->size != newFile->size || oldFile->mtime != newFile->mtime))) {
+                Models::FileChange change = makeChange(*newFile, Models::ChangeType::Modified);
+                change.oldSize = oldFile->type == Models::FileType::Directory ? 0 : oldFile->size;
+                change.newSize = isDir ? 0 : newFile->size;
+                engine.addChange(change);
+            }
+            ++i;
+            ++j;
+        }
+    }
+
+    Models::SnapshotDiff diff = engine.finish();
+    diff.fromIndex = true;
+    return diff;
+}
+
+// ========== 流式累积 ==========
+
+void SnapshotDiffEngine::addChange(const Models::FileChange& change)
+{
+    if (change.type != Models::FileType::Directory &&
+        ((change.change != Models::ChangeType::Added && change.oldSize < 0) ||
+         (change.change != Models::ChangeType::Removed && change.newSize < 0))) {
+        m_sizesComplete = false;
+    }
+
+    m_diff.changes.append(change);
+    rollup(change);
+}
+
+void SnapshotDiffEngine::rollup(const Models::FileChange& change)
+{
+    const bool sizeKnown = (change.change == Models::ChangeType::Added || change.oldSize >= 0) &&
+                           (change.change == Models::ChangeType::Removed || change.newSize >= 0);
+
+    // 大小未知的变化只计数，不计入字节数
+    qint64 added = 0;
+    qint64 removed = 0;
+    if (change.type != Models::FileType::Directory && sizeKnown) {
+        const qint64 delta = change.sizeDelta();
+        if (delta > 0) {
+            added = delta;
+        } else {
+            removed = -delta;
+        }
+    }
+
+    // 祖先目录：/、/a、/a/b ...（不含条目本身）
+    QString dir = QStringLiteral("/");
+    int slash = 0;
+    for (;;) {
+        Models::DirectoryChange& summary = m_directories[dir];
+        switch (change.change) {
+        case Models::ChangeType::Added:
+            summary.added++;
+            break;
+        case Models::ChangeType::Removed:
+            summary.removed++;
+            break;
+        case Models::ChangeType::Modified:
+            summary.modified++;
+            break;
+        }
+        summary.bytesAdded += added;
+        summary.bytesRemoved += removed;
+
+        slash = change.path.indexOf('/', slash + 1);
+        if (slash < 0) {
+            break;
+        }
+        dir = change.path.left(slash);
+    }
+}
+
+Models::SnapshotDiff SnapshotDiffEngine::finish()
+{
+    m_diff.directories.clear();
+    m_diff.directories.reserve(m_directories.size());
+    for (auto it = m_directories.constBegin(); it != m_directories.constEnd(); ++it) {
+        Models::DirectoryChange summary = it.value();
+        summary.path = it.key();
+        m_diff.directories.append(summary);
+    }
+
+    std::sort(m_diff.directories.begin(), m_diff.directories.end(),
+              [](const Models::DirectoryChange& a, const Models::DirectoryChange& b) {
+                  if (a.netBytes() != b.netBytes()) {
+                      return a.netBytes() > b.netBytes();
+                  }
+                  return a.path < b.path;
+              });
+
+    m_diff.sizesComplete = m_sizesComplete;
+    return m_diff;
+}
+
+} // namespace Core
+} // namespace ResticGUI
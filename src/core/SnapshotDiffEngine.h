@@ -0,0 +1,63 @@
+#ifndef SNAPSHOTDIFFENGINE_H
+#define SNAPSHOTDIFFENGINE_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include "../models/FileInfo.h"
+#include "../models/SnapshotDiff.h"
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief 快照差异计算
+ *
+ * 两种输入方式：
+ * - compareTrees：两个快照的递归文件列表都已缓存时，按路径顺序归并比较，
+ *   得到带大小变化的完整结果
+ * - addChange/finish：逐条接收 restic diff 的流式输出
+ *
+ * 每个变化都会累加到所有祖先目录的汇总中，用于找出增长最多的目录。
+ */
+class SnapshotDiffEngine
+{
+public:
+    SnapshotDiffEngine(const QString& oldSnapshotId, const QString& newSnapshotId);
+
+    /**
+     * @brief 归并比较两个递归文件列表
+     */
+    static Models::SnapshotDiff compareTrees(const QString& oldSnapshotId, const QString& newSnapshotId,
+                                             const QList<Models::FileInfo>& oldFiles,
+                                             const QList<Models::FileInfo>& newFiles);
+
+    /**
+     * @brief 按 restic 的遍历顺序比较路径（'/' 排在其他字符之前）
+     * @return 小于 0 表示 a 在前
+     */
+    static int comparePaths(const QString& a, const QString& b);
+
+    /**
+     * @brief 记录一个变化并更新目录汇总
+     */
+    void addChange(const Models::FileChange& change);
+
+    /**
+     * @brief 生成结果，目录汇总按净增长量排序
+     */
+    Models::SnapshotDiff finish();
+
+private:
+    static QVector<int> sortedOrder(const QList<Models::FileInfo>& files);
+    void rollup(const Models::FileChange& change);
+
+    Models::SnapshotDiff m_diff;
+    QHash<QString, Models::DirectoryChange> m_directories;
+    bool m_sizesComplete;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // SNAPSHOTDIFFENGINE_H
@@ -1,10 +1,14 @@
 #include "SnapshotManager.h"
+#include "SnapshotSearchIndex.h"
+#include "FileHistoryIndex.h"
+#include "SnapshotDiffEngine.h"
 #include "ResticWrapper.h"
 #include "RepositoryManager.h"
 #include "../data/CacheManager.h"
 #include "../data/PasswordManager.h"
 #include "../utils/Logger.h"
 #include <QMutexLocker>
+#include <QElapsedTimer>
 
 namespace ResticGUI {
 namespace Core {
@@ -23,7 +27,14 @@ SnapshotManager* SnapshotManager::instance()
     return s_instance;
 }
 
-SnapshotManager::SnapshotManager(QObject* parent) : QObject(parent) {}
+SnapshotManager::SnapshotManager(QObject* parent)
+    : QObject(parent)
+    , m_snapshotsFlight("snapshots")
+    , m_filesFlight("ls")
+    , m_searchIndexFlight("search-index")
+{
+}
+
 SnapshotManager::~SnapshotManager() {}
 
 void SnapshotManager::initialize()
@@ -33,8 +44,6 @@ void SnapshotManager::initialize()
 
 QList<Models::Snapshot> SnapshotManager::listSnapshots(int repoId, bool forceRefresh)
 {
-    QMutexLocker locker(&m_mutex);
-
     QList<Models::Snapshot> snapshots;
     Data::CacheManager* cache = Data::CacheManager::instance();
 
@@ -52,13 +61,38 @@ QList<Models::Snapshot> SnapshotManager::listSnapshots(int repoId, bool forceRef
         return snapshots;
     }
 
-    ResticWrapper wrapper;
-    if (wrapper.listSnapshots(repo, password, snapshots)) {
-        cache->cacheSnapshots(repoId, snapshots);
-        emit snapshotsUpdated(repoId);
+    // 多个页面同时刷新同一仓库时只运行一次 restic
+    fetchSnapshots(repo, password, snapshots);
+    return snapshots;
+}
+
+bool SnapshotManager::fetchSnapshots(const Models::Repository& repo, const QString& password,
+                                     QList<Models::Snapshot>& snapshots, QString* error)
+{
+    bool shared = false;
+    const SnapshotsFetch fetch = m_snapshotsFlight.run(QString("snapshots/%1").arg(repo.id), [&]() {
+        SnapshotsFetch result;
+        ResticWrapper wrapper;
+        result.success = wrapper.listSnapshots(repo, password, result.snapshots);
+        if (result.success) {
+            Data::CacheManager::instance()->cacheSnapshots(repo.id, result.snapshots);
+            emit snapshotsUpdated(repo.id);
+        } else {
+            result.error = wrapper.lastErrorOutput();
+        }
+        return result;
+    }, &shared);
+
+    if (shared) {
+        Utils::Logger::instance()->log(Utils::Logger::Debug,
+            QString("仓库 %1 的快照列表与进行中的查询合并").arg(repo.id));
     }
 
-    return snapshots;
+    snapshots = fetch.snapshots;
+    if (error) {
+        *error = fetch.error;
+    }
+    return fetch.success;
 }
 
 Models::Snapshot SnapshotManager::getSnapshot(int repoId, const QString& snapshotId)
@@ -89,6 +123,22 @@ bool SnapshotManager::deleteSnapshots(int repoId, const QStringList& snapshotIds
 
     if (success) {
         Data::CacheManager::instance()->clearSnapshotCache(repoId);
+        {
+            QMutexLocker locker(&m_searchIndexMutex);
+            for (const QString& id : snapshotIds) {
+                m_searchIndexes.remove(id);
+                m_searchIndexOrder.removeAll(id);
+            }
+        }
+        {
+            QMutexLocker locker(&m_historyMutex);
+            QSharedPointer<FileHistoryIndex> history = m_histories.value(repoId);
+            if (history) {
+                for (const QString& id : snapshotIds) {
+                    history->removeSnapshot(id);
+                }
+            }
+        }
         for (const QString& id : snapshotIds) {
             emit snapshotDeleted(id);
         }
@@ -114,39 +164,263 @@ QList<Models::FileInfo> SnapshotManager::listFiles(int repoId, const QString& sn
         return files;
     }
 
-    // 从restic获取
-    Models::Repository repo = RepositoryManager::instance()->getRepository(repoId);
-    QString password;
+    // 从restic获取；展开同一目录的并发请求（浏览对话框、恢复向导、预取）只运行一次 restic ls
+    const QString key = QString("ls/%1/%2/%3").arg(repoId).arg(snapshotId).arg(path);
+    files = m_filesFlight.run(key, [&]() {
+        QList<Models::FileInfo> result;
 
-    if (Data::PasswordManager::instance()->getPassword(repoId, password)) {
-        Utils::Logger::instance()->log(Utils::Logger::Debug,
-            "SnapshotManager::listFiles: 获取密码成功，准备调用ResticWrapper");
-        ResticWrapper wrapper;
-        if (wrapper.listFiles(repo, password, snapshotId, path, files)) {
+        // 等待期间上一次执行可能已经写入缓存
+        if (cache->getCachedFileTree(snapshotId, path, result)) {
+            return result;
+        }
+
+        Models::Repository repo = RepositoryManager::instance()->getRepository(repoId);
+        QString password;
+
+        if (Data::PasswordManager::instance()->getPassword(repoId, password)) {
             Utils::Logger::instance()->log(Utils::Logger::Debug,
-                QString("SnapshotManager::listFiles: ResticWrapper返回 %1 个文件").arg(files.size()));
-            cache->cacheFileTree(snapshotId, path, files);
+                "SnapshotManager::listFiles: 获取密码成功，准备调用ResticWrapper");
+            ResticWrapper wrapper;
+            if (wrapper.listFiles(repo, password, snapshotId, path, result)) {
+                Utils::Logger::instance()->log(Utils::Logger::Debug,
+                    QString("SnapshotManager::listFiles: ResticWrapper返回 %1 个文件").arg(result.size()));
+                cache->cacheFileTree(snapshotId, path, result);
+            } else {
+                Utils::Logger::instance()->log(Utils::Logger::Warning,
+                    "SnapshotManager::listFiles: ResticWrapper.listFiles失败");
+            }
         } else {
             Utils::Logger::instance()->log(Utils::Logger::Warning,
-                "SnapshotManager::listFiles: ResticWrapper.listFiles失败");
+                QString("SnapshotManager::listFiles: 无法获取仓库 %1 的密码").arg(repoId));
         }
-    } else {
-        Utils::Logger::instance()->log(Utils::Logger::Warning,
-            QString("SnapshotManager::listFiles: 无法获取仓库 %1 的密码").arg(repoId));
-    }
+        return result;
+    });
 
     Utils::Logger::instance()->log(Utils::Logger::Debug,
         QString("SnapshotManager::listFiles: 最终返回 %1 个文件").arg(files.size()));
     return files;
 }
 
-QList<Models::FileInfo> SnapshotManager::compareSnapshots(int repoId, const QString& snapshot1, const QString& snapshot2)
+QSharedPointer<const SnapshotSearchIndex> SnapshotManager::getSearchIndex(int repoId, const QString& snapshotId)
 {
-    // TODO: 实现快照比较功能
-    Q_UNUSED(repoId);
-    Q_UNUSED(snapshot1);
-    Q_UNUSED(snapshot2);
-    return QList<Models::FileInfo>();
+    {
+        QMutexLocker locker(&m_searchIndexMutex);
+        QSharedPointer<const SnapshotSearchIndex> cached = m_searchIndexes.value(snapshotId);
+        if (cached) {
+            m_searchIndexOrder.removeAll(snapshotId);
+            m_searchIndexOrder.prepend(snapshotId);
+            return cached;
+        }
+    }
+
+    // 同一快照的并发搜索只建立一次索引
+    return m_searchIndexFlight.run(QString("search-index/%1/%2").arg(repoId).arg(snapshotId),
+                                   [&]() -> QSharedPointer<const SnapshotSearchIndex> {
+        // 不指定路径时 restic ls 返回整个快照的递归列表
+        QList<Models::FileInfo> files = listFiles(repoId, snapshotId, QString());
+        if (files.isEmpty()) {
+            return QSharedPointer<const SnapshotSearchIndex>();
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QSharedPointer<SnapshotSearchIndex> index(new SnapshotSearchIndex());
+        index->build(files);
+
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("快照 %1 的搜索索引已建立，%2 个条目，耗时 %3 ms")
+                .arg(snapshotId.left(8)).arg(index->entryCount()).arg(timer.elapsed()));
+
+        QMutexLocker locker(&m_searchIndexMutex);
+        m_searchIndexes.insert(snapshotId, index);
+        m_searchIndexOrder.removeAll(snapshotId);
+        m_searchIndexOrder.prepend(snapshotId);
+        while (m_searchIndexOrder.size() > MaxCachedSearchIndexes) {
+            m_searchIndexes.remove(m_searchIndexOrder.takeLast());
+        }
+
+        return index;
+    });
+}
+
+QSharedPointer<const SnapshotSearchIndex> SnapshotManager::cachedSearchIndex(int repoId, const QString& snapshotId)
+{
+    bool indexed = false;
+    {
+        QMutexLocker locker(&m_searchIndexMutex);
+        indexed = m_searchIndexes.contains(snapshotId);
+    }
+
+    // 根目录的递归列表已缓存时，getSearchIndex() 直接用它建立索引
+    QList<Models::FileInfo> files;
+    if (!indexed && !Data::CacheManager::instance()->getCachedFileTree(snapshotId, QString(), files)) {
+        return QSharedPointer<const SnapshotSearchIndex>();
+    }
+    return getSearchIndex(repoId, snapshotId);
+}
+
+QList<Models::FileVersion> SnapshotManager::getFileVersions(int repoId, const QString& path)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<Models::Snapshot> snapshots = listSnapshots(repoId);
+    if (snapshots.isEmpty() || path.isEmpty()) {
+        return QList<Models::FileVersion>();
+    }
+
+    QList<Models::Snapshot> uncovered;
+    {
+        QMutexLocker locker(&m_historyMutex);
+        QSharedPointer<FileHistoryIndex>& history = m_histories[repoId];
+        if (!history) {
+            history.reset(new FileHistoryIndex());
+        }
+
+        syncFileHistory(*history, snapshots);
+        uncovered = history->uncoveredSnapshots(path, snapshots);
+
+        if (uncovered.isEmpty()) {
+            QList<Models::FileVersion> versions = history->versionsOf(path);
+            Utils::Logger::instance()->log(Utils::Logger::Debug,
+                QString("文件历史: %1 共 %2 个版本（索引，%3 ms）")
+                    .arg(path).arg(versions.size()).arg(timer.elapsed()));
+            return versions;
+        }
+    }
+
+    // 索引无法回答的快照用 restic find 补齐，全部未覆盖时不限定快照
+    QStringList snapshotIds;
+    if (uncovered.size() < snapshots.size()) {
+        for (const Models::Snapshot& snapshot : uncovered) {
+            snapshotIds.append(snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId);
+        }
+    }
+
+    Models::Repository repo = RepositoryManager::instance()->getRepository(repoId);
+    QString password;
+    QList<Models::FileVersion> found;
+    bool searched = false;
+
+    if (Data::PasswordManager::instance()->getPassword(repoId, password)) {
+        ResticWrapper wrapper;
+        searched = wrapper.findPath(repo, password, path, snapshotIds, found);
+    }
+
+    if (!searched) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("文件历史: restic find 查询 %1 失败，只返回已索引的版本").arg(path));
+    }
+
+    QMutexLocker locker(&m_historyMutex);
+    QSharedPointer<FileHistoryIndex> history = m_histories.value(repoId);
+    if (!history) {
+        return QList<Models::FileVersion>();
+    }
+    if (searched) {
+        history->addPathVersions(path, uncovered, found);
+    }
+
+    QList<Models::FileVersion> versions = history->versionsOf(path);
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("文件历史: %1 共 %2 个版本（restic find 查询 %3 个快照，%4 ms）")
+            .arg(path).arg(versions.size()).arg(uncovered.size()).arg(timer.elapsed()));
+    return versions;
+}
+
+void SnapshotManager::syncFileHistory(FileHistoryIndex& history, const QList<Models::Snapshot>& snapshots)
+{
+    // 注意：调用此函数前应已锁定 m_historyMutex
+    history.retainSnapshots(snapshots);
+
+    // 已缓存完整文件树（浏览或搜索过）的快照直接收录，无需再运行 restic
+    Data::CacheManager* cache = Data::CacheManager::instance();
+    for (const Models::Snapshot& snapshot : snapshots) {
+        const QString snapshotId = snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId;
+        if (history.isSnapshotIndexed(snapshotId)) {
+            continue;
+        }
+
+        QList<Models::FileInfo> files;
+        if (cache->getCachedFileTree(snapshotId, QString(), files) && !files.isEmpty()) {
+            history.addSnapshot(snapshot, files);
+            Utils::Logger::instance()->log(Utils::Logger::Debug,
+                QString("文件历史: 快照 %1 已收录，%2 个条目")
+                    .arg(snapshotId.left(8)).arg(files.size()));
+        }
+    }
+}
+
+Models::SnapshotDiff SnapshotManager::compareSnapshots(int repoId, const QString& snapshot1, const QString& snapshot2)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Data::CacheManager* cache = Data::CacheManager::instance();
+    QList<Models::FileInfo> oldFiles;
+    QList<Models::FileInfo> newFiles;
+    const bool oldCached = cache->getCachedFileTree(snapshot1, QString(), oldFiles);
+    const bool newCached = cache->getCachedFileTree(snapshot2, QString(), newFiles);
+
+    // 两棵文件树都在缓存中：按路径顺序归并比较，不运行 restic
+    if (oldCached && newCached) {
+        Models::SnapshotDiff diff = SnapshotDiffEngine::compareTrees(snapshot1, snapshot2, oldFiles, newFiles);
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("快照比较 %1 -> %2: %3 个变化（文件树归并，%4 ms）")
+                .arg(snapshot1.left(8)).arg(snapshot2.left(8))
+                .arg(diff.changes.size()).arg(timer.elapsed()));
+        return diff;
+    }
+
+    // 已缓存一侧的文件树用于补全 restic diff 缺少的大小
+    QHash<QString, qint64> oldSizes;
+    QHash<QString, qint64> newSizes;
+    for (const Models::FileInfo& file : oldFiles) {
+        oldSizes.insert(file.path, file.size);
+    }
+    for (const Models::FileInfo& file : newFiles) {
+        newSizes.insert(file.path, file.size);
+    }
+    oldFiles.clear();
+    newFiles.clear();
+
+    SnapshotDiffEngine engine(snapshot1, snapshot2);
+    Models::Repository repo = RepositoryManager::instance()->getRepository(repoId);
+    QString password;
+    bool success = false;
+
+    if (Data::PasswordManager::instance()->getPassword(repoId, password)) {
+        ResticWrapper wrapper;
+        success = wrapper.diffSnapshots(repo, password, snapshot1, snapshot2,
+            [&](Models::FileChange change) {
+                if (change.type != Models::FileType::Directory) {
+                    if (oldCached && change.change != Models::ChangeType::Added) {
+                        change.oldSize = oldSizes.value(change.path, -1);
+                    }
+                    if (newCached && change.change != Models::ChangeType::Removed) {
+                        change.newSize = newSizes.value(change.path, -1);
+                    }
+                }
+                engine.addChange(change);
+            });
+    }
+
+    if (!success) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("快照比较 %1 -> %2 失败").arg(snapshot1.left(8)).arg(snapshot2.left(8)));
+        Models::SnapshotDiff diff;
+        diff.oldSnapshotId = snapshot1;
+        diff.newSnapshotId = snapshot2;
+        return diff;
+    }
+
+    Models::SnapshotDiff diff = engine.finish();
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("快照比较 %1 -> %2: %3 个变化（restic diff，%4 ms）")
+            .arg(snapshot1.left(8)).arg(snapshot2.left(8))
+            .arg(diff.changes.size()).arg(timer.elapsed()));
+    return diff;
 }
 
 } // namespace Core
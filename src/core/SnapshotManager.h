@@ -3,12 +3,22 @@
 
 #include <QObject>
 #include <QMutex>
+#include <QHash>
+#include <QSharedPointer>
+#include <QStringList>
 #include "../models/Snapshot.h"
 #include "../models/FileInfo.h"
+#include "../models/FileVersion.h"
+#include "../models/SnapshotDiff.h"
+#include "../models/Repository.h"
+#include "../utils/SingleFlight.h"
 
 namespace ResticGUI {
 namespace Core {
 
+class SnapshotSearchIndex;
+class FileHistoryIndex;
+
 class SnapshotManager : public QObject
 {
     Q_OBJECT
@@ -19,14 +29,61 @@ public:
 
     // 快照操作
     QList<Models::Snapshot> listSnapshots(int repoId, bool forceRefresh = false);
+
+    /**
+     * @brief 从仓库读取快照列表并写入缓存（不检查缓存）
+     *
+     * 同一仓库的并发调用合并为一次 restic snapshots，后到的调用者共享先到者
+     * 的结果（包括失败）。成功时发出 snapshotsUpdated。应在工作线程中调用。
+     *
+     * @param error 可选输出，失败时为 restic 的错误输出
+     */
+    bool fetchSnapshots(const Models::Repository& repo, const QString& password,
+                        QList<Models::Snapshot>& snapshots, QString* error = nullptr);
     Models::Snapshot getSnapshot(int repoId, const QString& snapshotId);
     bool deleteSnapshots(int repoId, const QStringList& snapshotIds);
 
     // 文件浏览
     QList<Models::FileInfo> listFiles(int repoId, const QString& snapshotId, const QString& path = QString());
 
-    // 快照比较
-    QList<Models::FileInfo> compareSnapshots(int repoId, const QString& snapshot1, const QString& snapshot2);
+    /**
+     * @brief 获取快照的文件搜索索引
+     *
+     * 首次调用时用根目录的递归列表构建，最近使用的索引保留在内存中。
+     * 构建较慢，应在工作线程中调用。
+     *
+     * @return 索引，无法列出文件时返回空指针
+     */
+    QSharedPointer<const SnapshotSearchIndex> getSearchIndex(int repoId, const QString& snapshotId);
+
+    /**
+     * @brief 不运行 restic 能得到的搜索索引
+     *
+     * 索引已在内存中，或根目录的递归列表已缓存（浏览对话框加载根目录后即是如此）
+     * 时返回索引，否则返回空指针。可能需要建立索引，应在工作线程中调用。
+     */
+    QSharedPointer<const SnapshotSearchIndex> cachedSearchIndex(int repoId, const QString& snapshotId);
+
+    /**
+     * @brief 获取路径在仓库各快照中的版本（从新到旧）
+     *
+     * 优先使用跨快照历史索引，已缓存文件树的快照直接收录；索引无法回答的
+     * 快照用一次 restic find 补齐，结果同样记入索引，之后的查询只需内存查找。
+     * 可能运行 restic，应在工作线程中调用。
+     */
+    QList<Models::FileVersion> getFileVersions(int repoId, const QString& path);
+
+    /**
+     * @brief 比较两个快照
+     *
+     * 两个快照的递归文件树都已缓存时直接归并比较；否则读取 restic diff 的流式输出，
+     * 已缓存一侧的文件树用于补全大小。结果包含逐条变化和各目录的汇总。
+     * 可能运行 restic，应在工作线程中调用。
+     *
+     * @param snapshot1 旧快照
+     * @param snapshot2 新快照
+     */
+    Models::SnapshotDiff compareSnapshots(int repoId, const QString& snapshot1, const QString& snapshot2);
 
 signals:
     void snapshotsUpdated(int repoId);
@@ -40,7 +97,28 @@ private:
 
     static SnapshotManager* s_instance;
     static QMutex s_instanceMutex;
-    mutable QMutex m_mutex;
+
+    // 合并并发的相同查询（仓库、操作和参数相同）
+    struct SnapshotsFetch
+    {
+        bool success = false;
+        QList<Models::Snapshot> snapshots;
+        QString error;
+    };
+    Utils::SingleFlight<SnapshotsFetch> m_snapshotsFlight;
+    Utils::SingleFlight<QList<Models::FileInfo>> m_filesFlight;
+    Utils::SingleFlight<QSharedPointer<const SnapshotSearchIndex>> m_searchIndexFlight;
+
+    // 搜索索引缓存（按最近使用排序，只保留少量以控制内存）
+    static const int MaxCachedSearchIndexes = 2;
+    QMutex m_searchIndexMutex;
+    QHash<QString, QSharedPointer<const SnapshotSearchIndex>> m_searchIndexes;
+    QStringList m_searchIndexOrder;
+
+    // 跨快照文件历史索引（仓库ID -> 索引）
+    void syncFileHistory(FileHistoryIndex& history, const QList<Models::Snapshot>& snapshots);
+    QMutex m_historyMutex;
+    QHash<int, QSharedPointer<FileHistoryIndex>> m_histories;
 };
 
 } // namespace Core
@@ -0,0 +1,636 @@
+#include "SnapshotSearchIndex.h"
+#include <QPair>
+#include <QRegularExpression>
+#include <algorithm>
+#include <iterator>
+
+namespace ResticGUI {
+namespace Core {
+
+namespace {
+
+quint64 trigramKey(QChar a, QChar b, QChar c)
+{
+    return (quint64(a.unicode()) << 32) | (quint64(b.unicode()) << 16) | quint64(c.unicode());
+}
+
+// 同一父目录下按名称查找子项的哈希键，顶层条目的父条目为 -1
+uint childKey(int parent, const QStringRef& name)
+{
+    return qHash(name, uint(parent + 1));
+}
+
+QVector<int> intersectSorted(const QVector<int>& a, const QVector<int>& b)
+{
+    QVector<int> result;
+    result.reserve(qMin(a.size(), b.size()));
+    std::set_intersection(a.constBegin(), a.constEnd(), b.constBegin(), b.constEnd(),
+                          std::back_inserter(result));
+    return result;
+}
+
+} // namespace
+
+SnapshotSearchIndex::SnapshotSearchIndex()
+    : m_maxDepth(0)
+{
+}
+
+// ========== 构建 ==========
+
+void SnapshotSearchIndex::build(const QList<Models::FileInfo>& files)
+{
+    *this = SnapshotSearchIndex();
+
+    // 去重并记录目录位置（restic ls 可能返回重复项）
+    QVector<int> source;
+    source.reserve(files.size());
+    QHash<QString, int> dirIndex;
+    for (int i = 0; i < files.size(); ++i) {
+        const Models::FileInfo& file = files.at(i);
+        if (file.path.isEmpty() || file.name.isEmpty()) {
+            continue;
+        }
+        if (file.type == Models::FileType::Directory) {
+            if (dirIndex.contains(file.path)) {
+                continue;
+            }
+            dirIndex.insert(file.path, source.size());
+        } else if (!source.isEmpty() && files.at(source.last()).path == file.path) {
+            continue;
+        }
+        source.append(i);
+    }
+
+    const int count = source.size();
+
+    // 按路径找到父目录，找不到父目录的条目挂在顶层
+    QVector<int> parentOf(count);
+    for (int k = 0; k < count; ++k) {
+        const QString& path = files.at(source.at(k)).path;
+        const int slash = path.lastIndexOf('/');
+        parentOf[k] = slash > 0 ? dirIndex.value(path.left(slash), -1) : -1;
+    }
+    dirIndex.clear();
+
+    // 子项表：childStart[p] .. childStart[p + 1]，虚拟根节点编号为 count
+    QVector<int> childStart(count + 2, 0);
+    for (int k = 0; k < count; ++k) {
+        const int p = parentOf.at(k) < 0 ? count : parentOf.at(k);
+        childStart[p + 1]++;
+    }
+    for (int i = 1; i < childStart.size(); ++i) {
+        childStart[i] += childStart.at(i - 1);
+    }
+    QVector<int> cursor = childStart;
+    QVector<int> childList(count);
+    for (int k = 0; k < count; ++k) {
+        const int p = parentOf.at(k) < 0 ? count : parentOf.at(k);
+        childList[cursor[p]++] = k;
+    }
+    cursor.clear();
+
+    m_nameOffset.resize(count);
+    m_nameLength.resize(count);
+    m_parent.resize(count);
+    m_subtreeEnd.resize(count);
+    m_depth.resize(count);
+    m_type.resize(count);
+    m_size.resize(count);
+    m_mtime.resize(count);
+    m_children.reserve(count);
+
+    // 深度优先编号，使每个目录的子树在数组中连续
+    QVector<QPair<int, int>> stack;   // (原始编号, 父条目新编号)
+    for (int c = childStart.at(count + 1) - 1; c >= childStart.at(count); --c) {
+        stack.append(qMakePair(childList.at(c), -1));
+    }
+
+    int next = 0;
+    while (!stack.isEmpty()) {
+        const QPair<int, int> item = stack.takeLast();
+        const int old = item.first;
+        const int id = next++;
+        const Models::FileInfo& file = files.at(source.at(old));
+
+        // 名称取路径最后一段，保证沿父节点拼接后与原路径一致
+        QString name;
+        if (parentOf.at(old) >= 0) {
+            name = file.path.mid(file.path.lastIndexOf('/') + 1);
+        } else {
+            name = file.path.startsWith('/') ? file.path.mid(1) : file.path;
+        }
+        name.truncate(0xFFFF);
+
+        m_parent[id] = item.second;
+        m_subtreeEnd[id] = id + 1;
+        m_depth[id] = item.second < 0 ? 1 : m_depth.at(item.second) + 1;
+        m_type[id] = static_cast<quint8>(file.type);
+        m_size[id] = file.size;
+        m_mtime[id] = file.mtime.isValid() ? file.mtime.toMSecsSinceEpoch() : -1;
+        m_nameOffset[id] = m_names.size();
+        m_nameLength[id] = static_cast<quint16>(name.size());
+        m_names.append(name);
+        m_maxDepth = qMax(m_maxDepth, int(m_depth.at(id)));
+        m_children.insert(childKey(item.second, nameRef(id)), id);
+
+        // 三字符组倒排表，同一文件名内重复的组只记录一次
+        const QString folded = name.toCaseFolded();
+        for (int i = 0; i + 2 < folded.size(); ++i) {
+            QVector<int>& postings = m_trigrams[trigramKey(folded.at(i), folded.at(i + 1), folded.at(i + 2))];
+            if (postings.isEmpty() || postings.last() != id) {
+                postings.append(id);
+            }
+        }
+
+        for (int c = childStart.at(old + 1) - 1; c >= childStart.at(old); --c) {
+            stack.append(qMakePair(childList.at(c), id));
+        }
+    }
+
+    // 先序编号下，父目录的子树结束于最后一个子项子树的结束位置
+    for (int id = count - 1; id >= 0; --id) {
+        const int parent = m_parent.at(id);
+        if (parent >= 0 && m_subtreeEnd.at(id) > m_subtreeEnd.at(parent)) {
+            m_subtreeEnd[parent] = m_subtreeEnd.at(id);
+        }
+    }
+
+    for (auto it = m_trigrams.begin(); it != m_trigrams.end(); ++it) {
+        it.value().squeeze();
+    }
+    m_names.squeeze();
+}
+
+// ========== 条目访问 ==========
+
+QStringRef SnapshotSearchIndex::nameRef(int entry) const
+{
+    return QStringRef(&m_names, m_nameOffset.at(entry), m_nameLength.at(entry));
+}
+
+QString SnapshotSearchIndex::nameOf(int entry) const
+{
+    return nameRef(entry).toString();
+}
+
+QString SnapshotSearchIndex::pathOf(int entry) const
+{
+    QVector<int> chain;
+    for (int current = entry; current >= 0; current = m_parent.at(current)) {
+        chain.append(current);
+    }
+
+    QString path;
+    for (int i = chain.size() - 1; i >= 0; --i) {
+        path += '/';
+        path += nameRef(chain.at(i));
+    }
+    return path;
+}
+
+Models::FileInfo SnapshotSearchIndex::fileInfo(int entry) const
+{
+    return entryInfo(entry, pathOf(entry));
+}
+
+Models::FileInfo SnapshotSearchIndex::entryInfo(int entry, const QString& path) const
+{
+    Models::FileInfo info;
+    info.path = path;
+    info.name = nameOf(entry);
+    info.type = static_cast<Models::FileType>(m_type.at(entry));
+    info.size = m_size.at(entry);
+    if (m_mtime.at(entry) >= 0) {
+        info.mtime = QDateTime::fromMSecsSinceEpoch(m_mtime.at(entry));
+    }
+    return info;
+}
+
+QList<Models::FileInfo> SnapshotSearchIndex::childrenOf(const QString& dirPath) const
+{
+    QList<Models::FileInfo> children;
+
+    int begin = 0;
+    int end = entryCount();
+    QString prefix;
+
+    if (!dirPath.isEmpty() && dirPath != "/") {
+        const int dir = findEntry(dirPath);
+        if (dir < 0) {
+            return children;
+        }
+        begin = dir + 1;
+        end = m_subtreeEnd.at(dir);
+        prefix = pathOf(dir);
+    }
+
+    // 相邻兄弟之间隔着前一个兄弟的子树
+    for (int entry = begin; entry < end; entry = m_subtreeEnd.at(entry)) {
+        QString path = prefix;
+        path += '/';
+        path += nameRef(entry);
+        children.append(entryInfo(entry, path));
+    }
+    return children;
+}
+
+int SnapshotSearchIndex::findEntry(const QString& path) const
+{
+    const QVector<QStringRef> segments = path.splitRef('/', Qt::SkipEmptyParts);
+
+    int found = -1;
+    for (const QStringRef& segment : segments) {
+        const int parent = found;
+        found = -1;
+
+        // 同名兄弟（重复条目）取先序编号最小的，与逐个遍历兄弟的结果一致
+        const uint key = childKey(parent, segment);
+        for (auto it = m_children.constFind(key); it != m_children.constEnd() && it.key() == key; ++it) {
+            const int entry = it.value();
+            if (m_parent.at(entry) == parent && nameRef(entry) == segment
+                && (found < 0 || entry < found)) {
+                found = entry;
+            }
+        }
+        if (found < 0) {
+            return -1;
+        }
+    }
+
+    return found;
+}
+
+bool SnapshotSearchIndex::isDirectory(int entry) const
+{
+    return static_cast<Models::FileType>(m_type.at(entry)) == Models::FileType::Directory;
+}
+
+qint64 SnapshotSearchIndex::subtreeSize(int entry) const
+{
+    qint64 total = 0;
+    const int end = m_subtreeEnd.at(entry);
+    for (int current = entry; current < end; ++current) {
+        if (!isDirectory(current)) {
+            total += m_size.at(current);
+        }
+    }
+    return total;
+}
+
+void SnapshotSearchIndex::rangeStats(int begin, int end, qint64& files, qint64& dirs, qint64& bytes) const
+{
+    for (int current = begin; current < end; ++current) {
+        if (isDirectory(current)) {
+            dirs++;
+        } else {
+            files++;
+            bytes += m_size.at(current);
+        }
+    }
+}
+
+QVector<int> SnapshotSearchIndex::childEntries(int entry) const
+{
+    const int begin = entry < 0 ? 0 : entry + 1;
+    const int end = entry < 0 ? entryCount() : m_subtreeEnd.at(entry);
+
+    QVector<int> children;
+    for (int current = begin; current < end; current = m_subtreeEnd.at(current)) {
+        children.append(current);
+    }
+    return children;
+}
+
+// ========== 查询 ==========
+
+SnapshotSearchIndex::QueryMode SnapshotSearchIndex::parseQuery(const QString& text, QString& pattern)
+{
+    const QString trimmed = text.trimmed();
+
+    if (trimmed.startsWith("re:")) {
+        pattern = trimmed.mid(3);
+        return Regex;
+    }
+
+    pattern = trimmed;
+    if (trimmed.contains('*') || trimmed.contains('?') || trimmed.contains('[')) {
+        return Glob;
+    }
+    return Substring;
+}
+
+QStringList SnapshotSearchIndex::requiredLiterals(QueryMode mode, const QString& pattern)
+{
+    if (mode == Substring) {
+        return QStringList() << pattern;
+    }
+
+    QStringList literals;
+    QString current;
+    auto flush = [&literals, &current]() {
+        if (!current.isEmpty()) {
+            literals.append(current);
+            current.clear();
+        }
+    };
+
+    if (mode == Glob) {
+        for (int i = 0; i < pattern.size(); ++i) {
+            const QChar c = pattern.at(i);
+            if (c == '*' || c == '?') {
+                flush();
+            } else if (c == '[') {
+                flush();
+                const int close = pattern.indexOf(']', i + 1);
+                if (close > 0) {
+                    i = close;
+                }
+            } else {
+                current.append(c);
+            }
+        }
+        flush();
+        return literals;
+    }
+
+    // 正则：只收集顶层、未被量词修饰的普通字符；含分支时无法确定必需字面量
+    static const QString metaChars = QStringLiteral("\\^$.|?*+()[]{}");
+    int groupDepth = 0;
+    for (int i = 0; i < pattern.size(); ++i) {
+        const QChar c = pattern.at(i);
+
+        if (c == '|') {
+            return QStringList();
+        }
+        if (c == '\\') {
+            flush();
+            ++i;
+            continue;
+        }
+        if (c == '[') {
+            flush();
+            const int close = pattern.indexOf(']', i + 2);
+            if (close < 0) {
+                return QStringList();
+            }
+            i = close;
+            continue;
+        }
+        if (c == '(') {
+            flush();
+            groupDepth++;
+            continue;
+        }
+        if (c == ')') {
+            groupDepth = qMax(0, groupDepth - 1);
+            continue;
+        }
+        if (c == '?' || c == '*' || c == '{') {
+            // 量词作用于前一个字符，该字符不是必需的
+            current.chop(1);
+            flush();
+            if (c == '{') {
+                const int close = pattern.indexOf('}', i + 1);
+                if (close > 0) {
+                    i = close;
+                }
+            }
+            continue;
+        }
+        if (metaChars.contains(c)) {
+            flush();
+            continue;
+        }
+        if (groupDepth == 0) {
+            current.append(c);
+        }
+    }
+    flush();
+    return literals;
+}
+
+QString SnapshotSearchIndex::globToRegex(const QString& glob)
+{
+    QString regex;
+    for (int i = 0; i < glob.size(); ++i) {
+        const QChar c = glob.at(i);
+        if (c == '*') {
+            regex += ".*";
+        } else if (c == '?') {
+            regex += '.';
+        } else if (c == '[') {
+            const int close = glob.indexOf(']', i + 1);
+            if (close < 0) {
+                regex += "\\[";
+                continue;
+            }
+            QString set = glob.mid(i + 1, close - i - 1);
+            if (set.startsWith('!')) {
+                set[0] = '^';
+            }
+            regex += '[' + set + ']';
+            i = close;
+        } else {
+            regex += QRegularExpression::escape(QString(c));
+        }
+    }
+    return regex;
+}
+
+QVector<int> SnapshotSearchIndex::trigramCandidates(const QString& literal, bool& usable) const
+{
+    const QString folded = literal.toCaseFolded();
+    usable = folded.size() >= 3;
+    if (!usable) {
+        return QVector<int>();
+    }
+
+    QVector<const QVector<int>*> lists;
+    for (int i = 0; i + 2 < folded.size(); ++i) {
+        auto it = m_trigrams.constFind(trigramKey(folded.at(i), folded.at(i + 1), folded.at(i + 2)));
+        if (it == m_trigrams.constEnd()) {
+            return QVector<int>();
+        }
+        lists.append(&it.value());
+    }
+
+    // 从最短的倒排表开始求交集
+    std::sort(lists.begin(), lists.end(), [](const QVector<int>* a, const QVector<int>* b) {
+        return a->size() < b->size();
+    });
+
+    QVector<int> result = *lists.first();
+    for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+        result = intersectSorted(result, *lists.at(i));
+    }
+    return result;
+}
+
+int SnapshotSearchIndex::search(const QString& text, int batchSize, const BatchCallback& onBatch) const
+{
+    QString pattern;
+    const QueryMode mode = parseQuery(text, pattern);
+    if (pattern.isEmpty()) {
+        return -1;
+    }
+
+    const bool matchPath = pattern.contains('/');
+
+    QRegularExpression regex;
+    if (mode != Substring) {
+        QString expression;
+        if (mode == Glob) {
+            // 文件名通配符匹配整个名称；路径通配符不以 / 开头时从任意一级目录开始匹配
+            expression = globToRegex(pattern);
+            if (!matchPath || pattern.startsWith('/')) {
+                expression = "\\A(?:" + expression + ")\\z";
+            } else {
+                expression = "(?:\\A|/)(?:" + expression + ")\\z";
+            }
+        } else {
+            expression = pattern;
+        }
+
+        regex.setPattern(expression);
+        regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+        if (!regex.isValid()) {
+            return -1;
+        }
+        regex.optimize();
+    }
+
+    // 由必需的字面量得到候选条目；没有可用的三字符组时退化为全量扫描
+    const QStringList literals = requiredLiterals(mode, pattern);
+    QVector<int> candidates;
+    bool haveCandidates = false;
+
+    if (!matchPath) {
+        for (const QString& literal : literals) {
+            bool usable = false;
+            QVector<int> postings = trigramCandidates(literal, usable);
+            if (!usable) {
+                continue;
+            }
+            candidates = haveCandidates ? intersectSorted(candidates, postings) : postings;
+            haveCandidates = true;
+            if (candidates.isEmpty()) {
+                break;
+            }
+        }
+    } else {
+        // 路径中的每一段都落在匹配条目或其某个祖先的名称里，取最具选择性的一段
+        for (const QString& literal : literals) {
+            const QStringList segments = literal.split('/', Qt::SkipEmptyParts);
+            for (const QString& segment : segments) {
+                bool usable = false;
+                QVector<int> postings = trigramCandidates(segment, usable);
+                if (usable && (!haveCandidates || postings.size() < candidates.size())) {
+                    candidates = postings;
+                    haveCandidates = true;
+                }
+            }
+        }
+    }
+
+    // 排序键：等级 << 48 | 深度 << 32 | 条目编号（深度优先顺序即路径顺序）
+    QVector<quint64> hits;
+    auto addHit = [this, &hits](int entry, quint64 rank) {
+        hits.append((rank << 48) | (quint64(m_depth.at(entry)) << 32) | quint64(entry));
+    };
+
+    if (!matchPath) {
+        auto checkName = [&](int entry) {
+            const QStringRef name = nameRef(entry);
+            if (mode == Substring) {
+                if (!name.contains(pattern, Qt::CaseInsensitive)) {
+                    return;
+                }
+                if (name.compare(pattern, Qt::CaseInsensitive) == 0) {
+                    addHit(entry, 0);
+                } else if (name.startsWith(pattern, Qt::CaseInsensitive)) {
+                    addHit(entry, 1);
+                } else {
+                    addHit(entry, 2);
+                }
+            } else if (regex.match(name).hasMatch()) {
+                addHit(entry, 2);
+            }
+        };
+
+        if (haveCandidates) {
+            for (int entry : candidates) {
+                checkName(entry);
+            }
+        } else {
+            for (int entry = 0; entry < entryCount(); ++entry) {
+                checkName(entry);
+            }
+        }
+    } else {
+        QVector<QString> pathAtDepth(m_maxDepth + 1);
+
+        // 扫描连续的子树区间，路径逐级拼接
+        auto scanRange = [&](int begin, int end) {
+            const int parent = m_parent.at(begin);
+            pathAtDepth[m_depth.at(begin) - 1] = parent >= 0 ? pathOf(parent) : QString();
+
+            for (int entry = begin; entry < end; ++entry) {
+                const int depth = m_depth.at(entry);
+                QString& path = pathAtDepth[depth];
+                path = pathAtDepth.at(depth - 1);
+                path += '/';
+                path += nameRef(entry);
+
+                const bool matched = (mode == Substring)
+                    ? path.contains(pattern, Qt::CaseInsensitive)
+                    : regex.match(path).hasMatch();
+                if (matched) {
+                    addHit(entry, 3);
+                    // 子串匹配时子树中的条目必然也匹配，只报告最上层的目录
+                    if (mode == Substring) {
+                        entry = m_subtreeEnd.at(entry) - 1;
+                    }
+                }
+            }
+        };
+
+        if (haveCandidates) {
+            int coveredEnd = 0;
+            for (int entry : candidates) {
+                if (entry < coveredEnd) {
+                    continue;
+                }
+                scanRange(entry, m_subtreeEnd.at(entry));
+                coveredEnd = m_subtreeEnd.at(entry);
+            }
+        } else if (entryCount() > 0) {
+            scanRange(0, entryCount());
+        }
+    }
+
+    std::sort(hits.begin(), hits.end());
+
+    const int total = hits.size();
+    if (!onBatch) {
+        return total;
+    }
+
+    const int step = batchSize > 0 ? batchSize : qMax(total, 1);
+    for (int pos = 0; pos < total; pos += step) {
+        const int end = qMin(total, pos + step);
+        QVector<int> batch;
+        batch.reserve(end - pos);
+        for (int i = pos; i < end; ++i) {
+            batch.append(static_cast<int>(hits.at(i) & 0xFFFFFFFFu));
+        }
+        if (!onBatch(batch, total)) {
+            break;
+        }
+    }
+
+    return total;
+}
+
+} // namespace Core
+} // namespace ResticGUI
@@ -0,0 +1,139 @@
+#ifndef SNAPSHOTSEARCHINDEX_H
+#define SNAPSHOTSEARCHINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <functional>
+#include "../models/FileInfo.h"
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief 快照文件搜索索引
+ *
+ * 由一次递归 restic ls 的输出构建，构建后只读，可在多个线程中同时查询。
+ * 条目按深度优先顺序存放，每个目录的子树在数组中连续；文件名集中保存在
+ * 一个字符串缓冲区中，完整路径在需要时沿父节点拼接。文件名的三字符组
+ * （trigram）倒排表用于筛选候选条目，再对候选逐一校验。
+ *
+ * 查询语法：
+ * - 普通文本：不区分大小写的子串匹配
+ * - 含 * ? [ 的文本：通配符匹配
+ * - 以 "re:" 开头：正则表达式匹配
+ * 查询中包含 '/' 时匹配完整路径，否则只匹配文件名。
+ */
+class SnapshotSearchIndex
+{
+public:
+    enum QueryMode {
+        Substring,
+        Glob,
+        Regex
+    };
+
+    /**
+     * @brief 分批返回结果的回调
+     * @param entries 本批条目编号（按排名顺序）
+     * @param totalHits 匹配总数
+     * @return 返回 false 时不再返回后续批次
+     */
+    typedef std::function<bool(const QVector<int>& entries, int totalHits)> BatchCallback;
+
+    SnapshotSearchIndex();
+
+    /**
+     * @brief 从递归文件列表构建索引
+     */
+    void build(const QList<Models::FileInfo>& files);
+
+    int entryCount() const { return m_parent.size(); }
+
+    QString nameOf(int entry) const;
+    QString pathOf(int entry) const;
+    Models::FileInfo fileInfo(int entry) const;
+
+    /**
+     * @brief 获取目录的直接子项
+     * @param dirPath 目录路径，空字符串表示快照根目录
+     */
+    QList<Models::FileInfo> childrenOf(const QString& dirPath) const;
+
+    // ========== 子树访问 ==========
+
+    /**
+     * @brief 按完整路径查找条目
+     *
+     * 每一段路径通过 (父条目, 名称) 哈希表定位，耗时只与路径深度有关。
+     *
+     * @return 条目编号，找不到返回 -1
+     */
+    int findEntry(const QString& path) const;
+
+    bool isDirectory(int entry) const;
+
+    /**
+     * @brief 子树结束位置（不含），[entry, subtreeEnd) 为 entry 及其所有子孙
+     */
+    int subtreeEnd(int entry) const { return m_subtreeEnd.at(entry); }
+
+    /**
+     * @brief 子树中所有文件的总大小
+     */
+    qint64 subtreeSize(int entry) const;
+
+    /**
+     * @brief 统计条目范围 [begin, end) 中的文件数、目录数和文件总大小
+     */
+    void rangeStats(int begin, int end, qint64& files, qint64& dirs, qint64& bytes) const;
+
+    /**
+     * @brief 目录的直接子条目，entry 为 -1 时返回顶层条目
+     */
+    QVector<int> childEntries(int entry) const;
+
+    /**
+     * @brief 解析查询文本
+     * @param text 用户输入
+     * @param pattern 输出去掉前缀后的模式
+     * @return 查询模式
+     */
+    static QueryMode parseQuery(const QString& text, QString& pattern);
+
+    /**
+     * @brief 搜索
+     *
+     * 结果按 完全同名 > 名称前缀 > 名称包含 > 路径匹配 排序，
+     * 同一等级内浅层目录在前，每批最多 batchSize 条。
+     *
+     * @return 匹配总数，查询无效时返回 -1
+     */
+    int search(const QString& text, int batchSize, const BatchCallback& onBatch) const;
+
+private:
+    QStringRef nameRef(int entry) const;
+    Models::FileInfo entryInfo(int entry, const QString& path) const;
+    QVector<int> trigramCandidates(const QString& literal, bool& usable) const;
+    static QStringList requiredLiterals(QueryMode mode, const QString& pattern);
+    static QString globToRegex(const QString& glob);
+
+    QString m_names;                    // 所有文件名首尾相接
+    QVector<int> m_nameOffset;
+    QVector<quint16> m_nameLength;
+    QVector<int> m_parent;              // 父条目，顶层为 -1
+    QVector<int> m_subtreeEnd;          // 子树结束位置（不含）
+    QVector<quint16> m_depth;           // 顶层为 1
+    QVector<quint8> m_type;
+    QVector<qint64> m_size;
+    QVector<qint64> m_mtime;            // 毫秒时间戳，-1 表示无效
+    QHash<quint64, QVector<int>> m_trigrams;  // 小写文件名三字符组 -> 条目（升序）
+    QMultiHash<uint, int> m_children;   // (父条目, 名称) 的哈希 -> 条目，名称需再比较
+    int m_maxDepth;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // SNAPSHOTSEARCHINDEX_H
@@ -0,0 +1,316 @@
+#include "VerificationScheduler.h"
+#include "ResticWrapper.h"
+#include "RepositoryManager.h"
+#include "../data/DatabaseManager.h"
+#include "../data/PasswordManager.h"
+#include "../utils/Logger.h"
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QPair>
+#include <QtConcurrent>
+
+namespace ResticGUI {
+namespace Core {
+
+VerificationScheduler* VerificationScheduler::s_instance = nullptr;
+QMutex VerificationScheduler::s_instanceMutex;
+
+VerificationScheduler* VerificationScheduler::instance()
+{
+    if (!s_instance) {
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new VerificationScheduler();
+        }
+    }
+    return s_instance;
+}
+
+VerificationScheduler::VerificationScheduler(QObject* parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setInterval(CheckIntervalMs);
+    connect(m_timer, &QTimer::timeout, this, &VerificationScheduler::onCheckTimer);
+}
+
+VerificationScheduler::~VerificationScheduler()
+{
+}
+
+void VerificationScheduler::initialize()
+{
+    m_timer->start();
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("验证调度器初始化完成，%1 个仓库启用了轮换验证")
+            .arg(Data::DatabaseManager::instance()->getEnabledVerificationPlans().size()));
+}
+
+void VerificationScheduler::stop()
+{
+    m_timer->stop();
+}
+
+void VerificationScheduler::setRunGuard(const std::function<bool()>& guard)
+{
+    m_runGuard = guard;
+}
+
+Models::VerificationPlan VerificationScheduler::plan(int repoId) const
+{
+    return Data::DatabaseManager::instance()->getVerificationPlan(repoId);
+}
+
+bool VerificationScheduler::savePlanSettings(const Models::VerificationPlan& settings)
+{
+    Data::DatabaseManager* db = Data::DatabaseManager::instance();
+    Models::VerificationPlan plan = db->getVerificationPlan(settings.repositoryId);
+    plan.enabled = settings.enabled;
+    plan.periodDays = qMax(1, settings.periodDays);
+    plan.timeBudgetMinutes = qMax(0, settings.timeBudgetMinutes);
+    plan.bytesBudget = qMax<qint64>(0, settings.bytesBudget);
+
+    // 新的预算从下一轮开始影响切片数，本轮保持不变以免切片错位
+    return db->saveVerificationPlan(plan);
+}
+
+bool VerificationScheduler::runNow(int repoId)
+{
+    return startRun(repoId);
+}
+
+bool VerificationScheduler::isRunning(int repoId) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_running.contains(repoId);
+}
+
+void VerificationScheduler::onCheckTimer()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    bool guardChecked = false;
+
+    for (const Models::VerificationPlan& plan : Data::DatabaseManager::instance()->getEnabledVerificationPlans()) {
+        if (isRunning(plan.repositoryId)) {
+            continue;
+        }
+        if (plan.lastRunAt.isValid() && plan.lastRunAt.secsTo(now) < MinRunIntervalSecs) {
+            continue;
+        }
+        if (plan.isDue(now)) {
+            // 有到期的验证时才检查一次，由其他进程执行时本轮都不开始
+            if (!guardChecked) {
+                guardChecked = true;
+                if (m_runGuard && !m_runGuard()) {
+                    return;
+                }
+            }
+            startRun(plan.repositoryId);
+        }
+    }
+}
+
+bool VerificationScheduler::startRun(int repoId)
+{
+    QString password;
+    if (!Data::PasswordManager::instance()->getPassword(repoId, password)) {
+        Utils::Logger::instance()->log(Utils::Logger::Debug,
+            QString("仓库 %1 没有可用的密码，跳过轮换验证").arg(repoId));
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_running.contains(repoId)) {
+            return false;
+        }
+        m_running.insert(repoId);
+    }
+
+    emit verificationStarted(repoId);
+
+    QtConcurrent::run([this, repoId, password]() {
+        runVerification(repoId, password);
+
+        QMutexLocker locker(&m_mutex);
+        m_running.remove(repoId);
+    });
+    return true;
+}
+
+void VerificationScheduler::runVerification(int repoId, const QString& password)
+{
+    Data::DatabaseManager* db = Data::DatabaseManager::instance();
+    Models::Repository repo = RepositoryManager::instance()->getRepository(repoId);
+    Models::VerificationPlan plan = db->getVerificationPlan(repoId);
+    ResticWrapper wrapper;
+
+    // 开始新一轮：按当前数据包大小和预算重新划分切片
+    if (!plan.cycleStarted() || plan.cycleCompleted()) {
+        Models::RepoStats stats;
+        qint64 repositoryBytes = 0;
+        if (wrapper.getStats(repo, password, stats, "raw-data")) {
+            repositoryBytes = stats.totalSize;
+        } else {
+            Utils::Logger::instance()->log(Utils::Logger::Warning,
+                QString("无法获取仓库 %1 的数据包大小，本轮作为一个切片验证").arg(repo.name));
+        }
+
+        plan.sliceCount = computeSliceCount(plan, repositoryBytes, historicalThroughput(repoId));
+        plan.nextSlice = 1;
+        plan.repositoryBytes = repositoryBytes;
+        plan.cycleStartedAt = QDateTime::currentDateTime();
+
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("仓库 %1 开始新一轮数据验证：%2 字节，分为 %3 个切片，周期 %4 天")
+                .arg(repo.name).arg(repositoryBytes).arg(plan.sliceCount).arg(plan.periodDays));
+    }
+
+    // restic 按数据包ID划分切片，各切片的大小大致相同
+    const qint64 sliceBytes = plan.repositoryBytes / plan.sliceCount;
+    const qint64 timeBudgetMs = plan.timeBudgetMinutes * 60000LL;
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 bytesChecked = 0;
+    int slicesChecked = 0;
+    bool success = true;
+    QString message;
+
+    while (!plan.cycleCompleted()) {
+        Models::VerificationRun run;
+        run.repositoryId = repoId;
+        run.sliceIndex = plan.nextSlice;
+        run.sliceCount = plan.sliceCount;
+        run.startTime = QDateTime::currentDateTime();
+        run.success = wrapper.checkDataSubset(repo, password, plan.nextSlice, plan.sliceCount);
+        run.endTime = QDateTime::currentDateTime();
+        run.bytesChecked = run.success ? sliceBytes : 0;
+        if (!run.success) {
+            run.errorMessage = wrapper.lastErrorOutput();
+        }
+        db->insertVerificationRun(run);
+        plan.lastRunAt = run.endTime;
+
+        // 失败的切片不推进，下次运行重新验证
+        if (!run.success) {
+            success = false;
+            message = run.errorMessage.isEmpty()
+                ? QString("数据切片 %1/%2 验证失败").arg(run.sliceIndex).arg(run.sliceCount)
+                : run.errorMessage;
+            Utils::Logger::instance()->log(Utils::Logger::Error,
+                QString("仓库 %1 数据切片 %2/%3 验证失败: %4")
+                    .arg(repo.name).arg(run.sliceIndex).arg(run.sliceCount).arg(message));
+            break;
+        }
+
+        plan.nextSlice++;
+        slicesChecked++;
+        bytesChecked += sliceBytes;
+
+        if (plan.cycleCompleted()) {
+            plan.lastCycleCompletedAt = run.endTime;
+            Utils::Logger::instance()->log(Utils::Logger::Info,
+                QString("仓库 %1 已完成一轮完整的数据验证，用时 %2 天")
+                    .arg(repo.name).arg(plan.cycleStartedAt.daysTo(run.endTime)));
+            break;
+        }
+
+        // 下一个切片按本切片的耗时估算，超出预算或已赶上周期进度时停止
+        const qint64 lastSliceMs = run.startTime.msecsTo(run.endTime);
+        if (timeBudgetMs > 0 && timer.elapsed() + lastSliceMs > timeBudgetMs) {
+            break;
+        }
+        if (plan.bytesBudget > 0 && bytesChecked + sliceBytes > plan.bytesBudget) {
+            break;
+        }
+        if (!plan.isDue(QDateTime::currentDateTime())) {
+            break;
+        }
+    }
+
+    // 设置可能在运行期间被修改，只写回进度
+    Models::VerificationPlan latest = db->getVerificationPlan(repoId);
+    latest.repositoryId = repoId;
+    latest.sliceCount = plan.sliceCount;
+    latest.nextSlice = plan.nextSlice;
+    latest.repositoryBytes = plan.repositoryBytes;
+    latest.cycleStartedAt = plan.cycleStartedAt;
+    latest.lastRunAt = plan.lastRunAt;
+    latest.lastCycleCompletedAt = plan.lastCycleCompletedAt;
+    db->saveVerificationPlan(latest);
+
+    if (success) {
+        message = QString("验证了 %1 个切片（约 %2 字节），本轮进度 %3/%4")
+                      .arg(slicesChecked).arg(bytesChecked)
+                      .arg(plan.slicesDone()).arg(plan.sliceCount);
+        Utils::Logger::instance()->log(Utils::Logger::Info,
+            QString("仓库 %1 %2").arg(repo.name).arg(message));
+    }
+
+    emit verificationFinished(repoId, success, message);
+}
+
+int VerificationScheduler::computeSliceCount(const Models::VerificationPlan& plan, qint64 repositoryBytes,
+                                             double bytesPerSecond)
+{
+    if (repositoryBytes <= 0) {
+        return 1;
+    }
+
+    // 每次运行能验证的数据量取两个预算中较小的一个
+    qint64 perRun = plan.bytesBudget > 0 ? plan.bytesBudget : 0;
+    if (plan.timeBudgetMinutes > 0 && bytesPerSecond > 0) {
+        const qint64 byTime = static_cast<qint64>(bytesPerSecond * plan.timeBudgetMinutes * 60);
+        perRun = perRun > 0 ? qMin(perRun, byTime) : byTime;
+    }
+    if (perRun <= 0) {
+        return 1;
+    }
+
+    const qint64 slices = (repositoryBytes + perRun - 1) / perRun;
+    return static_cast<int>(qBound<qint64>(1, slices, MaxSliceCount));
+}
+
+double VerificationScheduler::historicalThroughput(int repoId)
+{
+    const QList<Models::VerificationRun> runs = Data::DatabaseManager::instance()->getVerificationRuns(
+        repoId, QDateTime::currentDateTime().addDays(-90));
+
+    qint64 bytes = 0;
+    qint64 seconds = 0;
+    for (const Models::VerificationRun& run : runs) {
+        if (run.success && run.durationSecs() > 0) {
+            bytes += run.bytesChecked;
+            seconds += run.durationSecs();
+        }
+    }
+
+    return (seconds > 0 && bytes > 0) ? static_cast<double>(bytes) / seconds : DefaultBytesPerSecond;
+}
+
+double VerificationScheduler::coverageAt(const QList<Models::VerificationRun>& runs, const QDateTime& at,
+                                         int periodDays)
+{
+    const QDateTime windowStart = at.addDays(-qMax(1, periodDays));
+
+    // 同一切片重复验证只计一次；切片数不同的轮次按各自的比例累加
+    QSet<QPair<int, int>> counted;
+    double coverage = 0;
+    for (const Models::VerificationRun& run : runs) {
+        if (!run.success || run.sliceCount <= 0 || run.endTime <= windowStart || run.endTime > at) {
+            continue;
+        }
+        const QPair<int, int> slice(run.sliceIndex, run.sliceCount);
+        if (counted.contains(slice)) {
+            continue;
+        }
+        counted.insert(slice);
+        coverage += 1.0 / run.sliceCount;
+    }
+
+    return qMin(coverage, 1.0);
+}
+
+} // namespace Core
+} // namespace ResticGUI
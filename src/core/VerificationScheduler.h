@@ -0,0 +1,109 @@
+#ifndef VERIFICATIONSCHEDULER_H
+#define VERIFICATIONSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QMutex>
+#include <QSet>
+#include <QList>
+#include <functional>
+#include "../models/VerificationPlan.h"
+
+namespace ResticGUI {
+namespace Core {
+
+/**
+ * @brief 仓库数据轮换验证调度器（单例模式）
+ *
+ * restic check --read-data 要读取全部数据包，大型云端仓库往往需要数天。
+ * 调度器每轮把仓库分成 N 个切片，每次运行验证一个或几个切片
+ * （check --read-data-subset=n/N），使整个仓库在设定的周期内被验证一遍。
+ * N 在每轮开始时按数据包总大小和每次运行的时间/数据量预算计算，
+ * 进度和每个切片的结果保存在数据库中，程序重启后继续。
+ */
+class VerificationScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static VerificationScheduler* instance();
+    void initialize();
+    void stop();
+
+    /**
+     * @brief 设置开始到期验证前的检查，返回 false 时本进程不执行（见 SchedulerManager::setRunGuard）
+     */
+    void setRunGuard(const std::function<bool()>& guard);
+
+    /**
+     * @brief 获取仓库的验证计划
+     */
+    Models::VerificationPlan plan(int repoId) const;
+
+    /**
+     * @brief 保存计划设置（启用、周期、预算），不影响本轮进度
+     */
+    bool savePlanSettings(const Models::VerificationPlan& plan);
+
+    /**
+     * @brief 立即验证下一个切片（不检查是否到期，仍受预算限制）
+     * @return 已开始返回true，该仓库正在验证或没有保存密码时返回false
+     */
+    bool runNow(int repoId);
+
+    bool isRunning(int repoId) const;
+
+    /**
+     * @brief 截至某一时刻，最近一个周期内验证通过的数据占仓库的比例（0..1）
+     * @param runs 验证记录
+     * @param at 统计时刻
+     * @param periodDays 周期天数
+     */
+    static double coverageAt(const QList<Models::VerificationRun>& runs, const QDateTime& at, int periodDays);
+
+    /**
+     * @brief 按数据包总大小和预算计算每轮的切片数
+     * @param repositoryBytes 数据包总大小
+     * @param bytesPerSecond 验证吞吐量
+     */
+    static int computeSliceCount(const Models::VerificationPlan& plan, qint64 repositoryBytes, double bytesPerSecond);
+
+    /**
+     * @brief 该仓库历史验证的平均吞吐量（字节/秒），没有记录时返回默认值
+     */
+    static double historicalThroughput(int repoId);
+
+    static constexpr int CheckIntervalMs = 10 * 60 * 1000;
+    static constexpr qint64 MinRunIntervalSecs = 60 * 60;     // 两次运行的最小间隔，失败后不会反复重试
+    static constexpr int MaxSliceCount = 10000;
+    static constexpr double DefaultBytesPerSecond = 10.0 * 1024 * 1024;
+
+signals:
+    void verificationStarted(int repoId);
+    void verificationFinished(int repoId, bool success, const QString& message);
+
+private slots:
+    void onCheckTimer();
+
+private:
+    explicit VerificationScheduler(QObject* parent = nullptr);
+    ~VerificationScheduler();
+    VerificationScheduler(const VerificationScheduler&) = delete;
+    VerificationScheduler& operator=(const VerificationScheduler&) = delete;
+
+    bool startRun(int repoId);
+    void runVerification(int repoId, const QString& password);
+
+    static VerificationScheduler* s_instance;
+    static QMutex s_instanceMutex;
+
+    QTimer* m_timer;
+    std::function<bool()> m_runGuard;
+    QSet<int> m_running;
+    mutable QMutex m_mutex;
+};
+
+} // namespace Core
+} // namespace ResticGUI
+
+#endif // VERIFICATIONSCHEDULER_H
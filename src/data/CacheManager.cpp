@@ -6,11 +6,23 @@
 #include "CacheManager.h"
 #include "DatabaseManager.h"
 #include "../utils/Logger.h"
+#include "../utils/Metrics.h"
 #include <QMutexLocker>
 
 namespace ResticGUI {
 namespace Data {
 
+namespace {
+
+// 命中率由 MetricsExporter 在采集时按这两个计数计算
+Utils::Counter* lookupCounter(const QString& cache, bool hit)
+{
+    return Utils::MetricsRegistry::instance()->counter("resticgui_cache_requests_total", "缓存查询次数",
+        {{"cache", cache}, {"result", hit ? QString("hit") : QString("miss")}});
+}
+
+} // namespace
+
 CacheManager* CacheManager::s_instance = nullptr;
 QMutex CacheManager::s_instanceMutex;
 
@@ -66,11 +78,15 @@ void CacheManager::cacheSnapshots(int repoId, const QList<Models::Snapshot>& sna
 
 bool CacheManager::getCachedSnapshots(int repoId, QList<Models::Snapshot>& snapshots)
 {
+    static Utils::Counter* const hits = lookupCounter("snapshots", true);
+    static Utils::Counter* const misses = lookupCounter("snapshots", false);
+
     QMutexLocker locker(&m_mutex);
 
     // 先检查内存缓存
     if (m_snapshotCache.contains(repoId)) {
         snapshots = m_snapshotCache[repoId].snapshots;
+        hits->inc();
         return true;
     }
 
@@ -82,9 +98,11 @@ bool CacheManager::getCachedSnapshots(int repoId, QList<Models::Snapshot>& snaps
         cache.snapshots = snapshots;
         cache.timestamp = QDateTime::currentDateTime();
         m_snapshotCache[repoId] = cache;
+        hits->inc();
         return true;
     }
 
+    misses->inc();
     return false;
 }
 
@@ -139,15 +157,20 @@ void CacheManager::cacheFileTree(const QString& snapshotId, const QString& path,
 
 bool CacheManager::getCachedFileTree(const QString& snapshotId, const QString& path, QList<Models::FileInfo>& files)
 {
+    static Utils::Counter* const hits = lookupCounter("file_tree", true);
+    static Utils::Counter* const misses = lookupCounter("file_tree", false);
+
     QMutexLocker locker(&m_mutex);
 
     QString cacheKey = snapshotId + "_" + path;
 
     if (m_fileTreeCache.contains(cacheKey)) {
         files = m_fileTreeCache[cacheKey].files;
+        hits->inc();
         return true;
     }
 
+    misses->inc();
     return false;
 }
 
@@ -195,13 +218,18 @@ void CacheManager::cacheRepoStats(int repoId, const Models::RepoStats& stats)
 
 bool CacheManager::getCachedRepoStats(int repoId, Models::RepoStats& stats)
 {
+    static Utils::Counter* const hits = lookupCounter("repo_stats", true);
+    static Utils::Counter* const misses = lookupCounter("repo_stats", false);
+
     QMutexLocker locker(&m_mutex);
 
     if (m_repoStatsCache.contains(repoId)) {
         stats = m_repoStatsCache[repoId].stats;
+        hits->inc();
         return true;
     }
 
+    misses->inc();
     return false;
 }
 
@@ -239,6 +239,38 @@ void ConfigManager::setLogRetentionDays(int days)
     setValue("Backup/LogRetentionDays", days);
 }
 
+// ========== 日志设置 ==========
+
+int ConfigManager::getLogMaxFileSizeMB() const
+{
+    return getValue("Log/MaxFileSizeMB", 10).toInt();
+}
+
+void ConfigManager::setLogMaxFileSizeMB(int sizeMB)
+{
+    setValue("Log/MaxFileSizeMB", sizeMB);
+}
+
+bool ConfigManager::getCompressRotatedLogs() const
+{
+    return getValue("Log/CompressRotated", true).toBool();
+}
+
+void ConfigManager::setCompressRotatedLogs(bool enabled)
+{
+    setValue("Log/CompressRotated", enabled);
+}
+
+bool ConfigManager::getStructuredLogs() const
+{
+    return getValue("Log/StructuredFormat", false).toBool();
+}
+
+void ConfigManager::setStructuredLogs(bool enabled)
+{
+    setValue("Log/StructuredFormat", enabled);
+}
+
 // ========== 密码设置 ==========
 
 int ConfigManager::getPasswordStorageMode() const
@@ -313,6 +345,38 @@ void ConfigManager::setNetworkTimeout(int seconds)
     setValue("Network/Timeout", seconds);
 }
 
+// ========== 指标设置 ==========
+
+bool ConfigManager::getMetricsHttpEnabled() const
+{
+    return getValue("Metrics/HttpEnabled", false).toBool();
+}
+
+void ConfigManager::setMetricsHttpEnabled(bool enabled)
+{
+    setValue("Metrics/HttpEnabled", enabled);
+}
+
+int ConfigManager::getMetricsHttpPort() const
+{
+    return getValue("Metrics/HttpPort", 9184).toInt();
+}
+
+void ConfigManager::setMetricsHttpPort(int port)
+{
+    setValue("Metrics/HttpPort", port);
+}
+
+QString ConfigManager::getMetricsTextfilePath() const
+{
+    return getValue("Metrics/TextfilePath", QString()).toString();
+}
+
+void ConfigManager::setMetricsTextfilePath(const QString& path)
+{
+    setValue("Metrics/TextfilePath", path);
+}
+
 // ========== UI设置 ==========
 
 QByteArray ConfigManager::getWindowGeometry() const
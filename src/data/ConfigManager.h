@@ -115,11 +115,31 @@ public:
     void setMaxParallelBackups(int count);
 
     /**
-     * @brief 获取备份日志保留天数
+     * @brief 获取日志保留天数（超过天数的轮转日志文件被删除）
      */
     int getLogRetentionDays() const;
     void setLogRetentionDays(int days);
 
+    // ========== 日志设置 ==========
+
+    /**
+     * @brief 获取单个日志文件的最大大小（MB），超过时轮转
+     */
+    int getLogMaxFileSizeMB() const;
+    void setLogMaxFileSizeMB(int sizeMB);
+
+    /**
+     * @brief 获取是否压缩轮转的日志文件
+     */
+    bool getCompressRotatedLogs() const;
+    void setCompressRotatedLogs(bool enabled);
+
+    /**
+     * @brief 获取是否以 JSON Lines 格式写日志文件
+     */
+    bool getStructuredLogs() const;
+    void setStructuredLogs(bool enabled);
+
     // ========== 密码设置 ==========
 
     /**
@@ -158,6 +178,23 @@ public:
     int getNetworkTimeout() const;
     void setNetworkTimeout(int seconds);
 
+    // ========== 指标设置 ==========
+
+    /**
+     * @brief 获取是否启用本地 HTTP 指标端点（只监听 127.0.0.1）
+     */
+    bool getMetricsHttpEnabled() const;
+    void setMetricsHttpEnabled(bool enabled);
+
+    int getMetricsHttpPort() const;
+    void setMetricsHttpPort(int port);
+
+    /**
+     * @brief 获取指标文本文件路径（node_exporter textfile collector），为空不写
+     */
+    QString getMetricsTextfilePath() const;
+    void setMetricsTextfilePath(const QString& path);
+
     // ========== UI设置 ==========
 
     /**
@@ -5,6 +5,8 @@
 
 #include "DatabaseManager.h"
 #include "../utils/Logger.h"
+#include "../utils/Tracer.h"
+#include "../utils/Metrics.h"
 #include <QSqlError>
 #include <QSqlRecord>
 #include <QFile>
@@ -18,6 +20,14 @@
 namespace ResticGUI {
 namespace Data {
 
+// 查询的跟踪区间和耗时分布，耗时包括等待数据库锁的时间
+#define DB_QUERY_SCOPE(query) \
+    TRACE_SCOPE_CAT("DatabaseManager::" query, "db"); \
+    static Utils::Histogram* const queryLatency = Utils::MetricsRegistry::instance()->histogram( \
+        "resticgui_db_query_duration_seconds", "数据库查询耗时（秒）", \
+        Utils::Histogram::latencyBuckets(), {{"query", query}}); \
+    Utils::HistogramTimer queryTimer(queryLatency)
+
 DatabaseManager* DatabaseManager::s_instance = nullptr;
 QMutex DatabaseManager::s_instanceMutex;
 
@@ -175,6 +185,155 @@ bool DatabaseManager::checkAndUpgradeSchema()
         Utils::Logger::instance()->log(Utils::Logger::Info, "数据库已升级到版本2");
     }
 
+    // 升级到版本 3：为任务列表的最近状态子查询添加复合索引
+    if (currentVersion < 3) {
+        Utils::Logger::instance()->log(Utils::Logger::Info, "升级数据库到版本3：添加备份历史复合索引");
+
+        QSqlQuery upgradeQuery(m_database);
+        if (!upgradeQuery.exec("CREATE INDEX IF NOT EXISTS idx_backup_history_task_time "
+                               "ON backup_history(task_id, start_time)")) {
+            Utils::Logger::instance()->log(Utils::Logger::Error,
+                QString("创建 idx_backup_history_task_time 索引失败: %1").arg(upgradeQuery.lastError().text()));
+            return false;
+        }
+
+        upgradeQuery.exec("INSERT OR REPLACE INTO schema_version (version, applied_at) VALUES (3, datetime('now'))");
+        m_schemaVersion = 3;
+        Utils::Logger::instance()->log(Utils::Logger::Info, "数据库已升级到版本3");
+    }
+
+    // 升级到版本 4：添加恢复日志表，用于继续被中断的恢复
+    if (currentVersion < 4) {
+        Utils::Logger::instance()->log(Utils::Logger::Info, "升级数据库到版本4：添加恢复日志表");
+
+        QSqlQuery upgradeQuery(m_database);
+        if (!upgradeQuery.exec("CREATE TABLE IF NOT EXISTS restore_journal ("
+                               "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                               "repository_id INTEGER NOT NULL, "
+                               "snapshot_id TEXT NOT NULL, "
+                               "target_path TEXT NOT NULL, "
+                               "options TEXT, "
+                               "status INTEGER DEFAULT 0, "
+                               "start_time TEXT NOT NULL, "
+                               "end_time TEXT, "
+                               "total_files INTEGER DEFAULT 0, "
+                               "files_restored INTEGER DEFAULT 0, "
+                               "files_skipped INTEGER DEFAULT 0, "
+                               "files_deleted INTEGER DEFAULT 0, "
+                               "total_bytes INTEGER DEFAULT 0, "
+                               "bytes_restored INTEGER DEFAULT 0, "
+                               "bytes_skipped INTEGER DEFAULT 0, "
+                               "error_message TEXT, "
+                               "FOREIGN KEY (repository_id) REFERENCES repositories(id) ON DELETE CASCADE, "
+                               "CHECK (status BETWEEN 0 AND 3))")) {
+            Utils::Logger::instance()->log(Utils::Logger::Error,
+                QString("创建 restore_journal 表失败: %1").arg(upgradeQuery.lastError().text()));
+            return false;
+        }
+
+        if (!upgradeQuery.exec("CREATE INDEX IF NOT EXISTS idx_restore_journal_start_time "
+                               "ON restore_journal(start_time)")) {
+            Utils::Logger::instance()->log(Utils::Logger::Error,
+                QString("创建 idx_restore_journal_start_time 索引失败: %1").arg(upgradeQuery.lastError().text()));
+            return false;
+        }
+
+        upgradeQuery.exec("INSERT OR REPLACE INTO schema_version (version, applied_at) VALUES (4, datetime('now'))");
+        m_schemaVersion = 4;
+        Utils::Logger::instance()->log(Utils::Logger::Info, "数据库已升级到版本4");
+    }
+
+    // 升级到版本 5：添加轮换验证计划表和切片验证记录表
+    if (currentVersion < 5) {
+        Utils::Logger::instance()->log(Utils::Logger::Info, "升级数据库到版本5：添加轮换验证表");
+
+        QSqlQuery upgradeQuery(m_database);
+        if (!upgradeQuery.exec("CREATE TABLE IF NOT EXISTS verification_plans ("
+                               "repository_id INTEGER PRIMARY KEY, "
+                               "enabled INTEGER DEFAULT 0, "
+                               "period_days INTEGER DEFAULT 30, "
+                               "time_budget_minutes INTEGER DEFAULT 60, "
+                               "bytes_budget INTEGER DEFAULT 0, "
+                               "slice_count INTEGER DEFAULT 0, "
+                               "next_slice INTEGER DEFAULT 1, "
+                               "repository_bytes INTEGER DEFAULT 0, "
+                               "cycle_started_at TEXT, "
+                               "last_run_at TEXT, "
+                               "last_cycle_completed_at TEXT, "
+                               "FOREIGN KEY (repository_id) REFERENCES repositories(id) ON DELETE CASCADE)")) {
+            Utils::Logger::instance()->log(Utils::Logger::Error,
+                QString("创建 verification_plans 表失败: %1").arg(upgradeQuery.lastError().text()));
+            return false;
+        }
+
+        if (!upgradeQuery.exec("CREATE TABLE IF NOT EXISTS verification_runs ("
+                               "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                               "repository_id INTEGER NOT NULL, "
+                               "slice_index INTEGER NOT NULL, "
+                               "slice_count INTEGER NOT NULL, "
+                               "start_time TEXT NOT NULL, "
+                               "end_time TEXT, "
+                               "success INTEGER DEFAULT 0, "
+                               "bytes_checked INTEGER DEFAULT 0, "
+                               "error_message TEXT, "
+                               "FOREIGN KEY (repository_id) REFERENCES repositories(id) ON DELETE CASCADE)")) {
+            Utils::Logger::instance()->log(Utils::Logger::Error,
+                QString("创建 verification_runs 表失败: %1").arg(upgradeQuery.lastError().text()));
+            return false;
+        }
+
+        if (!upgradeQuery.exec("CREATE INDEX IF NOT EXISTS idx_verification_runs_repo_time "
+                               "ON verification_runs(repository_id, start_time)")) {
+            Utils::Logger::instance()->log(Utils::Logger::Error,
+                QString("创建 idx_verification_runs_repo_time 索引失败: %1").arg(upgradeQuery.lastError().text()));
+            return false;
+        }
+
+        upgradeQuery.exec("INSERT OR REPLACE INTO schema_version (version, applied_at) VALUES (5, datetime('now'))");
+        m_schemaVersion = 5;
+        Utils::Logger::instance()->log(Utils::Logger::Info, "数据库已升级到版本5");
+    }
+
+    // 升级到版本 6：添加维护历史表
+    if (currentVersion < 6) {
+        Utils::Logger::instance()->log(Utils::Logger::Info, "升级数据库到版本6：添加维护历史表");
+
+        QSqlQuery upgradeQuery(m_database);
+        if (!upgradeQuery.exec("CREATE TABLE IF NOT EXISTS prune_history ("
+                               "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                               "repository_id INTEGER NOT NULL, "
+                               "start_time TEXT NOT NULL, "
+                               "end_time TEXT, "
+                               "success INTEGER DEFAULT 0, "
+                               "max_unused TEXT, "
+                               "max_repack_size INTEGER DEFAULT 0, "
+                               "repack_cacheable_only INTEGER DEFAULT 0, "
+                               "removed_snapshots INTEGER DEFAULT 0, "
+                               "repack_bytes INTEGER DEFAULT 0, "
+                               "repack_removed_bytes INTEGER DEFAULT 0, "
+                               "delete_bytes INTEGER DEFAULT 0, "
+                               "reclaimed_bytes INTEGER DEFAULT 0, "
+                               "remaining_bytes INTEGER DEFAULT 0, "
+                               "unused_after_bytes INTEGER DEFAULT 0, "
+                               "error_message TEXT, "
+                               "FOREIGN KEY (repository_id) REFERENCES repositories(id) ON DELETE CASCADE)")) {
+            Utils::Logger::instance()->log(Utils::Logger::Error,
+                QString("创建 prune_history 表失败: %1").arg(upgradeQuery.lastError().text()));
+            return false;
+        }
+
+        if (!upgradeQuery.exec("CREATE INDEX IF NOT EXISTS idx_prune_history_repo_time "
+                               "ON prune_history(repository_id, start_time)")) {
+            Utils::Logger::instance()->log(Utils::Logger::Error,
+                QString("创建 idx_prune_history_repo_time 索引失败: %1").arg(upgradeQuery.lastError().text()));
+            return false;
+        }
+
+        upgradeQuery.exec("INSERT OR REPLACE INTO schema_version (version, applied_at) VALUES (6, datetime('now'))");
+        m_schemaVersion = 6;
+        Utils::Logger::instance()->log(Utils::Logger::Info, "数据库已升级到版本6");
+    }
+
     return true;
 }
 
@@ -291,6 +450,8 @@ int DatabaseManager::insertRepository(const Models::Repository& repo)
 
 bool DatabaseManager::updateRepository(const Models::Repository& repo)
 {
+    DB_QUERY_SCOPE("updateRepository");
+
     QMutexLocker locker(&m_mutex);
 
     QSqlQuery query(m_database);
@@ -338,6 +499,8 @@ bool DatabaseManager::deleteRepository(int id)
 
 Models::Repository DatabaseManager::getRepository(int id)
 {
+    DB_QUERY_SCOPE("getRepository");
+
     QMutexLocker locker(&m_mutex);
 
     QSqlQuery query(m_database);
@@ -369,6 +532,8 @@ Models::Repository DatabaseManager::getRepository(int id)
 
 QList<Models::Repository> DatabaseManager::getAllRepositories()
 {
+    DB_QUERY_SCOPE("getAllRepositories");
+
     QMutexLocker locker(&m_mutex);
 
     QList<Models::Repository> repositories;
@@ -404,6 +569,8 @@ QList<Models::Repository> DatabaseManager::getAllRepositories()
 
 Models::Repository DatabaseManager::getDefaultRepository()
 {
+    DB_QUERY_SCOPE("getDefaultRepository");
+
     QMutexLocker locker(&m_mutex);
 
     QSqlQuery query(m_database);
@@ -522,6 +689,8 @@ int DatabaseManager::insertBackupTask(const Models::BackupTask& task)
 
 bool DatabaseManager::updateBackupTask(const Models::BackupTask& task)
 {
+    DB_QUERY_SCOPE("updateBackupTask");
+
     QMutexLocker locker(&m_mutex);
 
     QSqlQuery query(m_database);
@@ -590,6 +759,8 @@ bool DatabaseManager::deleteBackupTask(int id)
 
 Models::BackupTask DatabaseManager::getBackupTask(int id)
 {
+    DB_QUERY_SCOPE("getBackupTask");
+
     QMutexLocker locker(&m_mutex);
 
     QSqlQuery query(m_database);
@@ -640,6 +811,8 @@ Models::BackupTask DatabaseManager::getBackupTask(int id)
 
 QList<Models::BackupTask> DatabaseManager::getAllBackupTasks()
 {
+    DB_QUERY_SCOPE("getAllBackupTasks");
+
     QMutexLocker locker(&m_mutex);
 
     QList<Models::BackupTask> tasks;
@@ -703,6 +876,8 @@ QList<Models::BackupTask> DatabaseManager::getAllBackupTasks()
 
 QList<Models::BackupTask> DatabaseManager::getBackupTasksByRepository(int repoId)
 {
+    DB_QUERY_SCOPE("getBackupTasksByRepository");
+
     QMutexLocker locker(&m_mutex);
 
     QList<Models::BackupTask> tasks;
@@ -759,6 +934,8 @@ QList<Models::BackupTask> DatabaseManager::getBackupTasksByRepository(int repoId
 
 QList<Models::BackupTask> DatabaseManager::getEnabledBackupTasks()
 {
+    DB_QUERY_SCOPE("getEnabledBackupTasks");
+
     QMutexLocker locker(&m_mutex);
 
     QList<Models::BackupTask> tasks;
@@ -812,10 +989,80 @@ QList<Models::BackupTask> DatabaseManager::getEnabledBackupTasks()
     return tasks;
 }
 
+QList<Models::TaskListEntry> DatabaseManager::getTaskListEntries()
+{
+    DB_QUERY_SCOPE("getTaskListEntries");
+
+    QMutexLocker locker(&m_mutex);
+
+    QList<Models::TaskListEntry> entries;
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+
+    // 联接 repositories 获取仓库名称，子查询取最近一次执行状态
+    // （backup_history 上有 task_id + start_time 复合索引）
+    query.prepare(
+        "SELECT t.id, t.name, t.repository_id, t.source_paths, t.schedule_type, "
+        "t.enabled, t.last_run, t.next_run, r.name AS repo_name, "
+        "(SELECT h.status FROM backup_history h WHERE h.task_id = t.id "
+        " ORDER BY h.start_time DESC LIMIT 1) AS last_status "
+        "FROM backup_tasks t "
+        "LEFT JOIN repositories r ON t.repository_id = r.id "
+        "ORDER BY t.name ASC"
+    );
+
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        return entries;
+    }
+
+    while (query.next()) {
+        Models::TaskListEntry entry;
+        entry.id = query.value(0).toInt();
+        entry.name = query.value(1).toString();
+        entry.repositoryId = query.value(2).toInt();
+
+        // 只取第一个路径和路径数量
+        const QString sourcePaths = query.value(3).toString();
+        const QStringList paths = sourcePaths.split("\n", Qt::SkipEmptyParts);
+        entry.sourcePathCount = paths.size();
+        if (!paths.isEmpty()) {
+            entry.firstSourcePath = paths.first();
+        }
+
+        entry.scheduleType = static_cast<Models::Schedule::Type>(query.value(4).toInt());
+        entry.enabled = query.value(5).toInt() == 1;
+
+        const QString lastRunStr = query.value(6).toString();
+        if (!lastRunStr.isEmpty()) {
+            entry.lastRun = QDateTime::fromString(lastRunStr, Qt::ISODate);
+        }
+
+        const QString nextRunStr = query.value(7).toString();
+        if (!nextRunStr.isEmpty()) {
+            entry.nextRun = QDateTime::fromString(nextRunStr, Qt::ISODate);
+        }
+
+        entry.repositoryName = query.value(8).toString();
+
+        const QVariant lastStatus = query.value(9);
+        if (!lastStatus.isNull()) {
+            entry.hasLastStatus = true;
+            entry.lastStatus = static_cast<Models::BackupStatus>(lastStatus.toInt());
+        }
+
+        entries.append(entry);
+    }
+
+    return entries;
+}
+
 // ========== 备份历史表操作 ==========
 
 int DatabaseManager::insertBackupHistory(const Models::BackupResult& result)
 {
+    DB_QUERY_SCOPE("insertBackupHistory");
+
     QMutexLocker locker(&m_mutex);
 
     QSqlQuery query(m_database);
@@ -854,6 +1101,8 @@ int DatabaseManager::insertBackupHistory(const Models::BackupResult& result)
 
 QList<Models::BackupResult> DatabaseManager::getBackupHistory(int taskId, int limit)
 {
+    DB_QUERY_SCOPE("getBackupHistory");
+
     QMutexLocker locker(&m_mutex);
 
     QList<Models::BackupResult> results;
@@ -897,6 +1146,8 @@ QList<Models::BackupResult> DatabaseManager::getBackupHistory(int taskId, int li
 
 QList<Models::BackupResult> DatabaseManager::getRecentBackupHistory(int limit)
 {
+    DB_QUERY_SCOPE("getRecentBackupHistory");
+
     QMutexLocker locker(&m_mutex);
 
     QList<Models::BackupResult> results;
@@ -948,6 +1199,408 @@ QList<Models::BackupResult> DatabaseManager::getRecentBackupHistory(int limit)
     return results;
 }
 
+// ========== 恢复日志表操作 ==========
+
+static Models::RestoreJournalEntry restoreJournalFromQuery(const QSqlQuery& query)
+{
+    Models::RestoreJournalEntry entry;
+    entry.id = query.value("id").toInt();
+    entry.repositoryId = query.value("repository_id").toInt();
+    entry.snapshotId = query.value("snapshot_id").toString();
+
+    QJsonDocument optionsDoc = QJsonDocument::fromJson(query.value("options").toString().toUtf8());
+    entry.options = Models::RestoreOptions::fromVariantMap(optionsDoc.object().toVariantMap());
+    entry.options.targetPath = query.value("target_path").toString();
+
+    entry.status = static_cast<Models::RestoreStatus>(query.value("status").toInt());
+    entry.startTime = QDateTime::fromString(query.value("start_time").toString(), Qt::ISODate);
+    entry.endTime = QDateTime::fromString(query.value("end_time").toString(), Qt::ISODate);
+
+    entry.summary.totalFiles = query.value("total_files").toULongLong();
+    entry.summary.filesRestored = query.value("files_restored").toULongLong();
+    entry.summary.filesSkipped = query.value("files_skipped").toULongLong();
+    entry.summary.filesDeleted = query.value("files_deleted").toULongLong();
+    entry.summary.totalBytes = query.value("total_bytes").toULongLong();
+    entry.summary.bytesRestored = query.value("bytes_restored").toULongLong();
+    entry.summary.bytesSkipped = query.value("bytes_skipped").toULongLong();
+    entry.errorMessage = query.value("error_message").toString();
+    return entry;
+}
+
+int DatabaseManager::insertRestoreJournal(const Models::RestoreJournalEntry& entry)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QSqlQuery query(m_database);
+    query.prepare(
+        "INSERT INTO restore_journal (repository_id, snapshot_id, target_path, options, status, start_time) "
+        "VALUES (:repository_id, :snapshot_id, :target_path, :options, :status, :start_time)"
+    );
+
+    QJsonDocument optionsDoc = QJsonDocument::fromVariant(entry.options.toVariantMap());
+    query.bindValue(":repository_id", entry.repositoryId);
+    query.bindValue(":snapshot_id", entry.snapshotId);
+    query.bindValue(":target_path", entry.options.targetPath);
+    query.bindValue(":options", QString::fromUtf8(optionsDoc.toJson(QJsonDocument::Compact)));
+    query.bindValue(":status", static_cast<int>(entry.status));
+    query.bindValue(":start_time", entry.startTime.toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("插入恢复日志失败: %1").arg(m_lastError));
+        return -1;
+    }
+
+    return query.lastInsertId().toInt();
+}
+
+bool DatabaseManager::updateRestoreJournal(const Models::RestoreJournalEntry& entry)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QSqlQuery query(m_database);
+    query.prepare(
+        "UPDATE restore_journal SET status=:status, end_time=:end_time, "
+        "total_files=:total_files, files_restored=:files_restored, files_skipped=:files_skipped, "
+        "files_deleted=:files_deleted, total_bytes=:total_bytes, bytes_restored=:bytes_restored, "
+        "bytes_skipped=:bytes_skipped, error_message=:error_message "
+        "WHERE id=:id"
+    );
+
+    query.bindValue(":id", entry.id);
+    query.bindValue(":status", static_cast<int>(entry.status));
+    query.bindValue(":end_time", entry.endTime.toString(Qt::ISODate));
+    query.bindValue(":total_files", static_cast<qulonglong>(entry.summary.totalFiles));
+    query.bindValue(":files_restored", static_cast<qulonglong>(entry.summary.filesRestored));
+    query.bindValue(":files_skipped", static_cast<qulonglong>(entry.summary.filesSkipped));
+    query.bindValue(":files_deleted", static_cast<qulonglong>(entry.summary.filesDeleted));
+    query.bindValue(":total_bytes", static_cast<qulonglong>(entry.summary.totalBytes));
+    query.bindValue(":bytes_restored", static_cast<qulonglong>(entry.summary.bytesRestored));
+    query.bindValue(":bytes_skipped", static_cast<qulonglong>(entry.summary.bytesSkipped));
+    query.bindValue(":error_message", entry.errorMessage);
+
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("更新恢复日志失败: %1").arg(m_lastError));
+        return false;
+    }
+
+    return true;
+}
+
+Models::RestoreJournalEntry DatabaseManager::getRestoreJournal(int id)
+{
+    DB_QUERY_SCOPE("getRestoreJournal");
+
+    QMutexLocker locker(&m_mutex);
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM restore_journal WHERE id=:id");
+    query.bindValue(":id", id);
+
+    if (!query.exec() || !query.next()) {
+        m_lastError = query.lastError().text();
+        return Models::RestoreJournalEntry();
+    }
+
+    return restoreJournalFromQuery(query);
+}
+
+QList<Models::RestoreJournalEntry> DatabaseManager::getRecentRestoreJournal(int limit)
+{
+    DB_QUERY_SCOPE("getRecentRestoreJournal");
+
+    QMutexLocker locker(&m_mutex);
+
+    QList<Models::RestoreJournalEntry> entries;
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM restore_journal ORDER BY start_time DESC LIMIT :limit");
+    query.bindValue(":limit", limit);
+
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("获取恢复日志失败: %1").arg(m_lastError));
+        return entries;
+    }
+
+    while (query.next()) {
+        entries.append(restoreJournalFromQuery(query));
+    }
+
+    return entries;
+}
+
+int DatabaseManager::markInterruptedRestores()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QSqlQuery query(m_database);
+    query.prepare("UPDATE restore_journal SET status=:interrupted WHERE status=:running");
+    query.bindValue(":interrupted", static_cast<int>(Models::RestoreStatus::Interrupted));
+    query.bindValue(":running", static_cast<int>(Models::RestoreStatus::Running));
+
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        return 0;
+    }
+
+    return query.numRowsAffected();
+}
+
+// ========== 轮换验证表操作 ==========
+
+static Models::VerificationPlan verificationPlanFromQuery(const QSqlQuery& query)
+{
+    Models::VerificationPlan plan;
+    plan.repositoryId = query.value("repository_id").toInt();
+    plan.enabled = query.value("enabled").toBool();
+    plan.periodDays = query.value("period_days").toInt();
+    plan.timeBudgetMinutes = query.value("time_budget_minutes").toInt();
+    plan.bytesBudget = query.value("bytes_budget").toLongLong();
+    plan.sliceCount = query.value("slice_count").toInt();
+    plan.nextSlice = query.value("next_slice").toInt();
+    plan.repositoryBytes = query.value("repository_bytes").toLongLong();
+    plan.cycleStartedAt = QDateTime::fromString(query.value("cycle_started_at").toString(), Qt::ISODate);
+    plan.lastRunAt = QDateTime::fromString(query.value("last_run_at").toString(), Qt::ISODate);
+    plan.lastCycleCompletedAt = QDateTime::fromString(query.value("last_cycle_completed_at").toString(), Qt::ISODate);
+    return plan;
+}
+
+Models::VerificationPlan DatabaseManager::getVerificationPlan(int repoId)
+{
+    DB_QUERY_SCOPE("getVerificationPlan");
+
+    QMutexLocker locker(&m_mutex);
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM verification_plans WHERE repository_id=:repository_id");
+    query.bindValue(":repository_id", repoId);
+
+    if (!query.exec() || !query.next()) {
+        m_lastError = query.lastError().text();
+        Models::VerificationPlan plan;
+        plan.repositoryId = repoId;
+        return plan;
+    }
+
+    return verificationPlanFromQuery(query);
+}
+
+QList<Models::VerificationPlan> DatabaseManager::getEnabledVerificationPlans()
+{
+    DB_QUERY_SCOPE("getEnabledVerificationPlans");
+
+    QMutexLocker locker(&m_mutex);
+
+    QList<Models::VerificationPlan> plans;
+    QSqlQuery query(m_database);
+    if (!query.exec("SELECT * FROM verification_plans WHERE enabled=1")) {
+        m_lastError = query.lastError().text();
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("获取验证计划失败: %1").arg(m_lastError));
+        return plans;
+    }
+
+    while (query.next()) {
+        plans.append(verificationPlanFromQuery(query));
+    }
+
+    return plans;
+}
+
+bool DatabaseManager::saveVerificationPlan(const Models::VerificationPlan& plan)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QSqlQuery query(m_database);
+    query.prepare(
+        "INSERT OR REPLACE INTO verification_plans (repository_id, enabled, period_days, time_budget_minutes, "
+        "bytes_budget, slice_count, next_slice, repository_bytes, cycle_started_at, last_run_at, "
+        "last_cycle_completed_at) "
+        "VALUES (:repository_id, :enabled, :period_days, :time_budget_minutes, :bytes_budget, :slice_count, "
+        ":next_slice, :repository_bytes, :cycle_started_at, :last_run_at, :last_cycle_completed_at)"
+    );
+
+    query.bindValue(":repository_id", plan.repositoryId);
+    query.bindValue(":enabled", plan.enabled ? 1 : 0);
+    query.bindValue(":period_days", plan.periodDays);
+    query.bindValue(":time_budget_minutes", plan.timeBudgetMinutes);
+    query.bindValue(":bytes_budget", plan.bytesBudget);
+    query.bindValue(":slice_count", plan.sliceCount);
+    query.bindValue(":next_slice", plan.nextSlice);
+    query.bindValue(":repository_bytes", plan.repositoryBytes);
+    query.bindValue(":cycle_started_at", plan.cycleStartedAt.toString(Qt::ISODate));
+    query.bindValue(":last_run_at", plan.lastRunAt.toString(Qt::ISODate));
+    query.bindValue(":last_cycle_completed_at", plan.lastCycleCompletedAt.toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("保存验证计划失败: %1").arg(m_lastError));
+        return false;
+    }
+
+    return true;
+}
+
+int DatabaseManager::insertVerificationRun(const Models::VerificationRun& run)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QSqlQuery query(m_database);
+    query.prepare(
+        "INSERT INTO verification_runs (repository_id, slice_index, slice_count, start_time, end_time, "
+        "success, bytes_checked, error_message) "
+        "VALUES (:repository_id, :slice_index, :slice_count, :start_time, :end_time, "
+        ":success, :bytes_checked, :error_message)"
+    );
+
+    query.bindValue(":repository_id", run.repositoryId);
+    query.bindValue(":slice_index", run.sliceIndex);
+    query.bindValue(":slice_count", run.sliceCount);
+    query.bindValue(":start_time", run.startTime.toString(Qt::ISODate));
+    query.bindValue(":end_time", run.endTime.toString(Qt::ISODate));
+    query.bindValue(":success", run.success ? 1 : 0);
+    query.bindValue(":bytes_checked", run.bytesChecked);
+    query.bindValue(":error_message", run.errorMessage);
+
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("插入验证记录失败: %1").arg(m_lastError));
+        return -1;
+    }
+
+    return query.lastInsertId().toInt();
+}
+
+QList<Models::VerificationRun> DatabaseManager::getVerificationRuns(int repoId, const QDateTime& since)
+{
+    DB_QUERY_SCOPE("getVerificationRuns");
+
+    QMutexLocker locker(&m_mutex);
+
+    QList<Models::VerificationRun> runs;
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM verification_runs WHERE repository_id=:repository_id "
+                  "AND start_time>=:since ORDER BY start_time DESC");
+    query.bindValue(":repository_id", repoId);
+    query.bindValue(":since", since.toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("获取验证记录失败: %1").arg(m_lastError));
+        return runs;
+    }
+
+    while (query.next()) {
+        Models::VerificationRun run;
+        run.id = query.value("id").toInt();
+        run.repositoryId = query.value("repository_id").toInt();
+        run.sliceIndex = query.value("slice_index").toInt();
+        run.sliceCount = query.value("slice_count").toInt();
+        run.startTime = QDateTime::fromString(query.value("start_time").toString(), Qt::ISODate);
+        run.endTime = QDateTime::fromString(query.value("end_time").toString(), Qt::ISODate);
+        run.success = query.value("success").toBool();
+        run.bytesChecked = query.value("bytes_checked").toLongLong();
+        run.errorMessage = query.value("error_message").toString();
+        runs.append(run);
+    }
+
+    return runs;
+}
+
+// ========== 维护历史表操作 ==========
+
+int DatabaseManager::insertPruneRecord(const Models::PruneRecord& record)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QSqlQuery query(m_database);
+    query.prepare(
+        "INSERT INTO prune_history (repository_id, start_time, end_time, success, max_unused, max_repack_size, "
+        "repack_cacheable_only, removed_snapshots, repack_bytes, repack_removed_bytes, delete_bytes, "
+        "reclaimed_bytes, remaining_bytes, unused_after_bytes, error_message) "
+        "VALUES (:repository_id, :start_time, :end_time, :success, :max_unused, :max_repack_size, "
+        ":repack_cacheable_only, :removed_snapshots, :repack_bytes, :repack_removed_bytes, :delete_bytes, "
+        ":reclaimed_bytes, :remaining_bytes, :unused_after_bytes, :error_message)"
+    );
+
+    query.bindValue(":repository_id", record.repositoryId);
+    query.bindValue(":start_time", record.startTime.toString(Qt::ISODate));
+    query.bindValue(":end_time", record.endTime.toString(Qt::ISODate));
+    query.bindValue(":success", record.success ? 1 : 0);
+    query.bindValue(":max_unused", record.options.maxUnused);
+    query.bindValue(":max_repack_size", record.options.maxRepackSize);
+    query.bindValue(":repack_cacheable_only", record.options.repackCacheableOnly ? 1 : 0);
+    query.bindValue(":removed_snapshots", record.stats.removedSnapshots);
+    query.bindValue(":repack_bytes", record.stats.repackBytes);
+    query.bindValue(":repack_removed_bytes", record.stats.repackRemovedBytes);
+    query.bindValue(":delete_bytes", record.stats.deleteBytes);
+    query.bindValue(":reclaimed_bytes", record.stats.reclaimedBytes);
+    query.bindValue(":remaining_bytes", record.stats.remainingBytes);
+    query.bindValue(":unused_after_bytes", record.stats.unusedAfterBytes);
+    query.bindValue(":error_message", record.errorMessage);
+
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("插入维护记录失败: %1").arg(m_lastError));
+        return -1;
+    }
+
+    return query.lastInsertId().toInt();
+}
+
+QList<Models::PruneRecord> DatabaseManager::getPruneHistory(int repoId, int limit)
+{
+    DB_QUERY_SCOPE("getPruneHistory");
+
+    QMutexLocker locker(&m_mutex);
+
+    QList<Models::PruneRecord> records;
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM prune_history WHERE repository_id=:repository_id "
+                  "ORDER BY start_time DESC LIMIT :limit");
+    query.bindValue(":repository_id", repoId);
+    query.bindValue(":limit", limit);
+
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        Utils::Logger::instance()->log(Utils::Logger::Error,
+            QString("获取维护记录失败: %1").arg(m_lastError));
+        return records;
+    }
+
+    while (query.next()) {
+        Models::PruneRecord record;
+        record.id = query.value("id").toInt();
+        record.repositoryId = query.value("repository_id").toInt();
+        record.startTime = QDateTime::fromString(query.value("start_time").toString(), Qt::ISODate);
+        record.endTime = QDateTime::fromString(query.value("end_time").toString(), Qt::ISODate);
+        record.success = query.value("success").toBool();
+        record.options.maxUnused = query.value("max_unused").toString();
+        record.options.maxRepackSize = query.value("max_repack_size").toLongLong();
+        record.options.repackCacheableOnly = query.value("repack_cacheable_only").toBool();
+        record.stats.valid = true;
+        record.stats.removedSnapshots = query.value("removed_snapshots").toInt();
+        record.stats.repackBytes = query.value("repack_bytes").toLongLong();
+        record.stats.repackRemovedBytes = query.value("repack_removed_bytes").toLongLong();
+        record.stats.deleteBytes = query.value("delete_bytes").toLongLong();
+        record.stats.reclaimedBytes = query.value("reclaimed_bytes").toLongLong();
+        record.stats.remainingBytes = query.value("remaining_bytes").toLongLong();
+        record.stats.unusedAfterBytes = query.value("unused_after_bytes").toLongLong();
+        record.errorMessage = query.value("error_message").toString();
+        records.append(record);
+    }
+
+    return records;
+}
+
 // ========== 快照缓存表操作 ==========
 
 bool DatabaseManager::cacheSnapshots(int repoId, const QList<Models::Snapshot>& snapshots)
@@ -998,6 +1651,8 @@ bool DatabaseManager::cacheSnapshots(int repoId, const QList<Models::Snapshot>&
 
 QList<Models::Snapshot> DatabaseManager::getCachedSnapshots(int repoId)
 {
+    DB_QUERY_SCOPE("getCachedSnapshots");
+
     QMutexLocker locker(&m_mutex);
 
     QList<Models::Snapshot> snapshots;
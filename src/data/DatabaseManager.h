@@ -9,6 +9,10 @@
 #include "../models/BackupTask.h"
 #include "../models/Snapshot.h"
 #include "../models/BackupResult.h"
+#include "../models/TaskListEntry.h"
+#include "../models/RestoreJournal.h"
+#include "../models/VerificationPlan.h"
+#include "../models/PruneRecord.h"
 
 namespace ResticGUI {
 namespace Data {
@@ -132,6 +136,15 @@ public:
      */
     QList<Models::BackupTask> getEnabledBackupTasks();
 
+    /**
+     * @brief 获取任务列表显示数据
+     *
+     * 一次联表查询返回列表所需的列（任务、仓库名称、调度类型、
+     * 上次/下次执行时间、最近一次执行状态），避免逐行查询仓库。
+     * @return 按任务名称排序的列表行
+     */
+    QList<Models::TaskListEntry> getTaskListEntries();
+
     // ========== 备份历史表操作 ==========
 
     /**
@@ -151,6 +164,76 @@ public:
      */
     QList<Models::BackupResult> getRecentBackupHistory(int limit = 10);
 
+    // ========== 恢复日志表操作 ==========
+
+    /**
+     * @brief 插入恢复日志
+     * @return 新记录ID，失败返回 -1
+     */
+    int insertRestoreJournal(const Models::RestoreJournalEntry& entry);
+
+    /**
+     * @brief 更新恢复日志的状态、统计和结束时间
+     */
+    bool updateRestoreJournal(const Models::RestoreJournalEntry& entry);
+
+    /**
+     * @brief 获取单条恢复日志
+     */
+    Models::RestoreJournalEntry getRestoreJournal(int id);
+
+    /**
+     * @brief 获取最近的恢复日志，按开始时间倒序排列
+     */
+    QList<Models::RestoreJournalEntry> getRecentRestoreJournal(int limit = 20);
+
+    /**
+     * @brief 把仍为运行中的恢复日志标记为已中断（启动时调用）
+     * @return 被标记的记录数
+     */
+    int markInterruptedRestores();
+
+    // ========== 轮换验证表操作 ==========
+
+    /**
+     * @brief 获取仓库的验证计划，没有记录时返回默认计划
+     */
+    Models::VerificationPlan getVerificationPlan(int repoId);
+
+    /**
+     * @brief 获取所有已启用的验证计划
+     */
+    QList<Models::VerificationPlan> getEnabledVerificationPlans();
+
+    /**
+     * @brief 保存验证计划（包括本轮进度）
+     */
+    bool saveVerificationPlan(const Models::VerificationPlan& plan);
+
+    /**
+     * @brief 插入切片验证记录
+     * @return 新记录ID，失败返回 -1
+     */
+    int insertVerificationRun(const Models::VerificationRun& run);
+
+    /**
+     * @brief 获取仓库在指定时间之后的切片验证记录，按开始时间倒序排列
+     */
+    QList<Models::VerificationRun> getVerificationRuns(int repoId, const QDateTime& since);
+
+    // ========== 维护历史表操作 ==========
+
+    /**
+     * @brief 插入维护记录
+     * @return 新记录ID，失败返回 -1
+     */
+    int insertPruneRecord(const Models::PruneRecord& record);
+
+    /**
+     * @brief 获取仓库最近的维护记录，按开始时间倒序排列
+     */
+    QList<Models::PruneRecord> getPruneHistory(int repoId, int limit = 20);
+
     // ========== 快照缓存表操作 ==========
 
     /**
@@ -6,21 +6,87 @@
  */
 
 #include <QApplication>
+#include <QScopedPointer>
+#include <cstring>
 #include <QTranslator>
 #include <QLocale>
 #include <QDir>
 #include <QStandardPaths>
+#include <QElapsedTimer>
 #include "ui/MainWindow.h"
 #include "utils/Logger.h"
+#include "utils/Tracer.h"
+#include "utils/Metrics.h"
 #include "data/DatabaseManager.h"
 #include "data/ConfigManager.h"
 #include "core/SchedulerManager.h"
+#include "core/RestoreManager.h"
+#include "core/MountManager.h"
+#include "core/VerificationScheduler.h"
+#include "core/MetricsExporter.h"
+#include "core/DaemonServer.h"
+#include "core/DaemonClient.h"
 
 using namespace ResticGUI;
 
+namespace {
+
+// 创建 QApplication 之前就要知道运行模式，只能直接检查 argv
+bool hasArgument(int argc, char *argv[], const char* name)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 记录从进程启动到主窗口第一次绘制的耗时：日志、指标和性能跟踪各一份
+void reportFirstPaint(qint64 elapsedMs)
+{
+    Utils::Logger::LogContext context;
+    context.durationMs = elapsedMs;
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("主窗口首次绘制完成，启动耗时 %1 ms").arg(elapsedMs), context);
+
+    Utils::MetricsRegistry::instance()->gauge("resticgui_startup_first_paint_seconds",
+        "启动到主窗口首次绘制的耗时（秒）")->set(elapsedMs / 1000.0);
+    Utils::Tracer::instance()->instant("first-paint", "startup", QString("%1 ms").arg(elapsedMs));
+}
+
+// 图形界面是否仍负责计划任务：后台服务可能在本程序之后才启动（用户或服务管理器），
+// 每次触发计划任务前都确认一次，发现后台服务后交出计划任务，避免同一任务执行两次
+bool scheduleOwnedLocally()
+{
+    Core::DaemonClient* client = Core::DaemonClient::instance();
+    if (client->isConnected()) {
+        return false;
+    }
+    if (!client->connectToDaemon(200)) {
+        return true;
+    }
+
+    Utils::Logger::instance()->info("检测到后台服务，计划任务改由后台服务执行");
+    // 检查在调度器持有内部锁时进行，停止调度器放到事件循环中
+    QMetaObject::invokeMethod(QCoreApplication::instance(), []() {
+        Core::SchedulerManager::instance()->stop();
+        Core::VerificationScheduler::instance()->stop();
+    }, Qt::QueuedConnection);
+    return false;
+}
+
+} // namespace
+
 int main(int argc, char *argv[])
 {
-    QApplication app(argc, argv);
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
+    // 后台服务模式不需要窗口系统，使用 QCoreApplication，在没有图形会话的服务器上也能运行
+    const bool daemonMode = hasArgument(argc, argv, "--daemon");
+    QScopedPointer<QCoreApplication> app(daemonMode ? new QCoreApplication(argc, argv)
+                                                    : new QApplication(argc, argv));
 
     // 设置应用程序信息
     QCoreApplication::setOrganizationName("ResticGUI");
@@ -29,23 +95,36 @@ int main(int argc, char *argv[])
     QCoreApplication::setApplicationVersion("1.0.0");
 
     // 禁用"最后一个窗口关闭时退出"，因为我们使用系统托盘
-    app.setQuitOnLastWindowClosed(false);
+    if (!daemonMode) {
+        static_cast<QApplication*>(app.data())->setQuitOnLastWindowClosed(false);
+    }
 
     // 初始化日志系统
     QString logPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/logs";
     QDir().mkpath(logPath);
+    Data::ConfigManager* config = Data::ConfigManager::instance();
+    Utils::Logger::instance()->setFormat(config->getStructuredLogs() ? Utils::Logger::JsonLines : Utils::Logger::Text);
+    Utils::Logger::instance()->setRotation(config->getLogMaxFileSizeMB() * Q_INT64_C(1024) * 1024,
+                                           config->getLogRetentionDays(), config->getCompressRotatedLogs());
     Utils::Logger::instance()->setLogFile(logPath + "/restic-gui.log");
     Utils::Logger::instance()->setLevel(Utils::Logger::Debug);  // 开启调试日志
 
     Utils::Logger::instance()->info("========================================");
-    Utils::Logger::instance()->info("Restic GUI v1.0.0 启动");
+    Utils::Logger::instance()->info(daemonMode ? "Restic GUI v1.0.0 后台服务启动" : "Restic GUI v1.0.0 启动");
     Utils::Logger::instance()->info("========================================");
 
+    // 设置了 RESTIC_GUI_TRACE 时记录性能跟踪，退出时导出到该文件
+    const QString traceFile = qEnvironmentVariable("RESTIC_GUI_TRACE");
+    if (!traceFile.isEmpty()) {
+        Utils::Tracer::instance()->setEnabled(true);
+        Utils::Logger::instance()->info(QString("性能跟踪已启用，退出时导出到: %1").arg(traceFile));
+    }
+
     // 加载翻译文件
     QTranslator translator;
     QString translationPath = ":/translations";
     if (translator.load(QLocale(), "restic_gui", "_", translationPath)) {
-        app.installTranslator(&translator);
+        app->installTranslator(&translator);
         Utils::Logger::instance()->info("已加载中文翻译");
     }
 
@@ -60,6 +139,7 @@ int main(int argc, char *argv[])
     if (!Data::DatabaseManager::instance()->initialize(dbFile)) {
         QString error = Data::DatabaseManager::instance()->lastError();
         Utils::Logger::instance()->critical(QString("数据库初始化失败: %1").arg(error));
+        Utils::Logger::instance()->shutdown();
         return -1;
     }
 
@@ -67,24 +147,99 @@ int main(int argc, char *argv[])
     Utils::Logger::instance()->info(QString("restic 路径: %1")
         .arg(Data::ConfigManager::instance()->getResticPath()));
 
-    // 初始化并启动调度管理器
-    Utils::Logger::instance()->info("初始化调度管理器");
-    Core::SchedulerManager* scheduler = Core::SchedulerManager::instance();
-    scheduler->initialize();
-    scheduler->start();
-    Utils::Logger::instance()->info("调度管理器已启动");
-
-    // 创建并显示主窗口
-    UI::MainWindow mainWindow;
-    mainWindow.show();
+    // 后台服务：只运行调度、备份和数据库，通过控制套接字接受图形界面的连接
+    // 图形界面：已有后台服务时连接它，计划任务交给后台服务执行，避免重复运行
+    bool runScheduler = true;
+    QScopedPointer<UI::MainWindow> mainWindow;
+    if (daemonMode) {
+        Core::DaemonServer* server = Core::DaemonServer::instance();
+        if (!server->start()) {
+            Utils::Logger::instance()->shutdown();
+            return 1;
+        }
+        server->installSignalHandlers();
+        QObject::connect(server, &Core::DaemonServer::shutdownRequested, app.data(), &QCoreApplication::quit);
+    } else {
+        if (Core::DaemonClient::instance()->connectToDaemon()) {
+            runScheduler = false;
+            Utils::Logger::instance()->info("检测到后台服务，计划任务由后台服务执行");
+        }
+
+        // 后台服务退出后由本程序接管计划任务（包括本程序运行期间才连上的后台服务）
+        QObject::connect(Core::DaemonClient::instance(), &Core::DaemonClient::connectionLost, app.data(), []() {
+            Utils::Logger::instance()->info("后台服务已退出，由本程序执行计划任务");
+            Core::SchedulerManager::instance()->initializeAsync();
+            Core::SchedulerManager::instance()->start();
+            Core::VerificationScheduler::instance()->initialize();
+            Core::MetricsExporter::instance()->initialize();
+        });
+
+        Core::SchedulerManager::instance()->setRunGuard(scheduleOwnedLocally);
+        Core::VerificationScheduler::instance()->setRunGuard(scheduleOwnedLocally);
+    }
 
-    Utils::Logger::instance()->info("主窗口已显示");
+    // 调度相关的服务不影响界面显示，图形界面下推迟到主窗口第一次绘制之后再启动
+    auto startBackgroundServices = [runScheduler]() {
+        if (!runScheduler) {
+            return;
+        }
+
+        // 启动调度管理器，任务在后台线程加载，加载完成前计时器还不会到期
+        Utils::Logger::instance()->info("初始化调度管理器");
+        Core::SchedulerManager* scheduler = Core::SchedulerManager::instance();
+        scheduler->initializeAsync();
+        scheduler->start();
+        Utils::Logger::instance()->info("调度管理器已启动");
+
+        // 初始化验证调度器，按计划轮换验证仓库数据
+        Core::VerificationScheduler::instance()->initialize();
+
+        // 按配置启动指标端点和指标文件，由执行计划任务的进程提供
+        Core::MetricsExporter::instance()->initialize();
+    };
+
+    // 初始化恢复管理器，标记上次退出时被中断的恢复
+    Core::RestoreManager::instance()->initialize();
+
+    if (daemonMode) {
+        startBackgroundServices();
+    } else {
+        // 初始化挂载管理器，退出时卸载所有挂载点
+        Core::MountManager::instance()->initialize();
+
+        // 创建并显示主窗口，页面在第一次切换到时才创建
+        mainWindow.reset(new UI::MainWindow);
+        QObject::connect(mainWindow.data(), &UI::MainWindow::firstPaint, app.data(),
+                         [&startupTimer, startBackgroundServices]() {
+            reportFirstPaint(startupTimer.elapsed());
+            startBackgroundServices();
+        });
+        mainWindow->show();
+
+        Utils::Logger::instance()->info("主窗口已显示");
+    }
 
     // 进入事件循环
-    int ret = app.exec();
+    int ret = app->exec();
+
+    if (daemonMode) {
+        Core::DaemonServer::instance()->stop();
+    }
+    mainWindow.reset();
 
     Utils::Logger::instance()->info(QString("应用程序退出，返回码: %1").arg(ret));
     Utils::Logger::instance()->info("========================================\n");
 
+    // 最后写一次指标文件，collector 能看到退出前的计数
+    Core::MetricsExporter::instance()->writeTextfile();
+
+    if (!traceFile.isEmpty()) {
+        Utils::Tracer::instance()->setEnabled(false);
+        Utils::Tracer::instance()->exportChromeTrace(traceFile);
+    }
+
+    // 写出异步日志队列中剩余的日志
+    Utils::Logger::instance()->shutdown();
+
     return ret;
 }
@@ -37,6 +37,7 @@ QVariantMap BackupTask::toVariantMap() const
     map["noExtraVerify"] = noExtraVerify;
     map["readConcurrency"] = readConcurrency;
     map["packSize"] = packSize;
+    map["skipIfUnchanged"] = skipIfUnchanged;
 
     return map;
 }
@@ -75,6 +76,7 @@ BackupTask BackupTask::fromVariantMap(const QVariantMap& map)
     task.noExtraVerify = map.value("noExtraVerify", false).toBool();
     task.readConcurrency = map.value("readConcurrency", 0).toInt();
     task.packSize = map.value("packSize", 0).toInt();
+    task.skipIfUnchanged = map.value("skipIfUnchanged", false).toBool();
 
     return task;
 }
@@ -51,6 +51,7 @@ struct BackupTask
     bool noExtraVerify = false;    // 禁用额外验证
     int readConcurrency = 0;       // 文件读取并发数 (0表示使用默认值)
     int packSize = 0;              // 包大小(MiB) (0表示使用默认值16)
+    bool skipIfUnchanged = false;  // 数据没有变化时不创建快照
 
     // 运行时填充
     Repository repository;
@@ -0,0 +1,6 @@
+#include "FileVersion.h"
+
+namespace ResticGUI {
+namespace Models {
+} // namespace Models
+} // namespace ResticGUI
@@ -0,0 +1,34 @@
+/**
+ * @file FileVersion.h
+ * @brief 文件在某个快照中的版本
+ */
+
+#ifndef FILEVERSION_H
+#define FILEVERSION_H
+
+#include <QString>
+#include <QDateTime>
+#include "FileInfo.h"
+
+namespace ResticGUI {
+namespace Models {
+
+/**
+ * @brief 文件历史中的一个版本
+ *
+ * 同一路径在不同快照中的大小和修改时间，由 FileHistoryIndex 查询得到。
+ */
+struct FileVersion
+{
+    QString snapshotId;
+    QDateTime snapshotTime;
+    QString hostname;
+    FileType type = FileType::File;
+    qint64 size = 0;
+    QDateTime mtime;
+};
+
+} // namespace Models
+} // namespace ResticGUI
+
+#endif // FILEVERSION_H
@@ -0,0 +1,6 @@
+#include "MountSession.h"
+
+namespace ResticGUI {
+namespace Models {
+} // namespace Models
+} // namespace ResticGUI
@@ -0,0 +1,53 @@
+/**
+ * @file MountSession.h
+ * @brief 仓库挂载会话
+ */
+
+#ifndef MOUNTSESSION_H
+#define MOUNTSESSION_H
+
+#include <QString>
+#include <QDateTime>
+
+namespace ResticGUI {
+namespace Models {
+
+enum class MountState
+{
+    Starting,       // restic mount 已启动，等待挂载就绪
+    Mounted,
+    Unmounting,
+    Stopped,
+    Failed
+};
+
+/**
+ * @brief 一个 restic mount 进程及其挂载点
+ *
+ * restic mount 挂载整个仓库，单个快照位于挂载点下的 ids/<短ID> 目录中。
+ */
+struct MountSession
+{
+    int id = -1;
+    int repositoryId = -1;
+    QString mountPoint;
+    MountState state = MountState::Starting;
+    QDateTime startedAt;
+    QString lastError;
+
+    bool isActive() const {
+        return state == MountState::Starting || state == MountState::Mounted;
+    }
+
+    /**
+     * @brief 快照在挂载点中的目录
+     */
+    QString snapshotPath(const QString& snapshotId) const {
+        return mountPoint + "/ids/" + snapshotId.left(8);
+    }
+};
+
+} // namespace Models
+} // namespace ResticGUI
+
+#endif // MOUNTSESSION_H
@@ -0,0 +1,6 @@
+#include "PruneRecord.h"
+
+namespace ResticGUI {
+namespace Models {
+} // namespace Models
+} // namespace ResticGUI
@@ -0,0 +1,77 @@
+/**
+ * @file PruneRecord.h
+ * @brief 仓库维护（forget --prune）的参数、统计和历史记录
+ */
+
+#ifndef PRUNERECORD_H
+#define PRUNERECORD_H
+
+#include <QString>
+#include <QDateTime>
+
+namespace ResticGUI {
+namespace Models {
+
+/**
+ * @brief 一次维护的保留策略和 prune 调优参数
+ */
+struct PruneOptions
+{
+    int keepLast = 0;
+    int keepDaily = 0;
+    int keepWeekly = 0;
+    int keepMonthly = 0;
+    int keepYearly = 0;
+
+    QString maxUnused;              // --max-unused，如 "5%"、"unlimited"，空表示 restic 默认（5%）
+    qint64 maxRepackSize = 0;       // --max-repack-size（字节），0 表示不限
+    bool repackCacheableOnly = false;   // --repack-cacheable-only
+
+    bool hasKeepPolicy() const {
+        return keepLast > 0 || keepDaily > 0 || keepWeekly > 0 || keepMonthly > 0 || keepYearly > 0;
+    }
+};
+
+/**
+ * @brief restic prune 输出的统计信息
+ *
+ * 重新打包要下载部分使用的数据包，丢弃其中未使用的数据后重新上传保留的部分；
+ * 完全未使用的数据包直接删除，不产生传输。
+ */
+struct PruneStats
+{
+    bool valid = false;
+    int removedSnapshots = 0;
+    qint64 repackBytes = 0;         // 重新打包时保留并重新上传的数据（to repack）
+    qint64 repackRemovedBytes = 0;  // 重新打包时丢弃的数据（this removes）
+    qint64 deleteBytes = 0;         // 随整个数据包删除的数据（to delete）
+    qint64 reclaimedBytes = 0;      // 释放的空间（total prune）
+    qint64 remainingBytes = 0;
+    qint64 unusedAfterBytes = 0;    // prune 后仍未使用的数据
+
+    qint64 downloadBytes() const { return repackBytes + repackRemovedBytes; }
+    qint64 uploadBytes() const { return repackBytes; }
+    qint64 transferBytes() const { return downloadBytes() + uploadBytes(); }
+};
+
+/**
+ * @brief 一次维护的历史记录
+ */
+struct PruneRecord
+{
+    int id = -1;
+    int repositoryId = -1;
+    QDateTime startTime;
+    QDateTime endTime;
+    bool success = false;
+    PruneOptions options;
+    PruneStats stats;
+    QString errorMessage;
+
+    qint64 durationSecs() const { return startTime.secsTo(endTime); }
+};
+
+} // namespace Models
+} // namespace ResticGUI
+
+#endif // PRUNERECORD_H
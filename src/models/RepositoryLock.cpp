@@ -0,0 +1,6 @@
+#include "RepositoryLock.h"
+
+namespace ResticGUI {
+namespace Models {
+} // namespace Models
+} // namespace ResticGUI
@@ -0,0 +1,33 @@
+/**
+ * @file RepositoryLock.h
+ * @brief 仓库中的 restic 锁
+ */
+
+#ifndef REPOSITORYLOCK_H
+#define REPOSITORYLOCK_H
+
+#include <QString>
+#include <QDateTime>
+
+namespace ResticGUI {
+namespace Models {
+
+/**
+ * @brief restic cat lock 输出的一个锁文件
+ *
+ * restic 运行期间每 5 分钟刷新一次锁的时间，进程崩溃后锁文件会一直留在仓库中。
+ */
+struct RepositoryLock
+{
+    QString id;
+    QDateTime time;             // 创建或最近一次刷新的时间
+    bool exclusive = false;
+    QString hostname;
+    QString username;
+    qint64 pid = 0;
+};
+
+} // namespace Models
+} // namespace ResticGUI
+
+#endif // REPOSITORYLOCK_H
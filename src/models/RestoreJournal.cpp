@@ -0,0 +1,19 @@
+#include "RestoreJournal.h"
+
+namespace ResticGUI {
+namespace Models {
+
+RestoreSummary& RestoreSummary::operator+=(const RestoreSummary& other)
+{
+    totalFiles += other.totalFiles;
+    filesRestored += other.filesRestored;
+    filesSkipped += other.filesSkipped;
+    filesDeleted += other.filesDeleted;
+    totalBytes += other.totalBytes;
+    bytesRestored += other.bytesRestored;
+    bytesSkipped += other.bytesSkipped;
+    return *this;
+}
+
+} // namespace Models
+} // namespace ResticGUI
@@ -0,0 +1,67 @@
+/**
+ * @file RestoreJournal.h
+ * @brief 恢复日志记录
+ */
+
+#ifndef RESTOREJOURNAL_H
+#define RESTOREJOURNAL_H
+
+#include <QString>
+#include <QDateTime>
+#include "RestoreOptions.h"
+
+namespace ResticGUI {
+namespace Models {
+
+enum class RestoreStatus
+{
+    Running,
+    Completed,
+    Failed,
+    Interrupted     // 程序退出时仍在运行，可继续恢复
+};
+
+/**
+ * @brief restic restore 的汇总统计（--json 输出的 summary 行）
+ */
+struct RestoreSummary
+{
+    quint64 totalFiles = 0;
+    quint64 filesRestored = 0;
+    quint64 filesSkipped = 0;       // 目标中已正确而跳过的文件
+    quint64 filesDeleted = 0;       // --delete 删除的多余文件
+    quint64 totalBytes = 0;
+    quint64 bytesRestored = 0;
+    quint64 bytesSkipped = 0;
+
+    RestoreSummary& operator+=(const RestoreSummary& other);
+};
+
+/**
+ * @brief 一次恢复的日志
+ *
+ * 恢复开始时写入，结束时更新状态和统计。启动时仍为 Running 的记录
+ * 说明上次恢复被中断，可按原选项以“有变化才覆盖”重新运行，
+ * 已恢复完整的文件会被 restic 跳过。
+ */
+struct RestoreJournalEntry
+{
+    int id = -1;
+    int repositoryId = -1;
+    QString snapshotId;
+    RestoreOptions options;
+    RestoreStatus status = RestoreStatus::Running;
+    RestoreSummary summary;
+    QDateTime startTime;
+    QDateTime endTime;
+    QString errorMessage;
+
+    bool canResume() const {
+        return status == RestoreStatus::Interrupted || status == RestoreStatus::Failed;
+    }
+};
+
+} // namespace Models
+} // namespace ResticGUI
+
+#endif // RESTOREJOURNAL_H
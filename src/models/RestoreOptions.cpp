@@ -2,5 +2,41 @@
 
 namespace ResticGUI {
 namespace Models {
+
+QVariantMap RestoreOptions::toVariantMap() const
+{
+    QVariantMap map;
+    map["targetPath"] = targetPath;
+    map["includePaths"] = includePaths;
+    map["excludePaths"] = excludePaths;
+    map["overwritePolicy"] = static_cast<int>(overwritePolicy);
+    map["restorePermissions"] = restorePermissions;
+    map["restoreTimestamps"] = restoreTimestamps;
+    map["restoreOwnership"] = restoreOwnership;
+    map["sparse"] = sparse;
+    map["deleteExtraneous"] = deleteExtraneous;
+    map["verify"] = verify;
+    map["parallelJobs"] = parallelJobs;
+    return map;
+}
+
+RestoreOptions RestoreOptions::fromVariantMap(const QVariantMap& map)
+{
+    RestoreOptions options;
+    options.targetPath = map.value("targetPath").toString();
+    options.includePaths = map.value("includePaths").toStringList();
+    options.excludePaths = map.value("excludePaths").toStringList();
+    options.overwritePolicy = static_cast<OverwritePolicy>(
+        map.value("overwritePolicy", static_cast<int>(IfChanged)).toInt());
+    options.restorePermissions = map.value("restorePermissions", true).toBool();
+    options.restoreTimestamps = map.value("restoreTimestamps", true).toBool();
+    options.restoreOwnership = map.value("restoreOwnership", false).toBool();
+    options.sparse = map.value("sparse", false).toBool();
+    options.deleteExtraneous = map.value("deleteExtraneous", false).toBool();
+    options.verify = map.value("verify", false).toBool();
+    options.parallelJobs = map.value("parallelJobs", 1).toInt();
+    return options;
+}
+
 } // namespace Models
 } // namespace ResticGUI
@@ -3,28 +3,38 @@
 
 #include <QString>
 #include <QStringList>
+#include <QVariantMap>
 
 namespace ResticGUI {
 namespace Models {
 
 struct RestoreOptions
 {
+    // 数值会随恢复日志持久化，新增策略只能追加在末尾
     enum OverwritePolicy {
         Always,
         Never,
         IfNewer,
-        Ask
+        Ask,
+        IfChanged       // 内容有变化时才覆盖，已正确的文件直接跳过
     };
 
     QString targetPath;
     QStringList includePaths;
     QStringList excludePaths;
-    OverwritePolicy overwritePolicy = Always;
+    OverwritePolicy overwritePolicy = IfChanged;
     bool restorePermissions = true;
     bool restoreTimestamps = true;
     bool restoreOwnership = false;
     bool sparse = false;
+    bool deleteExtraneous = false;  // 删除目标目录中快照里不存在的文件
     bool verify = false;
+    int parallelJobs = 1;       // 并行的 restic restore 进程数，1 为单进程
+    bool dryRun = false;        // 只统计将要恢复的内容，不写入目标（不随日志保存）
+
+    // 序列化（用于恢复日志）
+    QVariantMap toVariantMap() const;
+    static RestoreOptions fromVariantMap(const QVariantMap& map);
 };
 
 } // namespace Models
@@ -0,0 +1,6 @@
+#include "SnapshotDiff.h"
+
+namespace ResticGUI {
+namespace Models {
+} // namespace Models
+} // namespace ResticGUI
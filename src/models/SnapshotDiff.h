@@ -0,0 +1,71 @@
+/**
+ * @file SnapshotDiff.h
+ * @brief 两个快照之间的差异
+ */
+
+#ifndef SNAPSHOTDIFF_H
+#define SNAPSHOTDIFF_H
+
+#include <QString>
+#include <QList>
+#include "FileInfo.h"
+
+namespace ResticGUI {
+namespace Models {
+
+enum class ChangeType
+{
+    Added,
+    Removed,
+    Modified
+};
+
+/**
+ * @brief 单个条目的变化
+ *
+ * 大小为 -1 表示未知（restic diff 的输出不含文件大小，
+ * 只有对应快照的文件树已缓存时才能补全）。
+ */
+struct FileChange
+{
+    QString path;
+    ChangeType change = ChangeType::Modified;
+    FileType type = FileType::File;
+    qint64 oldSize = -1;
+    qint64 newSize = -1;
+
+    qint64 sizeDelta() const
+    {
+        return qMax<qint64>(newSize, 0) - qMax<qint64>(oldSize, 0);
+    }
+};
+
+/**
+ * @brief 目录的变化汇总（包含所有子孙条目）
+ */
+struct DirectoryChange
+{
+    QString path;
+    int added = 0;
+    int removed = 0;
+    int modified = 0;
+    qint64 bytesAdded = 0;      // 新增文件与变大文件的增量
+    qint64 bytesRemoved = 0;    // 删除文件与变小文件的减量
+
+    qint64 netBytes() const { return bytesAdded - bytesRemoved; }
+};
+
+struct SnapshotDiff
+{
+    QString oldSnapshotId;
+    QString newSnapshotId;
+    QList<FileChange> changes;          // 按路径顺序
+    QList<DirectoryChange> directories; // 按净增长量从大到小，包含根目录 "/"
+    bool fromIndex = false;             // 由本地缓存的文件树比较得到
+    bool sizesComplete = false;         // 所有变化条目的大小均已知
+};
+
+} // namespace Models
+} // namespace ResticGUI
+
+#endif // SNAPSHOTDIFF_H
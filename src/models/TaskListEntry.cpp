@@ -0,0 +1,6 @@
+#include "TaskListEntry.h"
+
+namespace ResticGUI {
+namespace Models {
+} // namespace Models
+} // namespace ResticGUI
@@ -0,0 +1,45 @@
+/**
+ * @file TaskListEntry.h
+ * @brief 备份任务列表行数据模型（只读视图）
+ */
+
+#ifndef TASKLISTENTRY_H
+#define TASKLISTENTRY_H
+
+#include <QString>
+#include <QDateTime>
+#include "Schedule.h"
+#include "BackupResult.h"
+
+namespace ResticGUI {
+namespace Models {
+
+/**
+ * @brief 任务列表的一行
+ *
+ * 只包含列表显示所需的列，由一次联表查询直接填充，
+ * 不解析 options / schedule_config 等 JSON 字段。
+ * 完整的 BackupTask 在需要时（详情面板、编辑）再单独加载。
+ */
+struct TaskListEntry
+{
+    int id = -1;
+    QString name;
+    int repositoryId = -1;
+    QString repositoryName;
+    QString firstSourcePath;
+    int sourcePathCount = 0;
+    Schedule::Type scheduleType = Schedule::None;
+    bool enabled = true;
+    QDateTime lastRun;
+    QDateTime nextRun;
+
+    // 最近一次执行结果（无历史记录时 hasLastStatus 为 false）
+    bool hasLastStatus = false;
+    BackupStatus lastStatus = BackupStatus::Running;
+};
+
+} // namespace Models
+} // namespace ResticGUI
+
+#endif // TASKLISTENTRY_H
@@ -0,0 +1,26 @@
+#include "VerificationPlan.h"
+
+namespace ResticGUI {
+namespace Models {
+
+bool VerificationPlan::isDue(const QDateTime& now) const
+{
+    if (!cycleStarted()) {
+        return true;
+    }
+
+    const qint64 periodSecs = qMax(1, periodDays) * 86400LL;
+    const qint64 elapsed = cycleStartedAt.secsTo(now);
+
+    // 本轮已完成，等到周期结束再开始下一轮
+    if (cycleCompleted()) {
+        return elapsed >= periodSecs;
+    }
+
+    // 第 k 个切片在周期的 (k-1)/N 处到期，落后时尽快追上
+    const int expected = static_cast<int>(qMin<qint64>(sliceCount, sliceCount * elapsed / periodSecs + 1));
+    return slicesDone() < expected;
+}
+
+} // namespace Models
+} // namespace ResticGUI
@@ -0,0 +1,68 @@
+/**
+ * @file VerificationPlan.h
+ * @brief 仓库数据的分片轮换验证计划
+ */
+
+#ifndef VERIFICATIONPLAN_H
+#define VERIFICATIONPLAN_H
+
+#include <QString>
+#include <QDateTime>
+
+namespace ResticGUI {
+namespace Models {
+
+/**
+ * @brief 一个仓库的轮换验证计划和本轮进度
+ *
+ * 每轮把仓库的数据包分成 N 个切片，按 restic check --read-data-subset=n/N
+ * 依次验证，在周期内均匀推进，周期结束时整个仓库都被读取过一遍。
+ */
+struct VerificationPlan
+{
+    int repositoryId = -1;
+    bool enabled = false;
+    int periodDays = 30;            // 验证完整个仓库的周期
+    int timeBudgetMinutes = 60;     // 每次运行的时间预算，0 表示不限
+    qint64 bytesBudget = 0;         // 每次运行读取的数据量预算，0 表示不限
+
+    // 本轮进度
+    int sliceCount = 0;             // 切片数 N，0 表示尚未开始
+    int nextSlice = 1;              // 下一个要验证的切片（1..N），N+1 表示本轮已完成
+    qint64 repositoryBytes = 0;     // 本轮开始时数据包总大小
+    QDateTime cycleStartedAt;
+    QDateTime lastRunAt;
+    QDateTime lastCycleCompletedAt;
+
+    bool cycleStarted() const { return sliceCount > 0 && cycleStartedAt.isValid(); }
+    int slicesDone() const { return cycleStarted() ? qMin(nextSlice - 1, sliceCount) : 0; }
+    bool cycleCompleted() const { return cycleStarted() && slicesDone() >= sliceCount; }
+
+    /**
+     * @brief 按周期内均匀推进的进度，当前是否应该验证下一个切片（或开始新一轮）
+     */
+    bool isDue(const QDateTime& now) const;
+};
+
+/**
+ * @brief 一次切片验证的记录
+ */
+struct VerificationRun
+{
+    int id = -1;
+    int repositoryId = -1;
+    int sliceIndex = 0;
+    int sliceCount = 0;
+    QDateTime startTime;
+    QDateTime endTime;
+    bool success = false;
+    qint64 bytesChecked = 0;        // 按数据包总大小 / N 估算
+    QString errorMessage;
+
+    qint64 durationSecs() const { return startTime.secsTo(endTime); }
+};
+
+} // namespace Models
+} // namespace ResticGUI
+
+#endif // VERIFICATIONPLAN_H
@@ -15,7 +15,10 @@
 #include "wizards/CreateRepoWizard.h"
 #include "../data/ConfigManager.h"
 #include "../core/RepositoryManager.h"
+#include "../core/DaemonClient.h"
+#include "../core/DataStore.h"
 #include "../utils/Logger.h"
+#include "../utils/Tracer.h"
 
 #include <QLabel>
 #include <QMessageBox>
@@ -23,6 +26,7 @@
 #include <QMenu>
 #include <QAction>
 #include <QIcon>
+#include <QElapsedTimer>
 
 namespace ResticGUI {
 namespace UI {
@@ -39,6 +43,7 @@ MainWindow::MainWindow(QWidget* parent)
     , m_trayIcon(nullptr)
     , m_trayMenu(nullptr)
     , m_currentRepositoryId(-1)
+    , m_firstPaintDone(false)
 {
     ui->setupUi(this);
 
@@ -64,21 +69,84 @@ MainWindow::~MainWindow()
 
 void MainWindow::createPages()
 {
-    // 创建各个页面
-    m_homePage = new HomePage(this);
-    m_repositoryPage = new RepositoryPage(this);
-    m_backupPage = new BackupPage(this);
-    m_snapshotPage = new SnapshotPage(this);
-    m_restorePage = new RestorePage(this);
-    m_statsPage = new StatsPage(this);
-
-    // 添加到堆叠窗口
-    ui->pageStack->addWidget(m_homePage);
-    ui->pageStack->addWidget(m_repositoryPage);
-    ui->pageStack->addWidget(m_backupPage);
-    ui->pageStack->addWidget(m_snapshotPage);
-    ui->pageStack->addWidget(m_restorePage);
-    ui->pageStack->addWidget(m_statsPage);
+    // 先放入占位控件，页面的构造（及其中的数据库查询）推迟到第一次切换到该页面
+    for (int i = 0; i < PageCount; ++i) {
+        ui->pageStack->addWidget(new QWidget(ui->pageStack));
+    }
+}
+
+QWidget* MainWindow::ensurePage(int index)
+{
+    QWidget* placeholder = ui->pageStack->widget(index);
+    if (!placeholder) {
+        return nullptr;
+    }
+
+    Utils::TraceSpan span("MainWindow::ensurePage", "ui");
+    QElapsedTimer timer;
+    timer.start();
+
+    QWidget* page = nullptr;
+    Core::RepositoryManager* repoMgr = Core::RepositoryManager::instance();
+    switch (index) {
+    case HomePageIndex:
+        if (!m_homePage) {
+            m_homePage = new HomePage(this);
+            // 首页导航信号
+            connect(m_homePage, &HomePage::navigateToPage, [this](int pageIndex) {
+                ui->navigationList->setCurrentRow(pageIndex);
+            });
+        }
+        page = m_homePage;
+        break;
+    case RepositoryPageIndex:
+        if (!m_repositoryPage) {
+            m_repositoryPage = new RepositoryPage(this);
+        }
+        page = m_repositoryPage;
+        break;
+    case BackupPageIndex:
+        if (!m_backupPage) {
+            m_backupPage = new BackupPage(this);
+        }
+        page = m_backupPage;
+        break;
+    case SnapshotPageIndex:
+        if (!m_snapshotPage) {
+            m_snapshotPage = new SnapshotPage(this);
+            connect(repoMgr, &Core::RepositoryManager::repositoryListChanged,
+                    m_snapshotPage, &SnapshotPage::loadRepositories);
+        }
+        page = m_snapshotPage;
+        break;
+    case RestorePageIndex:
+        if (!m_restorePage) {
+            m_restorePage = new RestorePage(this);
+            connect(repoMgr, &Core::RepositoryManager::repositoryListChanged,
+                    m_restorePage, &RestorePage::loadRepositories);
+        }
+        page = m_restorePage;
+        break;
+    case StatsPageIndex:
+        if (!m_statsPage) {
+            m_statsPage = new StatsPage(this);
+        }
+        page = m_statsPage;
+        break;
+    default:
+        return nullptr;
+    }
+
+    if (placeholder != page) {
+        ui->pageStack->insertWidget(index, page);
+        ui->pageStack->removeWidget(placeholder);
+        placeholder->deleteLater();
+
+        span.setDetail(QString::number(index));
+        Utils::Logger::instance()->log(Utils::Logger::Debug,
+            QString("创建页面 %1，耗时 %2 ms").arg(index).arg(timer.elapsed()));
+    }
+    return page;
 }
 
 void MainWindow::setupConnections()
@@ -87,11 +155,6 @@ void MainWindow::setupConnections()
     connect(ui->navigationList, &QListWidget::currentRowChanged,
             this, &MainWindow::onNavigationChanged);
 
-    // 首页导航信号
-    connect(m_homePage, &HomePage::navigateToPage, [this](int pageIndex) {
-        ui->navigationList->setCurrentRow(pageIndex);
-    });
-
     // 文件菜单
     connect(ui->actionNewRepository, &QAction::triggered, this, &MainWindow::onNewRepository);
     connect(ui->actionOpenRepository, &QAction::triggered, this, &MainWindow::onOpenRepository);
@@ -107,23 +170,41 @@ void MainWindow::setupConnections()
     connect(ui->actionRefresh, &QAction::triggered, this, &MainWindow::onRefresh);
     connect(ui->actionStop, &QAction::triggered, this, &MainWindow::onStop);
 
-    // 监听仓库列表变化
-    Core::RepositoryManager* repoMgr = Core::RepositoryManager::instance();
-    connect(repoMgr, &Core::RepositoryManager::repositoryListChanged,
-            m_snapshotPage, &SnapshotPage::loadRepositories);
-    connect(repoMgr, &Core::RepositoryManager::repositoryListChanged,
-            m_restorePage, &RestorePage::loadRepositories);
-
     // 状态栏初始化
     QLabel* statusLabel = new QLabel(tr("就绪"), this);
     ui->statusBar->addWidget(statusLabel);
 
     QLabel* repoLabel = new QLabel(tr("当前仓库: 无"), this);
     ui->statusBar->addPermanentWidget(repoLabel);
+
+    // 连接了后台服务时，计划任务在后台服务中执行，这里显示它的状态
+    Core::DaemonClient* daemon = Core::DaemonClient::instance();
+    if (daemon->isConnected()) {
+        QLabel* daemonLabel = new QLabel(tr("后台服务: 已连接"), this);
+        ui->statusBar->addPermanentWidget(daemonLabel);
+
+        connect(daemon, &Core::DaemonClient::backupStarted, this, [daemonLabel](int taskId) {
+            daemonLabel->setText(tr("后台服务: 正在执行任务 %1").arg(taskId));
+        });
+        connect(daemon, &Core::DaemonClient::backupFinished, this, [this, daemonLabel](int taskId, bool success) {
+            daemonLabel->setText(tr("后台服务: 已连接"));
+            // 备份页面未创建时同样刷新，数据存储的其他订阅者也能看到最近运行状态
+            Core::DataStore::instance()->revalidateTaskList();
+            if (m_trayIcon && m_trayIcon->isVisible()) {
+                m_trayIcon->showMessage(tr("Restic GUI"),
+                    success ? tr("后台服务完成了任务 %1").arg(taskId) : tr("后台服务执行任务 %1 失败").arg(taskId),
+                    success ? QSystemTrayIcon::Information : QSystemTrayIcon::Warning, 3000);
+            }
+        });
+        connect(daemon, &Core::DaemonClient::connectionLost, this, [daemonLabel]() {
+            daemonLabel->setText(tr("后台服务: 已断开，计划任务在本程序中执行"));
+        });
+    }
 }
 
 void MainWindow::onNavigationChanged(int index)
 {
+    ensurePage(index);
     ui->pageStack->setCurrentIndex(index);
 
     Utils::Logger::instance()->log(Utils::Logger::Debug,
@@ -219,6 +300,17 @@ void MainWindow::closeEvent(QCloseEvent* event)
     }
 }
 
+void MainWindow::paintEvent(QPaintEvent* event)
+{
+    QMainWindow::paintEvent(event);
+
+    if (!m_firstPaintDone) {
+        m_firstPaintDone = true;
+        // 排队发出，让这一帧先提交到屏幕
+        QMetaObject::invokeMethod(this, [this]() { emit firstPaint(); }, Qt::QueuedConnection);
+    }
+}
+
 void MainWindow::changeEvent(QEvent* event)
 {
     QMainWindow::changeEvent(event);
@@ -254,8 +346,10 @@ void MainWindow::onNewRepository()
 
     CreateRepoWizard wizard(this);
     if (wizard.exec() == QDialog::Accepted) {
-        // 仓库创建成功，刷新仓库列表
-        m_repositoryPage->loadRepositories();
+        // 仓库创建成功，刷新仓库列表（页面尚未创建时，创建时会自行加载）
+        if (m_repositoryPage) {
+            m_repositoryPage->loadRepositories();
+        }
 
         // 切换到仓库管理页面
         ui->navigationList->setCurrentRow(1);
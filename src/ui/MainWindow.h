@@ -21,7 +21,8 @@ class StatsPage;
 /**
  * @brief 主窗口
  *
- * 采用侧边栏导航 + 内容区域的布局
+ * 采用侧边栏导航 + 内容区域的布局。页面在第一次切换到时才创建，
+ * 启动时只构建首页。
  */
 class MainWindow : public QMainWindow
 {
@@ -31,9 +32,16 @@ public:
     explicit MainWindow(QWidget* parent = nullptr);
     ~MainWindow();
 
+signals:
+    /**
+     * @brief 窗口第一次绘制完成，启动流程据此执行延后的初始化
+     */
+    void firstPaint();
+
 protected:
     void closeEvent(QCloseEvent* event) override;
     void changeEvent(QEvent* event) override;
+    void paintEvent(QPaintEvent* event) override;
 
 private slots:
     void onNavigationChanged(int index);
@@ -59,7 +67,22 @@ private slots:
     void onExitApplication();
 
 private:
+    enum PageIndex {
+        HomePageIndex = 0,
+        RepositoryPageIndex,
+        BackupPageIndex,
+        SnapshotPageIndex,
+        RestorePageIndex,
+        StatsPageIndex,
+        PageCount
+    };
+
     void createPages();
+
+    /**
+     * @brief 创建页面（如果还没有创建）并替换堆叠窗口中的占位控件
+     */
+    QWidget* ensurePage(int index);
     void setupConnections();
     void loadSettings();
     void saveSettings();
@@ -81,6 +104,8 @@ private:
 
     // 当前选中的仓库ID
     int m_currentRepositoryId;
+
+    bool m_firstPaintDone;
 };
 
 } // namespace UI
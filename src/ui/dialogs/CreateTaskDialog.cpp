@@ -410,6 +410,7 @@ CreateTaskDialog::CreateTaskDialog(QWidget* parent)
 
         QString packSizeText = m_packSizeEdit->text().trimmed();
         m_task.packSize = packSizeText.isEmpty() ? 0 : packSizeText.toInt();
+        m_task.skipIfUnchanged = m_skipIfUnchangedCheck->isChecked();
 
         Utils::Logger::instance()->log(Utils::Logger::Info,
             QString("创建任务对话框完成: name=%1, repoId=%2, path=%3, tags=%4, scheduleType=%5, excludePatterns=%6, filesFrom=%7, noScan=%8, compression=%9")
@@ -523,6 +524,7 @@ void CreateTaskDialog::setTask(const Models::BackupTask& task)
     // 填充备份参数数据
     m_noScanCheck->setChecked(task.noScan);
     m_noExtraVerifyCheck->setChecked(task.noExtraVerify);
+    m_skipIfUnchangedCheck->setChecked(task.skipIfUnchanged);
 
     // 设置压缩级别
     QString compression = task.compression.isEmpty() ? "auto" : task.compression;
@@ -1173,6 +1175,12 @@ void CreateTaskDialog::setupBackupParams()
     m_packSizeEdit->setToolTip(tr("对于大型仓库或快速上传，可增加包大小。注意会增加临时空间和内存使用"));
     contentLayout->addWidget(m_packSizeEdit);
 
+    // 6. 无变化时不创建快照
+    m_skipIfUnchangedCheck = new QCheckBox(tr("数据无变化时不创建快照 (--skip-if-unchanged)"), contentWidget);
+    m_skipIfUnchangedCheck->setStyleSheet("QCheckBox { font-size: 8pt; color: #333333; }");
+    m_skipIfUnchangedCheck->setToolTip(tr("频繁执行的备份可避免产生大量相同的快照（需要 restic 0.17 或更高版本，旧版本忽略此选项）"));
+    contentLayout->addWidget(m_skipIfUnchangedCheck);
+
     scrollArea->setWidget(contentWidget);
     paramsLayout->addWidget(scrollArea);
 
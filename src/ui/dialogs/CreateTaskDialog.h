@@ -100,6 +100,7 @@ private:
     QCheckBox* m_noExtraVerifyCheck;
     QLineEdit* m_readConcurrencyEdit;
     QLineEdit* m_packSizeEdit;
+    QCheckBox* m_skipIfUnchangedCheck;
 };
 
 } // namespace UI
@@ -0,0 +1,122 @@
+#include "FileHistoryDialog.h"
+#include "../models/SnapshotFileModel.h"
+#include "../../core/SnapshotManager.h"
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QtConcurrent>
+
+namespace ResticGUI {
+namespace UI {
+
+FileHistoryDialog::FileHistoryDialog(int repoId, const QString& path, QWidget* parent)
+    : QDialog(parent)
+    , m_repoId(repoId)
+    , m_path(path)
+    , m_versionTable(nullptr)
+    , m_statusLabel(nullptr)
+    , m_closeButton(nullptr)
+    , m_versionWatcher(nullptr)
+{
+    setupUI();
+    loadVersions();
+}
+
+FileHistoryDialog::~FileHistoryDialog()
+{
+}
+
+void FileHistoryDialog::setupUI()
+{
+    setWindowTitle(tr("历史版本 - %1").arg(m_path.mid(m_path.lastIndexOf('/') + 1)));
+    setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
+    resize(760, 420);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    QLabel* pathLabel = new QLabel(tr("路径: %1").arg(m_path), this);
+    pathLabel->setWordWrap(true);
+    pathLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    mainLayout->addWidget(pathLabel);
+
+    m_versionTable = new QTableWidget(0, 6, this);
+    m_versionTable->setHorizontalHeaderLabels(
+        {tr("快照时间"), tr("快照ID"), tr("主机"), tr("大小"), tr("修改时间"), tr("变化")});
+    m_versionTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_versionTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_versionTable->setAlternatingRowColors(true);
+    m_versionTable->verticalHeader()->setVisible(false);
+    m_versionTable->horizontalHeader()->setStretchLastSection(true);
+    m_versionTable->setColumnWidth(0, 150);
+    m_versionTable->setColumnWidth(1, 90);
+    m_versionTable->setColumnWidth(2, 120);
+    m_versionTable->setColumnWidth(3, 90);
+    m_versionTable->setColumnWidth(4, 150);
+    mainLayout->addWidget(m_versionTable);
+
+    QHBoxLayout* bottomLayout = new QHBoxLayout();
+    m_statusLabel = new QLabel(tr("正在查询历史版本..."), this);
+    m_closeButton = new QPushButton(tr("关闭"), this);
+    bottomLayout->addWidget(m_statusLabel);
+    bottomLayout->addStretch();
+    bottomLayout->addWidget(m_closeButton);
+    mainLayout->addLayout(bottomLayout);
+
+    connect(m_closeButton, &QPushButton::clicked, this, &QDialog::accept);
+
+    m_versionWatcher = new QFutureWatcher<QList<Models::FileVersion>>(this);
+    connect(m_versionWatcher, &QFutureWatcher<QList<Models::FileVersion>>::finished,
+            this, &FileHistoryDialog::onVersionsLoaded);
+}
+
+void FileHistoryDialog::loadVersions()
+{
+    int repoId = m_repoId;
+    QString path = m_path;
+
+    m_versionWatcher->setFuture(QtConcurrent::run([repoId, path]() {
+        return Core::SnapshotManager::instance()->getFileVersions(repoId, path);
+    }));
+}
+
+void FileHistoryDialog::onVersionsLoaded()
+{
+    const QList<Models::FileVersion> versions = m_versionWatcher->result();
+
+    m_versionTable->setRowCount(versions.size());
+    for (int row = 0; row < versions.size(); ++row) {
+        const Models::FileVersion& version = versions.at(row);
+
+        // 列表从新到旧，与下一行（更早的版本）比较
+        QString change;
+        if (row + 1 >= versions.size()) {
+            change = tr("首次出现");
+        } else {
+            const Models::FileVersion& older = versions.at(row + 1);
+            change = (older.size == version.size && older.mtime == version.mtime)
+                ? tr("未变化") : tr("已修改");
+        }
+
+        QTableWidgetItem* timeItem = new QTableWidgetItem(version.snapshotTime.toString("yyyy-MM-dd HH:mm:ss"));
+        timeItem->setData(Qt::UserRole, version.snapshotId);
+        m_versionTable->setItem(row, 0, timeItem);
+        m_versionTable->setItem(row, 1, new QTableWidgetItem(version.snapshotId.left(8)));
+        m_versionTable->setItem(row, 2, new QTableWidgetItem(version.hostname));
+        m_versionTable->setItem(row, 3, new QTableWidgetItem(
+            version.type == Models::FileType::Directory ? QString("-") : SnapshotFileModel::formatSize(version.size)));
+        m_versionTable->setItem(row, 4, new QTableWidgetItem(version.mtime.toString("yyyy-MM-dd HH:mm:ss")));
+        m_versionTable->setItem(row, 5, new QTableWidgetItem(change));
+    }
+
+    if (versions.isEmpty()) {
+        m_statusLabel->setText(tr("没有找到该路径的历史版本"));
+    } else {
+        m_statusLabel->setText(tr("共 %1 个版本").arg(versions.size()));
+    }
+}
+
+} // namespace UI
+} // namespace ResticGUI
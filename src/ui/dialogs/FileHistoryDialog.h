@@ -0,0 +1,49 @@
+#ifndef FILEHISTORYDIALOG_H
+#define FILEHISTORYDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include "../../models/FileVersion.h"
+
+class QTableWidget;
+class QLabel;
+class QPushButton;
+
+namespace ResticGUI {
+namespace UI {
+
+/**
+ * @brief 文件历史版本对话框
+ *
+ * 列出路径出现过的所有快照及对应的大小、修改时间，并标出相对上一版本的变化。
+ * 查询在工作线程中通过 SnapshotManager::getFileVersions 完成。
+ */
+class FileHistoryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    FileHistoryDialog(int repoId, const QString& path, QWidget* parent = nullptr);
+    ~FileHistoryDialog();
+
+private slots:
+    void onVersionsLoaded();
+
+private:
+    void setupUI();
+    void loadVersions();
+
+    int m_repoId;
+    QString m_path;
+
+    QTableWidget* m_versionTable;
+    QLabel* m_statusLabel;
+    QPushButton* m_closeButton;
+
+    QFutureWatcher<QList<Models::FileVersion>>* m_versionWatcher;
+};
+
+} // namespace UI
+} // namespace ResticGUI
+
+#endif // FILEHISTORYDIALOG_H
@@ -1,5 +1,6 @@
 #include "PruneOptionsDialog.h"
 #include "ui_PruneOptionsDialog.h"
+#include "../../data/ConfigManager.h"
 
 namespace ResticGUI {
 namespace UI {
@@ -10,6 +11,11 @@ PruneOptionsDialog::PruneOptionsDialog(QWidget* parent)
 {
     ui->setupUi(this);
     setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
+
+    Data::ConfigManager* config = Data::ConfigManager::instance();
+    ui->timeBudgetSpinBox->setValue(config->getValue("Prune/TimeBudgetMinutes", 0).toInt());
+    ui->costBudgetSpinBox->setValue(config->getValue("Prune/CostBudget", 0.0).toDouble());
+    ui->egressCostSpinBox->setValue(config->getValue("Prune/EgressCostPerGiB", 0.0).toDouble());
 }
 
 PruneOptionsDialog::~PruneOptionsDialog()
@@ -52,5 +58,24 @@ void PruneOptionsDialog::setKeepPolicy(int keepLast, int keepDaily, int keepWeek
     ui->keepYearlySpinBox->setValue(keepYearly);
 }
 
+Core::PrunePolicy PruneOptionsDialog::getPolicy() const
+{
+    Core::PrunePolicy policy;
+    policy.timeBudgetMinutes = ui->timeBudgetSpinBox->value();
+    policy.costBudget = ui->costBudgetSpinBox->value();
+    policy.egressCostPerGiB = ui->egressCostSpinBox->value();
+    return policy;
+}
+
+void PruneOptionsDialog::accept()
+{
+    Data::ConfigManager* config = Data::ConfigManager::instance();
+    config->setValue("Prune/TimeBudgetMinutes", ui->timeBudgetSpinBox->value());
+    config->setValue("Prune/CostBudget", ui->costBudgetSpinBox->value());
+    config->setValue("Prune/EgressCostPerGiB", ui->egressCostSpinBox->value());
+
+    QDialog::accept();
+}
+
 } // namespace UI
 } // namespace ResticGUI
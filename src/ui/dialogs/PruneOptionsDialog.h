@@ -2,6 +2,7 @@
 #define PRUNEOPTIONSDIALOG_H
 
 #include <QDialog>
+#include "../../core/PrunePlanner.h"
 
 namespace Ui {
 class PruneOptionsDialog;
@@ -13,7 +14,7 @@ namespace UI {
 /**
  * @brief 维护仓库（Prune）选项对话框
  *
- * 让用户配置快照保留策略
+ * 让用户配置快照保留策略和维护的时间/费用预算，预算在对话框之间保留
  */
 class PruneOptionsDialog : public QDialog
 {
@@ -54,6 +55,13 @@ public:
     void setKeepPolicy(int keepLast, int keepDaily, int keepWeekly,
                       int keepMonthly, int keepYearly);
 
+    /**
+     * @brief 获取维护预算
+     */
+    Core::PrunePolicy getPolicy() const;
+
+    void accept() override;
+
 private:
     Ui::PruneOptionsDialog* ui;
 };
@@ -6,6 +6,9 @@
 #include "SettingsDialog.h"
 #include "ui_SettingsDialog.h"
 #include "../../data/ConfigManager.h"
+#include "../../utils/Logger.h"
+#include "../../core/MetricsExporter.h"
+#include "../../core/DaemonClient.h"
 #include <QFileDialog>
 #include <QPushButton>
 #include <QDialogButtonBox>
@@ -47,6 +50,9 @@ void SettingsDialog::loadSettings()
 
     ui->maxParallelSpin->setValue(config->getMaxParallelBackups());
     ui->logRetentionSpin->setValue(config->getLogRetentionDays());
+    ui->logMaxSizeSpin->setValue(config->getLogMaxFileSizeMB());
+    ui->compressLogsCheck->setChecked(config->getCompressRotatedLogs());
+    ui->structuredLogsCheck->setChecked(config->getStructuredLogs());
     ui->showNotificationsCheck->setChecked(config->getShowBackupNotifications());
 
     ui->passwordModeCombo->setCurrentIndex(config->getPasswordStorageMode());
@@ -55,6 +61,10 @@ void SettingsDialog::loadSettings()
     ui->useProxyCheck->setChecked(config->getUseProxy());
     ui->proxyHostEdit->setText(config->getProxyHost());
     ui->proxyPortSpin->setValue(config->getProxyPort());
+
+    ui->metricsHttpCheck->setChecked(config->getMetricsHttpEnabled());
+    ui->metricsPortSpin->setValue(config->getMetricsHttpPort());
+    ui->metricsTextfileEdit->setText(config->getMetricsTextfilePath());
 }
 
 void SettingsDialog::saveSettings()
@@ -67,6 +77,14 @@ void SettingsDialog::saveSettings()
 
     config->setMaxParallelBackups(ui->maxParallelSpin->value());
     config->setLogRetentionDays(ui->logRetentionSpin->value());
+    config->setLogMaxFileSizeMB(ui->logMaxSizeSpin->value());
+    config->setCompressRotatedLogs(ui->compressLogsCheck->isChecked());
+    config->setStructuredLogs(ui->structuredLogsCheck->isChecked());
+
+    // 轮转和保留立即生效，文件格式在下次启动时切换，避免同一文件混用两种格式
+    Utils::Logger::instance()->setRotation(ui->logMaxSizeSpin->value() * Q_INT64_C(1024) * 1024,
+                                           ui->logRetentionSpin->value(), ui->compressLogsCheck->isChecked());
+
     config->setShowBackupNotifications(ui->showNotificationsCheck->isChecked());
 
     config->setPasswordStorageMode(ui->passwordModeCombo->currentIndex());
@@ -76,7 +94,16 @@ void SettingsDialog::saveSettings()
     config->setProxyHost(ui->proxyHostEdit->text());
     config->setProxyPort(ui->proxyPortSpin->value());
 
+    config->setMetricsHttpEnabled(ui->metricsHttpCheck->isChecked());
+    config->setMetricsHttpPort(ui->metricsPortSpin->value());
+    config->setMetricsTextfilePath(ui->metricsTextfileEdit->text().trimmed());
+
     config->sync();
+
+    // 指标端点和文件按新设置重新启动；连接了后台服务时由后台服务提供，重启后台服务后生效
+    if (!Core::DaemonClient::instance()->isConnected()) {
+        Core::MetricsExporter::instance()->initialize();
+    }
 }
 
 void SettingsDialog::onBrowseResticPath()
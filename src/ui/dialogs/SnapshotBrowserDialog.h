@@ -2,8 +2,7 @@
 #define SNAPSHOTBROWSERDIALOG_H
 
 #include <QDialog>
-#include <QTreeWidget>
-#include <QTreeWidgetItem>
+#include <QTreeView>
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -15,6 +14,10 @@
 namespace ResticGUI {
 namespace UI {
 
+class SnapshotFileModel;
+class SnapshotTreeSearch;
+class SnapshotPrefetcher;
+
 /**
  * @brief 快照文件浏览对话框
  *
@@ -33,12 +36,11 @@ public:
     QStringList getSelectedPaths() const;
 
 private slots:
-    void onItemExpanded(QTreeWidgetItem* item);
-    void onItemDoubleClicked(QTreeWidgetItem* item, int column);
-    void onItemChanged(QTreeWidgetItem* item, int column);
+    void onDirectoryFetchRequested(const QString& path);
+    void onItemDoubleClicked(const QModelIndex& index);
+    void onContextMenuRequested(const QPoint& pos);
     void onSearchTextChanged(const QString& text);
     void onFilesLoaded();
-    void onSearchTimerTimeout();
     void onSelectAll();
     void onSelectNone();
     void onExpandAll();
@@ -48,22 +50,17 @@ private slots:
 private:
     void setupUI();
     void loadRootFiles();
-    void loadDirectoryFiles(QTreeWidgetItem* item, const QString& path);
-    void addFileItems(QTreeWidgetItem* parent, const QList<Models::FileInfo>& files);
-    QIcon getFileIcon(const Models::FileInfo& fileInfo);
-    QString formatFileSize(qint64 size);
-    bool filterTreeItem(QTreeWidgetItem* item, const QString& searchText);
-    void expandAllUnloadedDirectories(QTreeWidgetItem* item = nullptr);
-    void performSearch(const QString& searchText);
+    void loadNextDirectory();
     void updateSelectionStats();
-    void setItemChecked(QTreeWidgetItem* item, bool checked, bool updateChildren = true);
-    void collectSelectedPaths(QTreeWidgetItem* item, QStringList& paths) const;
 
     int m_repoId;
     QString m_snapshotId;
     QString m_snapshotName;
 
-    QTreeWidget* m_treeWidget;
+    QTreeView* m_treeView;
+    SnapshotFileModel* m_fileModel;
+    SnapshotTreeSearch* m_treeSearch;
+    SnapshotPrefetcher* m_prefetcher;
     QLineEdit* m_searchEdit;
     QLabel* m_statusLabel;
     QLabel* m_selectionLabel;
@@ -76,11 +73,8 @@ private:
 
     bool m_isLoading;
     QFutureWatcher<QList<Models::FileInfo>>* m_fileWatcher;
-    QTreeWidgetItem* m_currentLoadingItem;
-
-    QString m_pendingSearchText;
-    QTimer* m_searchTimer;
-    bool m_isSearching;
+    QString m_currentLoadingPath;
+    QStringList m_pendingDirectories;   // 排队等待加载的目录
 
     QStringList m_selectedPaths;
 };
@@ -0,0 +1,233 @@
+#include "VerificationPlanDialog.h"
+#include "../models/SnapshotFileModel.h"
+#include "../../core/VerificationScheduler.h"
+#include "../../data/DatabaseManager.h"
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QFormLayout>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QMessageBox>
+
+namespace ResticGUI {
+namespace UI {
+
+namespace {
+constexpr qint64 BytesPerGiB = 1024LL * 1024 * 1024;
+}
+
+VerificationPlanDialog::VerificationPlanDialog(int repoId, const QString& repoName, QWidget* parent)
+    : QDialog(parent)
+    , m_repoId(repoId)
+    , m_repoName(repoName)
+    , m_enabledCheck(nullptr)
+    , m_periodSpin(nullptr)
+    , m_timeBudgetSpin(nullptr)
+    , m_bytesBudgetSpin(nullptr)
+    , m_progressLabel(nullptr)
+    , m_runTable(nullptr)
+    , m_statusLabel(nullptr)
+    , m_runButton(nullptr)
+    , m_saveButton(nullptr)
+    , m_closeButton(nullptr)
+{
+    setupUI();
+    loadPlan();
+    loadRuns();
+}
+
+VerificationPlanDialog::~VerificationPlanDialog()
+{
+}
+
+void VerificationPlanDialog::setupUI()
+{
+    setWindowTitle(tr("验证计划 - %1").arg(m_repoName));
+    setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
+    resize(760, 520);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    QLabel* hintLabel = new QLabel(tr("每次运行验证仓库数据的一个切片（check --read-data-subset），"
+                                      "在设定的周期内轮换验证全部数据。"), this);
+    hintLabel->setWordWrap(true);
+    mainLayout->addWidget(hintLabel);
+
+    QFormLayout* formLayout = new QFormLayout();
+
+    m_enabledCheck = new QCheckBox(tr("启用轮换验证"), this);
+    formLayout->addRow(QString(), m_enabledCheck);
+
+    m_periodSpin = new QSpinBox(this);
+    m_periodSpin->setRange(1, 365);
+    m_periodSpin->setSuffix(tr(" 天"));
+    formLayout->addRow(tr("完整验证周期:"), m_periodSpin);
+
+    m_timeBudgetSpin = new QSpinBox(this);
+    m_timeBudgetSpin->setRange(0, 24 * 60);
+    m_timeBudgetSpin->setSuffix(tr(" 分钟"));
+    m_timeBudgetSpin->setSpecialValueText(tr("不限"));
+    formLayout->addRow(tr("每次运行时间上限:"), m_timeBudgetSpin);
+
+    m_bytesBudgetSpin = new QSpinBox(this);
+    m_bytesBudgetSpin->setRange(0, 100000);
+    m_bytesBudgetSpin->setSuffix(tr(" GiB"));
+    m_bytesBudgetSpin->setSpecialValueText(tr("不限"));
+    formLayout->addRow(tr("每次运行数据量上限:"), m_bytesBudgetSpin);
+
+    mainLayout->addLayout(formLayout);
+
+    m_progressLabel = new QLabel(this);
+    m_progressLabel->setWordWrap(true);
+    mainLayout->addWidget(m_progressLabel);
+
+    m_runTable = new QTableWidget(0, 6, this);
+    m_runTable->setHorizontalHeaderLabels(
+        {tr("时间"), tr("切片"), tr("耗时"), tr("数据量"), tr("结果"), tr("覆盖率")});
+    m_runTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_runTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_runTable->setAlternatingRowColors(true);
+    m_runTable->verticalHeader()->setVisible(false);
+    m_runTable->horizontalHeader()->setStretchLastSection(true);
+    m_runTable->setColumnWidth(0, 150);
+    m_runTable->setColumnWidth(1, 90);
+    m_runTable->setColumnWidth(2, 90);
+    m_runTable->setColumnWidth(3, 90);
+    m_runTable->setColumnWidth(4, 200);
+    mainLayout->addWidget(m_runTable);
+
+    QHBoxLayout* bottomLayout = new QHBoxLayout();
+    m_statusLabel = new QLabel(this);
+    m_runButton = new QPushButton(tr("立即验证"), this);
+    m_saveButton = new QPushButton(tr("保存"), this);
+    m_closeButton = new QPushButton(tr("关闭"), this);
+    bottomLayout->addWidget(m_statusLabel);
+    bottomLayout->addStretch();
+    bottomLayout->addWidget(m_runButton);
+    bottomLayout->addWidget(m_saveButton);
+    bottomLayout->addWidget(m_closeButton);
+    mainLayout->addLayout(bottomLayout);
+
+    connect(m_runButton, &QPushButton::clicked, this, &VerificationPlanDialog::onRunNow);
+    connect(m_saveButton, &QPushButton::clicked, this, &VerificationPlanDialog::onSave);
+    connect(m_closeButton, &QPushButton::clicked, this, &QDialog::accept);
+
+    Core::VerificationScheduler* scheduler = Core::VerificationScheduler::instance();
+    connect(scheduler, &Core::VerificationScheduler::verificationFinished,
+            this, &VerificationPlanDialog::onVerificationFinished);
+
+    if (scheduler->isRunning(m_repoId)) {
+        m_runButton->setEnabled(false);
+        m_statusLabel->setText(tr("正在验证..."));
+    }
+}
+
+void VerificationPlanDialog::loadPlan()
+{
+    m_plan = Core::VerificationScheduler::instance()->plan(m_repoId);
+
+    m_enabledCheck->setChecked(m_plan.enabled);
+    m_periodSpin->setValue(m_plan.periodDays);
+    m_timeBudgetSpin->setValue(m_plan.timeBudgetMinutes);
+    m_bytesBudgetSpin->setValue(static_cast<int>(m_plan.bytesBudget / BytesPerGiB));
+
+    QStringList lines;
+    if (!m_plan.cycleStarted()) {
+        lines << tr("尚未开始验证");
+    } else {
+        lines << tr("本轮进度: %1/%2 个切片（开始于 %3，仓库数据约 %4）")
+                     .arg(m_plan.slicesDone()).arg(m_plan.sliceCount)
+                     .arg(m_plan.cycleStartedAt.toString("yyyy-MM-dd HH:mm"))
+                     .arg(SnapshotFileModel::formatSize(m_plan.repositoryBytes));
+    }
+    if (m_plan.lastCycleCompletedAt.isValid()) {
+        lines << tr("上次完成完整验证: %1").arg(m_plan.lastCycleCompletedAt.toString("yyyy-MM-dd HH:mm"));
+    }
+    m_progressLabel->setText(lines.join("\n"));
+}
+
+void VerificationPlanDialog::loadRuns()
+{
+    // 覆盖率要看到周期之前的记录，多取一个周期
+    const QDateTime since = QDateTime::currentDateTime().addDays(-2 * m_plan.periodDays);
+    const QList<Models::VerificationRun> runs = Data::DatabaseManager::instance()->getVerificationRuns(m_repoId, since);
+
+    m_runTable->setRowCount(runs.size());
+    for (int row = 0; row < runs.size(); ++row) {
+        const Models::VerificationRun& run = runs.at(row);
+        const double coverage = Core::VerificationScheduler::coverageAt(runs, run.endTime, m_plan.periodDays);
+
+        m_runTable->setItem(row, 0, new QTableWidgetItem(run.startTime.toString("yyyy-MM-dd HH:mm:ss")));
+        m_runTable->setItem(row, 1, new QTableWidgetItem(QString("%1/%2").arg(run.sliceIndex).arg(run.sliceCount)));
+        m_runTable->setItem(row, 2, new QTableWidgetItem(tr("%1 秒").arg(run.durationSecs())));
+        m_runTable->setItem(row, 3, new QTableWidgetItem(
+            run.success ? SnapshotFileModel::formatSize(run.bytesChecked) : QString("-")));
+
+        QTableWidgetItem* resultItem = new QTableWidgetItem(run.success ? tr("通过") : tr("失败"));
+        if (!run.success) {
+            resultItem->setForeground(Qt::red);
+            resultItem->setToolTip(run.errorMessage);
+        }
+        m_runTable->setItem(row, 4, resultItem);
+        m_runTable->setItem(row, 5, new QTableWidgetItem(QString("%1%").arg(coverage * 100, 0, 'f', 1)));
+    }
+
+    if (!m_runButton->isEnabled()) {
+        return;
+    }
+    const double current = Core::VerificationScheduler::coverageAt(
+        runs, QDateTime::currentDateTime(), m_plan.periodDays);
+    m_statusLabel->setText(tr("最近 %1 天已验证 %2% 的数据")
+                               .arg(m_plan.periodDays).arg(current * 100, 0, 'f', 1));
+}
+
+void VerificationPlanDialog::onSave()
+{
+    Models::VerificationPlan plan;
+    plan.repositoryId = m_repoId;
+    plan.enabled = m_enabledCheck->isChecked();
+    plan.periodDays = m_periodSpin->value();
+    plan.timeBudgetMinutes = m_timeBudgetSpin->value();
+    plan.bytesBudget = m_bytesBudgetSpin->value() * BytesPerGiB;
+
+    if (!Core::VerificationScheduler::instance()->savePlanSettings(plan)) {
+        QMessageBox::critical(this, tr("错误"), tr("保存验证计划失败"));
+        return;
+    }
+    loadPlan();
+    loadRuns();
+}
+
+void VerificationPlanDialog::onRunNow()
+{
+    if (!Core::VerificationScheduler::instance()->runNow(m_repoId)) {
+        QMessageBox::warning(this, tr("警告"),
+            tr("无法开始验证：仓库正在验证，或没有保存仓库密码"));
+        return;
+    }
+    m_runButton->setEnabled(false);
+    m_statusLabel->setText(tr("正在验证..."));
+}
+
+void VerificationPlanDialog::onVerificationFinished(int repoId, bool success, const QString& message)
+{
+    if (repoId != m_repoId) {
+        return;
+    }
+
+    m_runButton->setEnabled(true);
+    loadPlan();
+    loadRuns();
+
+    if (!success) {
+        m_statusLabel->setText(tr("验证失败"));
+        QMessageBox::warning(this, tr("验证失败"), message);
+    }
+}
+
+} // namespace UI
+} // namespace ResticGUI
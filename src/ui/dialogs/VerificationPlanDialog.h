@@ -0,0 +1,59 @@
+#ifndef VERIFICATIONPLANDIALOG_H
+#define VERIFICATIONPLANDIALOG_H
+
+#include <QDialog>
+#include "../../models/VerificationPlan.h"
+
+class QCheckBox;
+class QSpinBox;
+class QTableWidget;
+class QLabel;
+class QPushButton;
+
+namespace ResticGUI {
+namespace UI {
+
+/**
+ * @brief 轮换验证计划对话框
+ *
+ * 设置仓库的验证周期和每次运行的预算，显示本轮进度以及每次运行后
+ * 最近一个周期内已验证数据的覆盖率。
+ */
+class VerificationPlanDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    VerificationPlanDialog(int repoId, const QString& repoName, QWidget* parent = nullptr);
+    ~VerificationPlanDialog();
+
+private slots:
+    void onSave();
+    void onRunNow();
+    void onVerificationFinished(int repoId, bool success, const QString& message);
+
+private:
+    void setupUI();
+    void loadPlan();
+    void loadRuns();
+
+    int m_repoId;
+    QString m_repoName;
+    Models::VerificationPlan m_plan;
+
+    QCheckBox* m_enabledCheck;
+    QSpinBox* m_periodSpin;
+    QSpinBox* m_timeBudgetSpin;
+    QSpinBox* m_bytesBudgetSpin;
+    QLabel* m_progressLabel;
+    QTableWidget* m_runTable;
+    QLabel* m_statusLabel;
+    QPushButton* m_runButton;
+    QPushButton* m_saveButton;
+    QPushButton* m_closeButton;
+};
+
+} // namespace UI
+} // namespace ResticGUI
+
+#endif // VERIFICATIONPLANDIALOG_H
@@ -0,0 +1,628 @@
+#include "SnapshotFileModel.h"
+#include "../../core/ResticWrapper.h"
+#include "../../utils/Tracer.h"
+#include <QApplication>
+#include <QStyle>
+
+namespace ResticGUI {
+namespace UI {
+
+SnapshotFileModel::SnapshotFileModel(QObject* parent)
+    : QAbstractItemModel(parent)
+    , m_checkable(true)
+{
+    // 图标只取一次，所有节点共享
+    QStyle* style = QApplication::style();
+    m_dirIcon = style->standardIcon(QStyle::SP_DirIcon);
+    m_fileIcon = style->standardIcon(QStyle::SP_FileIcon);
+    m_linkIcon = style->standardIcon(QStyle::SP_FileLinkIcon);
+
+    Node root;
+    root.type = Models::FileType::Directory;
+    root.loadState = Loading;   // 根目录由调用方主动加载
+    m_nodes.append(root);
+    m_pathIndex.insert(QString(), 0);
+    m_checked.resize(1);
+    m_partial.resize(1);
+}
+
+// ========== QAbstractItemModel 接口 ==========
+
+QModelIndex SnapshotFileModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if (!hasIndex(row, column, parent)) {
+        return QModelIndex();
+    }
+
+    const int childId = m_nodes.at(nodeId(parent)).children.at(row);
+    return createIndex(row, column, quintptr(childId));
+}
+
+QModelIndex SnapshotFileModel::parent(const QModelIndex& child) const
+{
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+
+    const int parentId = m_nodes.at(nodeId(child)).parent;
+    if (parentId <= 0) {
+        return QModelIndex();
+    }
+    return indexOfNode(parentId);
+}
+
+int SnapshotFileModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.column() > 0) {
+        return 0;
+    }
+    return m_nodes.at(nodeId(parent)).fetchedCount;
+}
+
+int SnapshotFileModel::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+bool SnapshotFileModel::hasChildren(const QModelIndex& parent) const
+{
+    if (parent.column() > 0) {
+        return false;
+    }
+
+    const int id = nodeId(parent);
+    if (!isDirNode(id)) {
+        return false;
+    }
+
+    // 未加载的目录显示展开箭头，加载后以实际子项为准
+    const Node& node = m_nodes.at(id);
+    return node.loadState != Loaded || !node.children.isEmpty();
+}
+
+QVariant SnapshotFileModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    const int id = nodeId(index);
+    const Node& node = m_nodes.at(id);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case NameColumn:
+            return node.name;
+        case SizeColumn:
+            return node.type == Models::FileType::File ? formatSize(node.size) : QString("-");
+        case TypeColumn:
+            if (node.type == Models::FileType::Directory) {
+                return tr("文件夹");
+            } else if (node.type == Models::FileType::Symlink) {
+                return tr("符号链接");
+            }
+            return tr("文件");
+        case MtimeColumn:
+            return node.mtime.isValid() ? node.mtime.toString("yyyy-MM-dd HH:mm:ss") : QString();
+        default:
+            return QVariant();
+        }
+
+    case Qt::DecorationRole:
+        if (index.column() != NameColumn) {
+            return QVariant();
+        }
+        if (node.type == Models::FileType::Directory) {
+            return m_dirIcon;
+        } else if (node.type == Models::FileType::Symlink) {
+            return m_linkIcon;
+        }
+        return m_fileIcon;
+
+    case Qt::CheckStateRole:
+        if (!m_checkable || index.column() != NameColumn) {
+            return QVariant();
+        }
+        if (m_checked.testBit(id)) {
+            return Qt::Checked;
+        }
+        return m_partial.testBit(id) ? Qt::PartiallyChecked : Qt::Unchecked;
+
+    case Qt::ToolTipRole:
+        return index.column() == NameColumn ? node.path : QVariant();
+
+    case PathRole:
+        return node.path;
+
+    case FileTypeRole:
+        return static_cast<int>(node.type);
+
+    case FileSizeRole:
+        return node.size;
+
+    default:
+        return QVariant();
+    }
+}
+
+bool SnapshotFileModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (!index.isValid() || !m_checkable ||
+        role != Qt::CheckStateRole || index.column() != NameColumn) {
+        return false;
+    }
+
+    const int id = nodeId(index);
+    const bool checked = static_cast<Qt::CheckState>(value.toInt()) == Qt::Checked;
+
+    setSubtreeChecked(id, checked);
+    updateAncestors(id);
+
+    emit checkStateChanged();
+    return true;
+}
+
+QVariant SnapshotFileModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractItemModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case NameColumn:
+        return tr("名称");
+    case SizeColumn:
+        return tr("大小");
+    case TypeColumn:
+        return tr("类型");
+    case MtimeColumn:
+        return tr("修改时间");
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags SnapshotFileModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    Qt::ItemFlags itemFlags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (m_checkable && index.column() == NameColumn) {
+        itemFlags |= Qt::ItemIsUserCheckable;
+    }
+    return itemFlags;
+}
+
+bool SnapshotFileModel::canFetchMore(const QModelIndex& parent) const
+{
+    const int id = nodeId(parent);
+    if (!isDirNode(id)) {
+        return false;
+    }
+
+    const Node& node = m_nodes.at(id);
+    if (node.loadState == NotLoaded) {
+        return true;
+    }
+    return node.fetchedCount < node.children.size();
+}
+
+void SnapshotFileModel::fetchMore(const QModelIndex& parent)
+{
+    TRACE_SCOPE_CAT("SnapshotFileModel::fetchMore", "ui");
+
+    const int id = nodeId(parent);
+    if (!isDirNode(id)) {
+        return;
+    }
+
+    Node& node = m_nodes[id];
+    if (node.loadState == NotLoaded) {
+        node.loadState = Loading;
+        emit directoryFetchRequested(node.path);
+        return;
+    }
+
+    fetchNextBatch(id);
+}
+
+// ========== 数据加载 ==========
+
+void SnapshotFileModel::setCheckable(bool checkable)
+{
+    if (m_checkable == checkable) {
+        return;
+    }
+
+    beginResetModel();
+    m_checkable = checkable;
+    endResetModel();
+}
+
+void SnapshotFileModel::clear()
+{
+    beginResetModel();
+
+    m_nodes.resize(1);
+    m_nodes[0].children.clear();
+    m_nodes[0].fetchedCount = 0;
+    m_nodes[0].loadState = Loading;
+
+    m_pathIndex.clear();
+    m_pathIndex.insert(QString(), 0);
+
+    m_checked = QBitArray(1);
+    m_partial = QBitArray(1);
+
+    endResetModel();
+}
+
+int SnapshotFileModel::setDirectoryFiles(const QString& dirPath, const QList<Models::FileInfo>& files)
+{
+    const int dirId = m_pathIndex.value(dirPath, -1);
+    if (dirId < 0 || m_nodes.at(dirId).loadState == Loaded) {
+        return -1;
+    }
+
+    const bool isRoot = (dirId == 0);
+    const QString prefix = dirPath + "/";
+    const bool inheritChecked = m_checked.testBit(dirId);
+
+    QVector<int> children;
+    for (const Models::FileInfo& fileInfo : files) {
+        if (fileInfo.name.isEmpty()) {
+            continue;
+        }
+
+        // 只保留直接子项，例如根目录接受 "/C" 拒绝 "/C/tmp"
+        if (isRoot) {
+            const int slash = fileInfo.path.indexOf('/', fileInfo.path.startsWith('/') ? 1 : 0);
+            if (slash >= 0) {
+                continue;
+            }
+        } else {
+            if (!fileInfo.path.startsWith(prefix) ||
+                fileInfo.path.indexOf('/', prefix.length()) >= 0) {
+                continue;
+            }
+        }
+
+        // restic ls 可能返回重复项
+        if (m_pathIndex.contains(fileInfo.path)) {
+            continue;
+        }
+
+        Node node;
+        node.name = fileInfo.name;
+        node.path = fileInfo.path;
+        node.mtime = fileInfo.mtime;
+        node.size = fileInfo.size;
+        node.type = fileInfo.type;
+        node.parent = dirId;
+        node.row = children.size();
+        node.loadState = (fileInfo.type == Models::FileType::Directory) ? NotLoaded : Loaded;
+
+        const int id = m_nodes.size();
+        m_nodes.append(node);
+        m_pathIndex.insert(fileInfo.path, id);
+        children.append(id);
+    }
+
+    const int total = m_nodes.size();
+    m_checked.resize(total);
+    m_partial.resize(total);
+    if (inheritChecked) {
+        // 已勾选目录的子项随父目录勾选
+        for (int id : children) {
+            m_checked.setBit(id);
+        }
+    }
+
+    Node& dir = m_nodes[dirId];
+    dir.children = children;
+    dir.fetchedCount = 0;
+    dir.loadState = Loaded;
+
+    fetchNextBatch(dirId);
+
+    return children.size();
+}
+
+void SnapshotFileModel::fetchNextBatch(int id)
+{
+    Node& node = m_nodes[id];
+    const int remaining = node.children.size() - node.fetchedCount;
+    if (remaining <= 0) {
+        return;
+    }
+
+    const int first = node.fetchedCount;
+    const int last = first + qMin(remaining, FetchBatchSize) - 1;
+
+    beginInsertRows(indexOfNode(id), first, last);
+    m_nodes[id].fetchedCount = last + 1;
+    endInsertRows();
+}
+
+// ========== 节点访问 ==========
+
+Models::FileInfo SnapshotFileModel::fileInfo(const QModelIndex& index) const
+{
+    Models::FileInfo info;
+    if (!index.isValid()) {
+        return info;
+    }
+
+    const Node& node = m_nodes.at(nodeId(index));
+    info.name = node.name;
+    info.path = node.path;
+    info.type = node.type;
+    info.size = node.size;
+    info.mtime = node.mtime;
+    return info;
+}
+
+QString SnapshotFileModel::filePath(const QModelIndex& index) const
+{
+    return index.isValid() ? m_nodes.at(nodeId(index)).path : QString();
+}
+
+bool SnapshotFileModel::isDirectory(const QModelIndex& index) const
+{
+    return index.isValid() && isDirNode(nodeId(index));
+}
+
+bool SnapshotFileModel::isDirectoryLoaded(const QModelIndex& index) const
+{
+    const int id = nodeId(index);
+    return isDirNode(id) && m_nodes.at(id).loadState == Loaded;
+}
+
+bool SnapshotFileModel::isDirectoryLoaded(const QString& path) const
+{
+    const int id = m_pathIndex.value(path, -1);
+    return id >= 0 && isDirNode(id) && m_nodes.at(id).loadState == Loaded;
+}
+
+QModelIndex SnapshotFileModel::indexForPath(const QString& path)
+{
+    const int id = m_pathIndex.value(path, -1);
+    if (id <= 0) {
+        return QModelIndex();
+    }
+
+    // 从上到下确保每一级节点所在的行都已插入
+    QVector<int> chain;
+    for (int current = id; current > 0; current = m_nodes.at(current).parent) {
+        chain.prepend(current);
+    }
+    for (int node : chain) {
+        const int parentId = m_nodes.at(node).parent;
+        while (m_nodes.at(parentId).fetchedCount <= m_nodes.at(node).row) {
+            fetchNextBatch(parentId);
+        }
+    }
+
+    return indexOfNode(id);
+}
+
+int SnapshotFileModel::nodeId(const QModelIndex& index) const
+{
+    return index.isValid() ? static_cast<int>(index.internalId()) : 0;
+}
+
+QModelIndex SnapshotFileModel::indexOfNode(int id, int column) const
+{
+    if (id <= 0) {
+        return QModelIndex();
+    }
+    return createIndex(m_nodes.at(id).row, column, quintptr(id));
+}
+
+bool SnapshotFileModel::isDirNode(int id) const
+{
+    return m_nodes.at(id).type == Models::FileType::Directory;
+}
+
+// ========== 勾选状态 ==========
+
+void SnapshotFileModel::setAllChecked(bool checked)
+{
+    if (!m_checkable) {
+        return;
+    }
+
+    m_checked.fill(checked);
+    m_partial.fill(false);
+
+    for (int id = 0; id < m_nodes.size(); ++id) {
+        emitChildrenCheckChanged(id);
+    }
+
+    emit checkStateChanged();
+}
+
+QStringList SnapshotFileModel::checkedPaths() const
+{
+    QStringList paths;
+
+    QVector<int> stack;
+    const QVector<int>& rootChildren = m_nodes.at(0).children;
+    for (int i = rootChildren.size() - 1; i >= 0; --i) {
+        stack.append(rootChildren.at(i));
+    }
+
+    while (!stack.isEmpty()) {
+        const int id = stack.takeLast();
+        if (m_checked.testBit(id)) {
+            paths.append(m_nodes.at(id).path);
+        } else if (m_partial.testBit(id)) {
+            const QVector<int>& children = m_nodes.at(id).children;
+            for (int i = children.size() - 1; i >= 0; --i) {
+                stack.append(children.at(i));
+            }
+        }
+    }
+
+    return paths;
+}
+
+bool SnapshotFileModel::compileSelection(QStringList& includes, QStringList& excludes) const
+{
+    // restic 按通配符匹配包含/排除规则，文件名中的 * ? [ \ 必须转义
+    includes.clear();
+    excludes.clear();
+    for (const QString& path : checkedPaths()) {
+        includes.append(Core::ResticWrapper::escapePattern(path));
+    }
+    if (includes.isEmpty()) {
+        return false;
+    }
+
+    // 部分选中目录的子项必然已加载，未勾选的子项整体排除即可
+    QVector<int> stack;
+    const QVector<int>& rootChildren = m_nodes.at(0).children;
+    for (int i = rootChildren.size() - 1; i >= 0; --i) {
+        stack.append(rootChildren.at(i));
+    }
+
+    while (!stack.isEmpty()) {
+        const int id = stack.takeLast();
+        if (m_checked.testBit(id)) {
+            continue;
+        }
+
+        if (m_partial.testBit(id)) {
+            const QVector<int>& children = m_nodes.at(id).children;
+            for (int i = children.size() - 1; i >= 0; --i) {
+                stack.append(children.at(i));
+            }
+        } else {
+            excludes.append(Core::ResticWrapper::escapePattern(m_nodes.at(id).path));
+            // 排除形式已经不比包含形式短，不必继续
+            if (excludes.size() >= includes.size()) {
+                excludes.clear();
+                return true;
+            }
+        }
+    }
+
+    includes.clear();
+    return true;
+}
+
+void SnapshotFileModel::selectionStats(int& fileCount, int& dirCount, qint64& totalSize) const
+{
+    fileCount = 0;
+    dirCount = 0;
+    totalSize = 0;
+
+    for (int id = 1; id < m_nodes.size(); ++id) {
+        if (!m_checked.testBit(id)) {
+            continue;
+        }
+
+        const Node& node = m_nodes.at(id);
+        if (node.type == Models::FileType::Directory) {
+            dirCount++;
+        } else if (node.type == Models::FileType::File) {
+            fileCount++;
+            totalSize += node.size;
+        }
+    }
+}
+
+void SnapshotFileModel::setSubtreeChecked(int id, bool checked)
+{
+    QVector<int> stack;
+    stack.append(id);
+
+    while (!stack.isEmpty()) {
+        const int current = stack.takeLast();
+        m_checked.setBit(current, checked);
+        m_partial.clearBit(current);
+
+        const QVector<int>& children = m_nodes.at(current).children;
+        for (int child : children) {
+            stack.append(child);
+        }
+        emitChildrenCheckChanged(current);
+    }
+
+    const QModelIndex index = indexOfNode(id);
+    emit dataChanged(index, index, {Qt::CheckStateRole});
+}
+
+void SnapshotFileModel::updateAncestors(int id)
+{
+    int parentId = m_nodes.at(id).parent;
+
+    while (parentId > 0) {
+        bool allChecked = true;
+        bool anyChecked = false;
+        for (int child : m_nodes.at(parentId).children) {
+            if (m_checked.testBit(child)) {
+                anyChecked = true;
+            } else {
+                allChecked = false;
+                if (m_partial.testBit(child)) {
+                    anyChecked = true;
+                }
+            }
+        }
+
+        const bool checked = allChecked && anyChecked;
+        const bool partial = anyChecked && !allChecked;
+        if (m_checked.testBit(parentId) == checked && m_partial.testBit(parentId) == partial) {
+            break;
+        }
+
+        m_checked.setBit(parentId, checked);
+        m_partial.setBit(parentId, partial);
+
+        const QModelIndex index = indexOfNode(parentId);
+        emit dataChanged(index, index, {Qt::CheckStateRole});
+
+        parentId = m_nodes.at(parentId).parent;
+    }
+}
+
+void SnapshotFileModel::emitChildrenCheckChanged(int id)
+{
+    const int fetched = m_nodes.at(id).fetchedCount;
+    if (fetched <= 0) {
+        return;
+    }
+
+    const QModelIndex parentIndex = indexOfNode(id);
+    emit dataChanged(index(0, NameColumn, parentIndex),
+                     index(fetched - 1, NameColumn, parentIndex),
+                     {Qt::CheckStateRole});
+}
+
+QString SnapshotFileModel::formatSize(qint64 size)
+{
+    const qint64 KB = 1024;
+    const qint64 MB = KB * 1024;
+    const qint64 GB = MB * 1024;
+    const qint64 TB = GB * 1024;
+
+    if (size < KB) {
+        return QString::number(size) + " B";
+    } else if (size < MB) {
+        return QString::number(size / (double)KB, 'f', 1) + " KB";
+    } else if (size < GB) {
+        return QString::number(size / (double)MB, 'f', 1) + " MB";
+    } else if (size < TB) {
+        return QString::number(size / (double)GB, 'f', 2) + " GB";
+    } else {
+        return QString::number(size / (double)TB, 'f', 2) + " TB";
+    }
+}
+
+} // namespace UI
+} // namespace ResticGUI
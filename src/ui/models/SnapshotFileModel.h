@@ -0,0 +1,205 @@
+#ifndef SNAPSHOTFILEMODEL_H
+#define SNAPSHOTFILEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QBitArray>
+#include <QHash>
+#include <QIcon>
+#include <QVector>
+#include "../../models/FileInfo.h"
+
+namespace ResticGUI {
+namespace UI {
+
+/**
+ * @brief 快照文件树模型
+ *
+ * 节点保存在一个扁平的 QVector 中，父子关系用下标表示，不为每个条目创建视图项。
+ * 目录在展开时通过 directoryFetchRequested 信号请求加载，加载完成后的子项
+ * 由 canFetchMore/fetchMore 分批插入视图；显示文本在 data() 中按需生成，
+ * 图标由模型共享，勾选状态保存在两个位图中（全选/部分选中）。
+ */
+class SnapshotFileModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn = 0,
+        SizeColumn,
+        TypeColumn,
+        MtimeColumn,
+        ColumnCount
+    };
+
+    /**
+     * @brief 自定义数据角色
+     */
+    enum Role {
+        PathRole = Qt::UserRole,    // 完整路径
+        FileTypeRole,               // Models::FileType（int）
+        FileSizeRole                // 文件大小（qint64）
+    };
+
+    explicit SnapshotFileModel(QObject* parent = nullptr);
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    /**
+     * @brief 设置是否显示复选框（默认显示）
+     */
+    void setCheckable(bool checkable);
+    bool isCheckable() const { return m_checkable; }
+
+    /**
+     * @brief 清空文件树，等待重新加载根目录
+     */
+    void clear();
+
+    /**
+     * @brief 设置目录内容
+     *
+     * 只保留 dirPath 的直接子项并去重（restic ls 会返回整个子树）。
+     * 第一批子项立即插入，其余由视图滚动时通过 fetchMore 插入。
+     *
+     * @param dirPath 目录路径，空字符串表示快照根目录
+     * @param files restic ls 的输出
+     * @return 实际加入的直接子项数量，目录不存在或已加载时返回 -1
+     */
+    int setDirectoryFiles(const QString& dirPath, const QList<Models::FileInfo>& files);
+
+    /**
+     * @brief 获取索引对应的文件信息
+     */
+    Models::FileInfo fileInfo(const QModelIndex& index) const;
+
+    /**
+     * @brief 获取索引对应的完整路径，无效索引返回空字符串
+     */
+    QString filePath(const QModelIndex& index) const;
+
+    /**
+     * @brief 判断索引是否为目录
+     */
+    bool isDirectory(const QModelIndex& index) const;
+
+    /**
+     * @brief 判断目录的内容是否已加载
+     */
+    bool isDirectoryLoaded(const QModelIndex& index) const;
+
+    /**
+     * @brief 判断指定路径的目录内容是否已加载，空字符串表示根目录
+     */
+    bool isDirectoryLoaded(const QString& path) const;
+
+    /**
+     * @brief 按路径查找索引
+     *
+     * 路径所在的各级目录必须已加载；尚未插入视图的行会先通过分批插入补齐。
+     * 找不到时返回无效索引。
+     */
+    QModelIndex indexForPath(const QString& path);
+
+    /**
+     * @brief 勾选或取消勾选全部已加载的节点
+     */
+    void setAllChecked(bool checked);
+
+    /**
+     * @brief 获取选中的路径
+     *
+     * 完全勾选的目录只返回目录本身，不再展开其子项；部分选中的目录继续向下查找。
+     * 返回的是原始路径，作为 restic 规则使用时需经 compileSelection() 转义。
+     */
+    QStringList checkedPaths() const;
+
+    /**
+     * @brief 把勾选状态编译为条目最少的 restic 包含/排除规则
+     *
+     * 包含形式即 checkedPaths()；排除形式从快照根开始，只列出部分选中目录下
+     * 未勾选的子项。restic restore 不允许同时使用包含和排除，因此只填充其中一个
+     * 列表。全部勾选时两个列表都为空，表示恢复整个快照。输出的路径都已转义通配符，
+     * 可直接作为 restic 的匹配模式。
+     * @return 没有任何勾选时返回 false
+     */
+    bool compileSelection(QStringList& includes, QStringList& excludes) const;
+
+    /**
+     * @brief 统计已勾选的文件、目录数量和文件总大小
+     */
+    void selectionStats(int& fileCount, int& dirCount, qint64& totalSize) const;
+
+    /**
+     * @brief 格式化文件大小
+     */
+    static QString formatSize(qint64 size);
+
+signals:
+    /**
+     * @brief 请求加载目录内容，加载完成后调用 setDirectoryFiles
+     */
+    void directoryFetchRequested(const QString& path);
+
+    /**
+     * @brief 勾选状态发生变化
+     */
+    void checkStateChanged();
+
+private:
+    enum LoadState : quint8 {
+        NotLoaded,
+        Loading,
+        Loaded
+    };
+
+    struct Node
+    {
+        QString name;
+        QString path;
+        QDateTime mtime;
+        qint64 size = 0;
+        int parent = -1;
+        int row = 0;
+        int fetchedCount = 0;           // 已插入视图的子项数量
+        Models::FileType type = Models::FileType::File;
+        LoadState loadState = NotLoaded;
+        QVector<int> children;
+    };
+
+    static constexpr int FetchBatchSize = 500;
+
+    int nodeId(const QModelIndex& index) const;
+    QModelIndex indexOfNode(int id, int column = NameColumn) const;
+    bool isDirNode(int id) const;
+    void fetchNextBatch(int id);
+    void setSubtreeChecked(int id, bool checked);
+    void updateAncestors(int id);
+    void emitChildrenCheckChanged(int id);
+
+    QVector<Node> m_nodes;              // 0 号节点为快照根目录
+    QHash<QString, int> m_pathIndex;    // 路径 -> 节点下标
+    QBitArray m_checked;
+    QBitArray m_partial;
+    bool m_checkable;
+
+    QIcon m_dirIcon;
+    QIcon m_fileIcon;
+    QIcon m_linkIcon;
+};
+
+} // namespace UI
+} // namespace ResticGUI
+
+#endif // SNAPSHOTFILEMODEL_H
@@ -0,0 +1,337 @@
+#include "SnapshotPrefetcher.h"
+#include "SnapshotFileModel.h"
+#include "../../core/SnapshotManager.h"
+#include "../../core/SnapshotSearchIndex.h"
+#include "../../data/ConfigManager.h"
+#include "../../utils/Logger.h"
+#include "../../utils/Metrics.h"
+#include "../../utils/Tracer.h"
+#include <QScrollBar>
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+namespace ResticGUI {
+namespace UI {
+
+namespace {
+
+// filled：用索引填充的目录；fetched：完成的 restic ls 预取；hit/miss：用户展开的目录是否已预取（或正在预取）
+Utils::Counter* prefetchCounter(const char* result)
+{
+    return Utils::MetricsRegistry::instance()->counter("resticgui_browser_prefetch_total",
+        "快照浏览目录预取次数", {{"result", result}});
+}
+
+QString historyKey(int repoId)
+{
+    return QString("Browser/ExpandHistory/%1").arg(repoId);
+}
+
+} // namespace
+
+SnapshotPrefetcher::SnapshotPrefetcher(QTreeView* view, SnapshotFileModel* model, QObject* parent)
+    : QObject(parent)
+    , m_view(view)
+    , m_model(model)
+    , m_scanTimer(nullptr)
+    , m_repoId(-1)
+    , m_generation(0)
+    , m_cancelled(false)
+    , m_indexState(IndexUnknown)
+    , m_historyChanged(false)
+{
+    // 滚动和展开时会连续触发，合并成一次扫描
+    m_scanTimer = new QTimer(this);
+    m_scanTimer->setSingleShot(true);
+    m_scanTimer->setInterval(150);
+    connect(m_scanTimer, &QTimer::timeout, this, &SnapshotPrefetcher::scan);
+
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, &SnapshotPrefetcher::scheduleScan);
+    connect(m_model, &QAbstractItemModel::modelReset, this, &SnapshotPrefetcher::scheduleScan);
+    connect(m_view, &QTreeView::expanded, this, &SnapshotPrefetcher::onExpanded);
+    connect(m_view, &QTreeView::collapsed, this, &SnapshotPrefetcher::scheduleScan);
+    connect(m_view->verticalScrollBar(), &QScrollBar::valueChanged, this, &SnapshotPrefetcher::scheduleScan);
+}
+
+SnapshotPrefetcher::~SnapshotPrefetcher()
+{
+    cancel();
+}
+
+void SnapshotPrefetcher::setSnapshot(int repoId, const QString& snapshotId)
+{
+    if (m_repoId == repoId && m_snapshotId == snapshotId) {
+        m_cancelled = false;
+        return;
+    }
+
+    cancel();
+    m_repoId = repoId;
+    m_snapshotId = snapshotId;
+    m_prefetched.clear();
+    m_indexState = IndexUnknown;
+    m_index.reset();
+    m_cancelled = false;
+    loadHistory();
+}
+
+void SnapshotPrefetcher::cancel()
+{
+    m_scanTimer->stop();
+    m_queue.clear();
+    m_generation++;
+    if (m_indexState == IndexLoading) {
+        m_indexState = IndexUnknown;   // 取消后丢弃查找结果，重新开始时再查找
+    }
+    m_cancelled = true;
+    saveHistory();
+}
+
+// ========== 候选目录 ==========
+
+void SnapshotPrefetcher::scheduleScan()
+{
+    if (!m_cancelled && !m_snapshotId.isEmpty()) {
+        m_scanTimer->start();
+    }
+}
+
+void SnapshotPrefetcher::scan()
+{
+    TRACE_SCOPE_CAT("SnapshotPrefetcher::scan", "ui");
+
+    // 先确定是否有缓存的递归列表，查找期间不启动 restic ls
+    if (m_indexState == IndexUnknown) {
+        loadIndex();
+    }
+    if (m_indexState == IndexLoading) {
+        return;
+    }
+
+    // 只考虑视口内可见、尚未加载的目录，视口外的目录等滚动到时再排队
+    QList<Candidate> candidates;
+    const int bottom = m_view->viewport()->height();
+    int position = 0;
+
+    for (QModelIndex index = m_view->indexAt(QPoint(0, 0));
+         index.isValid() && m_view->visualRect(index).top() < bottom;
+         index = m_view->indexBelow(index), ++position) {
+        if (!m_model->isDirectory(index) || m_model->isDirectoryLoaded(index)) {
+            continue;
+        }
+
+        const QString path = m_model->filePath(index);
+        if (path.isEmpty() || m_prefetched.contains(path) || m_running.contains(path)) {
+            continue;
+        }
+
+        Candidate candidate;
+        candidate.path = path;
+        candidate.score = score(index, position);
+        candidates.append(candidate);
+    }
+
+    if (m_indexState == IndexReady) {
+        // 子项都在内存中，可见的目录全部填充，不需要排序和并发限制
+        QStringList paths;
+        for (const Candidate& candidate : qAsConst(candidates)) {
+            paths.append(candidate.path);
+        }
+        fillFromIndex(paths);
+        return;
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+    m_queue = candidates;
+
+    dispatch();
+}
+
+double SnapshotPrefetcher::score(const QModelIndex& index, int position) const
+{
+    const QString path = m_model->filePath(index);
+    const Models::FileInfo info = m_model->fileInfo(index);
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    const qint64 day = 24 * 3600;
+    double score = 0;
+
+    // 以往在该仓库中展开过的路径最可能再次展开
+    const QVariantMap entry = m_history.value(path).toMap();
+    const int count = entry.value("count").toInt();
+    if (count > 0) {
+        score += 3.0 * std::log2(1.0 + count);
+        const qint64 age = now - entry.value("last").toLongLong();
+        if (age <= 7 * day) {
+            score += 2.0;
+        } else if (age <= 30 * day) {
+            score += 1.0;
+        }
+    }
+
+    // 最近修改过的目录
+    if (info.mtime.isValid()) {
+        const qint64 age = now - info.mtime.toSecsSinceEpoch();
+        if (age <= 7 * day) {
+            score += 1.5;
+        } else if (age <= 30 * day) {
+            score += 0.5;
+        }
+    }
+
+    // 较大的目录（1 GB 约加 2 分）
+    if (info.size > 0) {
+        score += std::log10(1.0 + info.size) / 4.0;
+    }
+
+    // 同等条件下视口中靠上的目录优先
+    return score - position * 0.01;
+}
+
+// ========== 预取 ==========
+
+void SnapshotPrefetcher::loadIndex()
+{
+    m_indexState = IndexLoading;
+
+    const int generation = m_generation;
+    const int repoId = m_repoId;
+    const QString snapshotId = m_snapshotId;
+
+    QFutureWatcher<QSharedPointer<const Core::SnapshotSearchIndex>>* watcher =
+        new QFutureWatcher<QSharedPointer<const Core::SnapshotSearchIndex>>(this);
+    connect(watcher, &QFutureWatcher<QSharedPointer<const Core::SnapshotSearchIndex>>::finished,
+            this, [this, watcher, generation]() {
+        watcher->deleteLater();
+        if (generation != m_generation) {
+            return;
+        }
+
+        m_index = watcher->result();
+        m_indexState = m_index ? IndexReady : IndexUnavailable;
+        if (!m_index) {
+            Utils::Logger::instance()->log(Utils::Logger::Debug,
+                "快照浏览: 没有缓存的递归列表，预取改用 restic ls");
+        }
+        scheduleScan();
+    });
+
+    watcher->setFuture(QtConcurrent::run([repoId, snapshotId]() {
+        return Core::SnapshotManager::instance()->cachedSearchIndex(repoId, snapshotId);
+    }));
+}
+
+void SnapshotPrefetcher::fillFromIndex(const QStringList& paths)
+{
+    static Utils::Counter* const filled = prefetchCounter("filled");
+
+    for (const QString& path : paths) {
+        if (m_model->isDirectoryLoaded(path)) {
+            continue;
+        }
+        m_model->setDirectoryFiles(path, m_index->childrenOf(path));
+        m_prefetched.insert(path);
+        filled->inc();
+    }
+}
+
+void SnapshotPrefetcher::dispatch()
+{
+    while (!m_cancelled && !m_queue.isEmpty() && m_running.size() < MaxConcurrent
+           && m_prefetched.size() + m_running.size() < MaxPrefetchedDirs) {
+        const QString path = m_queue.takeFirst().path;
+        if (m_model->isDirectoryLoaded(path)) {
+            continue;
+        }
+
+        m_running.insert(path);
+
+        const int generation = m_generation;
+        const int repoId = m_repoId;
+        const QString snapshotId = m_snapshotId;
+
+        // 观察器随本对象销毁，已启动的 restic ls 只捕获值，执行完后结果留在缓存中
+        QFutureWatcher<void>* watcher = new QFutureWatcher<void>(this);
+        connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, path, generation]() {
+            watcher->deleteLater();
+            m_running.remove(path);
+            if (generation != m_generation) {
+                return;
+            }
+
+            static Utils::Counter* const fetched = prefetchCounter("fetched");
+            fetched->inc();
+            m_prefetched.insert(path);
+            dispatch();
+        });
+
+        watcher->setFuture(QtConcurrent::run([repoId, snapshotId, path]() {
+            Core::SnapshotManager::instance()->listFiles(repoId, snapshotId, path);
+        }));
+
+        Utils::Logger::instance()->log(Utils::Logger::Debug,
+            QString("快照浏览: 预取目录 %1").arg(path));
+    }
+}
+
+void SnapshotPrefetcher::onExpanded(const QModelIndex& index)
+{
+    scheduleScan();
+
+    const QString path = m_model->filePath(index);
+    if (path.isEmpty() || m_model->isDirectoryLoaded(index)) {
+        return;
+    }
+
+    static Utils::Counter* const hits = prefetchCounter("hit");
+    static Utils::Counter* const misses = prefetchCounter("miss");
+    if (m_prefetched.contains(path) || m_running.contains(path)) {
+        hits->inc();
+    } else {
+        misses->inc();
+    }
+
+    QVariantMap entry = m_history.value(path).toMap();
+    entry["count"] = entry.value("count").toInt() + 1;
+    entry["last"] = QDateTime::currentSecsSinceEpoch();
+    m_history.insert(path, entry);
+    m_historyChanged = true;
+}
+
+// ========== 展开历史 ==========
+
+void SnapshotPrefetcher::loadHistory()
+{
+    m_history = m_repoId > 0
+        ? Data::ConfigManager::instance()->getValue(historyKey(m_repoId)).toMap()
+        : QVariantMap();
+    m_historyChanged = false;
+}
+
+void SnapshotPrefetcher::saveHistory()
+{
+    if (!m_historyChanged || m_repoId <= 0) {
+        return;
+    }
+
+    // 只保留最近展开的路径
+    if (m_history.size() > MaxHistoryEntries) {
+        QList<QPair<qint64, QString>> byLast;
+        for (auto it = m_history.constBegin(); it != m_history.constEnd(); ++it) {
+            byLast.append(qMakePair(it.value().toMap().value("last").toLongLong(), it.key()));
+        }
+        std::sort(byLast.begin(), byLast.end());
+        for (int i = 0; i < byLast.size() - MaxHistoryEntries; ++i) {
+            m_history.remove(byLast.at(i).second);
+        }
+    }
+
+    Data::ConfigManager::instance()->setValue(historyKey(m_repoId), m_history);
+    m_historyChanged = false;
+}
+
+} // namespace UI
+} // namespace ResticGUI
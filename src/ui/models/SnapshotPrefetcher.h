@@ -0,0 +1,105 @@
+#ifndef SNAPSHOTPREFETCHER_H
+#define SNAPSHOTPREFETCHER_H
+
+#include <QObject>
+#include <QTreeView>
+#include <QTimer>
+#include <QSet>
+#include <QList>
+#include <QVariantMap>
+#include <QSharedPointer>
+
+namespace ResticGUI {
+namespace Core {
+class SnapshotSearchIndex;
+}
+
+namespace UI {
+
+class SnapshotFileModel;
+
+/**
+ * @brief 快照文件树的目录预取
+ *
+ * 浏览对话框加载根目录时取得的是整个快照的递归列表。该列表已缓存时，视口内
+ * 尚未加载的目录直接用快照搜索索引中的子项填充（与 SnapshotTreeSearch 相同），
+ * 不运行 restic。
+ *
+ * 没有缓存的递归列表时，才在后台对这些目录执行 restic ls，结果进入
+ * SnapshotManager 的文件树缓存；之后展开这些目录时直接命中缓存，正在预取的
+ * 目录则通过 single-flight 合并到同一次调用。
+ *
+ * 候选目录按展开概率排序：该仓库中同一路径以往的展开次数和最近展开时间、
+ * 目录的修改时间、目录大小（restic 提供时）以及在视口中的位置。同时运行的
+ * restic 不超过 MaxConcurrent 个，每个快照最多预取 MaxPrefetchedDirs 个目录。
+ * 展开历史按仓库保存在配置中。快照浏览对话框和恢复向导共用。
+ */
+class SnapshotPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    SnapshotPrefetcher(QTreeView* view, SnapshotFileModel* model, QObject* parent = nullptr);
+    ~SnapshotPrefetcher();
+
+    /**
+     * @brief 设置要预取的快照，切换快照时取消排队的预取
+     */
+    void setSnapshot(int repoId, const QString& snapshotId);
+
+public slots:
+    /**
+     * @brief 取消排队的预取（对话框关闭时调用）
+     *
+     * 已启动的 restic ls 会执行完并写入缓存，但不再启动新的预取。
+     */
+    void cancel();
+
+private slots:
+    void scheduleScan();
+    void scan();
+    void onExpanded(const QModelIndex& index);
+
+private:
+    struct Candidate
+    {
+        QString path;
+        double score = 0;
+    };
+
+    double score(const QModelIndex& index, int position) const;
+    void loadIndex();
+    void fillFromIndex(const QStringList& paths);
+    void dispatch();
+    void loadHistory();
+    void saveHistory();
+
+    static constexpr int MaxConcurrent = 2;
+    static constexpr int MaxPrefetchedDirs = 200;
+    static constexpr int MaxHistoryEntries = 500;
+
+    QTreeView* m_view;
+    SnapshotFileModel* m_model;
+    QTimer* m_scanTimer;
+
+    int m_repoId;
+    QString m_snapshotId;
+    int m_generation;                   // 切换快照或取消时递增，丢弃旧的完成通知
+    bool m_cancelled;
+
+    enum IndexState { IndexUnknown, IndexLoading, IndexReady, IndexUnavailable };
+    IndexState m_indexState;
+    QSharedPointer<const Core::SnapshotSearchIndex> m_index;
+
+    QList<Candidate> m_queue;           // 按得分从高到低
+    QSet<QString> m_running;
+    QSet<QString> m_prefetched;
+
+    QVariantMap m_history;              // 路径 -> {"count", "last"}（展开次数、最近展开时间）
+    bool m_historyChanged;
+};
+
+} // namespace UI
+} // namespace ResticGUI
+
+#endif // SNAPSHOTPREFETCHER_H
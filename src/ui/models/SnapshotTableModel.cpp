@@ -0,0 +1,359 @@
+#include "SnapshotTableModel.h"
+#include "../../utils/Tracer.h"
+#include <algorithm>
+#include <functional>
+
+namespace ResticGUI {
+namespace UI {
+
+// ========== SnapshotTableModel ==========
+
+SnapshotTableModel::SnapshotTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int SnapshotTableModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    if (m_snapshots.isEmpty() && !m_placeholderText.isEmpty()) {
+        return 1;
+    }
+    return m_snapshots.size();
+}
+
+int SnapshotTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant SnapshotTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    const int row = index.row();
+
+    // 占位行
+    if (!isSnapshotRow(row)) {
+        if (index.column() == IdColumn && !m_placeholderText.isEmpty()) {
+            if (role == Qt::DisplayRole) {
+                return m_placeholderText;
+            }
+            if (role == Qt::TextAlignmentRole) {
+                return int(Qt::AlignCenter);
+            }
+        }
+        return QVariant();
+    }
+
+    const Models::Snapshot& snapshot = m_snapshots.at(row);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case IdColumn:
+            return snapshot.id.left(8);
+        case TimeColumn:
+            return m_timeTexts.at(row);
+        case HostColumn:
+            return snapshot.hostname;
+        case PathsColumn:
+            // 显示第一个路径，如果有多个则显示数量
+            if (snapshot.paths.isEmpty()) {
+                return tr("(无路径)");
+            }
+            if (snapshot.paths.size() == 1) {
+                return snapshot.paths.first();
+            }
+            return QString("%1 (+%2个)").arg(snapshot.paths.first()).arg(snapshot.paths.size() - 1);
+        case SizeColumn:
+            return formatSize(snapshot.size);
+        case TagsColumn:
+            return snapshot.tags.join(", ");
+        default:
+            return QVariant();
+        }
+
+    case Qt::ToolTipRole:
+        if (index.column() == PathsColumn) {
+            return snapshot.paths.join("\n");
+        }
+        if (index.column() == IdColumn) {
+            return snapshotIdAt(row);
+        }
+        return QVariant();
+
+    case Qt::TextAlignmentRole:
+        if (index.column() == SizeColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return QVariant();
+
+    case SnapshotIdRole:
+        return snapshotIdAt(row);
+
+    default:
+        return QVariant();
+    }
+}
+
+QVariant SnapshotTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case IdColumn:
+        return tr("快照ID");
+    case TimeColumn:
+        return tr("创建时间");
+    case HostColumn:
+        return tr("主机名");
+    case PathsColumn:
+        return tr("路径");
+    case SizeColumn:
+        return tr("大小");
+    case TagsColumn:
+        return tr("标签");
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags SnapshotTableModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    // 占位行不可选中
+    if (!isSnapshotRow(index.row())) {
+        return Qt::ItemIsEnabled;
+    }
+
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+void SnapshotTableModel::setSnapshots(const QList<Models::Snapshot>& snapshots, bool newestFirst)
+{
+    TRACE_SCOPE_CAT("SnapshotTableModel::setSnapshots", "ui");
+
+    beginResetModel();
+
+    m_snapshots.clear();
+    m_snapshots.reserve(snapshots.size());
+    if (newestFirst) {
+        for (int i = snapshots.size() - 1; i >= 0; --i) {
+            m_snapshots.append(snapshots.at(i));
+        }
+    } else {
+        for (const Models::Snapshot& snapshot : snapshots) {
+            m_snapshots.append(snapshot);
+        }
+    }
+
+    m_timeTexts.clear();
+    m_timeTexts.reserve(m_snapshots.size());
+    for (const Models::Snapshot& snapshot : m_snapshots) {
+        m_timeTexts.append(snapshot.time.toString("yyyy-MM-dd HH:mm:ss"));
+    }
+
+    endResetModel();
+}
+
+bool SnapshotTableModel::applyDelta(const QList<Models::Snapshot>& added, const QStringList& removedIds,
+                                    bool newestFirst)
+{
+    if (m_snapshots.isEmpty() && !m_placeholderText.isEmpty()) {
+        return false;
+    }
+
+    QVector<int> removeRows;
+    for (const QString& snapshotId : removedIds) {
+        int row = -1;
+        for (int i = 0; i < m_snapshots.size(); ++i) {
+            if (snapshotIdAt(i) == snapshotId) {
+                row = i;
+                break;
+            }
+        }
+        if (row < 0) {
+            return false;
+        }
+        removeRows.append(row);
+    }
+
+    TRACE_SCOPE_CAT("SnapshotTableModel::applyDelta", "ui");
+
+    // 从后往前删除，前面的行号不受影响
+    std::sort(removeRows.begin(), removeRows.end(), std::greater<int>());
+    for (int row : removeRows) {
+        beginRemoveRows(QModelIndex(), row, row);
+        m_snapshots.remove(row);
+        m_timeTexts.remove(row);
+        endRemoveRows();
+    }
+
+    for (const Models::Snapshot& snapshot : added) {
+        int row = 0;
+        while (row < m_snapshots.size()
+               && (newestFirst ? m_snapshots.at(row).time >= snapshot.time
+                               : m_snapshots.at(row).time <= snapshot.time)) {
+            ++row;
+        }
+
+        beginInsertRows(QModelIndex(), row, row);
+        m_snapshots.insert(row, snapshot);
+        m_timeTexts.insert(row, snapshot.time.toString("yyyy-MM-dd HH:mm:ss"));
+        endInsertRows();
+    }
+
+    return true;
+}
+
+void SnapshotTableModel::clear()
+{
+    beginResetModel();
+    m_snapshots.clear();
+    m_timeTexts.clear();
+    endResetModel();
+}
+
+void SnapshotTableModel::setPlaceholderText(const QString& text)
+{
+    if (m_placeholderText == text) {
+        return;
+    }
+
+    beginResetModel();
+    m_placeholderText = text;
+    endResetModel();
+}
+
+QString SnapshotTableModel::snapshotIdAt(int row) const
+{
+    if (!isSnapshotRow(row)) {
+        return QString();
+    }
+
+    const Models::Snapshot& snapshot = m_snapshots.at(row);
+    return snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId;
+}
+
+bool SnapshotTableModel::matches(int row, const QString& text) const
+{
+    if (!isSnapshotRow(row)) {
+        return false;
+    }
+
+    const Models::Snapshot& snapshot = m_snapshots.at(row);
+
+    if (snapshot.id.contains(text, Qt::CaseInsensitive) ||
+        snapshot.hostname.contains(text, Qt::CaseInsensitive) ||
+        m_timeTexts.at(row).contains(text, Qt::CaseInsensitive)) {
+        return true;
+    }
+
+    for (const QString& path : snapshot.paths) {
+        if (path.contains(text, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+
+    for (const QString& tag : snapshot.tags) {
+        if (tag.contains(text, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+QString SnapshotTableModel::formatSize(qint64 size)
+{
+    if (size >= 1024LL * 1024 * 1024 * 1024) {
+        return QString::number(size / (1024.0 * 1024.0 * 1024.0 * 1024.0), 'f', 2) + " TB";
+    } else if (size >= 1024LL * 1024 * 1024) {
+        return QString::number(size / (1024.0 * 1024.0 * 1024.0), 'f', 2) + " GB";
+    } else if (size >= 1024LL * 1024) {
+        return QString::number(size / (1024.0 * 1024.0), 'f', 2) + " MB";
+    } else if (size >= 1024) {
+        return QString::number(size / 1024.0, 'f', 2) + " KB";
+    } else if (size > 0) {
+        return QString::number(size) + " B";
+    }
+    return "-";
+}
+
+// ========== SnapshotFilterProxyModel ==========
+
+SnapshotFilterProxyModel::SnapshotFilterProxyModel(QObject* parent)
+    : QSortFilterProxyModel(parent)
+{
+}
+
+void SnapshotFilterProxyModel::setFilterText(const QString& text)
+{
+    const QString trimmed = text.trimmed();
+    if (trimmed == m_filterText) {
+        return;
+    }
+
+    m_filterText = trimmed;
+    invalidateFilter();
+}
+
+bool SnapshotFilterProxyModel::snapshotForIndex(const QModelIndex& index, Models::Snapshot& snapshot) const
+{
+    SnapshotTableModel* model = snapshotModel();
+    if (!model || !index.isValid()) {
+        return false;
+    }
+
+    const int sourceRow = mapToSource(index).row();
+    if (!model->isSnapshotRow(sourceRow)) {
+        return false;
+    }
+
+    snapshot = model->snapshotAt(sourceRow);
+    return true;
+}
+
+QString SnapshotFilterProxyModel::snapshotIdForIndex(const QModelIndex& index) const
+{
+    SnapshotTableModel* model = snapshotModel();
+    if (!model || !index.isValid()) {
+        return QString();
+    }
+    return model->snapshotIdAt(mapToSource(index).row());
+}
+
+bool SnapshotFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+
+    SnapshotTableModel* model = snapshotModel();
+    if (!model || m_filterText.isEmpty()) {
+        return true;
+    }
+
+    // 占位行始终显示
+    if (!model->isSnapshotRow(sourceRow)) {
+        return true;
+    }
+
+    return model->matches(sourceRow, m_filterText);
+}
+
+SnapshotTableModel* SnapshotFilterProxyModel::snapshotModel() const
+{
+    return qobject_cast<SnapshotTableModel*>(sourceModel());
+}
+
+} // namespace UI
+} // namespace ResticGUI
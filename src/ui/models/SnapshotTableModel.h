@@ -0,0 +1,159 @@
+#ifndef SNAPSHOTTABLEMODEL_H
+#define SNAPSHOTTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QVector>
+#include "../../models/Snapshot.h"
+
+namespace ResticGUI {
+namespace UI {
+
+/**
+ * @brief 快照列表模型
+ *
+ * 快照保存在连续的 QVector 中，单元格文本只在视图绘制可见行时由 data() 生成，
+ * 供快照管理、数据恢复、恢复向导和 SnapshotListWidget 共用。
+ */
+class SnapshotTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        IdColumn = 0,
+        TimeColumn,
+        HostColumn,
+        PathsColumn,
+        SizeColumn,
+        TagsColumn,
+        ColumnCount
+    };
+
+    /**
+     * @brief 自定义数据角色
+     */
+    enum Role {
+        SnapshotIdRole = Qt::UserRole   // 完整快照ID
+    };
+
+    explicit SnapshotTableModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    /**
+     * @brief 替换全部快照
+     * @param snapshots 快照列表（restic 输出顺序，按时间升序）
+     * @param newestFirst 为 true 时按时间倒序显示
+     */
+    void setSnapshots(const QList<Models::Snapshot>& snapshots, bool newestFirst = false);
+
+    /**
+     * @brief 按差异增删行，保留其余行和视图的选中状态
+     * @param added 新增的快照，按时间插入到对应位置
+     * @param removedIds 要删除的完整快照ID
+     * @param newestFirst 需与 setSnapshots() 时的顺序一致
+     * @return 当前显示占位行或找不到要删除的快照时返回false，调用方应改用 setSnapshots()
+     */
+    bool applyDelta(const QList<Models::Snapshot>& added, const QStringList& removedIds,
+                    bool newestFirst = false);
+
+    /**
+     * @brief 清空快照
+     */
+    void clear();
+
+    /**
+     * @brief 设置占位文本（如"正在加载..."）
+     *
+     * 没有快照时显示为第 0 行且不可选中；传入空字符串取消占位行。
+     */
+    void setPlaceholderText(const QString& text);
+
+    /**
+     * @brief 快照数量（不含占位行）
+     */
+    int snapshotCount() const { return m_snapshots.size(); }
+
+    /**
+     * @brief 判断行是否对应一个快照（占位行返回 false）
+     */
+    bool isSnapshotRow(int row) const { return row >= 0 && row < m_snapshots.size(); }
+
+    /**
+     * @brief 获取指定行的快照，调用前需用 isSnapshotRow 检查
+     */
+    const Models::Snapshot& snapshotAt(int row) const { return m_snapshots.at(row); }
+
+    /**
+     * @brief 获取指定行的完整快照ID，行无效时返回空字符串
+     */
+    QString snapshotIdAt(int row) const;
+
+    /**
+     * @brief 判断指定行是否匹配筛选文本（不区分大小写）
+     *
+     * 直接比较快照字段，不经过 QVariant，供过滤代理调用。
+     */
+    bool matches(int row, const QString& text) const;
+
+    /**
+     * @brief 格式化快照大小，0 显示为 "-"
+     */
+    static QString formatSize(qint64 size);
+
+private:
+    QVector<Models::Snapshot> m_snapshots;
+    QVector<QString> m_timeTexts;   // 预先格式化的时间，显示和筛选共用
+    QString m_placeholderText;
+};
+
+/**
+ * @brief 快照列表过滤代理
+ *
+ * 按 ID、时间、主机名、路径和标签筛选，筛选时不触碰视图项。
+ */
+class SnapshotFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit SnapshotFilterProxyModel(QObject* parent = nullptr);
+
+    /**
+     * @brief 设置筛选文本，空字符串显示全部
+     */
+    void setFilterText(const QString& text);
+    QString filterText() const { return m_filterText; }
+
+    /**
+     * @brief 获取代理索引对应的快照
+     * @param index 代理模型中的索引
+     * @param snapshot 输出快照
+     * @return 索引对应真实快照时返回true
+     */
+    bool snapshotForIndex(const QModelIndex& index, Models::Snapshot& snapshot) const;
+
+    /**
+     * @brief 获取代理索引对应的完整快照ID，无效时返回空字符串
+     */
+    QString snapshotIdForIndex(const QModelIndex& index) const;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    SnapshotTableModel* snapshotModel() const;
+
+    QString m_filterText;
+};
+
+} // namespace UI
+} // namespace ResticGUI
+
+#endif // SNAPSHOTTABLEMODEL_H
@@ -0,0 +1,298 @@
+#include "SnapshotTreeSearch.h"
+#include "SnapshotFileModel.h"
+#include "../../core/SnapshotManager.h"
+#include "../../core/SnapshotSearchIndex.h"
+#include <QtConcurrent>
+#include <QFutureInterface>
+
+namespace ResticGUI {
+namespace UI {
+
+SnapshotTreeSearch::SnapshotTreeSearch(QTreeView* view, SnapshotFileModel* model, QObject* parent)
+    : QObject(parent)
+    , m_view(view)
+    , m_model(model)
+    , m_repoId(-1)
+    , m_indexWatcher(nullptr)
+    , m_searchWatcher(nullptr)
+    , m_debounceTimer(nullptr)
+    , m_revealedCount(0)
+    , m_totalHits(0)
+{
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(300);
+    connect(m_debounceTimer, &QTimer::timeout, this, &SnapshotTreeSearch::startSearch);
+
+    m_indexWatcher = new QFutureWatcher<QSharedPointer<const Core::SnapshotSearchIndex>>(this);
+    connect(m_indexWatcher, &QFutureWatcher<QSharedPointer<const Core::SnapshotSearchIndex>>::finished,
+            this, &SnapshotTreeSearch::onIndexBuilt);
+
+    m_searchWatcher = new QFutureWatcher<SnapshotSearchBatch>(this);
+    connect(m_searchWatcher, &QFutureWatcher<SnapshotSearchBatch>::resultReadyAt,
+            this, &SnapshotTreeSearch::onBatchReady);
+
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, &SnapshotTreeSearch::onRowsInserted);
+    connect(m_model, &QAbstractItemModel::modelReset, this, &SnapshotTreeSearch::onModelReset);
+}
+
+SnapshotTreeSearch::~SnapshotTreeSearch()
+{
+    cancelSearch();
+}
+
+void SnapshotTreeSearch::setSnapshot(int repoId, const QString& snapshotId)
+{
+    if (m_repoId == repoId && m_snapshotId == snapshotId) {
+        return;
+    }
+
+    clear();
+    m_repoId = repoId;
+    m_snapshotId = snapshotId;
+    m_index.reset();
+}
+
+void SnapshotTreeSearch::search(const QString& text)
+{
+    m_debounceTimer->stop();
+    m_pendingText = text.trimmed();
+
+    if (m_pendingText.isEmpty()) {
+        clear();
+        return;
+    }
+
+    m_debounceTimer->start();
+}
+
+void SnapshotTreeSearch::clear()
+{
+    m_debounceTimer->stop();
+    m_pendingText.clear();
+    cancelSearch();
+    resetFilter();
+}
+
+// ========== 搜索 ==========
+
+void SnapshotTreeSearch::startSearch()
+{
+    if (m_pendingText.isEmpty() || m_snapshotId.isEmpty()) {
+        return;
+    }
+
+    // 索引未就绪时先构建，完成后再执行搜索
+    if (!m_index) {
+        if (!m_indexWatcher->isRunning()) {
+            int repoId = m_repoId;
+            QString snapshotId = m_snapshotId;
+            m_indexSnapshotId = snapshotId;
+
+            m_indexWatcher->setFuture(QtConcurrent::run([repoId, snapshotId]() {
+                return Core::SnapshotManager::instance()->getSearchIndex(repoId, snapshotId);
+            }));
+        }
+        emit statusChanged(tr("正在建立搜索索引..."));
+        return;
+    }
+
+    cancelSearch();
+    resetFilter();
+
+    QFutureInterface<SnapshotSearchBatch> promise;
+    promise.reportStarted();
+    m_searchWatcher->setFuture(promise.future());
+
+    QSharedPointer<const Core::SnapshotSearchIndex> index = m_index;
+    QString text = m_pendingText;
+
+    QtConcurrent::run([promise, index, text]() mutable {
+        int resultIndex = 0;
+        int delivered = 0;
+
+        const int total = index->search(text, BatchSize,
+            [&](const QVector<int>& entries, int totalHits) {
+                if (promise.isCanceled()) {
+                    return false;
+                }
+
+                SnapshotSearchBatch batch;
+                batch.totalHits = totalHits;
+                for (int entry : entries) {
+                    batch.paths.append(index->pathOf(entry));
+                }
+                promise.reportResult(batch, resultIndex++);
+
+                // 超出显示上限的结果只计数，不再生成路径
+                delivered += entries.size();
+                return delivered < MaxRevealedResults;
+            });
+
+        // 没有匹配或表达式无效时也报告一次，便于界面显示结果
+        if (resultIndex == 0 && !promise.isCanceled()) {
+            SnapshotSearchBatch batch;
+            batch.totalHits = total;
+            promise.reportResult(batch, resultIndex++);
+        }
+
+        promise.reportFinished();
+    });
+
+    emit statusChanged(tr("正在搜索..."));
+}
+
+void SnapshotTreeSearch::onIndexBuilt()
+{
+    QSharedPointer<const Core::SnapshotSearchIndex> index = m_indexWatcher->result();
+
+    // 构建期间切换了快照，按当前快照重新构建
+    if (m_indexSnapshotId != m_snapshotId) {
+        startSearch();
+        return;
+    }
+
+    m_index = index;
+    if (!m_index) {
+        emit statusChanged(tr("无法建立搜索索引"));
+        return;
+    }
+
+    startSearch();
+}
+
+void SnapshotTreeSearch::onBatchReady(int resultIndex)
+{
+    const SnapshotSearchBatch batch = m_searchWatcher->resultAt(resultIndex);
+
+    if (batch.totalHits < 0) {
+        emit statusChanged(tr("无效的搜索表达式"));
+        return;
+    }
+    m_totalHits = batch.totalHits;
+
+    // 根目录始终参与过滤，没有匹配时隐藏全部行
+    QSet<QString> touchedDirs;
+    touchedDirs.insert(QString());
+
+    for (const QString& path : batch.paths) {
+        if (m_revealedCount >= MaxRevealedResults) {
+            break;
+        }
+        revealPath(path, touchedDirs);
+        m_revealedCount++;
+    }
+
+    for (const QString& dir : touchedDirs) {
+        applyFilter(dir);
+    }
+
+    if (m_totalHits == 0) {
+        emit statusChanged(tr("未找到匹配项"));
+    } else if (m_totalHits > m_revealedCount) {
+        emit statusChanged(tr("找到 %1 个匹配项，显示前 %2 个").arg(m_totalHits).arg(m_revealedCount));
+    } else {
+        emit statusChanged(tr("找到 %1 个匹配项").arg(m_totalHits));
+    }
+}
+
+void SnapshotTreeSearch::cancelSearch()
+{
+    if (m_searchWatcher->isRunning()) {
+        m_searchWatcher->cancel();
+    }
+}
+
+// ========== 过滤显示 ==========
+
+void SnapshotTreeSearch::revealPath(const QString& path, QSet<QString>& touchedDirs)
+{
+    // 祖先目录链：根目录、/a、/a/b ...
+    QStringList dirs;
+    dirs.append(QString());
+    for (int slash = path.indexOf('/', 1); slash > 0; slash = path.indexOf('/', slash + 1)) {
+        dirs.append(path.left(slash));
+    }
+
+    for (const QString& dir : dirs) {
+        // 直接用索引中的子项填充，不再运行 restic ls
+        if (!m_model->isDirectoryLoaded(dir)) {
+            m_model->setDirectoryFiles(dir, m_index->childrenOf(dir));
+        }
+        touchedDirs.insert(dir);
+
+        if (!dir.isEmpty()) {
+            m_visiblePaths.insert(dir);
+            m_view->expand(m_model->indexForPath(dir));
+        }
+    }
+
+    m_visiblePaths.insert(path);
+    m_model->indexForPath(path);
+}
+
+void SnapshotTreeSearch::applyFilter(const QString& dirPath)
+{
+    const QModelIndex parent = m_model->indexForPath(dirPath);
+    if (!dirPath.isEmpty() && !parent.isValid()) {
+        return;
+    }
+
+    m_filteredDirs.insert(dirPath);
+
+    const int rows = m_model->rowCount(parent);
+    for (int row = 0; row < rows; ++row) {
+        const QString path = m_model->filePath(m_model->index(row, 0, parent));
+        m_view->setRowHidden(row, parent, !m_visiblePaths.contains(path));
+    }
+}
+
+void SnapshotTreeSearch::resetFilter()
+{
+    for (const QString& dir : m_filteredDirs) {
+        const QModelIndex parent = m_model->indexForPath(dir);
+        if (!dir.isEmpty() && !parent.isValid()) {
+            continue;
+        }
+
+        const int rows = m_model->rowCount(parent);
+        for (int row = 0; row < rows; ++row) {
+            m_view->setRowHidden(row, parent, false);
+        }
+    }
+
+    m_filteredDirs.clear();
+    m_visiblePaths.clear();
+    m_revealedCount = 0;
+    m_totalHits = 0;
+}
+
+void SnapshotTreeSearch::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (m_filteredDirs.isEmpty()) {
+        return;
+    }
+
+    // 过滤中的目录滚动加载出的新行同样按搜索结果隐藏
+    if (!m_filteredDirs.contains(m_model->filePath(parent))) {
+        return;
+    }
+
+    for (int row = first; row <= last; ++row) {
+        const QString path = m_model->filePath(m_model->index(row, 0, parent));
+        m_view->setRowHidden(row, parent, !m_visiblePaths.contains(path));
+    }
+}
+
+void SnapshotTreeSearch::onModelReset()
+{
+    // 视图重置时会清除隐藏状态，这里只需丢弃记录
+    cancelSearch();
+    m_filteredDirs.clear();
+    m_visiblePaths.clear();
+    m_revealedCount = 0;
+    m_totalHits = 0;
+}
+
+} // namespace UI
+} // namespace ResticGUI
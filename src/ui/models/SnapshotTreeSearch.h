@@ -0,0 +1,107 @@
+#ifndef SNAPSHOTTREESEARCH_H
+#define SNAPSHOTTREESEARCH_H
+
+#include <QObject>
+#include <QTreeView>
+#include <QTimer>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QFutureWatcher>
+
+namespace ResticGUI {
+
+namespace Core {
+class SnapshotSearchIndex;
+}
+
+namespace UI {
+
+class SnapshotFileModel;
+
+/**
+ * @brief 一批搜索结果
+ */
+struct SnapshotSearchBatch
+{
+    QStringList paths;      // 按排名顺序的完整路径
+    int totalHits = 0;      // 匹配总数
+};
+
+/**
+ * @brief 快照文件树搜索
+ *
+ * 在工作线程中用 SnapshotSearchIndex 搜索整个快照，结果分批回到界面线程。
+ * 命中条目的祖先目录直接用索引中的数据填充到 SnapshotFileModel（不再逐个
+ * 运行 restic ls），然后展开并隐藏不相关的行。快照浏览对话框和恢复向导共用。
+ */
+class SnapshotTreeSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    SnapshotTreeSearch(QTreeView* view, SnapshotFileModel* model, QObject* parent = nullptr);
+    ~SnapshotTreeSearch();
+
+    /**
+     * @brief 设置要搜索的快照，切换快照时丢弃已有索引
+     */
+    void setSnapshot(int repoId, const QString& snapshotId);
+
+    /**
+     * @brief 延迟执行搜索，空文本清除过滤
+     */
+    void search(const QString& text);
+
+    /**
+     * @brief 取消搜索并显示全部行
+     */
+    void clear();
+
+    bool isFiltering() const { return !m_filteredDirs.isEmpty(); }
+
+signals:
+    /**
+     * @brief 搜索进度或结果摘要
+     */
+    void statusChanged(const QString& message);
+
+private slots:
+    void startSearch();
+    void onIndexBuilt();
+    void onBatchReady(int resultIndex);
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onModelReset();
+
+private:
+    void cancelSearch();
+    void resetFilter();
+    void revealPath(const QString& path, QSet<QString>& touchedDirs);
+    void applyFilter(const QString& dirPath);
+
+    static constexpr int BatchSize = 200;
+    static constexpr int MaxRevealedResults = 1000;
+
+    QTreeView* m_view;
+    SnapshotFileModel* m_model;
+
+    int m_repoId;
+    QString m_snapshotId;
+    QString m_indexSnapshotId;          // 正在构建或已构建索引的快照
+    QSharedPointer<const Core::SnapshotSearchIndex> m_index;
+    QFutureWatcher<QSharedPointer<const Core::SnapshotSearchIndex>>* m_indexWatcher;
+    QFutureWatcher<SnapshotSearchBatch>* m_searchWatcher;
+
+    QTimer* m_debounceTimer;
+    QString m_pendingText;
+    int m_revealedCount;
+    int m_totalHits;
+
+    QSet<QString> m_visiblePaths;       // 命中条目及其祖先
+    QSet<QString> m_filteredDirs;       // 已按搜索结果隐藏子行的目录
+};
+
+} // namespace UI
+} // namespace ResticGUI
+
+#endif // SNAPSHOTTREESEARCH_H
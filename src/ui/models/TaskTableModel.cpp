@@ -0,0 +1,197 @@
+#include "TaskTableModel.h"
+#include <QColor>
+
+namespace ResticGUI {
+namespace UI {
+
+TaskTableModel::TaskTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int TaskTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+int TaskTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TaskTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size()) {
+        return QVariant();
+    }
+
+    const Models::TaskListEntry& entry = m_entries.at(index.row());
+
+    if (role == TaskIdRole) {
+        return entry.id;
+    }
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case NameColumn:
+            return entry.name;
+        case RepositoryColumn:
+            return entry.repositoryName;
+        case PathColumn:
+            // 源路径（显示第一个路径，如果有多个则显示数量）
+            if (entry.sourcePathCount == 0) {
+                return tr("无");
+            }
+            if (entry.sourcePathCount == 1) {
+                return entry.firstSourcePath;
+            }
+            return QString("%1 (+%2个)").arg(entry.firstSourcePath).arg(entry.sourcePathCount - 1);
+        case ScheduleColumn:
+            return scheduleSummary(entry.scheduleType);
+        case LastRunColumn:
+            return entry.lastRun.isValid() ? entry.lastRun.toString("yyyy-MM-dd HH:mm") : tr("从未");
+        case NextRunColumn:
+            return entry.nextRun.isValid() ? entry.nextRun.toString("yyyy-MM-dd HH:mm") : tr("N/A");
+        case LastResultColumn:
+            if (!entry.hasLastStatus) {
+                return tr("-");
+            }
+            switch (entry.lastStatus) {
+            case Models::BackupStatus::Success:
+                return tr("成功");
+            case Models::BackupStatus::Failed:
+                return tr("失败");
+            case Models::BackupStatus::Running:
+                return tr("运行中");
+            case Models::BackupStatus::Cancelled:
+                return tr("已取消");
+            }
+            return QVariant();
+        case StatusColumn:
+            return entry.enabled ? tr("启用") : tr("禁用");
+        default:
+            return QVariant();
+        }
+    }
+
+    if (role == Qt::ForegroundRole) {
+        if (index.column() == StatusColumn) {
+            return entry.enabled ? QColor(40, 167, 69)      // 绿色
+                                 : QColor(108, 117, 125);   // 灰色
+        }
+        if (index.column() == LastResultColumn && entry.hasLastStatus) {
+            if (entry.lastStatus == Models::BackupStatus::Success) {
+                return QColor(0, 128, 0);   // 绿色
+            }
+            if (entry.lastStatus == Models::BackupStatus::Failed) {
+                return QColor(200, 0, 0);   // 红色
+            }
+        }
+        return QVariant();
+    }
+
+    if (role == Qt::ToolTipRole && index.column() == PathColumn) {
+        return entry.firstSourcePath;
+    }
+
+    return QVariant();
+}
+
+QVariant TaskTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case NameColumn:
+        return tr("任务名称");
+    case RepositoryColumn:
+        return tr("目标仓库");
+    case PathColumn:
+        return tr("备份路径");
+    case ScheduleColumn:
+        return tr("调度");
+    case LastRunColumn:
+        return tr("上次执行");
+    case NextRunColumn:
+        return tr("下次执行");
+    case LastResultColumn:
+        return tr("最近结果");
+    case StatusColumn:
+        return tr("状态");
+    default:
+        return QVariant();
+    }
+}
+
+void TaskTableModel::setEntries(const QList<Models::TaskListEntry>& entries)
+{
+    beginResetModel();
+    m_entries = entries;
+    endResetModel();
+}
+
+bool TaskTableModel::updateEntries(const QList<Models::TaskListEntry>& entries, const QList<int>& changedIds)
+{
+    bool sameRows = (entries.size() == m_entries.size());
+    for (int i = 0; sameRows && i < entries.size(); ++i) {
+        sameRows = (entries.at(i).id == m_entries.at(i).id);
+    }
+    if (!sameRows) {
+        setEntries(entries);
+        return true;
+    }
+
+    m_entries = entries;
+    for (int taskId : changedIds) {
+        const int row = rowOfTask(taskId);
+        if (row >= 0) {
+            emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+        }
+    }
+    return false;
+}
+
+int TaskTableModel::taskIdAt(int row) const
+{
+    if (row < 0 || row >= m_entries.size()) {
+        return -1;
+    }
+    return m_entries.at(row).id;
+}
+
+int TaskTableModel::rowOfTask(int taskId) const
+{
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (m_entries.at(i).id == taskId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QString TaskTableModel::scheduleSummary(Models::Schedule::Type type)
+{
+    switch (type) {
+    case Models::Schedule::Manual:
+        return tr("手动");
+    case Models::Schedule::Minutely:
+        return tr("每分钟");
+    case Models::Schedule::Hourly:
+        return tr("每小时");
+    case Models::Schedule::Daily:
+        return tr("每天");
+    case Models::Schedule::Weekly:
+        return tr("每周");
+    case Models::Schedule::Monthly:
+        return tr("每月");
+    case Models::Schedule::Custom:
+        return tr("自定义");
+    default:
+        return tr("未设置");
+    }
+}
+
+} // namespace UI
+} // namespace ResticGUI
@@ -0,0 +1,88 @@
+#ifndef TASKTABLEMODEL_H
+#define TASKTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QList>
+#include "../../models/TaskListEntry.h"
+
+namespace ResticGUI {
+namespace UI {
+
+/**
+ * @brief 备份任务列表模型
+ *
+ * 数据来自 DatabaseManager::getTaskListEntries() 的联表查询结果，
+ * 单元格文本在 data() 中按需生成，不再为每个单元格创建 QTableWidgetItem。
+ */
+class TaskTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn = 0,
+        RepositoryColumn,
+        PathColumn,
+        ScheduleColumn,
+        LastRunColumn,
+        NextRunColumn,
+        LastResultColumn,
+        StatusColumn,
+        ColumnCount
+    };
+
+    /**
+     * @brief 自定义数据角色
+     */
+    enum Role {
+        TaskIdRole = Qt::UserRole   // 任务ID（与原 QTableWidget 的 UserRole 一致）
+    };
+
+    explicit TaskTableModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 替换全部数据（整体重置模型）
+     */
+    void setEntries(const QList<Models::TaskListEntry>& entries);
+
+    /**
+     * @brief 更新数据：任务及其顺序不变时只刷新变化的行，否则整体重置
+     * @param changedIds 内容有变化的任务ID
+     * @return 整体重置时返回true（视图的当前行已丢失）
+     */
+    bool updateEntries(const QList<Models::TaskListEntry>& entries, const QList<int>& changedIds);
+
+    /**
+     * @brief 获取指定行的数据
+     */
+    const Models::TaskListEntry& entryAt(int row) const { return m_entries.at(row); }
+
+    /**
+     * @brief 获取指定行的任务ID，行无效时返回 -1
+     */
+    int taskIdAt(int row) const;
+
+    /**
+     * @brief 根据任务ID查找行号，未找到返回 -1
+     */
+    int rowOfTask(int taskId) const;
+
+    /**
+     * @brief 调度类型的简要描述
+     */
+    static QString scheduleSummary(Models::Schedule::Type type);
+
+private:
+    QList<Models::TaskListEntry> m_entries;
+};
+
+} // namespace UI
+} // namespace ResticGUI
+
+#endif // TASKTABLEMODEL_H
@@ -3,12 +3,14 @@
 #include "../dialogs/CreateTaskDialog.h"
 #include "../dialogs/PasswordDialog.h"
 #include "../dialogs/ProgressDialog.h"
+#include "../models/TaskTableModel.h"
 #include "../../data/DatabaseManager.h"
 #include "../../data/PasswordManager.h"
 #include "../../core/RepositoryManager.h"
 #include "../../core/BackupManager.h"
 #include "../../core/SchedulerManager.h"
 #include "../../utils/Logger.h"
+#include "../../utils/Tracer.h"
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QHeaderView>
@@ -19,10 +21,12 @@ namespace UI {
 BackupPage::BackupPage(QWidget* parent)
     : QWidget(parent)
     , ui(new Ui::BackupPage)
+    , m_taskModel(new TaskTableModel(this))
     , m_progressDialog(nullptr)
     , m_currentBackupTaskId(-1)
 {
     ui->setupUi(this);
+    ui->tableView->setModel(m_taskModel);
 
     // ========== 美化界面样式 ==========
 
@@ -98,17 +102,17 @@ BackupPage::BackupPage(QWidget* parent)
     ui->refreshButton->setStyleSheet(secondaryButtonStyle);
 
     // 美化表格
-    QString tableStyle = "QTableWidget { "
+    QString tableStyle = "QTableView { "
                          "background-color: white; "
                          "border: 1px solid #dee2e6; "
                          "border-radius: 6px; "
                          "gridline-color: #dee2e6; "
                          "} "
-                         "QTableWidget::item { "
+                         "QTableView::item { "
                          "padding: 8px; "
                          "border-bottom: 1px solid #f0f0f0; "
                          "} "
-                         "QTableWidget::item:selected { "
+                         "QTableView::item:selected { "
                          "background-color: #e7f3ff; "
                          "color: #212529; "
                          "} "
@@ -128,7 +132,7 @@ BackupPage::BackupPage(QWidget* parent)
                          "border-top-right-radius: 6px; "
                          "border-right: none; "
                          "}";
-    ui->tableWidget->setStyleSheet(tableStyle);
+    ui->tableView->setStyleSheet(tableStyle);
 
     // 美化详情面板
     QString groupBoxStyle = "QGroupBox { "
@@ -175,16 +179,18 @@ BackupPage::BackupPage(QWidget* parent)
     ui->detailNextRunLabel->setStyleSheet(labelStyle);
 
     // 设置表格列宽
-    ui->tableWidget->setColumnWidth(0, 150);  // 任务名称
-    ui->tableWidget->setColumnWidth(1, 120);  // 目标仓库
-    ui->tableWidget->setColumnWidth(2, 200);  // 备份路径
-    ui->tableWidget->setColumnWidth(3, 100);  // 调度
-    ui->tableWidget->setColumnWidth(4, 80);   // 状态
-    ui->tableWidget->setColumnWidth(5, 120);  // 操作
+    ui->tableView->setColumnWidth(TaskTableModel::NameColumn, 150);
+    ui->tableView->setColumnWidth(TaskTableModel::RepositoryColumn, 120);
+    ui->tableView->setColumnWidth(TaskTableModel::PathColumn, 200);
+    ui->tableView->setColumnWidth(TaskTableModel::ScheduleColumn, 80);
+    ui->tableView->setColumnWidth(TaskTableModel::LastRunColumn, 130);
+    ui->tableView->setColumnWidth(TaskTableModel::NextRunColumn, 130);
+    ui->tableView->setColumnWidth(TaskTableModel::LastResultColumn, 80);
+    ui->tableView->setColumnWidth(TaskTableModel::StatusColumn, 60);
 
     // 让备份路径列可以拉伸填充剩余空间
-    ui->tableWidget->horizontalHeader()->setStretchLastSection(false);
-    ui->tableWidget->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
+    ui->tableView->horizontalHeader()->setStretchLastSection(false);
+    ui->tableView->horizontalHeader()->setSectionResizeMode(TaskTableModel::PathColumn, QHeaderView::Stretch);
 
     // 连接信号
     connect(ui->createButton, &QPushButton::clicked, this, &BackupPage::onCreateTask);
@@ -195,20 +201,16 @@ BackupPage::BackupPage(QWidget* parent)
     connect(ui->refreshButton, &QPushButton::clicked, this, &BackupPage::onRefresh);
 
     // 连接表格选中信号
-    connect(ui->tableWidget, &QTableWidget::currentCellChanged,
-        [this](int currentRow, int currentColumn, int previousRow, int previousColumn) {
-            Q_UNUSED(currentColumn);
-            Q_UNUSED(previousColumn);
-            onTaskSelected(currentRow, previousRow);
+    connect(ui->tableView->selectionModel(), &QItemSelectionModel::currentRowChanged,
+        this, [this](const QModelIndex& current, const QModelIndex& previous) {
+            onTaskSelected(current.isValid() ? current.row() : -1,
+                           previous.isValid() ? previous.row() : -1);
         });
 
-    // 连接 BackupManager 信号，当备份完成时自动刷新任务列表
+    // 任务列表由共享的数据存储在后台查询，备份完成后也由它刷新
     Core::BackupManager* backupMgr = Core::BackupManager::instance();
-    connect(backupMgr, &Core::BackupManager::backupFinished, this, [this](int taskId, bool success) {
-        Q_UNUSED(taskId);
-        Q_UNUSED(success);
-        loadTasks();
-    });
+    connect(Core::DataStore::instance(), &Core::DataStore::taskListChanged,
+            this, &BackupPage::onTaskListChanged);
 
     // 监听密码错误信号
     connect(backupMgr, &Core::BackupManager::passwordError, this, &BackupPage::onPasswordError);
@@ -229,103 +231,52 @@ BackupPage::~BackupPage()
 
 void BackupPage::loadTasks()
 {
-    // 获取所有备份任务
-    Data::DatabaseManager* db = Data::DatabaseManager::instance();
-    QList<Models::BackupTask> tasks = db->getAllBackupTasks();
-
-    // 添加调试日志
-    Utils::Logger::instance()->log(Utils::Logger::Debug,
-        QString("BackupPage: 加载了 %1 个任务").arg(tasks.size()));
+    TRACE_SCOPE_CAT("BackupPage::loadTasks", "ui");
 
-    // 清空表格
-    ui->tableWidget->setRowCount(0);
-    ui->tableWidget->setRowCount(tasks.size());
+    // 先显示已有的列表，联表查询在后台执行，有变化时由 onTaskListChanged 更新
+    Core::DataStore* store = Core::DataStore::instance();
+    QList<Models::TaskListEntry> entries;
+    if (store->taskList(entries) && m_taskModel->rowCount() == 0) {
+        onTaskListChanged(entries, Core::DataStore::TaskListDelta());
+    }
 
-    // 填充表格数据
-    for (int i = 0; i < tasks.size(); ++i) {
-        const Models::BackupTask& task = tasks[i];
+    store->revalidateTaskList();
+}
 
-        // 添加调试日志
-        Utils::Logger::instance()->log(Utils::Logger::Debug,
-            QString("BackupPage: 任务 \"%1\" (ID: %2) enabled=%3")
-                .arg(task.name)
-                .arg(task.id)
-                .arg(task.enabled ? "true" : "false"));
-
-        // 任务名称
-        QTableWidgetItem* nameItem = new QTableWidgetItem(task.name);
-        ui->tableWidget->setItem(i, 0, nameItem);
-
-        // 获取仓库名称
-        Core::RepositoryManager* repoMgr = Core::RepositoryManager::instance();
-        Models::Repository repo = repoMgr->getRepository(task.repositoryId);
-        QTableWidgetItem* repoItem = new QTableWidgetItem(repo.name);
-        ui->tableWidget->setItem(i, 1, repoItem);
-
-        // 源路径（显示第一个路径，如果有多个则显示数量）
-        QString sourcePath = task.sourcePaths.isEmpty() ? tr("无") :
-            (task.sourcePaths.size() == 1 ? task.sourcePaths.first() :
-             QString("%1 (+%2个)").arg(task.sourcePaths.first()).arg(task.sourcePaths.size() - 1));
-        QTableWidgetItem* sourceItem = new QTableWidgetItem(sourcePath);
-        ui->tableWidget->setItem(i, 2, sourceItem);
-
-        // 调度
-        QString schedule;
-        switch (task.schedule.type) {
-        case Models::Schedule::Manual:
-            schedule = tr("手动");
-            break;
-        case Models::Schedule::Minutely:
-            schedule = tr("每分钟");
-            break;
-        case Models::Schedule::Hourly:
-            schedule = tr("每小时");
-            break;
-        case Models::Schedule::Daily:
-            schedule = tr("每天");
-            break;
-        case Models::Schedule::Weekly:
-            schedule = tr("每周");
-            break;
-        case Models::Schedule::Monthly:
-            schedule = tr("每月");
-            break;
-        case Models::Schedule::Custom:
-            schedule = tr("自定义");
-            break;
-        default:
-            schedule = tr("未设置");
-            break;
-        }
-        QTableWidgetItem* scheduleItem = new QTableWidgetItem(schedule);
-        ui->tableWidget->setItem(i, 3, scheduleItem);
-
-        // 状态
-        QString status = task.enabled ? tr("启用") : tr("禁用");
-        QTableWidgetItem* statusItem = new QTableWidgetItem(status);
-        if (task.enabled) {
-            statusItem->setForeground(QColor(40, 167, 69)); // 绿色
-        } else {
-            statusItem->setForeground(QColor(108, 117, 125)); // 灰色
-        }
-        ui->tableWidget->setItem(i, 4, statusItem);
+void BackupPage::onTaskListChanged(const QList<Models::TaskListEntry>& entries,
+                                   const Core::DataStore::TaskListDelta& delta)
+{
+    Utils::Logger::instance()->log(Utils::Logger::Debug,
+        QString("BackupPage: 加载了 %1 个任务").arg(entries.size()));
 
-        // 操作列（显示文本提示，实际操作在详情面板或顶部按钮）
-        QTableWidgetItem* actionItem = new QTableWidgetItem(tr("[详情]"));
-        actionItem->setForeground(QColor(0, 123, 255)); // 蓝色
-        actionItem->setTextAlignment(Qt::AlignCenter);
-        ui->tableWidget->setItem(i, 5, actionItem);
+    // 记住当前选中的任务，刷新后恢复
+    int selectedId = selectedTaskId();
 
-        // 存储任务ID
-        nameItem->setData(Qt::UserRole, task.id);
+    if (!m_taskModel->updateEntries(entries, delta.changed)) {
+        // 只有行内容变化，选中状态保留；选中的任务变化时刷新详情
+        if (delta.changed.contains(selectedId)) {
+            onTaskSelected(m_taskModel->rowOfTask(selectedId));
+        }
+        return;
     }
 
-    // 清空详情显示
-    if (ui->tableWidget->rowCount() == 0) {
+    int row = m_taskModel->rowOfTask(selectedId);
+    if (row >= 0) {
+        ui->tableView->setCurrentIndex(m_taskModel->index(row, TaskTableModel::NameColumn));
+    } else {
         clearDetails();
     }
 }
 
+int BackupPage::selectedTaskId() const
+{
+    QModelIndex current = ui->tableView->currentIndex();
+    if (!current.isValid()) {
+        return -1;
+    }
+    return m_taskModel->taskIdAt(current.row());
+}
+
 void BackupPage::onCreateTask()
 {
     Utils::Logger::instance()->log(Utils::Logger::Info, "点击创建任务按钮");
@@ -398,17 +349,13 @@ void BackupPage::onCreateTask()
 
 void BackupPage::onEditTask()
 {
-    // 获取选中的行
-    int currentRow = ui->tableWidget->currentRow();
-    if (currentRow < 0) {
+    // 获取选中的任务ID
+    int taskId = selectedTaskId();
+    if (taskId < 0) {
         QMessageBox::warning(this, tr("警告"), tr("请先选择一个任务"));
         return;
     }
 
-    // 获取任务ID
-    QTableWidgetItem* nameItem = ui->tableWidget->item(currentRow, 0);
-    int taskId = nameItem->data(Qt::UserRole).toInt();
-
     // 获取任务信息
     Data::DatabaseManager* db = Data::DatabaseManager::instance();
     Models::BackupTask task = db->getBackupTask(taskId);
@@ -448,17 +395,13 @@ void BackupPage::onEditTask()
 
 void BackupPage::onToggleTask()
 {
-    // 获取选中的行
-    int currentRow = ui->tableWidget->currentRow();
-    if (currentRow < 0) {
+    // 获取选中的任务ID
+    int taskId = selectedTaskId();
+    if (taskId < 0) {
         QMessageBox::warning(this, tr("警告"), tr("请先选择一个任务"));
         return;
     }
 
-    // 获取任务ID
-    QTableWidgetItem* nameItem = ui->tableWidget->item(currentRow, 0);
-    int taskId = nameItem->data(Qt::UserRole).toInt();
-
     // 获取任务信息
     Data::DatabaseManager* db = Data::DatabaseManager::instance();
     Models::BackupTask task = db->getBackupTask(taskId);
@@ -504,16 +447,16 @@ void BackupPage::onToggleTask()
 void BackupPage::onDeleteTask()
 {
     // 获取选中的行
-    int currentRow = ui->tableWidget->currentRow();
-    if (currentRow < 0) {
+    QModelIndex current = ui->tableView->currentIndex();
+    if (!current.isValid()) {
         QMessageBox::warning(this, tr("警告"), tr("请先选择一个任务"));
         return;
     }
 
     // 获取任务ID和名称
-    QTableWidgetItem* nameItem = ui->tableWidget->item(currentRow, 0);
-    int taskId = nameItem->data(Qt::UserRole).toInt();
-    QString taskName = nameItem->text();
+    const Models::TaskListEntry& entry = m_taskModel->entryAt(current.row());
+    int taskId = entry.id;
+    QString taskName = entry.name;
 
     // 确认删除
     QMessageBox::StandardButton reply = QMessageBox::question(
@@ -540,17 +483,13 @@ void BackupPage::onDeleteTask()
 
 void BackupPage::onRunTask()
 {
-    // 获取选中的行
-    int currentRow = ui->tableWidget->currentRow();
-    if (currentRow < 0) {
+    // 获取选中的任务ID
+    int taskId = selectedTaskId();
+    if (taskId < 0) {
         QMessageBox::warning(this, tr("警告"), tr("请先选择一个任务"));
         return;
     }
 
-    // 获取任务ID
-    QTableWidgetItem* nameItem = ui->tableWidget->item(currentRow, 0);
-    int taskId = nameItem->data(Qt::UserRole).toInt();
-
     // 获取任务信息
     Data::DatabaseManager* db = Data::DatabaseManager::instance();
     Models::BackupTask task = db->getBackupTask(taskId);
@@ -686,43 +625,31 @@ void BackupPage::onTaskSelected(int currentRow, int previousRow)
         return;
     }
 
-    // 获取任务ID
-    QTableWidgetItem* nameItem = ui->tableWidget->item(currentRow, 0);
-    if (!nameItem) {
+    if (currentRow >= m_taskModel->rowCount()) {
         clearDetails();
         return;
     }
 
-    int taskId = nameItem->data(Qt::UserRole).toInt();
+    const Models::TaskListEntry& entry = m_taskModel->entryAt(currentRow);
 
-    // 获取任务信息
+    // 详情面板打开时才按ID加载完整任务
     Data::DatabaseManager* db = Data::DatabaseManager::instance();
-    QList<Models::BackupTask> tasks = db->getAllBackupTasks();
-
-    Models::BackupTask task;
-    bool found = false;
-    for (const auto& t : tasks) {
-        if (t.id == taskId) {
-            task = t;
-            found = true;
-            break;
-        }
-    }
+    Models::BackupTask task = db->getBackupTask(entry.id);
 
-    if (!found) {
+    if (task.id <= 0) {
         clearDetails();
         return;
     }
 
+    int taskId = task.id;
+
     // 填充详情面板
 
     // 任务名称
     ui->detailNameLabel->setText(task.name);
 
-    // 目标仓库
-    Core::RepositoryManager* repoMgr = Core::RepositoryManager::instance();
-    Models::Repository repo = repoMgr->getRepository(task.repositoryId);
-    ui->detailRepoLabel->setText(repo.name);
+    // 目标仓库（列表查询已联表取得名称）
+    ui->detailRepoLabel->setText(entry.repositoryName);
 
     // 备份路径
     QString paths = task.sourcePaths.isEmpty() ? tr("无") : task.sourcePaths.join("\n");
@@ -2,6 +2,7 @@
 #define BACKUPPAGE_H
 
 #include <QWidget>
+#include "../../core/DataStore.h"
 
 namespace Ui {
 class BackupPage;
@@ -11,6 +12,7 @@ namespace ResticGUI {
 
 namespace UI {
 class ProgressDialog; // 前置声明
+class TaskTableModel;
 }
 
 namespace UI {
@@ -35,6 +37,8 @@ private slots:
     void onRefresh();
     void onPasswordError(int taskId, int repoId);
     void onTaskSelected(int currentRow, int previousRow = -1);
+    void onTaskListChanged(const QList<Models::TaskListEntry>& entries,
+                           const Core::DataStore::TaskListDelta& delta);
 
     // 备份进度相关槽函数
     void onBackupStarted(int taskId);
@@ -45,7 +49,13 @@ private slots:
 private:
     void clearDetails();
 
+    /**
+     * @brief 获取当前选中任务的ID，未选中返回 -1
+     */
+    int selectedTaskId() const;
+
     Ui::BackupPage* ui;
+    TaskTableModel* m_taskModel;        // 任务列表模型
     ProgressDialog* m_progressDialog;  // 进度对话框
     int m_currentBackupTaskId;          // 当前执行的备份任务ID
 };
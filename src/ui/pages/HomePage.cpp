@@ -1,14 +1,15 @@
 #include "HomePage.h"
 #include "ui_HomePage.h"
 #include "../../core/RepositoryManager.h"
-#include "../../core/SnapshotManager.h"
+#include "../../core/DataStore.h"
 #include "../../data/DatabaseManager.h"
 #include "../../data/PasswordManager.h"
-#include "../../data/CacheManager.h"
 #include "../wizards/CreateRepoWizard.h"
 #include "../dialogs/CreateTaskDialog.h"
 #include "../../utils/Logger.h"
+#include "../../utils/Tracer.h"
 #include <QMessageBox>
+#include <QTimer>
 
 namespace ResticGUI {
 namespace UI {
@@ -61,13 +62,12 @@ HomePage::HomePage(QWidget* parent)
     connect(ui->createTaskButton, &QPushButton::clicked, this, &HomePage::onCreateTask);
     connect(ui->browseSnapshotsButton, &QPushButton::clicked, this, &HomePage::onRestoreData);
 
-    // 监听快照更新信号
-    Core::SnapshotManager* snapshotMgr = Core::SnapshotManager::instance();
-    connect(snapshotMgr, &Core::SnapshotManager::snapshotsUpdated,
-            this, [this](int) { refreshData(); });
+    // 监听快照更新信号（任何页面触发的刷新有变化时都会发出）
+    connect(Core::DataStore::instance(), &Core::DataStore::snapshotsChanged,
+            this, [this]() { refreshData(); });
 
-    loadDashboardData();
-    loadRecentActivities();
+    // 数据在窗口第一次显示之后再加载，不推迟首次绘制
+    QTimer::singleShot(0, this, &HomePage::refreshData);
 }
 
 HomePage::~HomePage()
@@ -77,6 +77,8 @@ HomePage::~HomePage()
 
 void HomePage::loadDashboardData()
 {
+    TRACE_SCOPE_CAT("HomePage::loadDashboardData", "ui");
+
     // 获取仓库数量
     Core::RepositoryManager* repoMgr = Core::RepositoryManager::instance();
     QList<Models::Repository> repositories = repoMgr->getAllRepositories();
@@ -90,29 +92,24 @@ void HomePage::loadDashboardData()
     // 获取快照数量和总存储量（从缓存读取，不需要密码）
     int snapshotCount = 0;
     qint64 totalStorage = 0;
-    Data::CacheManager* cacheMgr = Data::CacheManager::instance();
+    Core::DataStore* store = Core::DataStore::instance();
     Data::PasswordManager* passMgr = Data::PasswordManager::instance();
 
     for (const auto& repo : repositories) {
         QList<Models::Snapshot> snapshots;
 
-        // 优先从缓存读取
-        if (cacheMgr->getCachedSnapshots(repo.id, snapshots)) {
+        // 只从缓存读取
+        if (store->snapshots(repo.id, snapshots)) {
             snapshotCount += snapshots.size();
             // 累加存储量
             for (const auto& snapshot : snapshots) {
                 totalStorage += snapshot.size;
             }
         }
-        // 如果缓存不存在且有密码，则从 SnapshotManager 获取
+        // 如果缓存不存在且有密码，在后台获取，不在界面线程中等待 restic；
+        // 获取成功后数据存储发出 snapshotsChanged，首页随之刷新
         else if (passMgr->hasPassword(repo.id)) {
-            Core::SnapshotManager* snapshotMgr = Core::SnapshotManager::instance();
-            snapshots = snapshotMgr->listSnapshots(repo.id, false);
-            snapshotCount += snapshots.size();
-            // 累加存储量
-            for (const auto& snapshot : snapshots) {
-                totalStorage += snapshot.size;
-            }
+            store->revalidateSnapshots(repo.id);
         }
     }
 
@@ -139,6 +136,8 @@ void HomePage::loadDashboardData()
 
 void HomePage::loadRecentActivities()
 {
+    TRACE_SCOPE_CAT("HomePage::loadRecentActivities", "ui");
+
     // 清空列表
     ui->recentActivitiesList->clear();
 
@@ -2,14 +2,18 @@
 #include "ui_RepositoryPage.h"
 #include "../../core/RepositoryManager.h"
 #include "../../core/BackupManager.h"
-#include "../../core/SnapshotManager.h"
 #include "../../core/ResticWrapper.h"
+#include "../../core/DataStore.h"
 #include "../../data/PasswordManager.h"
 #include "../../data/CacheManager.h"
 #include "../wizards/CreateRepoWizard.h"
 #include "../dialogs/ProgressDialog.h"
 #include "../dialogs/PruneOptionsDialog.h"
 #include "../dialogs/PasswordDialog.h"
+#include "../dialogs/VerificationPlanDialog.h"
+#include "../models/SnapshotFileModel.h"
+#include "../../data/DatabaseManager.h"
+#include "../../utils/Tracer.h"
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QHeaderView>
@@ -28,6 +32,7 @@ RepositoryPage::RepositoryPage(QWidget* parent)
     , m_repairRepoWatcher(nullptr)
     , m_unlockRepoWatcher(nullptr)
     , m_pruneRepoWatcher(nullptr)
+    , m_prunePlanWatcher(nullptr)
     , m_progressDialog(nullptr)
     , m_progressTimer(nullptr)
     , m_timeoutTimer(nullptr)
@@ -106,6 +111,7 @@ RepositoryPage::RepositoryPage(QWidget* parent)
     ui->connectButton->setStyleSheet(primaryButtonStyle);
     ui->editButton->setStyleSheet(secondaryButtonStyle);
     ui->checkButton->setStyleSheet(secondaryButtonStyle);
+    ui->verifyButton->setStyleSheet(secondaryButtonStyle);
     ui->repairButton->setStyleSheet(warningButtonStyle);
     ui->pruneButton->setStyleSheet(warningButtonStyle);
     ui->deleteButton->setStyleSheet(dangerButtonStyle);
@@ -205,6 +211,7 @@ RepositoryPage::RepositoryPage(QWidget* parent)
     connect(ui->editButton, &QPushButton::clicked, this, &RepositoryPage::onEditRepository);
     connect(ui->deleteButton, &QPushButton::clicked, this, &RepositoryPage::onDeleteRepository);
     connect(ui->checkButton, &QPushButton::clicked, this, &RepositoryPage::onCheckRepository);
+    connect(ui->verifyButton, &QPushButton::clicked, this, &RepositoryPage::onVerificationPlan);
     connect(ui->repairButton, &QPushButton::clicked, this, &RepositoryPage::onRepairRepository);
     connect(ui->pruneButton, &QPushButton::clicked, this, &RepositoryPage::onPruneRepository);
 
@@ -225,6 +232,19 @@ RepositoryPage::RepositoryPage(QWidget* parent)
         }
     });
 
+    // 选中仓库的快照列表在后台刷新后更新详情
+    connect(Core::DataStore::instance(), &Core::DataStore::snapshotsChanged, this,
+            [this](int repoId, const QList<Models::Snapshot>& snapshots,
+                   const Core::DataStore::SnapshotDelta& delta) {
+        Q_UNUSED(snapshots);
+        Q_UNUSED(delta);
+        const int row = ui->tableWidget->currentRow();
+        QTableWidgetItem* nameItem = row >= 0 ? ui->tableWidget->item(row, 1) : nullptr;
+        if (nameItem && nameItem->data(Qt::UserRole).toInt() == repoId) {
+            onRepositorySelected(row);
+        }
+    });
+
     // 创建进度更新定时器
     m_progressTimer = new QTimer(this);
     connect(m_progressTimer, &QTimer::timeout, this, &RepositoryPage::onUpdateProgress);
@@ -278,6 +298,12 @@ RepositoryPage::~RepositoryPage()
             m_pruneRepoWatcher->waitForFinished();
         }
     }
+    if (m_prunePlanWatcher) {
+        m_prunePlanWatcher->cancel();
+        if (m_prunePlanWatcher->isRunning()) {
+            m_prunePlanWatcher->waitForFinished();
+        }
+    }
     // 注意：定时器和 watcher 的 parent 是 this，会自动删除
     // progressDialog 已使用 deleteLater()，不需要在这里删除
     delete ui;
@@ -285,6 +311,8 @@ RepositoryPage::~RepositoryPage()
 
 void RepositoryPage::loadRepositories()
 {
+    TRACE_SCOPE_CAT("RepositoryPage::loadRepositories", "ui");
+
     // 获取所有仓库
     Core::RepositoryManager* repoMgr = Core::RepositoryManager::instance();
     QList<Models::Repository> repositories = repoMgr->getAllRepositories();
@@ -708,6 +736,21 @@ void RepositoryPage::onCheckRepository()
     });
 }
 
+void RepositoryPage::onVerificationPlan()
+{
+    int currentRow = ui->tableWidget->currentRow();
+    if (currentRow < 0) {
+        QMessageBox::warning(this, tr("警告"), tr("请先选择一个仓库"));
+        return;
+    }
+
+    QTableWidgetItem* nameItem = ui->tableWidget->item(currentRow, 1);
+    int repoId = nameItem->data(Qt::UserRole).toInt();
+
+    VerificationPlanDialog dialog(repoId, nameItem->text(), this);
+    dialog.exec();
+}
+
 void RepositoryPage::onRepairRepository()
 {
     // 获取选中的行
@@ -953,27 +996,117 @@ void RepositoryPage::onPruneRepository()
     }
 
     // 获取保留策略
-    int keepLast = optionsDialog.getKeepLast();
-    int keepDaily = optionsDialog.getKeepDaily();
-    int keepWeekly = optionsDialog.getKeepWeekly();
-    int keepMonthly = optionsDialog.getKeepMonthly();
-    int keepYearly = optionsDialog.getKeepYearly();
+    Models::PruneOptions keepPolicy;
+    keepPolicy.keepLast = optionsDialog.getKeepLast();
+    keepPolicy.keepDaily = optionsDialog.getKeepDaily();
+    keepPolicy.keepWeekly = optionsDialog.getKeepWeekly();
+    keepPolicy.keepMonthly = optionsDialog.getKeepMonthly();
+    keepPolicy.keepYearly = optionsDialog.getKeepYearly();
+    Core::PrunePolicy policy = optionsDialog.getPolicy();
 
     // 检查至少设置了一个保留策略
-    if (keepLast == 0 && keepDaily == 0 && keepWeekly == 0 &&
-        keepMonthly == 0 && keepYearly == 0) {
+    if (!keepPolicy.hasKeepPolicy()) {
         QMessageBox::warning(this, tr("警告"),
             tr("请至少设置一个保留策略！"));
         return;
     }
 
+    // 保存当前操作的仓库ID和密码
+    m_currentOperationRepoId = repo.id;
+    m_currentOperationPassword = password;
+
+    // 先试运行估算，确认后再执行
+    if (m_progressDialog) {
+        delete m_progressDialog;
+    }
+    m_progressDialog = new ProgressDialog(this);
+    m_progressDialog->setTitle(tr("估算维护"));
+    m_progressDialog->setMessage(tr("正在试运行估算仓库 \"%1\" 的维护量，请稍候...").arg(repo.name));
+    m_progressDialog->setProgress(0);
+    m_progressDialog->setWindowModality(Qt::ApplicationModal);
+    connect(m_progressDialog, &ProgressDialog::cancelled,
+            this, &RepositoryPage::onProgressCancelled);
+    m_progressDialog->show();
+
+    m_progressValue = 0;
+    m_progressTimer->start(200);
+    m_timeoutTimer->start(600000);
+
+    if (m_prunePlanWatcher) {
+        delete m_prunePlanWatcher;
+    }
+    m_prunePlanWatcher = new QFutureWatcher<Core::PrunePlan>(this);
+    connect(m_prunePlanWatcher, &QFutureWatcher<Core::PrunePlan>::finished,
+            this, &RepositoryPage::onPrunePlanFinished);
+
+    // 复制值避免跨线程问题
+    Models::Repository repoToPrune = repo;
+    QString passwordToUse = password;
+
+    QTimer::singleShot(50, [this, repoToPrune, passwordToUse, keepPolicy, policy]() {
+        QFuture<Core::PrunePlan> future = QtConcurrent::run([repoToPrune, passwordToUse, keepPolicy, policy]() {
+            Core::PrunePlanner planner;
+            return planner.plan(repoToPrune, passwordToUse, keepPolicy, policy);
+        });
+
+        m_prunePlanWatcher->setFuture(future);
+    });
+}
+
+void RepositoryPage::onPrunePlanFinished()
+{
+    m_progressTimer->stop();
+    m_timeoutTimer->stop();
+
+    // 估算期间用户取消了操作
+    if (!m_progressDialog) {
+        return;
+    }
+    m_progressDialog->close();
+    m_progressDialog->deleteLater();
+    m_progressDialog = nullptr;
+
+    const Core::PrunePlan plan = m_prunePlanWatcher->result();
+    Models::Repository repo = Core::RepositoryManager::instance()->getRepository(m_currentOperationRepoId);
+
+    if (!plan.valid) {
+        QMessageBox::critical(this, tr("估算失败"),
+            tr("仓库 \"%1\" 的维护试运行失败！\n\n请查看日志了解详情。").arg(repo.name));
+        return;
+    }
+
+    if (plan.estimate.removedSnapshots == 0 && plan.estimate.reclaimedBytes == 0) {
+        QMessageBox::information(this, tr("无需维护"),
+            tr("按当前保留策略，仓库 \"%1\" 没有需要删除的快照。").arg(repo.name));
+        return;
+    }
+
+    const Models::PruneStats& estimate = plan.estimate;
+    QString details = tr("将删除 %1 个快照\n预计释放空间: %2\n重新打包: %3（下载 %4）\n预计耗时: %5 分钟")
+                          .arg(estimate.removedSnapshots)
+                          .arg(SnapshotFileModel::formatSize(estimate.reclaimedBytes))
+                          .arg(SnapshotFileModel::formatSize(estimate.repackBytes))
+                          .arg(SnapshotFileModel::formatSize(estimate.downloadBytes()))
+                          .arg(qMax<qint64>(1, (plan.estimatedSeconds + 59) / 60));
+    if (plan.estimatedCost > 0) {
+        details += tr("\n预计下载费用: %1").arg(plan.estimatedCost, 0, 'f', 2);
+    }
+    details += tr("\n参数: %1\n%2").arg(Core::PrunePlanner::describeOptions(plan.options)).arg(plan.rationale);
+
+    const QList<Models::PruneRecord> history = Data::DatabaseManager::instance()->getPruneHistory(repo.id, 1);
+    if (!history.isEmpty() && history.first().success) {
+        details += tr("\n\n上次维护: %1，释放 %2")
+                       .arg(history.first().startTime.toString("yyyy-MM-dd HH:mm"))
+                       .arg(SnapshotFileModel::formatSize(history.first().stats.reclaimedBytes));
+    }
+
     // 确认维护
     QMessageBox::StandardButton reply = QMessageBox::question(
         this,
         tr("确认维护"),
         tr("确定要维护仓库 \"%1\" 吗？\n\n"
-           "这将执行 prune 操作，删除不符合保留策略的快照数据。\n"
-           "⚠️ 此操作不可恢复！").arg(repo.name),
+           "%2\n\n"
+           "⚠️ 此操作不可恢复！").arg(repo.name).arg(details),
         QMessageBox::Yes | QMessageBox::No,
         QMessageBox::No
     );
@@ -982,9 +1115,12 @@ void RepositoryPage::onPruneRepository()
         return;
     }
 
-    // 保存当前操作的仓库ID和密码
-    m_currentOperationRepoId = repo.id;
-    m_currentOperationPassword = password;
+    startPrune(plan);
+}
+
+void RepositoryPage::startPrune(const Core::PrunePlan& plan)
+{
+    Models::Repository repo = Core::RepositoryManager::instance()->getRepository(m_currentOperationRepoId);
 
     // 创建进度对话框
     if (m_progressDialog) {
@@ -1003,8 +1139,8 @@ void RepositoryPage::onPruneRepository()
     m_progressValue = 0;
     m_progressTimer->start(200);
 
-    // 启动超时定时器（10分钟超时）
-    m_timeoutTimer->start(600000);
+    // 启动超时定时器（至少10分钟，预计耗时更长时按预计耗时的两倍，最多24小时）
+    m_timeoutTimer->start(static_cast<int>(qBound<qint64>(600000, plan.estimatedSeconds * 2000, 24LL * 3600 * 1000)));
 
     // 在后台线程执行 prune
     if (m_pruneRepoWatcher) {
@@ -1016,15 +1152,12 @@ void RepositoryPage::onPruneRepository()
 
     // 复制值避免跨线程问题
     Models::Repository repoToPrune = repo;
-    QString passwordToUse = password;
+    QString passwordToUse = m_currentOperationPassword;
 
-    QTimer::singleShot(50, [this, repoToPrune, passwordToUse, keepLast, keepDaily,
-                             keepWeekly, keepMonthly, keepYearly]() {
-        QFuture<bool> future = QtConcurrent::run([repoToPrune, passwordToUse, keepLast,
-                                                   keepDaily, keepWeekly, keepMonthly, keepYearly]() {
-            Core::ResticWrapper wrapper;
-            return wrapper.prune(repoToPrune, passwordToUse, keepLast, keepDaily,
-                               keepWeekly, keepMonthly, keepYearly);
+    QTimer::singleShot(50, [this, repoToPrune, passwordToUse, plan]() {
+        QFuture<bool> future = QtConcurrent::run([repoToPrune, passwordToUse, plan]() {
+            Core::PrunePlanner planner;
+            return planner.execute(repoToPrune, passwordToUse, plan);
         });
 
         m_pruneRepoWatcher->setFuture(future);
@@ -1147,9 +1280,12 @@ void RepositoryPage::onPruneRepositoryFinished()
     Models::Repository repo = repoMgr->getRepository(m_currentOperationRepoId);
 
     if (success) {
+        const QList<Models::PruneRecord> history = Data::DatabaseManager::instance()->getPruneHistory(repo.id, 1);
+        const qint64 reclaimed = history.isEmpty() ? 0 : history.first().stats.reclaimedBytes;
         QMessageBox::information(this, tr("维护完成"),
             tr("仓库 \"%1\" 维护完成！\n\n"
-               "已删除不符合保留策略的快照数据，释放了存储空间。").arg(repo.name));
+               "已删除不符合保留策略的快照数据，释放了 %2 存储空间。")
+                .arg(repo.name).arg(SnapshotFileModel::formatSize(reclaimed)));
     } else {
         QMessageBox::critical(this, tr("维护失败"),
             tr("仓库 \"%1\" 维护失败！\n\n请查看日志了解详情。").arg(repo.name));
@@ -1194,23 +1330,16 @@ void RepositoryPage::onRepositorySelected(int currentRow, int previousRow)
         : tr("从未");
     ui->detailLastBackupLabel->setText(lastBackup);
 
-    // 获取快照信息
-    Data::CacheManager* cacheMgr = Data::CacheManager::instance();
+    // 获取快照信息：先显示已缓存的数据，不在界面线程执行 restic
+    Core::DataStore* store = Core::DataStore::instance();
     QList<Models::Snapshot> snapshots;
     int snapshotCount = 0;
     qint64 totalSize = 0;
+    store->snapshots(repo.id, snapshots);
 
-    // 优先从缓存获取
-    bool hasCache = cacheMgr->getCachedSnapshots(repo.id, snapshots);
-
-    // 如果缓存为空，尝试从仓库获取（需要密码）
-    if (!hasCache || snapshots.isEmpty()) {
-        Data::PasswordManager* passMgr = Data::PasswordManager::instance();
-        if (passMgr->hasPassword(repo.id)) {
-            // 有密码，尝试获取快照列表
-            Core::SnapshotManager* snapMgr = Core::SnapshotManager::instance();
-            snapshots = snapMgr->listSnapshots(repo.id, false);
-        }
+    // 有密码时在后台刷新，结果通过 snapshotsChanged 再次更新详情
+    if (Data::PasswordManager::instance()->hasPassword(repo.id)) {
+        store->revalidateSnapshots(repo.id);
     }
 
     // 计算快照数和总大小
@@ -5,6 +5,7 @@
 #include <QFutureWatcher>
 #include <QTimer>
 #include "../../models/Repository.h"
+#include "../../core/PrunePlanner.h"
 
 namespace Ui {
 class RepositoryPage;
@@ -31,6 +32,7 @@ private slots:
     void onEditRepository();
     void onDeleteRepository();
     void onCheckRepository();
+    void onVerificationPlan();
     void onRepairRepository();
     void onUnlockRepository();
     void onPruneRepository();
@@ -38,6 +40,7 @@ private slots:
     void onCheckRepositoryFinished();
     void onRepairRepositoryFinished();
     void onUnlockRepositoryFinished();
+    void onPrunePlanFinished();
     void onPruneRepositoryFinished();
     void onUpdateProgress();
     void onProgressCancelled();
@@ -45,6 +48,7 @@ private slots:
 
 private:
     void clearDetails();
+    void startPrune(const Core::PrunePlan& plan);
 
     Ui::RepositoryPage* ui;
     QFutureWatcher<int>* m_createRepoWatcher;
@@ -52,6 +56,7 @@ private:
     QFutureWatcher<bool>* m_repairRepoWatcher;
     QFutureWatcher<bool>* m_unlockRepoWatcher;
     QFutureWatcher<bool>* m_pruneRepoWatcher;
+    QFutureWatcher<Core::PrunePlan>* m_prunePlanWatcher;
     ProgressDialog* m_progressDialog;
     QTimer* m_progressTimer;
     QTimer* m_timeoutTimer;
@@ -1,19 +1,21 @@
 #include "RestorePage.h"
 #include "ui_RestorePage.h"
 #include "../../core/RepositoryManager.h"
-#include "../../core/SnapshotManager.h"
 #include "../../core/RestoreManager.h"
+#include "../../core/DataStore.h"
 #include "../../data/PasswordManager.h"
 #include "../../utils/Logger.h"
 #include "../../models/RestoreOptions.h"
 #include "../dialogs/ProgressDialog.h"
 #include "../dialogs/PasswordDialog.h"
 #include "../wizards/RestoreWizard.h"
+#include "../models/SnapshotTableModel.h"
+#include "../../utils/Tracer.h"
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QDir>
-#include <QtConcurrent>
+#include <QTimer>
 
 namespace ResticGUI {
 namespace UI {
@@ -21,13 +23,17 @@ namespace UI {
 RestorePage::RestorePage(QWidget* parent)
     : QWidget(parent)
     , ui(new Ui::RestorePage)
+    , m_snapshotModel(new SnapshotTableModel(this))
+    , m_snapshotProxy(new SnapshotFilterProxyModel(this))
     , m_currentRepositoryId(-1)
     , m_firstShow(true)
-    , m_isLoading(false)
-    , m_snapshotWatcher(nullptr)
+    , m_interruptedChecked(false)
 {
     ui->setupUi(this);
 
+    m_snapshotProxy->setSourceModel(m_snapshotModel);
+    ui->snapshotTable->setModel(m_snapshotProxy);
+
     // 应用样式
     QString primaryButtonStyle =
         "QPushButton {"
@@ -114,16 +120,16 @@ RestorePage::RestorePage(QWidget* parent)
         "}";
 
     QString tableStyle =
-        "QTableWidget {"
+        "QTableView {"
         "    border: 1px solid #dee2e6;"
         "    border-radius: 4px;"
         "    background-color: white;"
         "    gridline-color: #dee2e6;"
         "}"
-        "QTableWidget::item {"
+        "QTableView::item {"
         "    padding: 5px;"
         "}"
-        "QTableWidget::item:selected {"
+        "QTableView::item:selected {"
         "    background-color: #007bff;"
         "    color: white;"
         "}";
@@ -183,19 +189,14 @@ RestorePage::RestorePage(QWidget* parent)
     ui->snapshotTable->horizontalHeader()->setStretchLastSection(false);
 
     // 设置列宽和调整模式
-    ui->snapshotTable->setColumnWidth(0, 100);  // 快照ID（显示前8位）
-    ui->snapshotTable->setColumnWidth(1, 160);  // 创建时间
-    ui->snapshotTable->setColumnWidth(2, 100);  // 主机名
-    ui->snapshotTable->setColumnWidth(4, 100);  // 大小
-    ui->snapshotTable->setColumnWidth(5, 120);  // 标签
+    ui->snapshotTable->setColumnWidth(SnapshotTableModel::IdColumn, 100);    // 快照ID（显示前8位）
+    ui->snapshotTable->setColumnWidth(SnapshotTableModel::TimeColumn, 160);  // 创建时间
+    ui->snapshotTable->setColumnWidth(SnapshotTableModel::HostColumn, 100);  // 主机名
+    ui->snapshotTable->setColumnWidth(SnapshotTableModel::SizeColumn, 100);  // 大小
+    ui->snapshotTable->setColumnWidth(SnapshotTableModel::TagsColumn, 120);  // 标签
 
     // 路径列使用拉伸模式，占据剩余空间
-    ui->snapshotTable->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Stretch);
-
-    // 初始化异步加载器
-    m_snapshotWatcher = new QFutureWatcher<QList<Models::Snapshot>>(this);
-    connect(m_snapshotWatcher, &QFutureWatcher<QList<Models::Snapshot>>::finished,
-            this, &RestorePage::onSnapshotsLoaded);
+    ui->snapshotTable->horizontalHeader()->setSectionResizeMode(SnapshotTableModel::PathsColumn, QHeaderView::Stretch);
 
     // 先加载仓库列表（此时不连接信号，避免触发密码输入）
     loadRepositories();
@@ -211,15 +212,17 @@ RestorePage::RestorePage(QWidget* parent)
     connect(ui->restoreButton, &QPushButton::clicked, this, &RestorePage::onRestore);
     connect(ui->includeCheckBox, &QCheckBox::toggled, this, &RestorePage::onIncludeCheckBoxToggled);
     connect(ui->targetPathEdit, &QLineEdit::textChanged, this, &RestorePage::onTargetPathChanged);
-    connect(ui->snapshotTable, &QTableWidget::currentCellChanged,
-            this, [this](int currentRow, int, int previousRow, int) {
-        onSnapshotSelected(currentRow, previousRow);
+    connect(ui->snapshotTable->selectionModel(), &QItemSelectionModel::currentRowChanged,
+            this, [this](const QModelIndex& current, const QModelIndex& previous) {
+        onSnapshotSelected(current.isValid() ? current.row() : -1,
+                           previous.isValid() ? previous.row() : -1);
     });
 
-    // 监听快照更新信号
-    Core::SnapshotManager* snapshotMgr = Core::SnapshotManager::instance();
-    connect(snapshotMgr, &Core::SnapshotManager::snapshotsUpdated,
-            this, &RestorePage::onSnapshotsUpdated);
+    // 监听快照更新（包括其他页面和备份完成后触发的刷新）
+    connect(Core::DataStore::instance(), &Core::DataStore::snapshotsChanged,
+            this, &RestorePage::onSnapshotsChanged);
+    connect(Core::DataStore::instance(), &Core::DataStore::snapshotsRefreshFinished,
+            this, &RestorePage::onSnapshotsRefreshFinished);
 }
 
 RestorePage::~RestorePage()
@@ -236,10 +239,90 @@ void RestorePage::showEvent(QShowEvent* event)
         m_firstShow = false;
         loadSnapshots();
     }
+
+    // 每次运行只提示一次被中断的恢复，等页面显示后再弹出
+    if (!m_interruptedChecked) {
+        m_interruptedChecked = true;
+        QTimer::singleShot(0, this, &RestorePage::checkInterruptedRestores);
+    }
+}
+
+void RestorePage::checkInterruptedRestores()
+{
+    Core::RestoreManager* restoreMgr = Core::RestoreManager::instance();
+
+    // 只提示最近一次被中断的恢复
+    for (const Models::RestoreJournalEntry& entry : restoreMgr->getRestoreJournal()) {
+        if (entry.status != Models::RestoreStatus::Interrupted) {
+            continue;
+        }
+
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this,
+            tr("继续恢复"),
+            tr("上次的恢复未完成就被中断：\n\n"
+               "快照ID: %1\n"
+               "恢复到: %2\n"
+               "开始时间: %3\n\n"
+               "是否继续？目标中已恢复完整的文件将被跳过。")
+                .arg(entry.snapshotId.left(8))
+                .arg(entry.options.targetPath)
+                .arg(entry.startTime.toString("yyyy-MM-dd HH:mm:ss")),
+            QMessageBox::Yes | QMessageBox::No,
+            QMessageBox::Yes
+        );
+
+        if (reply == QMessageBox::Yes) {
+            resumeRestore(entry);
+        }
+        break;
+    }
+}
+
+void RestorePage::resumeRestore(const Models::RestoreJournalEntry& entry)
+{
+    Core::RestoreManager* restoreMgr = Core::RestoreManager::instance();
+
+    ProgressDialog* progressDialog = new ProgressDialog(this);
+    progressDialog->setTitle(tr("继续恢复"));
+    progressDialog->setMessage(tr("正在恢复数据..."));
+    progressDialog->setProgress(0);
+
+    connect(restoreMgr, &Core::RestoreManager::restoreProgress,
+            progressDialog, [progressDialog](int percent, const QString& message) {
+        progressDialog->setProgress(percent);
+        progressDialog->setMessage(message);
+        progressDialog->appendLog(message);
+    });
+
+    const QString targetPath = entry.options.targetPath;
+    connect(restoreMgr, &Core::RestoreManager::restoreFinished,
+            progressDialog, [this, progressDialog, targetPath](bool success) {
+        progressDialog->close();
+        progressDialog->deleteLater();
+
+        if (success) {
+            QMessageBox::information(this, tr("成功"),
+                tr("恢复已完成！\n\n目标路径：%1").arg(targetPath));
+        } else {
+            QMessageBox::critical(this, tr("失败"),
+                tr("继续恢复失败，请查看日志了解详情"));
+        }
+    });
+
+    if (restoreMgr->resumeRestore(entry.id)) {
+        progressDialog->show();
+    } else {
+        progressDialog->deleteLater();
+        QMessageBox::critical(this, tr("失败"),
+            tr("继续恢复失败，请查看日志了解详情"));
+    }
 }
 
 void RestorePage::loadRepositories()
 {
+    TRACE_SCOPE_CAT("RestorePage::loadRepositories", "ui");
+
     // 使用 QSignalBlocker 临时阻塞信号，避免在填充列表时触发 currentIndexChanged
     QSignalBlocker blocker(ui->repositoryComboBox);
 
@@ -282,24 +365,15 @@ void RestorePage::loadRepositories()
 void RestorePage::onRepositoryChanged(int index)
 {
     m_currentRepositoryId = ui->repositoryComboBox->itemData(index).toInt();
-
-    // 切换仓库时，重置加载状态以允许加载新仓库的快照
-    m_isLoading = false;
-
     loadSnapshots();
 }
 
-void RestorePage::loadSnapshots()
+void RestorePage::loadSnapshots(bool force)
 {
-    if (m_currentRepositoryId <= 0) {
-        ui->snapshotTable->setRowCount(0);
-        return;
-    }
+    TRACE_SCOPE_CAT("RestorePage::loadSnapshots", "ui");
 
-    // 防止重复加载
-    if (m_isLoading) {
-        Utils::Logger::instance()->log(Utils::Logger::Debug,
-            "快照正在加载中，忽略重复请求");
+    if (m_currentRepositoryId <= 0) {
+        m_snapshotModel->clear();
         return;
     }
 
@@ -315,7 +389,7 @@ void RestorePage::loadSnapshots()
             tr("请输入仓库 \"%1\" 的密码：").arg(repo.name), &ok);
 
         if (!ok || password.isEmpty()) {
-            ui->snapshotTable->setRowCount(0);
+            m_snapshotModel->clear();
             return;
         }
 
@@ -323,29 +397,18 @@ void RestorePage::loadSnapshots()
         passMgr->setPassword(m_currentRepositoryId, password);
     }
 
-    // 如果已经有任务在运行，取消它
-    if (m_snapshotWatcher->isRunning()) {
-        Utils::Logger::instance()->log(Utils::Logger::Debug, "取消之前的快照加载任务");
-        m_snapshotWatcher->cancel();
-        m_snapshotWatcher->waitForFinished();
+    // 有缓存时先显示缓存的快照列表，没有缓存才显示加载提示
+    Core::DataStore* store = Core::DataStore::instance();
+    QList<Models::Snapshot> cachedSnapshots;
+    if (store->snapshots(m_currentRepositoryId, cachedSnapshots)) {
+        displaySnapshots(cachedSnapshots);
+        ui->refreshButton->setEnabled(false);
+    } else {
+        showLoadingIndicator(true);
     }
 
-    // 设置加载状态
-    m_isLoading = true;
-
-    // 显示加载提示
-    showLoadingIndicator(true);
-
-    // 在后台线程异步加载快照列表
-    int repoId = m_currentRepositoryId;
-    QFuture<QList<Models::Snapshot>> future = QtConcurrent::run([repoId]() {
-        Utils::Logger::instance()->log(Utils::Logger::Debug,
-            QString("开始异步加载快照，仓库ID: %1").arg(repoId));
-        Core::SnapshotManager* snapshotMgr = Core::SnapshotManager::instance();
-        return snapshotMgr->listSnapshots(repoId, true);
-    });
-
-    m_snapshotWatcher->setFuture(future);
+    // 最近刷新过则直接用缓存，只有刷新按钮才强制刷新
+    store->revalidateSnapshots(m_currentRepositoryId, force);
 }
 
 void RestorePage::onBrowse()
@@ -362,17 +425,9 @@ void RestorePage::onBrowse()
     }
 }
 
-void RestorePage::onSnapshotsUpdated(int repoId)
-{
-    // 如果更新的是当前选中的仓库，刷新快照列表
-    if (repoId == m_currentRepositoryId) {
-        loadSnapshots();
-    }
-}
-
 void RestorePage::onRefresh()
 {
-    loadSnapshots();
+    loadSnapshots(true);
 }
 
 void RestorePage::onIncludeCheckBoxToggled(bool checked)
@@ -434,8 +489,9 @@ void RestorePage::onRestore()
         progressDialog->appendLog(message);
     });
 
+    // 以进度对话框为上下文，对话框删除后连接自动断开，不会累积到下一次恢复
     connect(restoreMgr, &Core::RestoreManager::restoreFinished,
-            this, [this, progressDialog, snapshotId, options](bool success) {
+            progressDialog, [this, progressDialog, snapshotId, options](bool success) {
         progressDialog->close();
         progressDialog->deleteLater();
 
@@ -474,103 +530,53 @@ void RestorePage::onRestore()
     }
 }
 
-void RestorePage::onSnapshotsLoaded()
+void RestorePage::onSnapshotsChanged(int repoId, const QList<Models::Snapshot>& snapshots,
+                                     const Core::DataStore::SnapshotDelta& delta)
 {
-    // 重置加载状态
-    m_isLoading = false;
-
-    // 隐藏加载提示
-    showLoadingIndicator(false);
-
-    // 获取异步加载的结果
-    QList<Models::Snapshot> snapshots = m_snapshotWatcher->result();
+    if (repoId != m_currentRepositoryId) {
+        return;
+    }
 
     Utils::Logger::instance()->log(Utils::Logger::Info,
         QString("已加载 %1 个快照").arg(snapshots.size()));
 
-    // 保存所有快照用于筛选
-    m_allSnapshots = snapshots;
-
-    // 应用当前筛选条件
-    QString filterText = ui->filterEdit->text().trimmed();
-    if (!filterText.isEmpty()) {
-        filterSnapshots(filterText);
-    } else {
-        // 显示快照列表
-        displaySnapshots(snapshots);
+    // 已有列表时只增删变化的行，代理保留当前筛选条件，选中的快照不丢失
+    if (m_snapshotModel->snapshotCount() > 0
+        && m_snapshotModel->applyDelta(delta.added, delta.removedIds, true)) {
+        updateQuickRestoreButtonState();
+        return;
     }
+
+    displaySnapshots(snapshots);
 }
 
-void RestorePage::displaySnapshots(const QList<Models::Snapshot>& snapshots)
+void RestorePage::onSnapshotsRefreshFinished(int repoId, bool success, const QString& error)
 {
-    ui->snapshotTable->setRowCount(0);
-
-    if (snapshots.isEmpty()) {
+    if (repoId != m_currentRepositoryId) {
         return;
     }
 
-    // 填充快照表格（按时间倒序，最新的在前面）
-    ui->snapshotTable->setRowCount(snapshots.size());
-
-    for (int i = 0; i < snapshots.size(); ++i) {
-        const Models::Snapshot& snapshot = snapshots[snapshots.size() - 1 - i];
-
-        // 快照ID（显示前8位）
-        QString displayId = snapshot.id.left(8);
-        QTableWidgetItem* idItem = new QTableWidgetItem(displayId);
-        idItem->setData(Qt::UserRole, snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId);  // 存储完整ID
-        ui->snapshotTable->setItem(i, 0, idItem);
-
-        // 创建时间
-        QTableWidgetItem* timeItem = new QTableWidgetItem(snapshot.time.toString("yyyy-MM-dd HH:mm:ss"));
-        ui->snapshotTable->setItem(i, 1, timeItem);
-
-        // 主机名
-        QTableWidgetItem* hostnameItem = new QTableWidgetItem(snapshot.hostname);
-        ui->snapshotTable->setItem(i, 2, hostnameItem);
-
-        // 路径（显示第一个路径，如果有多个显示省略号）
-        QString pathsText = snapshot.paths.isEmpty() ? tr("(无路径)") : snapshot.paths.first();
-        if (snapshot.paths.size() > 1) {
-            pathsText += QString(" (+%1)").arg(snapshot.paths.size() - 1);
-        }
-        QTableWidgetItem* pathsItem = new QTableWidgetItem(pathsText);
-        pathsItem->setToolTip(snapshot.paths.join("\n"));
-        ui->snapshotTable->setItem(i, 3, pathsItem);
-
-        // 大小（格式化显示）
-        QString sizeText;
-        qint64 size = snapshot.size;
-
-        if (size >= 1024LL * 1024 * 1024 * 1024) {
-            sizeText = QString::number(size / (1024.0 * 1024.0 * 1024.0 * 1024.0), 'f', 2) + " TB";
-        } else if (size >= 1024LL * 1024 * 1024) {
-            sizeText = QString::number(size / (1024.0 * 1024.0 * 1024.0), 'f', 2) + " GB";
-        } else if (size >= 1024LL * 1024) {
-            sizeText = QString::number(size / (1024.0 * 1024.0), 'f', 2) + " MB";
-        } else if (size >= 1024) {
-            sizeText = QString::number(size / 1024.0, 'f', 2) + " KB";
-        } else if (size > 0) {
-            sizeText = QString::number(size) + " B";
-        } else {
-            sizeText = "-";
-        }
-
-        QTableWidgetItem* sizeItem = new QTableWidgetItem(sizeText);
-        sizeItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        ui->snapshotTable->setItem(i, 4, sizeItem);
+    // 隐藏加载提示
+    showLoadingIndicator(false);
 
-        // 标签
-        QTableWidgetItem* tagsItem = new QTableWidgetItem(snapshot.tags.join(", "));
-        ui->snapshotTable->setItem(i, 5, tagsItem);
+    if (!success) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("加载快照列表失败: %1").arg(error));
     }
 }
 
+void RestorePage::displaySnapshots(const QList<Models::Snapshot>& snapshots)
+{
+    // 按时间倒序，最新的在前面
+    m_snapshotModel->setSnapshots(snapshots, true);
+    updateQuickRestoreButtonState();
+}
+
 void RestorePage::showLoadingIndicator(bool show)
 {
     if (show) {
         // 显示加载状态
-        ui->snapshotTable->setRowCount(0);
+        m_snapshotModel->clear();
         ui->snapshotTable->setEnabled(false);
         ui->restoreButton->setEnabled(false);
         ui->quickRestoreButton->setEnabled(false);
@@ -592,7 +598,7 @@ void RestorePage::onTargetPathChanged()
 void RestorePage::updateQuickRestoreButtonState()
 {
     // 只有在选中快照且填写了恢复目录时才启用快速恢复按钮
-    bool hasSnapshot = ui->snapshotTable->currentRow() >= 0;
+    bool hasSnapshot = ui->snapshotTable->currentIndex().isValid();
     bool hasTargetPath = !ui->targetPathEdit->text().isEmpty();
 
     ui->quickRestoreButton->setEnabled(hasSnapshot && hasTargetPath);
@@ -613,80 +619,31 @@ void RestorePage::onFilterTextChanged(const QString& text)
 
 void RestorePage::filterSnapshots(const QString& filterText)
 {
-    if (filterText.isEmpty()) {
-        // 如果筛选文本为空，显示所有快照
-        displaySnapshots(m_allSnapshots);
-        return;
-    }
-
-    // 筛选快照
-    QList<Models::Snapshot> filteredSnapshots;
-    QString lowerFilter = filterText.toLower();
-
-    for (const Models::Snapshot& snapshot : m_allSnapshots) {
-        // 在多个字段中搜索
-        bool matches = false;
-
-        // 搜索快照ID
-        if (snapshot.id.toLower().contains(lowerFilter)) {
-            matches = true;
-        }
-
-        // 搜索主机名
-        if (!matches && snapshot.hostname.toLower().contains(lowerFilter)) {
-            matches = true;
-        }
-
-        // 搜索路径
-        if (!matches) {
-            for (const QString& path : snapshot.paths) {
-                if (path.toLower().contains(lowerFilter)) {
-                    matches = true;
-                    break;
-                }
-            }
-        }
-
-        // 搜索标签
-        if (!matches) {
-            for (const QString& tag : snapshot.tags) {
-                if (tag.toLower().contains(lowerFilter)) {
-                    matches = true;
-                    break;
-                }
-            }
-        }
-
-        if (matches) {
-            filteredSnapshots.append(snapshot);
-        }
-    }
-
-    // 显示筛选后的快照
-    displaySnapshots(filteredSnapshots);
+    // 由代理模型筛选，不重建表格
+    m_snapshotProxy->setFilterText(filterText);
+    updateQuickRestoreButtonState();
 
     Utils::Logger::instance()->log(Utils::Logger::Debug,
         QString("筛选结果: %1 / %2 个快照")
-            .arg(filteredSnapshots.size())
-            .arg(m_allSnapshots.size()));
+            .arg(m_snapshotProxy->rowCount())
+            .arg(m_snapshotModel->snapshotCount()));
 }
 
 void RestorePage::onQuickRestore()
 {
     // 获取选中的快照
-    int currentRow = ui->snapshotTable->currentRow();
-    if (currentRow < 0) {
+    QModelIndex current = ui->snapshotTable->currentIndex();
+    if (!current.isValid()) {
         QMessageBox::warning(this, tr("警告"), tr("请先选择要恢复的快照"));
         return;
     }
 
-    // 获取快照ID
-    QTableWidgetItem* idItem = ui->snapshotTable->item(currentRow, 0);
-    if (!idItem) {
+    Models::Snapshot snapshot;
+    if (!m_snapshotProxy->snapshotForIndex(current, snapshot)) {
         QMessageBox::warning(this, tr("警告"), tr("无法获取快照信息"));
         return;
     }
-    QString snapshotId = idItem->data(Qt::UserRole).toString();
+    QString snapshotId = snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId;
 
     // 获取恢复目标路径
     QString targetPath = ui->targetPathEdit->text().trimmed();
@@ -703,8 +660,8 @@ void RestorePage::onQuickRestore()
     }
 
     // 获取快照时间（用于显示）
-    QTableWidgetItem* timeItem = ui->snapshotTable->item(currentRow, 1);
-    QString snapshotTime = timeItem ? timeItem->text() : tr("未知");
+    QString snapshotTime = snapshot.time.isValid() ?
+        snapshot.time.toString("yyyy-MM-dd HH:mm:ss") : tr("未知");
 
     // 构建确认消息
     QString confirmMessage = tr("确认执行快速恢复？\n\n"
@@ -739,7 +696,7 @@ void RestorePage::onQuickRestore()
     Models::RestoreOptions options;
     options.targetPath = targetPath;
     options.verify = false;  // 快速恢复默认不验证数据
-    options.overwritePolicy = Models::RestoreOptions::Always;  // 允许覆盖现有文件
+    options.overwritePolicy = Models::RestoreOptions::IfChanged;  // 覆盖有变化的文件，跳过未变化的
 
     // 如果勾选了包含特定文件/目录
     if (ui->includeCheckBox->isChecked() && !ui->includeEdit->text().isEmpty()) {
@@ -770,7 +727,7 @@ void RestorePage::onQuickRestore()
     });
 
     connect(restoreMgr, &Core::RestoreManager::restoreFinished,
-            this, [this, progressDialog, snapshotId, targetPath](bool success) {
+            progressDialog, [this, progressDialog, snapshotId, targetPath](bool success) {
         progressDialog->close();
         progressDialog->deleteLater();
 
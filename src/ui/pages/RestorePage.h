@@ -2,8 +2,9 @@
 #define RESTOREPAGE_H
 
 #include <QWidget>
-#include <QFutureWatcher>
 #include "../../models/Snapshot.h"
+#include "../../models/RestoreJournal.h"
+#include "../../core/DataStore.h"
 
 namespace Ui {
 class RestorePage;
@@ -12,6 +13,9 @@ class RestorePage;
 namespace ResticGUI {
 namespace UI {
 
+class SnapshotTableModel;
+class SnapshotFilterProxyModel;
+
 class RestorePage : public QWidget
 {
     Q_OBJECT
@@ -28,13 +32,14 @@ protected:
 
 private slots:
     void onRepositoryChanged(int index);
-    void loadSnapshots();
+    void loadSnapshots(bool force = false);
     void onRefresh();
     void onBrowse();
     void onRestore();
     void onQuickRestore();
-    void onSnapshotsUpdated(int repoId);
-    void onSnapshotsLoaded();
+    void onSnapshotsChanged(int repoId, const QList<Models::Snapshot>& snapshots,
+                            const Core::DataStore::SnapshotDelta& delta);
+    void onSnapshotsRefreshFinished(int repoId, bool success, const QString& error);
     void onSnapshotSelected(int currentRow, int previousRow = -1);
     void onIncludeCheckBoxToggled(bool checked);
     void onTargetPathChanged();
@@ -46,13 +51,15 @@ private:
     void showLoadingIndicator(bool show);
     void updateQuickRestoreButtonState();
     void filterSnapshots(const QString& filterText);
+    void checkInterruptedRestores();
+    void resumeRestore(const Models::RestoreJournalEntry& entry);
 
     Ui::RestorePage* ui;
+    SnapshotTableModel* m_snapshotModel;
+    SnapshotFilterProxyModel* m_snapshotProxy;
     int m_currentRepositoryId;
     bool m_firstShow;
-    bool m_isLoading;
-    QFutureWatcher<QList<Models::Snapshot>>* m_snapshotWatcher;
-    QList<Models::Snapshot> m_allSnapshots;  // 保存所有快照，用于筛选
+    bool m_interruptedChecked;
 };
 
 } // namespace UI
@@ -2,14 +2,21 @@
 #include "ui_SnapshotPage.h"
 #include "../../core/RepositoryManager.h"
 #include "../../core/SnapshotManager.h"
+#include "../../core/MountManager.h"
 #include "../../data/PasswordManager.h"
+#include "../../core/DataStore.h"
 #include "../../utils/Logger.h"
 #include "../dialogs/SnapshotBrowserDialog.h"
 #include "../dialogs/PasswordDialog.h"
+#include "../models/SnapshotTableModel.h"
+#include "../../utils/Tracer.h"
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QHeaderView>
-#include <QtConcurrent>
+#include <QFileDialog>
+#include <QDesktopServices>
+#include <QUrl>
+#include <QDir>
 
 namespace ResticGUI {
 namespace UI {
@@ -17,13 +24,16 @@ namespace UI {
 SnapshotPage::SnapshotPage(QWidget* parent)
     : QWidget(parent)
     , ui(new Ui::SnapshotPage)
+    , m_snapshotModel(new SnapshotTableModel(this))
+    , m_snapshotProxy(new SnapshotFilterProxyModel(this))
     , m_currentRepositoryId(-1)
     , m_firstShow(true)
-    , m_isLoading(false)
-    , m_snapshotWatcher(nullptr)
 {
     ui->setupUi(this);
 
+    m_snapshotProxy->setSourceModel(m_snapshotModel);
+    ui->tableView->setModel(m_snapshotProxy);
+
     // ========== 美化界面样式 ==========
 
     // 设置按钮样式
@@ -76,6 +86,11 @@ SnapshotPage::SnapshotPage(QWidget* parent)
     // 应用按钮样式
     ui->deleteButton->setStyleSheet(dangerButtonStyle);
     ui->browseButton->setStyleSheet(secondaryButtonStyle);
+    ui->mountButton->setStyleSheet(secondaryButtonStyle);
+#ifdef Q_OS_WIN
+    // restic mount 依赖 FUSE，Windows 不支持
+    ui->mountButton->setVisible(false);
+#endif
     ui->restoreButton->setStyleSheet(primaryButtonStyle);
     ui->refreshButton->setStyleSheet(secondaryButtonStyle);
     ui->searchButton->setStyleSheet(secondaryButtonStyle);
@@ -119,17 +134,17 @@ SnapshotPage::SnapshotPage(QWidget* parent)
     ui->filterEdit->setStyleSheet(lineEditStyle);
 
     // 美化表格
-    QString tableStyle = "QTableWidget { "
+    QString tableStyle = "QTableView { "
                          "background-color: white; "
                          "border: 1px solid #dee2e6; "
                          "border-radius: 6px; "
                          "gridline-color: #dee2e6; "
                          "} "
-                         "QTableWidget::item { "
+                         "QTableView::item { "
                          "padding: 8px; "
                          "border-bottom: 1px solid #f0f0f0; "
                          "} "
-                         "QTableWidget::item:selected { "
+                         "QTableView::item:selected { "
                          "background-color: #e7f3ff; "
                          "color: #212529; "
                          "} "
@@ -149,7 +164,7 @@ SnapshotPage::SnapshotPage(QWidget* parent)
                          "border-top-right-radius: 6px; "
                          "border-right: none; "
                          "}";
-    ui->tableWidget->setStyleSheet(tableStyle);
+    ui->tableView->setStyleSheet(tableStyle);
 
     // 美化详情面板
     QString groupBoxStyle = "QGroupBox { "
@@ -200,21 +215,22 @@ SnapshotPage::SnapshotPage(QWidget* parent)
     ui->detailSizeLabel->setStyleSheet(labelStyle);
 
     // 设置表格列宽
-    ui->tableWidget->setColumnWidth(0, 100);  // 快照ID
-    ui->tableWidget->setColumnWidth(1, 150);  // 时间
-    ui->tableWidget->setColumnWidth(2, 80);   // 主机名
-    ui->tableWidget->setColumnWidth(3, 200);  // 路径
-    ui->tableWidget->setColumnWidth(4, 100);  // 大小
-    ui->tableWidget->setColumnWidth(5, 120);  // 标签
+    ui->tableView->setColumnWidth(SnapshotTableModel::IdColumn, 100);
+    ui->tableView->setColumnWidth(SnapshotTableModel::TimeColumn, 150);
+    ui->tableView->setColumnWidth(SnapshotTableModel::HostColumn, 80);
+    ui->tableView->setColumnWidth(SnapshotTableModel::PathsColumn, 200);
+    ui->tableView->setColumnWidth(SnapshotTableModel::SizeColumn, 100);
+    ui->tableView->setColumnWidth(SnapshotTableModel::TagsColumn, 120);
 
     // 让路径列可以拉伸填充剩余空间
-    ui->tableWidget->horizontalHeader()->setStretchLastSection(false);
-    ui->tableWidget->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Stretch);
+    ui->tableView->horizontalHeader()->setStretchLastSection(false);
+    ui->tableView->horizontalHeader()->setSectionResizeMode(SnapshotTableModel::PathsColumn, QHeaderView::Stretch);
 
-    // 初始化异步加载器
-    m_snapshotWatcher = new QFutureWatcher<QList<Models::Snapshot>>(this);
-    connect(m_snapshotWatcher, &QFutureWatcher<QList<Models::Snapshot>>::finished,
-            this, &SnapshotPage::onSnapshotsLoaded);
+    // 快照列表由共享的数据存储在后台刷新，其他页面触发的刷新结果同样在这里显示
+    connect(Core::DataStore::instance(), &Core::DataStore::snapshotsChanged,
+            this, &SnapshotPage::onSnapshotsChanged);
+    connect(Core::DataStore::instance(), &Core::DataStore::snapshotsRefreshFinished,
+            this, &SnapshotPage::onSnapshotsRefreshFinished);
 
     // 先加载仓库列表（此时不连接信号，避免触发密码输入）
     loadRepositories();
@@ -224,16 +240,21 @@ SnapshotPage::SnapshotPage(QWidget* parent)
             this, &SnapshotPage::onRepositoryChanged);
     connect(ui->deleteButton, &QPushButton::clicked, this, &SnapshotPage::onDeleteSnapshot);
     connect(ui->browseButton, &QPushButton::clicked, this, &SnapshotPage::onBrowseSnapshot);
+    connect(ui->mountButton, &QPushButton::clicked, this, &SnapshotPage::onMountSnapshot);
+    connect(Core::MountManager::instance(), &Core::MountManager::mountReady,
+            this, &SnapshotPage::onMountReady);
+    connect(Core::MountManager::instance(), &Core::MountManager::mountFailed,
+            this, &SnapshotPage::onMountFailed);
     connect(ui->restoreButton, &QPushButton::clicked, this, &SnapshotPage::onRestoreSnapshot);
     connect(ui->refreshButton, &QPushButton::clicked, this, &SnapshotPage::onRefresh);
     connect(ui->searchButton, &QPushButton::clicked, this, &SnapshotPage::onSearch);
+    connect(ui->filterEdit, &QLineEdit::returnPressed, this, &SnapshotPage::onSearch);
 
     // 连接表格选中信号
-    connect(ui->tableWidget, &QTableWidget::currentCellChanged,
-        [this](int currentRow, int currentColumn, int previousRow, int previousColumn) {
-            Q_UNUSED(currentColumn);
-            Q_UNUSED(previousColumn);
-            onSnapshotSelected(currentRow, previousRow);
+    connect(ui->tableView->selectionModel(), &QItemSelectionModel::currentRowChanged,
+        this, [this](const QModelIndex& current, const QModelIndex& previous) {
+            onSnapshotSelected(current.isValid() ? current.row() : -1,
+                               previous.isValid() ? previous.row() : -1);
         });
 }
 
@@ -255,6 +276,8 @@ void SnapshotPage::showEvent(QShowEvent* event)
 
 void SnapshotPage::loadRepositories()
 {
+    TRACE_SCOPE_CAT("SnapshotPage::loadRepositories", "ui");
+
     // 使用 QSignalBlocker 临时阻塞信号，避免在填充列表时触发 currentIndexChanged
     QSignalBlocker blocker(ui->repositoryComboBox);
 
@@ -294,17 +317,12 @@ void SnapshotPage::loadRepositories()
     blocker.unblock();
 }
 
-void SnapshotPage::loadSnapshots()
+void SnapshotPage::loadSnapshots(bool force)
 {
-    if (m_currentRepositoryId <= 0) {
-        ui->tableWidget->setRowCount(0);
-        return;
-    }
+    TRACE_SCOPE_CAT("SnapshotPage::loadSnapshots", "ui");
 
-    // 防止重复加载
-    if (m_isLoading) {
-        Utils::Logger::instance()->log(Utils::Logger::Debug,
-            "快照正在加载中，忽略重复请求");
+    if (m_currentRepositoryId <= 0) {
+        m_snapshotModel->clear();
         return;
     }
 
@@ -327,62 +345,41 @@ void SnapshotPage::loadSnapshots()
         passMgr->setPassword(m_currentRepositoryId, password);
     }
 
-    // 如果已经有任务在运行，取消它
-    if (m_snapshotWatcher->isRunning()) {
-        Utils::Logger::instance()->log(Utils::Logger::Debug, "取消之前的快照加载任务");
-        m_snapshotWatcher->cancel();
-        m_snapshotWatcher->waitForFinished();
+    // 有缓存时先显示缓存的快照列表，后台刷新完成后按差异更新；没有缓存才显示加载提示
+    Core::DataStore* store = Core::DataStore::instance();
+    QList<Models::Snapshot> cachedSnapshots;
+    if (store->snapshots(m_currentRepositoryId, cachedSnapshots)) {
+        displaySnapshots(cachedSnapshots);
+        ui->refreshButton->setEnabled(false);
+    } else {
+        showLoadingIndicator(true);
     }
 
-    // 设置加载状态
-    m_isLoading = true;
-
-    // 显示加载提示
-    showLoadingIndicator(true);
-
-    // 在后台线程异步加载快照列表
-    int repoId = m_currentRepositoryId;
-    QFuture<QList<Models::Snapshot>> future = QtConcurrent::run([repoId]() {
-        Utils::Logger::instance()->log(Utils::Logger::Debug,
-            QString("开始异步加载快照，仓库ID: %1").arg(repoId));
-        Core::SnapshotManager* snapshotMgr = Core::SnapshotManager::instance();
-        return snapshotMgr->listSnapshots(repoId, true);
-    });
-
-    m_snapshotWatcher->setFuture(future);
+    // 切换页面时最近刷新过则直接用缓存，只有刷新按钮和删除后才强制刷新；
+    // 其他页面正在刷新同一仓库时合并到那一次 restic 调用
+    store->revalidateSnapshots(m_currentRepositoryId, force);
 }
 
 void SnapshotPage::onRepositoryChanged(int index)
 {
     m_currentRepositoryId = ui->repositoryComboBox->itemData(index).toInt();
-
-    // 切换仓库时，重置加载状态以允许加载新仓库的快照
-    m_isLoading = false;
-
     loadSnapshots();
 }
 
 void SnapshotPage::onDeleteSnapshot()
 {
-    // 获取所有选中的行
-    QList<QTableWidgetItem*> selectedItems = ui->tableWidget->selectedItems();
-    if (selectedItems.isEmpty()) {
+    // 获取所有选中的行（按行选择，每行只返回一个索引）
+    QModelIndexList selectedRows = ui->tableView->selectionModel()->selectedRows();
+    if (selectedRows.isEmpty()) {
         QMessageBox::warning(this, tr("警告"), tr("请先选择要删除的快照"));
         return;
     }
 
-    // 提取所有选中的快照ID（去重，因为每行有多列都会被选中）
-    QSet<int> selectedRows;
-    for (QTableWidgetItem* item : selectedItems) {
-        selectedRows.insert(item->row());
-    }
-
     QStringList snapshotIds;
     QStringList snapshotShortIds;
-    for (int row : selectedRows) {
-        QTableWidgetItem* idItem = ui->tableWidget->item(row, 0);
-        if (idItem) {
-            QString snapshotId = idItem->data(Qt::UserRole).toString();
+    for (const QModelIndex& index : selectedRows) {
+        QString snapshotId = m_snapshotProxy->snapshotIdForIndex(index);
+        if (!snapshotId.isEmpty()) {
             snapshotIds << snapshotId;
             snapshotShortIds << snapshotId.left(8);
         }
@@ -444,7 +441,7 @@ void SnapshotPage::onDeleteSnapshot()
             successMsg = tr("已成功删除 %1 个快照。\n\n注意：实际的数据将在下次运行 prune 命令后被移除。").arg(snapshotIds.size());
         }
         QMessageBox::information(this, tr("成功"), successMsg);
-        loadSnapshots();
+        loadSnapshots(true);
     } else {
         QMessageBox::critical(this, tr("错误"),
             tr("删除快照失败，请查看日志了解详情。"));
@@ -453,60 +450,137 @@ void SnapshotPage::onDeleteSnapshot()
 
 void SnapshotPage::onBrowseSnapshot()
 {
-    // 获取选中的行
-    int currentRow = ui->tableWidget->currentRow();
-    if (currentRow < 0) {
+    // 获取选中的快照
+    Models::Snapshot snapshot;
+    if (!m_snapshotProxy->snapshotForIndex(ui->tableView->currentIndex(), snapshot)) {
         QMessageBox::warning(this, tr("警告"), tr("请先选择一个快照"));
         return;
     }
 
-    // 获取快照信息
-    QTableWidgetItem* idItem = ui->tableWidget->item(currentRow, 0);
-    QString snapshotId = idItem->data(Qt::UserRole).toString();
-
-    QTableWidgetItem* timeItem = ui->tableWidget->item(currentRow, 1);
-    QString snapshotName = timeItem->text();
+    QString snapshotId = snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId;
+    QString snapshotName = snapshot.time.toString("yyyy-MM-dd HH:mm:ss");
 
     // 检查是否有仓库密码
+    if (!ensurePassword()) {
+        return;
+    }
+
+    // 打开文件浏览对话框
+    Utils::Logger::instance()->log(Utils::Logger::Info,
+        QString("打开快照浏览器: %1").arg(snapshotId));
+
+    SnapshotBrowserDialog dialog(m_currentRepositoryId, snapshotId, snapshotName, this);
+    dialog.exec();
+}
+
+bool SnapshotPage::ensurePassword()
+{
     Data::PasswordManager* passMgr = Data::PasswordManager::instance();
-    if (!passMgr->hasPassword(m_currentRepositoryId)) {
-        // 获取仓库名称
-        Core::RepositoryManager* repoMgr = Core::RepositoryManager::instance();
-        Models::Repository repo = repoMgr->getRepository(m_currentRepositoryId);
+    if (passMgr->hasPassword(m_currentRepositoryId)) {
+        return true;
+    }
 
-        bool ok;
-        QString password = PasswordDialog::getPassword(this, tr("输入密码"),
-            tr("请输入仓库 \"%1\" 的密码：").arg(repo.name), &ok);
+    // 获取仓库名称
+    Core::RepositoryManager* repoMgr = Core::RepositoryManager::instance();
+    Models::Repository repo = repoMgr->getRepository(m_currentRepositoryId);
 
-        if (!ok || password.isEmpty()) {
+    bool ok;
+    QString password = PasswordDialog::getPassword(this, tr("输入密码"),
+        tr("请输入仓库 \"%1\" 的密码：").arg(repo.name), &ok);
+
+    if (!ok || password.isEmpty()) {
+        return false;
+    }
+
+    // 保存密码到密码管理器
+    passMgr->setPassword(m_currentRepositoryId, password);
+    return true;
+}
+
+void SnapshotPage::onMountSnapshot()
+{
+    Models::Snapshot snapshot;
+    if (!m_snapshotProxy->snapshotForIndex(ui->tableView->currentIndex(), snapshot)) {
+        QMessageBox::warning(this, tr("警告"), tr("请先选择一个快照"));
+        return;
+    }
+    QString snapshotId = snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId;
+
+    Core::MountManager* mountMgr = Core::MountManager::instance();
+
+    // 仓库已挂载：打开快照目录或卸载
+    int sessionId = mountMgr->findSession(m_currentRepositoryId);
+    if (sessionId >= 0) {
+        Models::MountSession session = mountMgr->session(sessionId);
+        if (session.state == Models::MountState::Starting) {
+            m_pendingMountOpen.insert(sessionId, snapshotId);
+            QMessageBox::information(this, tr("提示"), tr("仓库正在挂载，完成后将自动打开快照目录。"));
             return;
         }
 
-        // 保存密码到密码管理器
-        passMgr->setPassword(m_currentRepositoryId, password);
+        QMessageBox box(QMessageBox::Question, tr("仓库已挂载"),
+            tr("仓库已挂载到：\n%1").arg(session.mountPoint), QMessageBox::Cancel, this);
+        QPushButton* openButton = box.addButton(tr("打开快照目录"), QMessageBox::AcceptRole);
+        QPushButton* unmountButton = box.addButton(tr("卸载"), QMessageBox::DestructiveRole);
+        box.exec();
+
+        if (box.clickedButton() == openButton) {
+            QDesktopServices::openUrl(QUrl::fromLocalFile(session.snapshotPath(snapshotId)));
+        } else if (box.clickedButton() == unmountButton) {
+            mountMgr->unmount(sessionId);
+        }
+        return;
     }
 
-    // 打开文件浏览对话框
-    Utils::Logger::instance()->log(Utils::Logger::Info,
-        QString("打开快照浏览器: %1").arg(snapshotId));
+    if (!ensurePassword()) {
+        return;
+    }
 
-    SnapshotBrowserDialog dialog(m_currentRepositoryId, snapshotId, snapshotName, this);
-    dialog.exec();
+    QString mountPoint = QFileDialog::getExistingDirectory(this, tr("选择挂载点（空目录）"), QDir::homePath());
+    if (mountPoint.isEmpty()) {
+        return;
+    }
+    if (!QDir(mountPoint).isEmpty()) {
+        QMessageBox::warning(this, tr("警告"), tr("挂载点必须是空目录"));
+        return;
+    }
+
+    sessionId = mountMgr->mount(m_currentRepositoryId, mountPoint);
+    if (sessionId < 0) {
+        QMessageBox::critical(this, tr("错误"), tr("无法挂载仓库，请查看日志了解详情"));
+        return;
+    }
+
+    // 挂载就绪后打开快照目录
+    m_pendingMountOpen.insert(sessionId, snapshotId);
+}
+
+void SnapshotPage::onMountReady(int sessionId)
+{
+    if (!m_pendingMountOpen.contains(sessionId)) {
+        return;
+    }
+
+    Models::MountSession session = Core::MountManager::instance()->session(sessionId);
+    QDesktopServices::openUrl(QUrl::fromLocalFile(session.snapshotPath(m_pendingMountOpen.take(sessionId))));
+}
+
+void SnapshotPage::onMountFailed(int sessionId, const QString& error)
+{
+    if (m_pendingMountOpen.remove(sessionId) > 0) {
+        QMessageBox::critical(this, tr("挂载失败"), tr("挂载仓库失败：\n%1").arg(error));
+    }
 }
 
 void SnapshotPage::onRestoreSnapshot()
 {
-    // 获取选中的行
-    int currentRow = ui->tableWidget->currentRow();
-    if (currentRow < 0) {
+    // 获取选中的快照ID
+    QString snapshotId = m_snapshotProxy->snapshotIdForIndex(ui->tableView->currentIndex());
+    if (snapshotId.isEmpty()) {
         QMessageBox::warning(this, tr("警告"), tr("请先选择一个快照"));
         return;
     }
 
-    // 获取快照ID
-    QTableWidgetItem* idItem = ui->tableWidget->item(currentRow, 0);
-    QString snapshotId = idItem->data(Qt::UserRole).toString();
-
     // TODO: 打开恢复对话框
     QMessageBox::information(this, tr("提示"),
         tr("快照恢复功能待实现。\n\n请切换到\"数据恢复\"页面进行恢复操作。"));
@@ -514,113 +588,75 @@ void SnapshotPage::onRestoreSnapshot()
 
 void SnapshotPage::onRefresh()
 {
-    loadSnapshots();
+    loadSnapshots(true);
 }
 
-void SnapshotPage::onSnapshotsLoaded()
+void SnapshotPage::onSnapshotsChanged(int repoId, const QList<Models::Snapshot>& snapshots,
+                                      const Core::DataStore::SnapshotDelta& delta)
 {
-    // 重置加载状态
-    m_isLoading = false;
-
-    // 隐藏加载提示
-    showLoadingIndicator(false);
-
-    // 获取异步加载的结果
-    QList<Models::Snapshot> snapshots = m_snapshotWatcher->result();
+    if (repoId != m_currentRepositoryId) {
+        return;
+    }
 
     Utils::Logger::instance()->log(Utils::Logger::Info,
         QString("已加载 %1 个快照").arg(snapshots.size()));
 
-    // 显示快照列表
+    // 已有列表时只增删变化的行，保留选中和滚动位置
+    if (m_snapshotModel->snapshotCount() > 0
+        && m_snapshotModel->applyDelta(delta.added, delta.removedIds)) {
+        return;
+    }
+
     displaySnapshots(snapshots);
 }
 
-void SnapshotPage::displaySnapshots(const QList<Models::Snapshot>& snapshots)
+void SnapshotPage::onSnapshotsRefreshFinished(int repoId, bool success, const QString& error)
 {
-    // 清空表格
-    ui->tableWidget->setRowCount(0);
-    ui->tableWidget->setRowCount(snapshots.size());
-
-    // 填充表格
-    for (int i = 0; i < snapshots.size(); ++i) {
-        const Models::Snapshot& snapshot = snapshots[i];
-
-        // 快照ID（显示短ID）
-        QString shortId = snapshot.id.left(8);
-        QTableWidgetItem* idItem = new QTableWidgetItem(shortId);
-        idItem->setData(Qt::UserRole, snapshot.id); // 存储完整ID
-        ui->tableWidget->setItem(i, 0, idItem);
-
-        // 时间
-        QString timeStr = snapshot.time.toString("yyyy-MM-dd HH:mm:ss");
-        QTableWidgetItem* timeItem = new QTableWidgetItem(timeStr);
-        ui->tableWidget->setItem(i, 1, timeItem);
-
-        // 主机名
-        QTableWidgetItem* hostnameItem = new QTableWidgetItem(snapshot.hostname);
-        ui->tableWidget->setItem(i, 2, hostnameItem);
-
-        // 路径（显示第一个路径，如果有多个则显示数量）
-        QString pathStr = snapshot.paths.isEmpty() ? tr("(无)") :
-            (snapshot.paths.size() == 1 ? snapshot.paths.first() :
-             QString("%1 (+%2个)").arg(snapshot.paths.first()).arg(snapshot.paths.size() - 1));
-        QTableWidgetItem* pathItem = new QTableWidgetItem(pathStr);
-        ui->tableWidget->setItem(i, 3, pathItem);
-
-        // 大小
-        QString sizeText;
-        qint64 size = snapshot.size;
-        if (size >= 1024LL * 1024 * 1024 * 1024) {
-            sizeText = QString::number(size / (1024.0 * 1024.0 * 1024.0 * 1024.0), 'f', 2) + " TB";
-        } else if (size >= 1024LL * 1024 * 1024) {
-            sizeText = QString::number(size / (1024.0 * 1024.0 * 1024.0), 'f', 2) + " GB";
-        } else if (size >= 1024 * 1024) {
-            sizeText = QString::number(size / (1024.0 * 1024.0), 'f', 2) + " MB";
-        } else if (size >= 1024) {
-            sizeText = QString::number(size / 1024.0, 'f', 2) + " KB";
-        } else {
-            sizeText = QString::number(size) + " B";
-        }
-        QTableWidgetItem* sizeItem = new QTableWidgetItem(sizeText);
-        sizeItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        ui->tableWidget->setItem(i, 4, sizeItem);
+    if (repoId != m_currentRepositoryId) {
+        return;
+    }
 
-        // 标签
-        QString tagsStr = snapshot.tags.join(", ");
-        QTableWidgetItem* tagsItem = new QTableWidgetItem(tagsStr);
-        ui->tableWidget->setItem(i, 5, tagsItem);
+    // 隐藏加载提示
+    showLoadingIndicator(false);
+
+    if (!success) {
+        Utils::Logger::instance()->log(Utils::Logger::Warning,
+            QString("加载快照列表失败: %1").arg(error));
     }
+}
+
+void SnapshotPage::displaySnapshots(const QList<Models::Snapshot>& snapshots)
+{
+    // 整体替换模型数据，视图只绘制可见行
+    m_snapshotModel->setSnapshots(snapshots);
 
     // 清空详情显示
-    if (snapshots.isEmpty()) {
-        clearDetails();
-    }
+    clearDetails();
 }
 
 void SnapshotPage::showLoadingIndicator(bool show)
 {
     if (show) {
         // 清空表格并显示"加载中..."提示
-        ui->tableWidget->setRowCount(1);
-        ui->tableWidget->setColumnCount(6);
-        QTableWidgetItem* loadingItem = new QTableWidgetItem(tr("正在加载快照列表，请稍候..."));
-        loadingItem->setTextAlignment(Qt::AlignCenter);
-        ui->tableWidget->setItem(0, 0, loadingItem);
-        ui->tableWidget->setSpan(0, 0, 1, 6); // 合并所有列
+        m_snapshotModel->clear();
+        m_snapshotModel->setPlaceholderText(tr("正在加载快照列表，请稍候..."));
+        ui->tableView->setSpan(0, 0, 1, SnapshotTableModel::ColumnCount); // 合并所有列
 
         // 禁用操作按钮
         ui->deleteButton->setEnabled(false);
         ui->browseButton->setEnabled(false);
+        ui->mountButton->setEnabled(false);
         ui->restoreButton->setEnabled(false);
         ui->refreshButton->setEnabled(false);
     } else {
-        // 恢复表格列数
-        ui->tableWidget->clearSpans();
-        ui->tableWidget->setRowCount(0);
+        // 移除占位行
+        ui->tableView->clearSpans();
+        m_snapshotModel->setPlaceholderText(QString());
 
         // 启用操作按钮
         ui->deleteButton->setEnabled(true);
         ui->browseButton->setEnabled(true);
+        ui->mountButton->setEnabled(true);
         ui->restoreButton->setEnabled(true);
         ui->refreshButton->setEnabled(true);
     }
@@ -630,68 +666,30 @@ void SnapshotPage::onSnapshotSelected(int currentRow, int previousRow)
 {
     Q_UNUSED(previousRow);
 
-    if (currentRow < 0) {
+    Models::Snapshot snapshot;
+    if (currentRow < 0 ||
+        !m_snapshotProxy->snapshotForIndex(m_snapshotProxy->index(currentRow, 0), snapshot)) {
         clearDetails();
         return;
     }
 
-    // 获取快照ID
-    QTableWidgetItem* idItem = ui->tableWidget->item(currentRow, 0);
-    if (!idItem) {
-        clearDetails();
-        return;
-    }
-
-    QString snapshotId = idItem->data(Qt::UserRole).toString();
-
-    // 从表格中获取快照信息
-    QTableWidgetItem* timeItem = ui->tableWidget->item(currentRow, 1);
-    QTableWidgetItem* hostnameItem = ui->tableWidget->item(currentRow, 2);
-    QTableWidgetItem* pathItem = ui->tableWidget->item(currentRow, 3);
-    QTableWidgetItem* sizeItem = ui->tableWidget->item(currentRow, 4);
-    QTableWidgetItem* tagsItem = ui->tableWidget->item(currentRow, 5);
-
-    // 填充详情面板
-    ui->detailSnapshotIdLabel->setText(snapshotId);
-    ui->detailCreateTimeLabel->setText(timeItem ? timeItem->text() : "-");
-    ui->detailHostnameLabel->setText(hostnameItem ? hostnameItem->text() : "-");
-    ui->detailUsernameLabel->setText("-"); // 用户名在表格中没有显示，需要从完整数据获取
-    ui->detailPathsLabel->setText(pathItem ? pathItem->text() : "-");
-    ui->detailSizeLabel->setText(sizeItem ? sizeItem->text() : "-");
-    ui->detailTagsLabel->setText(tagsItem ? tagsItem->text() : tr("无"));
-    ui->detailParentIdLabel->setText("-"); // 父快照需要从完整数据获取
-    ui->detailFileCountLabel->setText("-"); // 文件数需要从完整数据获取
-    ui->detailDirCountLabel->setText("-"); // 目录数需要从完整数据获取
-
-    // TODO: 如果需要更详细的信息，可以从 SnapshotManager 获取完整的快照数据
+    // 填充详情面板（模型中保存了完整的快照数据）
+    ui->detailSnapshotIdLabel->setText(snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId);
+    ui->detailCreateTimeLabel->setText(snapshot.time.toString("yyyy-MM-dd HH:mm:ss"));
+    ui->detailHostnameLabel->setText(snapshot.hostname.isEmpty() ? "-" : snapshot.hostname);
+    ui->detailUsernameLabel->setText(snapshot.username.isEmpty() ? "-" : snapshot.username);
+    ui->detailPathsLabel->setText(snapshot.paths.isEmpty() ? tr("(无)") : snapshot.paths.join("\n"));
+    ui->detailSizeLabel->setText(SnapshotTableModel::formatSize(snapshot.size));
+    ui->detailTagsLabel->setText(snapshot.tags.isEmpty() ? tr("无") : snapshot.tags.join(", "));
+    ui->detailParentIdLabel->setText(snapshot.parent.isEmpty() ? "-" : snapshot.parent.left(8));
+    ui->detailFileCountLabel->setText(snapshot.fileCount > 0 ? QString::number(snapshot.fileCount) : "-");
+    ui->detailDirCountLabel->setText(snapshot.dirCount > 0 ? QString::number(snapshot.dirCount) : "-");
 }
 
 void SnapshotPage::onSearch()
 {
-    QString filterText = ui->filterEdit->text().trimmed();
-
-    if (filterText.isEmpty()) {
-        // 如果筛选为空，重新加载所有快照
-        loadSnapshots();
-        return;
-    }
-
-    // 简单的客户端筛选
-    for (int i = 0; i < ui->tableWidget->rowCount(); ++i) {
-        bool match = false;
-
-        // 检查每一列是否包含筛选文本
-        for (int col = 0; col < ui->tableWidget->columnCount(); ++col) {
-            QTableWidgetItem* item = ui->tableWidget->item(i, col);
-            if (item && item->text().contains(filterText, Qt::CaseInsensitive)) {
-                match = true;
-                break;
-            }
-        }
-
-        // 根据匹配结果显示或隐藏行
-        ui->tableWidget->setRowHidden(i, !match);
-    }
+    // 客户端筛选：只重新计算代理的行映射，不重建表格
+    m_snapshotProxy->setFilterText(ui->filterEdit->text());
 }
 
 void SnapshotPage::clearDetails()
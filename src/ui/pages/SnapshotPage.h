@@ -2,8 +2,9 @@
 #define SNAPSHOTPAGE_H
 
 #include <QWidget>
-#include <QFutureWatcher>
+#include <QHash>
 #include "../../models/Snapshot.h"
+#include "../../core/DataStore.h"
 
 namespace Ui {
 class SnapshotPage;
@@ -12,6 +13,9 @@ class SnapshotPage;
 namespace ResticGUI {
 namespace UI {
 
+class SnapshotTableModel;
+class SnapshotFilterProxyModel;
+
 class SnapshotPage : public QWidget
 {
     Q_OBJECT
@@ -22,7 +26,7 @@ public:
 
 public slots:
     void loadRepositories();
-    void loadSnapshots();
+    void loadSnapshots(bool force = false);
 
 protected:
     void showEvent(QShowEvent* event) override;
@@ -31,9 +35,14 @@ private slots:
     void onRepositoryChanged(int index);
     void onDeleteSnapshot();
     void onBrowseSnapshot();
+    void onMountSnapshot();
+    void onMountReady(int sessionId);
+    void onMountFailed(int sessionId, const QString& error);
     void onRestoreSnapshot();
     void onRefresh();
-    void onSnapshotsLoaded();
+    void onSnapshotsChanged(int repoId, const QList<Models::Snapshot>& snapshots,
+                            const Core::DataStore::SnapshotDelta& delta);
+    void onSnapshotsRefreshFinished(int repoId, bool success, const QString& error);
     void onSnapshotSelected(int currentRow, int previousRow = -1);
     void onSearch();
 
@@ -41,12 +50,14 @@ private:
     void displaySnapshots(const QList<Models::Snapshot>& snapshots);
     void showLoadingIndicator(bool show);
     void clearDetails();
+    bool ensurePassword();
 
     Ui::SnapshotPage* ui;
+    SnapshotTableModel* m_snapshotModel;
+    SnapshotFilterProxyModel* m_snapshotProxy;
     int m_currentRepositoryId;
     bool m_firstShow;
-    bool m_isLoading;
-    QFutureWatcher<QList<Models::Snapshot>>* m_snapshotWatcher;
+    QHash<int, QString> m_pendingMountOpen;    // 挂载会话ID -> 就绪后要打开的快照ID
 };
 
 } // namespace UI
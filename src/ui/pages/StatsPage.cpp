@@ -6,6 +6,7 @@
 #include "../../data/PasswordManager.h"
 #include "../../utils/Logger.h"
 #include "../dialogs/PasswordDialog.h"
+#include "../../utils/Tracer.h"
 #include <QInputDialog>
 #include <QLineEdit>
 #include <QShowEvent>
@@ -57,6 +58,8 @@ void StatsPage::showEvent(QShowEvent* event)
 
 void StatsPage::loadStats()
 {
+    TRACE_SCOPE_CAT("StatsPage::loadStats", "ui");
+
     // 如果已经在加载中，不重复加载
     if (m_statsWatcher && m_statsWatcher->isRunning()) {
         Utils::Logger::instance()->log(Utils::Logger::Debug,
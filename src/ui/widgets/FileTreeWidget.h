@@ -2,12 +2,14 @@
 #define FILETREEWIDGET_H
 
 #include <QWidget>
-#include <QTreeWidget>
+#include <QTreeView>
 #include "../../models/FileInfo.h"
 
 namespace ResticGUI {
 namespace UI {
 
+class SnapshotFileModel;
+
 /**
  * @brief 文件树控件
  *
@@ -22,6 +24,7 @@ public:
     ~FileTreeWidget();
 
     void setFiles(const QList<Models::FileInfo>& files);
+    void setDirectoryFiles(const QString& path, const QList<Models::FileInfo>& files);
     QList<Models::FileInfo> getSelectedFiles() const;
     void clear();
 
@@ -30,16 +33,13 @@ signals:
     void directoryExpanded(const QString& path);
 
 private slots:
-    void onItemExpanded(QTreeWidgetItem* item);
     void onSelectionChanged();
 
 private:
     void setupUI();
-    QTreeWidgetItem* createTreeItem(const Models::FileInfo& file);
-    QString formatSize(qint64 size);
 
-    QTreeWidget* m_treeWidget;
-    QList<Models::FileInfo> m_files;
+    QTreeView* m_treeView;
+    SnapshotFileModel* m_model;
 };
 
 } // namespace UI
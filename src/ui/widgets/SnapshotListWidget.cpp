@@ -4,6 +4,8 @@
  */
 
 #include "SnapshotListWidget.h"
+#include "../models/SnapshotTableModel.h"
+#include "../../utils/Tracer.h"
 #include <QVBoxLayout>
 #include <QHeaderView>
 
@@ -12,6 +14,9 @@ namespace UI {
 
 SnapshotListWidget::SnapshotListWidget(QWidget* parent)
     : QWidget(parent)
+    , m_tableView(nullptr)
+    , m_model(nullptr)
+    , m_proxyModel(nullptr)
 {
     setupUI();
 }
@@ -25,70 +30,57 @@ void SnapshotListWidget::setupUI()
     QVBoxLayout* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
 
-    m_tableWidget = new QTableWidget(this);
-    m_tableWidget->setColumnCount(5);
-    m_tableWidget->setHorizontalHeaderLabels({
-        tr("快照ID"),
-        tr("时间"),
-        tr("主机"),
-        tr("路径"),
-        tr("标签")
-    });
-
-    m_tableWidget->horizontalHeader()->setStretchLastSection(true);
-    m_tableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_tableWidget->setSelectionMode(QAbstractItemView::ExtendedSelection);
-    m_tableWidget->setAlternatingRowColors(true);
-
-    connect(m_tableWidget, &QTableWidget::itemSelectionChanged,
+    m_model = new SnapshotTableModel(this);
+    m_proxyModel = new SnapshotFilterProxyModel(this);
+    m_proxyModel->setSourceModel(m_model);
+
+    m_tableView = new QTableView(this);
+    m_tableView->setModel(m_proxyModel);
+
+    // 本控件不显示大小列
+    m_tableView->setColumnHidden(SnapshotTableModel::SizeColumn, true);
+
+    m_tableView->horizontalHeader()->setStretchLastSection(true);
+    m_tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_tableView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_tableView->setAlternatingRowColors(true);
+
+    connect(m_tableView->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &SnapshotListWidget::onSelectionChanged);
-    connect(m_tableWidget, &QTableWidget::cellDoubleClicked,
+    connect(m_tableView, &QTableView::doubleClicked,
             this, &SnapshotListWidget::onItemDoubleClicked);
 
-    layout->addWidget(m_tableWidget);
+    layout->addWidget(m_tableView);
 }
 
 void SnapshotListWidget::setSnapshots(const QList<Models::Snapshot>& snapshots)
 {
-    m_snapshots = snapshots;
+    TRACE_SCOPE_CAT("SnapshotListWidget::setSnapshots", "ui");
 
-    m_tableWidget->setRowCount(snapshots.size());
-
-    for (int i = 0; i < snapshots.size(); ++i) {
-        const Models::Snapshot& snapshot = snapshots[i];
-
-        m_tableWidget->setItem(i, 0, new QTableWidgetItem(snapshot.id.left(8)));
-        m_tableWidget->setItem(i, 1, new QTableWidgetItem(
-            snapshot.time.toString("yyyy-MM-dd hh:mm:ss")));
-        m_tableWidget->setItem(i, 2, new QTableWidgetItem(snapshot.hostname));
-        m_tableWidget->setItem(i, 3, new QTableWidgetItem(
-            snapshot.paths.join(", ")));
-        m_tableWidget->setItem(i, 4, new QTableWidgetItem(
-            snapshot.tags.join(", ")));
-    }
+    m_model->setSnapshots(snapshots);
 }
 
 QList<Models::Snapshot> SnapshotListWidget::getSelectedSnapshots() const
 {
     QList<Models::Snapshot> selected;
-    QList<int> selectedRows;
 
-    foreach (QTableWidgetItem* item, m_tableWidget->selectedItems()) {
-        int row = item->row();
-        if (!selectedRows.contains(row)) {
-            selectedRows.append(row);
-        }
-    }
-
-    foreach (int row, selectedRows) {
-        if (row < m_snapshots.size()) {
-            selected.append(m_snapshots[row]);
+    const QModelIndexList rows = m_tableView->selectionModel()->selectedRows();
+    for (const QModelIndex& index : rows) {
+        Models::Snapshot snapshot;
+        if (m_proxyModel->snapshotForIndex(index, snapshot)) {
+            selected.append(snapshot);
         }
     }
 
     return selected;
 }
 
+void SnapshotListWidget::setFilterText(const QString& text)
+{
+    m_proxyModel->setFilterText(text);
+}
+
 void SnapshotListWidget::refresh()
 {
     // TODO: 触发刷新快照列表
@@ -102,12 +94,11 @@ void SnapshotListWidget::onSelectionChanged()
     }
 }
 
-void SnapshotListWidget::onItemDoubleClicked(int row, int column)
+void SnapshotListWidget::onItemDoubleClicked(const QModelIndex& index)
 {
-    Q_UNUSED(column);
-
-    if (row < m_snapshots.size()) {
-        emit snapshotDoubleClicked(m_snapshots[row]);
+    Models::Snapshot snapshot;
+    if (m_proxyModel->snapshotForIndex(index, snapshot)) {
+        emit snapshotDoubleClicked(snapshot);
     }
 }
 
@@ -2,12 +2,15 @@
 #define SNAPSHOTLISTWIDGET_H
 
 #include <QWidget>
-#include <QTableWidget>
+#include <QTableView>
 #include "../../models/Snapshot.h"
 
 namespace ResticGUI {
 namespace UI {
 
+class SnapshotTableModel;
+class SnapshotFilterProxyModel;
+
 /**
  * @brief 快照列表控件
  */
@@ -21,6 +24,7 @@ public:
 
     void setSnapshots(const QList<Models::Snapshot>& snapshots);
     QList<Models::Snapshot> getSelectedSnapshots() const;
+    void setFilterText(const QString& text);
     void refresh();
 
 signals:
@@ -29,13 +33,14 @@ signals:
 
 private slots:
     void onSelectionChanged();
-    void onItemDoubleClicked(int row, int column);
+    void onItemDoubleClicked(const QModelIndex& index);
 
 private:
     void setupUI();
 
-    QTableWidget* m_tableWidget;
-    QList<Models::Snapshot> m_snapshots;
+    QTableView* m_tableView;
+    SnapshotTableModel* m_model;
+    SnapshotFilterProxyModel* m_proxyModel;
 };
 
 } // namespace UI
@@ -1,9 +1,15 @@
 #include "RestoreWizard.h"
 #include "../../core/RepositoryManager.h"
 #include "../../core/SnapshotManager.h"
+#include "../../core/DataStore.h"
+#include "../../core/ResticWrapper.h"
 #include "../../data/PasswordManager.h"
 #include "../../utils/Logger.h"
 #include "../dialogs/PasswordDialog.h"
+#include "../models/SnapshotTableModel.h"
+#include "../models/SnapshotFileModel.h"
+#include "../models/SnapshotTreeSearch.h"
+#include "../models/SnapshotPrefetcher.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFormLayout>
@@ -11,12 +17,10 @@
 #include <QFileDialog>
 #include <QInputDialog>
 #include <QHeaderView>
-#include <QApplication>
-#include <QStyle>
 #include <QtConcurrent>
 #include <QDir>
 #include <QTimer>
-#include <functional>
+#include <QThread>
 
 namespace ResticGUI {
 namespace UI {
@@ -157,14 +161,24 @@ Models::RestoreOptions RestoreWizard::getRestoreOptions() const
     QString additionalPaths = field("additionalIncludePaths").toString();
     if (!additionalPaths.isEmpty()) {
         options.includePaths.append(additionalPaths.split(';', Qt::SkipEmptyParts));
+    } else {
+        // restic 不能同时使用包含和排除，排除形式只在没有额外包含路径时使用
+        QStringList excludedPaths = field("excludedPaths").toStringList();
+        if (!excludedPaths.isEmpty()) {
+            options.includePaths.clear();
+            options.excludePaths = excludedPaths;
+        }
     }
 
     options.restorePermissions = field("restorePermissions").toBool();
     options.restoreTimestamps = field("restoreTimestamps").toBool();
     options.verify = field("verify").toBool();
-    options.overwritePolicy = Models::RestoreOptions::Always;
+    options.parallelJobs = field("parallelJobs").toInt();
+    options.overwritePolicy = static_cast<Models::RestoreOptions::OverwritePolicy>(
+        field("overwritePolicy").toInt());
     options.restoreOwnership = false;
-    options.sparse = false;
+    options.sparse = field("sparse").toBool();
+    options.deleteExtraneous = field("deleteExtraneous").toBool();
 
     return options;
 }
@@ -189,10 +203,9 @@ SnapshotSelectionPage::SnapshotSelectionPage(QWidget* parent)
     , m_repositoryComboBox(nullptr)
     , m_refreshButton(nullptr)
     , m_snapshotTable(nullptr)
+    , m_snapshotModel(nullptr)
     , m_infoLabel(nullptr)
     , m_currentRepositoryId(-1)
-    , m_isLoading(false)
-    , m_snapshotWatcher(nullptr)
 {
     setTitle(tr("步骤 1/4: 选择快照"));
     setSubTitle(tr("请选择要恢复的仓库和快照"));
@@ -272,11 +285,9 @@ SnapshotSelectionPage::SnapshotSelectionPage(QWidget* parent)
     layout->addLayout(repoLayout);
 
     // 快照表格
-    m_snapshotTable = new QTableWidget(this);
-    m_snapshotTable->setColumnCount(6);
-    m_snapshotTable->setHorizontalHeaderLabels(
-        QStringList() << tr("快照ID") << tr("创建时间") << tr("主机名")
-                      << tr("路径") << tr("大小") << tr("标签"));
+    m_snapshotModel = new SnapshotTableModel(this);
+    m_snapshotTable = new QTableView(this);
+    m_snapshotTable->setModel(m_snapshotModel);
     m_snapshotTable->setSelectionMode(QAbstractItemView::SingleSelection);
     m_snapshotTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_snapshotTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -288,7 +299,7 @@ SnapshotSelectionPage::SnapshotSelectionPage(QWidget* parent)
     m_snapshotTable->setColumnWidth(3, 200);
     m_snapshotTable->setColumnWidth(4, 100);
     m_snapshotTable->setStyleSheet(
-        "QTableWidget {"
+        "QTableView {"
         "    border: 1px solid #E0E0E0;"
         "    border-radius: 4px;"
         "    background-color: white;"
@@ -296,10 +307,10 @@ SnapshotSelectionPage::SnapshotSelectionPage(QWidget* parent)
         "    selection-background-color: #E3F2FD;"
         "    selection-color: #1976D2;"
         "}"
-        "QTableWidget::item {"
+        "QTableView::item {"
         "    padding: 5px;"
         "}"
-        "QTableWidget::item:selected {"
+        "QTableView::item:selected {"
         "    background-color: #E3F2FD;"
         "    color: #1976D2;"
         "}"
@@ -320,18 +331,24 @@ SnapshotSelectionPage::SnapshotSelectionPage(QWidget* parent)
     registerField("snapshotId", this, "snapshotId");
     registerField("snapshotInfo", this, "snapshotInfo");
 
-    // 初始化异步加载器
-    m_snapshotWatcher = new QFutureWatcher<QList<Models::Snapshot>>(this);
-    connect(m_snapshotWatcher, &QFutureWatcher<QList<Models::Snapshot>>::finished,
-            this, &SnapshotSelectionPage::onSnapshotsLoaded);
+    // 快照列表来自共享的数据存储，与快照管理、数据恢复页面的刷新合并
+    connect(Core::DataStore::instance(), &Core::DataStore::snapshotsChanged,
+            this, &SnapshotSelectionPage::onSnapshotsChanged);
+    connect(Core::DataStore::instance(), &Core::DataStore::snapshotsRefreshFinished,
+            this, &SnapshotSelectionPage::onSnapshotsRefreshFinished);
 
     // 连接信号
     connect(m_repositoryComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &SnapshotSelectionPage::onRepositoryChanged);
     connect(m_refreshButton, &QPushButton::clicked, this, &SnapshotSelectionPage::onRefresh);
-    connect(m_snapshotTable, &QTableWidget::currentCellChanged,
-            this, [this](int currentRow, int, int previousRow, int) {
-        onSnapshotSelected(currentRow, previousRow);
+    connect(m_snapshotTable->selectionModel(), &QItemSelectionModel::currentRowChanged,
+            this, [this](const QModelIndex& current, const QModelIndex& previous) {
+        onSnapshotSelected(current.isValid() ? current.row() : -1,
+                           previous.isValid() ? previous.row() : -1);
+    });
+    // 模型重置时不会发出 currentRowChanged，需手动清空已选快照
+    connect(m_snapshotModel, &QAbstractItemModel::modelReset, this, [this]() {
+        onSnapshotSelected(-1);
     });
 
     setLayout(layout);
@@ -348,7 +365,7 @@ void SnapshotSelectionPage::initializePage()
 
 bool SnapshotSelectionPage::isComplete() const
 {
-    return m_snapshotTable->currentRow() >= 0;
+    return m_snapshotModel->isSnapshotRow(m_snapshotTable->currentIndex().row());
 }
 
 int SnapshotSelectionPage::nextId() const
@@ -392,23 +409,18 @@ void SnapshotSelectionPage::loadRepositories()
 void SnapshotSelectionPage::onRepositoryChanged(int index)
 {
     m_currentRepositoryId = m_repositoryComboBox->itemData(index).toInt();
-    m_isLoading = false;
     loadSnapshots();
 }
 
 void SnapshotSelectionPage::onRefresh()
 {
-    loadSnapshots();
+    loadSnapshots(true);
 }
 
-void SnapshotSelectionPage::loadSnapshots()
+void SnapshotSelectionPage::loadSnapshots(bool force)
 {
     if (m_currentRepositoryId <= 0) {
-        m_snapshotTable->setRowCount(0);
-        return;
-    }
-
-    if (m_isLoading) {
+        m_snapshotModel->clear();
         return;
     }
 
@@ -423,95 +435,58 @@ void SnapshotSelectionPage::loadSnapshots()
             tr("请输入仓库 \"%1\" 的密码：").arg(repo.name), &ok);
 
         if (!ok || password.isEmpty()) {
-            m_snapshotTable->setRowCount(0);
+            m_snapshotModel->clear();
             return;
         }
 
         passMgr->setPassword(m_currentRepositoryId, password);
     }
 
-    if (m_snapshotWatcher->isRunning()) {
-        m_snapshotWatcher->cancel();
-        m_snapshotWatcher->waitForFinished();
+    // 有缓存时立即显示，后台刷新完成后按差异更新
+    Core::DataStore* store = Core::DataStore::instance();
+    QList<Models::Snapshot> cachedSnapshots;
+    if (store->snapshots(m_currentRepositoryId, cachedSnapshots)) {
+        displaySnapshots(cachedSnapshots);
+    } else {
+        m_snapshotModel->clear();
+        m_snapshotTable->setEnabled(false);
     }
 
-    m_isLoading = true;
-    m_snapshotTable->setRowCount(0);
-    m_snapshotTable->setEnabled(false);
-
-    int repoId = m_currentRepositoryId;
-    QFuture<QList<Models::Snapshot>> future = QtConcurrent::run([repoId]() {
-        Core::SnapshotManager* snapshotMgr = Core::SnapshotManager::instance();
-        return snapshotMgr->listSnapshots(repoId, true);
-    });
-
-    m_snapshotWatcher->setFuture(future);
+    // 最近刷新过则直接用缓存，只有刷新按钮才强制刷新
+    store->revalidateSnapshots(m_currentRepositoryId, force);
 }
 
-void SnapshotSelectionPage::onSnapshotsLoaded()
+void SnapshotSelectionPage::onSnapshotsChanged(int repoId, const QList<Models::Snapshot>& snapshots,
+                                               const Core::DataStore::SnapshotDelta& delta)
 {
-    m_isLoading = false;
-    m_snapshotTable->setEnabled(true);
+    if (repoId != m_currentRepositoryId) {
+        return;
+    }
+
+    if (m_snapshotModel->snapshotCount() > 0
+        && m_snapshotModel->applyDelta(delta.added, delta.removedIds, true)) {
+        return;
+    }
 
-    QList<Models::Snapshot> snapshots = m_snapshotWatcher->result();
     displaySnapshots(snapshots);
 }
 
-void SnapshotSelectionPage::displaySnapshots(const QList<Models::Snapshot>& snapshots)
+void SnapshotSelectionPage::onSnapshotsRefreshFinished(int repoId, bool success, const QString& error)
 {
-    m_snapshotTable->setRowCount(0);
+    Q_UNUSED(success);
+    Q_UNUSED(error);
 
-    if (snapshots.isEmpty()) {
-        return;
+    if (repoId == m_currentRepositoryId) {
+        m_snapshotTable->setEnabled(true);
     }
+}
 
-    m_snapshotTable->setRowCount(snapshots.size());
-
-    for (int i = 0; i < snapshots.size(); ++i) {
-        const Models::Snapshot& snapshot = snapshots[snapshots.size() - 1 - i];
-
-        QString displayId = snapshot.id.left(8);
-        QTableWidgetItem* idItem = new QTableWidgetItem(displayId);
-        idItem->setData(Qt::UserRole, snapshot.fullId.isEmpty() ? snapshot.id : snapshot.fullId);
-        m_snapshotTable->setItem(i, 0, idItem);
-
-        QTableWidgetItem* timeItem = new QTableWidgetItem(snapshot.time.toString("yyyy-MM-dd HH:mm:ss"));
-        m_snapshotTable->setItem(i, 1, timeItem);
-
-        QTableWidgetItem* hostnameItem = new QTableWidgetItem(snapshot.hostname);
-        m_snapshotTable->setItem(i, 2, hostnameItem);
-
-        QString pathsText = snapshot.paths.isEmpty() ? tr("(无路径)") : snapshot.paths.first();
-        if (snapshot.paths.size() > 1) {
-            pathsText += QString(" (+%1)").arg(snapshot.paths.size() - 1);
-        }
-        QTableWidgetItem* pathsItem = new QTableWidgetItem(pathsText);
-        pathsItem->setToolTip(snapshot.paths.join("\n"));
-        m_snapshotTable->setItem(i, 3, pathsItem);
-
-        QString sizeText;
-        qint64 size = snapshot.size;
-        if (size >= 1024LL * 1024 * 1024 * 1024) {
-            sizeText = QString::number(size / (1024.0 * 1024.0 * 1024.0 * 1024.0), 'f', 2) + " TB";
-        } else if (size >= 1024LL * 1024 * 1024) {
-            sizeText = QString::number(size / (1024.0 * 1024.0 * 1024.0), 'f', 2) + " GB";
-        } else if (size >= 1024LL * 1024) {
-            sizeText = QString::number(size / (1024.0 * 1024.0), 'f', 2) + " MB";
-        } else if (size >= 1024) {
-            sizeText = QString::number(size / 1024.0, 'f', 2) + " KB";
-        } else if (size > 0) {
-            sizeText = QString::number(size) + " B";
-        } else {
-            sizeText = "-";
-        }
-        QTableWidgetItem* sizeItem = new QTableWidgetItem(sizeText);
-        sizeItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_snapshotTable->setItem(i, 4, sizeItem);
-
-        QTableWidgetItem* tagsItem = new QTableWidgetItem(snapshot.tags.join(", "));
-        m_snapshotTable->setItem(i, 5, tagsItem);
-    }
+void SnapshotSelectionPage::displaySnapshots(const QList<Models::Snapshot>& snapshots)
+{
+    // 按时间倒序，最新的在前面
+    m_snapshotModel->setSnapshots(snapshots, true);
 
+    // QTableView 只按可见行计算列宽
     m_snapshotTable->resizeColumnsToContents();
 }
 
@@ -524,18 +499,15 @@ void SnapshotSelectionPage::onSnapshotSelected(int currentRow, int previousRow)
         setField("snapshotId", QString());
         setField("snapshotInfo", QString());
     } else {
-        QTableWidgetItem* idItem = m_snapshotTable->item(currentRow, 0);
-        QTableWidgetItem* timeItem = m_snapshotTable->item(currentRow, 1);
-        QTableWidgetItem* sizeItem = m_snapshotTable->item(currentRow, 4);
-
-        if (idItem) {
+        if (m_snapshotModel->isSnapshotRow(currentRow)) {
+            const Models::Snapshot& snapshot = m_snapshotModel->snapshotAt(currentRow);
             setField("repositoryId", m_currentRepositoryId);
-            setField("snapshotId", idItem->data(Qt::UserRole).toString());
+            setField("snapshotId", m_snapshotModel->snapshotIdAt(currentRow));
 
             QString info = QString("%1 | 时间: %2 | 大小: %3")
-                .arg(idItem->text())
-                .arg(timeItem ? timeItem->text() : "-")
-                .arg(sizeItem ? sizeItem->text() : "-");
+                .arg(snapshot.id.left(8))
+                .arg(snapshot.time.toString("yyyy-MM-dd HH:mm:ss"))
+                .arg(SnapshotTableModel::formatSize(snapshot.size));
             setField("snapshotInfo", info);
         }
     }
@@ -550,7 +522,10 @@ void SnapshotSelectionPage::onSnapshotSelected(int currentRow, int previousRow)
 FileSelectionPage::FileSelectionPage(QWidget* parent)
     : QWizardPage(parent)
     , m_searchEdit(nullptr)
-    , m_treeWidget(nullptr)
+    , m_treeView(nullptr)
+    , m_fileModel(nullptr)
+    , m_treeSearch(nullptr)
+    , m_prefetcher(nullptr)
     , m_statusLabel(nullptr)
     , m_selectionLabel(nullptr)
     , m_selectAllButton(nullptr)
@@ -561,7 +536,8 @@ FileSelectionPage::FileSelectionPage(QWidget* parent)
     , m_snapshotId()
     , m_isLoading(false)
     , m_fileWatcher(nullptr)
-    , m_currentLoadingItem(nullptr)
+    , m_currentLoadingPath()
+    , m_pendingDirectories()
 {
     setTitle(tr("步骤 2/4: 选择要恢复的文件"));
     setSubTitle(tr("请勾选要恢复的文件和目录"));
@@ -595,7 +571,7 @@ FileSelectionPage::FileSelectionPage(QWidget* parent)
     searchLabel->setStyleSheet("QLabel { font-size: 10pt; font-weight: bold; color: #333333; }");
 
     m_searchEdit = new QLineEdit(this);
-    m_searchEdit->setPlaceholderText(tr("输入文件名或路径..."));
+    m_searchEdit->setPlaceholderText(tr("输入文件名或路径，支持 * ? 通配符，re: 开头为正则表达式"));
     m_searchEdit->setMinimumHeight(28);
     m_searchEdit->setStyleSheet(
         "QLineEdit {"
@@ -617,26 +593,28 @@ FileSelectionPage::FileSelectionPage(QWidget* parent)
     layout->addLayout(searchLayout);
 
     // 文件树（带复选框）
-    m_treeWidget = new QTreeWidget(this);
-    m_treeWidget->setHeaderLabels(QStringList() << tr("名称") << tr("大小") << tr("类型") << tr("修改时间"));
-    m_treeWidget->setColumnWidth(0, 350);
-    m_treeWidget->setColumnWidth(1, 100);
-    m_treeWidget->setColumnWidth(2, 80);
-    m_treeWidget->setColumnWidth(3, 150);
-    m_treeWidget->setRootIsDecorated(true);
-    m_treeWidget->setAlternatingRowColors(true);
-    m_treeWidget->setSortingEnabled(false);
-    m_treeWidget->setStyleSheet(
-        "QTreeWidget {"
+    m_fileModel = new SnapshotFileModel(this);
+    m_treeView = new QTreeView(this);
+    m_treeView->setModel(m_fileModel);
+    m_treeView->setUniformRowHeights(true);
+    m_treeView->setColumnWidth(SnapshotFileModel::NameColumn, 350);
+    m_treeView->setColumnWidth(SnapshotFileModel::SizeColumn, 100);
+    m_treeView->setColumnWidth(SnapshotFileModel::TypeColumn, 80);
+    m_treeView->setColumnWidth(SnapshotFileModel::MtimeColumn, 150);
+    m_treeView->setRootIsDecorated(true);
+    m_treeView->setAlternatingRowColors(true);
+    m_treeView->setSortingEnabled(false);
+    m_treeView->setStyleSheet(
+        "QTreeView {"
         "    border: 1px solid #E0E0E0;"
         "    border-radius: 4px;"
         "    background-color: white;"
         "    alternate-background-color: #FAFAFA;"
         "}"
-        "QTreeWidget::item {"
+        "QTreeView::item {"
         "    padding: 3px;"
         "}"
-        "QTreeWidget::item:selected {"
+        "QTreeView::item:selected {"
         "    background-color: #E3F2FD;"
         "    color: #1976D2;"
         "}"
@@ -650,7 +628,7 @@ FileSelectionPage::FileSelectionPage(QWidget* parent)
         "    color: #333333;"
         "}"
     );
-    layout->addWidget(m_treeWidget);
+    layout->addWidget(m_treeView);
 
     // 状态栏和选择统计
     QHBoxLayout* statsLayout = new QHBoxLayout();
@@ -712,6 +690,7 @@ FileSelectionPage::FileSelectionPage(QWidget* parent)
 
     // 注册字段
     registerField("selectedPaths", this, "selectedPaths");
+    registerField("excludedPaths", this, "excludedPaths");
 
     // 初始化异步加载器
     m_fileWatcher = new QFutureWatcher<QList<Models::FileInfo>>(this);
@@ -719,8 +698,18 @@ FileSelectionPage::FileSelectionPage(QWidget* parent)
             this, &FileSelectionPage::onFilesLoaded);
 
     // 连接信号
-    connect(m_treeWidget, &QTreeWidget::itemExpanded, this, &FileSelectionPage::onItemExpanded);
-    connect(m_treeWidget, &QTreeWidget::itemChanged, this, &FileSelectionPage::onItemChanged);
+    connect(m_fileModel, &SnapshotFileModel::directoryFetchRequested,
+            this, &FileSelectionPage::onDirectoryFetchRequested);
+    connect(m_fileModel, &SnapshotFileModel::checkStateChanged,
+            this, &FileSelectionPage::updateSelectionStats);
+
+    // 整个快照的索引搜索
+    m_treeSearch = new SnapshotTreeSearch(m_treeView, m_fileModel, this);
+    connect(m_treeSearch, &SnapshotTreeSearch::statusChanged, m_statusLabel, &QLabel::setText);
+
+    // 后台预取视口内的目录，展开时直接命中缓存
+    m_prefetcher = new SnapshotPrefetcher(m_treeView, m_fileModel, this);
+
     connect(m_searchEdit, &QLineEdit::textChanged, this, &FileSelectionPage::onSearchTextChanged);
     connect(m_selectAllButton, &QPushButton::clicked, this, &FileSelectionPage::onSelectAll);
     connect(m_selectNoneButton, &QPushButton::clicked, this, &FileSelectionPage::onSelectNone);
@@ -746,6 +735,10 @@ void FileSelectionPage::initializePage()
         infoLabel->setText(tr("快照: %1").arg(snapshotInfo));
     }
 
+    m_searchEdit->clear();
+    m_treeSearch->setSnapshot(m_repoId, m_snapshotId);
+    m_prefetcher->setSnapshot(m_repoId, m_snapshotId);
+
     // 延迟加载根目录
     QTimer::singleShot(100, this, &FileSelectionPage::loadRootFiles);
 }
@@ -768,34 +761,44 @@ void FileSelectionPage::loadRootFiles()
         return;
     }
 
-    m_isLoading = true;
-    m_currentLoadingItem = nullptr;
-    m_statusLabel->setText(tr("正在加载快照根目录..."));
-    m_treeWidget->clear();
+    m_fileModel->clear();
+    updateSelectionStats();
 
-    int repoId = m_repoId;
-    QString snapshotId = m_snapshotId;
+    m_pendingDirectories.clear();
+    m_pendingDirectories.append(QString());
+    loadNextDirectory();
+}
 
-    QFuture<QList<Models::FileInfo>> future = QtConcurrent::run([repoId, snapshotId]() {
-        Core::SnapshotManager* snapshotMgr = Core::SnapshotManager::instance();
-        return snapshotMgr->listFiles(repoId, snapshotId, QString());
-    });
+void FileSelectionPage::onDirectoryFetchRequested(const QString& path)
+{
+    // 同一时间只运行一个 restic ls，其余目录排队
+    if (!m_pendingDirectories.contains(path)) {
+        m_pendingDirectories.append(path);
+    }
 
-    m_fileWatcher->setFuture(future);
+    if (!m_isLoading) {
+        loadNextDirectory();
+    }
 }
 
-void FileSelectionPage::loadDirectoryFiles(QTreeWidgetItem* item, const QString& path)
+void FileSelectionPage::loadNextDirectory()
 {
-    if (m_isLoading) {
+    if (m_isLoading || m_pendingDirectories.isEmpty()) {
         return;
     }
 
     m_isLoading = true;
-    m_currentLoadingItem = item;
-    m_statusLabel->setText(tr("正在加载目录: %1").arg(path));
+    m_currentLoadingPath = m_pendingDirectories.takeFirst();
+
+    if (m_currentLoadingPath.isEmpty()) {
+        m_statusLabel->setText(tr("正在加载快照根目录..."));
+    } else {
+        m_statusLabel->setText(tr("正在加载目录: %1").arg(m_currentLoadingPath));
+    }
 
     int repoId = m_repoId;
     QString snapshotId = m_snapshotId;
+    QString path = m_currentLoadingPath;
 
     QFuture<QList<Models::FileInfo>> future = QtConcurrent::run([repoId, snapshotId, path]() {
         Core::SnapshotManager* snapshotMgr = Core::SnapshotManager::instance();
@@ -808,167 +811,45 @@ void FileSelectionPage::loadDirectoryFiles(QTreeWidgetItem* item, const QString&
 void FileSelectionPage::onFilesLoaded()
 {
     m_isLoading = false;
-    QList<Models::FileInfo> files = m_fileWatcher->result();
-
-    if (m_currentLoadingItem == nullptr) {
-        addFileItems(nullptr, files);
-        m_statusLabel->setText(tr("已加载 %1 个文件/目录").arg(files.size()));
-    } else {
-        m_currentLoadingItem->takeChildren();
-        addFileItems(m_currentLoadingItem, files);
-        m_statusLabel->setText(tr("已加载 %1 个文件/目录").arg(files.size()));
-    }
-}
-
-void FileSelectionPage::addFileItems(QTreeWidgetItem* parent, const QList<Models::FileInfo>& files)
-{
-    QString currentPath;
-    if (parent != nullptr) {
-        currentPath = parent->data(0, Qt::UserRole).toString();
-    }
-
-    QSet<QString> addedPaths;
 
-    for (const Models::FileInfo& fileInfo : files) {
-        if (fileInfo.name.isEmpty()) {
-            continue;
-        }
-
-        // 过滤：只添加当前目录的直接子项
-        if (parent == nullptr) {
-            QString path = fileInfo.path;
-            if (path.startsWith("/")) {
-                path = path.mid(1);
-            }
-            if (path.contains('/')) {
-                continue;
-            }
-        } else {
-            if (!fileInfo.path.startsWith(currentPath + "/")) {
-                continue;
-            }
-            QString relativePath = fileInfo.path.mid(currentPath.length() + 1);
-            if (relativePath.contains('/')) {
-                continue;
-            }
-        }
-
-        if (addedPaths.contains(fileInfo.path)) {
-            continue;
-        }
-        addedPaths.insert(fileInfo.path);
-
-        QTreeWidgetItem* item = new QTreeWidgetItem();
-        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-        item->setCheckState(0, Qt::Unchecked);
-        item->setText(0, fileInfo.name);
-        item->setIcon(0, getFileIcon(fileInfo));
-
-        if (fileInfo.type == Models::FileType::File) {
-            item->setText(1, formatFileSize(fileInfo.size));
-        } else {
-            item->setText(1, "-");
-        }
-
-        if (fileInfo.type == Models::FileType::Directory) {
-            item->setText(2, tr("文件夹"));
-            QTreeWidgetItem* placeholder = new QTreeWidgetItem();
-            placeholder->setText(0, tr("加载中..."));
-            item->addChild(placeholder);
-        } else if (fileInfo.type == Models::FileType::Symlink) {
-            item->setText(2, tr("符号链接"));
-        } else {
-            item->setText(2, tr("文件"));
-        }
-
-        if (fileInfo.mtime.isValid()) {
-            item->setText(3, fileInfo.mtime.toString("yyyy-MM-dd HH:mm:ss"));
-        }
-
-        item->setData(0, Qt::UserRole, fileInfo.path);
-        item->setData(0, Qt::UserRole + 1, static_cast<int>(fileInfo.type));
-
-        if (parent == nullptr) {
-            m_treeWidget->addTopLevelItem(item);
-        } else {
-            parent->addChild(item);
-        }
+    QList<Models::FileInfo> files = m_fileWatcher->result();
+    int added = m_fileModel->setDirectoryFiles(m_currentLoadingPath, files);
+    if (!m_treeSearch->isFiltering()) {
+        m_statusLabel->setText(tr("已加载 %1 个文件/目录").arg(qMax(added, 0)));
     }
-}
-
-void FileSelectionPage::onItemExpanded(QTreeWidgetItem* item)
-{
-    if (item->childCount() == 1 && item->child(0)->text(0) == tr("加载中...")) {
-        QString path = item->data(0, Qt::UserRole).toString();
-        int typeInt = item->data(0, Qt::UserRole + 1).toInt();
-        Models::FileType type = static_cast<Models::FileType>(typeInt);
 
-        if (type == Models::FileType::Directory) {
-            loadDirectoryFiles(item, path);
-        }
-    }
+    loadNextDirectory();
 }
 
-void FileSelectionPage::onItemChanged(QTreeWidgetItem* item, int column)
+void FileSelectionPage::onSearchTextChanged(const QString& text)
 {
-    if (column != 0) {
+    if (text.trimmed().isEmpty()) {
+        m_treeSearch->clear();
+        m_statusLabel->setText(tr("已加载 %1 个文件/目录").arg(m_fileModel->rowCount()));
         return;
     }
 
-    Qt::CheckState state = item->checkState(0);
-
-    m_treeWidget->blockSignals(true);
-
-    std::function<void(QTreeWidgetItem*)> setChildrenState = [&](QTreeWidgetItem* parent) {
-        for (int i = 0; i < parent->childCount(); ++i) {
-            QTreeWidgetItem* child = parent->child(i);
-            if (child->text(0) != tr("加载中...")) {
-                child->setCheckState(0, state);
-                setChildrenState(child);
-            }
-        }
-    };
-    setChildrenState(item);
-
-    m_treeWidget->blockSignals(false);
-
-    updateSelectionStats();
-}
-
-void FileSelectionPage::onSearchTextChanged(const QString& text)
-{
-    Q_UNUSED(text);
-    // 简单实现：搜索功能可选
+    m_treeSearch->search(text);
 }
 
 void FileSelectionPage::onSelectAll()
 {
-    m_treeWidget->blockSignals(true);
-    for (int i = 0; i < m_treeWidget->topLevelItemCount(); ++i) {
-        setItemChecked(m_treeWidget->topLevelItem(i), true);
-    }
-    m_treeWidget->blockSignals(false);
-    updateSelectionStats();
+    m_fileModel->setAllChecked(true);
 }
 
 void FileSelectionPage::onSelectNone()
 {
-    m_treeWidget->blockSignals(true);
-    for (int i = 0; i < m_treeWidget->topLevelItemCount(); ++i) {
-        setItemChecked(m_treeWidget->topLevelItem(i), false);
-    }
-    m_treeWidget->blockSignals(false);
-    updateSelectionStats();
+    m_fileModel->setAllChecked(false);
 }
 
 void FileSelectionPage::onExpandAll()
 {
-    m_treeWidget->expandAll();
+    m_treeView->expandAll();
 }
 
 void FileSelectionPage::onCollapseAll()
 {
-    m_treeWidget->collapseAll();
+    m_treeView->collapseAll();
 }
 
 void FileSelectionPage::updateSelectionStats()
@@ -976,111 +857,26 @@ void FileSelectionPage::updateSelectionStats()
     int fileCount = 0;
     int dirCount = 0;
     qint64 totalSize = 0;
-    QStringList selectedPaths;
-
-    std::function<void(QTreeWidgetItem*)> countSelected = [&](QTreeWidgetItem* item) {
-        if (item->checkState(0) == Qt::Checked) {
-            int typeInt = item->data(0, Qt::UserRole + 1).toInt();
-            Models::FileType type = static_cast<Models::FileType>(typeInt);
-            QString path = item->data(0, Qt::UserRole).toString();
-
-            if (!path.isEmpty()) {
-                selectedPaths.append(path);
-            }
-
-            if (type == Models::FileType::Directory) {
-                dirCount++;
-            } else if (type == Models::FileType::File) {
-                fileCount++;
-                QString sizeText = item->text(1);
-                if (!sizeText.isEmpty() && sizeText != "-") {
-                    qint64 size = 0;
-                    if (sizeText.endsWith(" MB")) {
-                        size = (qint64)(sizeText.left(sizeText.length() - 3).toDouble() * 1024 * 1024);
-                    } else if (sizeText.endsWith(" KB")) {
-                        size = (qint64)(sizeText.left(sizeText.length() - 3).toDouble() * 1024);
-                    } else if (sizeText.endsWith(" B")) {
-                        size = sizeText.left(sizeText.length() - 2).toLongLong();
-                    } else if (sizeText.endsWith(" GB")) {
-                        size = (qint64)(sizeText.left(sizeText.length() - 3).toDouble() * 1024 * 1024 * 1024);
-                    } else if (sizeText.endsWith(" TB")) {
-                        size = (qint64)(sizeText.left(sizeText.length() - 3).toDouble() * 1024LL * 1024 * 1024 * 1024);
-                    }
-                    totalSize += size;
-                }
-            }
-        }
-
-        for (int i = 0; i < item->childCount(); ++i) {
-            QTreeWidgetItem* child = item->child(i);
-            if (child->text(0) != tr("加载中...")) {
-                countSelected(child);
-            }
-        }
-    };
-
-    for (int i = 0; i < m_treeWidget->topLevelItemCount(); ++i) {
-        countSelected(m_treeWidget->topLevelItem(i));
-    }
+    m_fileModel->selectionStats(fileCount, dirCount, totalSize);
 
     m_selectionLabel->setText(tr("已选择: %1个文件，%2个文件夹 | 总大小: %3")
         .arg(fileCount)
         .arg(dirCount)
-        .arg(formatFileSize(totalSize)));
-
-    setField("selectedPaths", selectedPaths);
-    emit completeChanged();
-}
-
-void FileSelectionPage::setItemChecked(QTreeWidgetItem* item, bool checked, bool updateChildren)
-{
-    if (!item) {
-        return;
-    }
-
-    item->setCheckState(0, checked ? Qt::Checked : Qt::Unchecked);
-
-    if (updateChildren) {
-        for (int i = 0; i < item->childCount(); ++i) {
-            QTreeWidgetItem* child = item->child(i);
-            if (child->text(0) != tr("加载中...")) {
-                setItemChecked(child, checked, true);
-            }
+        .arg(SnapshotFileModel::formatSize(totalSize)));
+
+    // 完全勾选的目录只记录目录本身；大部分勾选时改用排除未勾选部分，条目更少
+    QStringList includes;
+    QStringList excludes;
+    m_fileModel->compileSelection(includes, excludes);
+    if (includes.isEmpty()) {
+        // 排除形式或全部勾选时仍记录勾选的路径，有额外包含路径时会作为包含规则使用，同样需要转义
+        for (const QString& path : m_fileModel->checkedPaths()) {
+            includes.append(Core::ResticWrapper::escapePattern(path));
         }
     }
-}
-
-QIcon FileSelectionPage::getFileIcon(const Models::FileInfo& fileInfo)
-{
-    QStyle* style = QApplication::style();
-
-    if (fileInfo.type == Models::FileType::Directory) {
-        return style->standardIcon(QStyle::SP_DirIcon);
-    } else if (fileInfo.type == Models::FileType::Symlink) {
-        return style->standardIcon(QStyle::SP_FileLinkIcon);
-    } else {
-        return style->standardIcon(QStyle::SP_FileIcon);
-    }
-}
-
-QString FileSelectionPage::formatFileSize(qint64 size)
-{
-    const qint64 KB = 1024;
-    const qint64 MB = KB * 1024;
-    const qint64 GB = MB * 1024;
-    const qint64 TB = GB * 1024;
-
-    if (size < KB) {
-        return QString::number(size) + " B";
-    } else if (size < MB) {
-        return QString::number(size / KB) + " KB";
-    } else if (size < GB) {
-        return QString::number(size / MB) + " MB";
-    } else if (size < TB) {
-        return QString::number(size / GB) + " GB";
-    } else {
-        return QString::number(size / TB) + " TB";
-    }
+    setField("selectedPaths", includes);
+    setField("excludedPaths", excludes);
+    emit completeChanged();
 }
 
 // ============================================================================
@@ -1096,6 +892,7 @@ RestoreOptionsPage::RestoreOptionsPage(QWidget* parent)
     , m_restorePermissionsCheckBox(nullptr)
     , m_restoreTimestampsCheckBox(nullptr)
     , m_verifyCheckBox(nullptr)
+    , m_parallelJobsSpinBox(nullptr)
 {
     setTitle(tr("步骤 3/4: 恢复选项"));
     setSubTitle(tr("设置恢复目标路径和其他选项"));
@@ -1276,6 +1073,46 @@ RestoreOptionsPage::RestoreOptionsPage(QWidget* parent)
     m_verifyCheckBox->setStyleSheet(checkBoxStyle);
     optionsLayout->addWidget(m_verifyCheckBox);
 
+    // 覆盖策略：默认只覆盖有变化的文件，中断后重新恢复时跳过已完成的部分
+    QHBoxLayout* overwriteLayout = new QHBoxLayout();
+    QLabel* overwriteLabel = new QLabel(tr("目标中已存在的文件:"), this);
+    overwriteLabel->setStyleSheet("QLabel { font-size: 10pt; color: #555555; }");
+    m_overwriteComboBox = new QComboBox(this);
+    m_overwriteComboBox->addItem(tr("内容有变化时覆盖（跳过未变化的文件）"),
+                                 static_cast<int>(Models::RestoreOptions::IfChanged));
+    m_overwriteComboBox->addItem(tr("始终覆盖"), static_cast<int>(Models::RestoreOptions::Always));
+    m_overwriteComboBox->addItem(tr("仅当快照中的文件较新时覆盖"),
+                                 static_cast<int>(Models::RestoreOptions::IfNewer));
+    m_overwriteComboBox->addItem(tr("不覆盖"), static_cast<int>(Models::RestoreOptions::Never));
+    overwriteLayout->addWidget(overwriteLabel);
+    overwriteLayout->addWidget(m_overwriteComboBox);
+    overwriteLayout->addStretch();
+    optionsLayout->addLayout(overwriteLayout);
+
+    m_sparseCheckBox = new QCheckBox(tr("以稀疏文件恢复（节省磁盘空间）"), this);
+    m_sparseCheckBox->setChecked(false);
+    m_sparseCheckBox->setStyleSheet(checkBoxStyle);
+    optionsLayout->addWidget(m_sparseCheckBox);
+
+    m_deleteCheckBox = new QCheckBox(tr("删除目标目录中快照里不存在的文件"), this);
+    m_deleteCheckBox->setChecked(false);
+    m_deleteCheckBox->setStyleSheet(checkBoxStyle);
+    m_deleteCheckBox->setToolTip(tr("使目标目录与快照完全一致，多余的文件将被永久删除"));
+    optionsLayout->addWidget(m_deleteCheckBox);
+
+    // 并行恢复：大型恢复按目录拆分给多个 restic 进程
+    QHBoxLayout* parallelLayout = new QHBoxLayout();
+    QLabel* parallelLabel = new QLabel(tr("并行恢复进程数:"), this);
+    parallelLabel->setStyleSheet("QLabel { font-size: 10pt; color: #555555; }");
+    m_parallelJobsSpinBox = new QSpinBox(this);
+    m_parallelJobsSpinBox->setRange(1, 8);
+    m_parallelJobsSpinBox->setValue(qBound(1, QThread::idealThreadCount() / 2, 4));
+    m_parallelJobsSpinBox->setToolTip(tr("恢复的数据量较大时拆分为多个进程同时恢复，结果与单进程相同"));
+    parallelLayout->addWidget(parallelLabel);
+    parallelLayout->addWidget(m_parallelJobsSpinBox);
+    parallelLayout->addStretch();
+    optionsLayout->addLayout(parallelLayout);
+
     layout->addWidget(optionsGroup);
 
     layout->addStretch();
@@ -1286,6 +1123,10 @@ RestoreOptionsPage::RestoreOptionsPage(QWidget* parent)
     registerField("restorePermissions", m_restorePermissionsCheckBox);
     registerField("restoreTimestamps", m_restoreTimestampsCheckBox);
     registerField("verify", m_verifyCheckBox);
+    registerField("overwritePolicy", m_overwriteComboBox, "currentData");
+    registerField("sparse", m_sparseCheckBox);
+    registerField("deleteExtraneous", m_deleteCheckBox);
+    registerField("parallelJobs", m_parallelJobsSpinBox);
 
     // 连接信号
     connect(m_browseButton, &QPushButton::clicked, this, &RestoreOptionsPage::onBrowse);
@@ -1334,6 +1175,20 @@ bool RestoreOptionsPage::validatePage()
         }
     }
 
+    if (m_deleteCheckBox->isChecked()) {
+        QMessageBox::StandardButton reply = QMessageBox::warning(
+            this,
+            tr("确认"),
+            tr("目标路径中快照里不存在的文件将被永久删除，是否继续？\n%1").arg(targetPath),
+            QMessageBox::Yes | QMessageBox::No,
+            QMessageBox::No
+        );
+
+        if (reply != QMessageBox::Yes) {
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -1371,6 +1226,8 @@ void RestoreOptionsPage::onIncludeCheckBoxToggled(bool checked)
 RestoreConfirmPage::RestoreConfirmPage(QWidget* parent)
     : QWizardPage(parent)
     , m_summaryText(nullptr)
+    , m_estimateLabel(nullptr)
+    , m_estimateWatcher(nullptr)
 {
     setTitle(tr("步骤 4/4: 确认恢复"));
     setSubTitle(tr("请确认以下信息，然后点击\"完成\"开始恢复"));
@@ -1398,6 +1255,16 @@ RestoreConfirmPage::RestoreConfirmPage(QWidget* parent)
     );
     layout->addWidget(m_summaryText);
 
+    // 数据量与耗时估算，后台计算完成后更新
+    m_estimateLabel = new QLabel(this);
+    m_estimateLabel->setWordWrap(true);
+    m_estimateLabel->setStyleSheet("QLabel { font-size: 10pt; color: #555555; }");
+    layout->addWidget(m_estimateLabel);
+
+    m_estimateWatcher = new QFutureWatcher<Core::RestoreEstimate>(this);
+    connect(m_estimateWatcher, &QFutureWatcher<Core::RestoreEstimate>::finished,
+            this, &RestoreConfirmPage::onEstimateFinished);
+
     // 警告区域
     QWidget* warningWidget = new QWidget(this);
     warningWidget->setStyleSheet(
@@ -1435,9 +1302,30 @@ void RestoreConfirmPage::initializePage()
     QStringList selectedPaths = field("selectedPaths").toStringList();
     QString targetPath = field("targetPath").toString();
     QString additionalPaths = field("additionalIncludePaths").toString();
+    QStringList excludedPaths = field("excludedPaths").toStringList();
     bool restorePermissions = field("restorePermissions").toBool();
     bool restoreTimestamps = field("restoreTimestamps").toBool();
     bool verify = field("verify").toBool();
+    int parallelJobs = field("parallelJobs").toInt();
+    int overwritePolicy = field("overwritePolicy").toInt();
+    bool sparse = field("sparse").toBool();
+    bool deleteExtraneous = field("deleteExtraneous").toBool();
+
+    QString overwriteText;
+    switch (overwritePolicy) {
+    case Models::RestoreOptions::Always:
+        overwriteText = tr("始终覆盖");
+        break;
+    case Models::RestoreOptions::IfNewer:
+        overwriteText = tr("仅覆盖较旧的文件");
+        break;
+    case Models::RestoreOptions::Never:
+        overwriteText = tr("不覆盖");
+        break;
+    default:
+        overwriteText = tr("有变化时覆盖");
+        break;
+    }
 
     QString summary;
     summary += tr("快照信息：\n");
@@ -1457,6 +1345,9 @@ void RestoreConfirmPage::initializePage()
     if (!additionalPaths.isEmpty()) {
         summary += tr("额外包含的路径：\n");
         summary += "  " + additionalPaths + "\n\n";
+    } else if (!excludedPaths.isEmpty()) {
+        summary += tr("排除未勾选的文件/目录：\n");
+        summary += tr("  共 %1 项（恢复时以排除规则代替逐项包含）\n\n").arg(excludedPaths.size());
     }
 
     summary += tr("恢复目标：\n");
@@ -1466,8 +1357,47 @@ void RestoreConfirmPage::initializePage()
     summary += tr("  恢复文件权限：%1\n").arg(restorePermissions ? tr("是") : tr("否"));
     summary += tr("  恢复文件时间戳：%1\n").arg(restoreTimestamps ? tr("是") : tr("否"));
     summary += tr("  恢复后验证：%1\n").arg(verify ? tr("是") : tr("否"));
+    summary += tr("  已存在的文件：%1\n").arg(overwriteText);
+    summary += tr("  稀疏文件：%1\n").arg(sparse ? tr("是") : tr("否"));
+    summary += tr("  删除多余文件：%1\n").arg(deleteExtraneous ? tr("是") : tr("否"));
+    summary += tr("  并行恢复进程数：%1\n").arg(parallelJobs);
 
     m_summaryText->setPlainText(summary);
+
+    startEstimate();
+}
+
+RestoreConfirmPage::~RestoreConfirmPage()
+{
+    // 估算在后台线程中持有估算器的引用，这里只需停止可能运行的试运行
+    cancelEstimate();
+}
+
+void RestoreConfirmPage::cleanupPage()
+{
+    cancelEstimate();
+    QWizardPage::cleanupPage();
+}
+
+bool RestoreConfirmPage::validatePage()
+{
+    if (m_estimate.isValid() && !m_estimate.hasEnoughSpace()) {
+        QMessageBox::StandardButton reply = QMessageBox::warning(
+            this,
+            tr("磁盘空间不足"),
+            tr("需要恢复约 %1，目标磁盘只剩 %2 可用空间。\n\n仍要继续恢复吗？")
+                .arg(SnapshotFileModel::formatSize(m_estimate.bytesToRestore()))
+                .arg(SnapshotFileModel::formatSize(m_estimate.freeBytes)),
+            QMessageBox::Yes | QMessageBox::No,
+            QMessageBox::No
+        );
+        if (reply != QMessageBox::Yes) {
+            return false;
+        }
+    }
+
+    cancelEstimate();
+    return true;
 }
 
 int RestoreConfirmPage::nextId() const
@@ -1475,5 +1405,99 @@ int RestoreConfirmPage::nextId() const
     return -1;  // 最后一页
 }
 
+void RestoreConfirmPage::startEstimate()
+{
+    RestoreWizard* restoreWizard = qobject_cast<RestoreWizard*>(wizard());
+    if (!restoreWizard) {
+        return;
+    }
+
+    cancelEstimate();
+    m_estimate = Core::RestoreEstimate();
+    m_estimateLabel->setText(tr("正在估算恢复的数据量和耗时..."));
+
+    const int repoId = restoreWizard->getRepositoryId();
+    const QString snapshotId = restoreWizard->getSnapshotId();
+    const Models::RestoreOptions options = restoreWizard->getRestoreOptions();
+
+    QSharedPointer<Core::RestoreEstimator> estimator(new Core::RestoreEstimator());
+    m_estimator = estimator;
+    m_estimateWatcher->setFuture(QtConcurrent::run([estimator, repoId, snapshotId, options]() {
+        return estimator->estimate(repoId, snapshotId, options);
+    }));
+}
+
+void RestoreConfirmPage::cancelEstimate()
+{
+    if (m_estimator) {
+        m_estimator->cancel();
+        m_estimator.clear();
+    }
+}
+
+void RestoreConfirmPage::onEstimateFinished()
+{
+    if (!m_estimator) {
+        return;     // 已取消
+    }
+    m_estimator.clear();
+    m_estimate = m_estimateWatcher->result();
+
+    if (!m_estimate.isValid()) {
+        m_estimateLabel->setText(tr("无法估算恢复的数据量"));
+        return;
+    }
+
+    QStringList lines;
+    QString amount = tr("预计恢复: %1").arg(SnapshotFileModel::formatSize(m_estimate.totalBytes));
+    if (m_estimate.fileCount >= 0) {
+        amount += tr("，%1 个文件").arg(m_estimate.fileCount);
+    }
+    if (!m_estimate.exact) {
+        amount += tr("（不含无法解析的包含模式）");
+    }
+    lines << amount;
+
+    if (m_estimate.skippedBytes > 0) {
+        lines << tr("目标中已有 %1 个未变化的文件（%2）将被跳过")
+                     .arg(m_estimate.skippedFiles)
+                     .arg(SnapshotFileModel::formatSize(m_estimate.skippedBytes));
+    }
+
+    if (m_estimate.estimatedSeconds >= 0) {
+        lines << tr("预计耗时: %1（按以往恢复的平均速度 %2/s）")
+                     .arg(formatDuration(m_estimate.estimatedSeconds))
+                     .arg(SnapshotFileModel::formatSize(static_cast<qint64>(m_estimate.bytesPerSecond)));
+    } else {
+        lines << tr("预计耗时: 暂无以往恢复的速度记录");
+    }
+
+    if (m_estimate.freeBytes >= 0) {
+        lines << tr("目标磁盘可用空间: %1").arg(SnapshotFileModel::formatSize(m_estimate.freeBytes));
+    }
+
+    m_estimateLabel->setText(lines.join("\n"));
+    m_estimateLabel->setStyleSheet(m_estimate.hasEnoughSpace()
+        ? "QLabel { font-size: 10pt; color: #555555; }"
+        : "QLabel { font-size: 10pt; color: #C62828; font-weight: bold; }");
+}
+
+QString RestoreConfirmPage::formatDuration(qint64 seconds)
+{
+    if (seconds < 60) {
+        return tr("不到 1 分钟");
+    }
+
+    const qint64 hours = seconds / 3600;
+    const qint64 minutes = (seconds % 3600) / 60;
+    if (hours == 0) {
+        return tr("%1 分钟").arg(minutes);
+    }
+    if (hours < 24) {
+        return tr("%1 小时 %2 分钟").arg(hours).arg(minutes);
+    }
+    return tr("%1 天 %2 小时").arg(hours / 24).arg(hours % 24);
+}
+
 } // namespace UI
 } // namespace ResticGUI
@@ -3,8 +3,8 @@
 
 #include <QWizard>
 #include <QWizardPage>
-#include <QTableWidget>
-#include <QTreeWidget>
+#include <QTableView>
+#include <QTreeView>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QCheckBox>
@@ -12,14 +12,23 @@
 #include <QComboBox>
 #include <QTextEdit>
 #include <QGroupBox>
+#include <QSpinBox>
 #include <QFutureWatcher>
 #include "../../models/Snapshot.h"
 #include "../../models/FileInfo.h"
 #include "../../models/RestoreOptions.h"
+#include "../../core/RestoreEstimator.h"
+#include "../../core/DataStore.h"
+#include <QSharedPointer>
 
 namespace ResticGUI {
 namespace UI {
 
+class SnapshotTableModel;
+class SnapshotFileModel;
+class SnapshotTreeSearch;
+class SnapshotPrefetcher;
+
 /**
  * @brief 数据恢复向导
  */
@@ -82,22 +91,23 @@ public:
 private slots:
     void onRepositoryChanged(int index);
     void onRefresh();
-    void onSnapshotsLoaded();
+    void onSnapshotsChanged(int repoId, const QList<Models::Snapshot>& snapshots,
+                            const Core::DataStore::SnapshotDelta& delta);
+    void onSnapshotsRefreshFinished(int repoId, bool success, const QString& error);
     void onSnapshotSelected(int currentRow, int previousRow = -1);
 
 private:
     void loadRepositories();
-    void loadSnapshots();
+    void loadSnapshots(bool force = false);
     void displaySnapshots(const QList<Models::Snapshot>& snapshots);
 
     QComboBox* m_repositoryComboBox;
     QPushButton* m_refreshButton;
-    QTableWidget* m_snapshotTable;
+    QTableView* m_snapshotTable;
+    SnapshotTableModel* m_snapshotModel;
     QLabel* m_infoLabel;
 
     int m_currentRepositoryId;
-    bool m_isLoading;
-    QFutureWatcher<QList<Models::Snapshot>>* m_snapshotWatcher;
 };
 
 /**
@@ -116,8 +126,7 @@ public:
     int nextId() const override;
 
 private slots:
-    void onItemExpanded(QTreeWidgetItem* item);
-    void onItemChanged(QTreeWidgetItem* item, int column);
+    void onDirectoryFetchRequested(const QString& path);
     void onSearchTextChanged(const QString& text);
     void onFilesLoaded();
     void onSelectAll();
@@ -127,15 +136,14 @@ private slots:
 
 private:
     void loadRootFiles();
-    void loadDirectoryFiles(QTreeWidgetItem* item, const QString& path);
-    void addFileItems(QTreeWidgetItem* parent, const QList<Models::FileInfo>& files);
+    void loadNextDirectory();
     void updateSelectionStats();
-    void setItemChecked(QTreeWidgetItem* item, bool checked, bool updateChildren = true);
-    QIcon getFileIcon(const Models::FileInfo& fileInfo);
-    QString formatFileSize(qint64 size);
 
     QLineEdit* m_searchEdit;
-    QTreeWidget* m_treeWidget;
+    QTreeView* m_treeView;
+    SnapshotFileModel* m_fileModel;
+    SnapshotTreeSearch* m_treeSearch;
+    SnapshotPrefetcher* m_prefetcher;
     QLabel* m_statusLabel;
     QLabel* m_selectionLabel;
     QPushButton* m_selectAllButton;
@@ -147,7 +155,8 @@ private:
     QString m_snapshotId;
     bool m_isLoading;
     QFutureWatcher<QList<Models::FileInfo>>* m_fileWatcher;
-    QTreeWidgetItem* m_currentLoadingItem;
+    QString m_currentLoadingPath;
+    QStringList m_pendingDirectories;   // 排队等待加载的目录
 };
 
 /**
@@ -176,6 +185,10 @@ private:
     QCheckBox* m_restorePermissionsCheckBox;
     QCheckBox* m_restoreTimestampsCheckBox;
     QCheckBox* m_verifyCheckBox;
+    QComboBox* m_overwriteComboBox;
+    QCheckBox* m_sparseCheckBox;
+    QCheckBox* m_deleteCheckBox;
+    QSpinBox* m_parallelJobsSpinBox;
 };
 
 /**
@@ -187,12 +200,26 @@ class RestoreConfirmPage : public QWizardPage
 
 public:
     explicit RestoreConfirmPage(QWidget* parent = nullptr);
+    ~RestoreConfirmPage();
 
     void initializePage() override;
+    void cleanupPage() override;
+    bool validatePage() override;
     int nextId() const override;
 
+private slots:
+    void onEstimateFinished();
+
 private:
+    void startEstimate();
+    void cancelEstimate();
+    static QString formatDuration(qint64 seconds);
+
     QTextEdit* m_summaryText;
+    QLabel* m_estimateLabel;
+    QFutureWatcher<Core::RestoreEstimate>* m_estimateWatcher;
+    QSharedPointer<Core::RestoreEstimator> m_estimator;
+    Core::RestoreEstimate m_estimate;
 };
 
 } // namespace UI
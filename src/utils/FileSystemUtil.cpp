@@ -1,6 +1,16 @@
 #include "FileSystemUtil.h"
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
+#include <array>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace ResticGUI {
 namespace Utils {
@@ -35,5 +45,129 @@ bool FileSystemUtil::isWritable(const QString& path)
     return info.isWritable();
 }
 
+bool FileSystemUtil::restoreDirectoryMetadata(const QString& path, const QDateTime& mtime,
+                                              uint mode, int uid, int gid)
+{
+    bool ok = true;
+
+#ifdef Q_OS_WIN
+    Q_UNUSED(mode);
+    Q_UNUSED(uid);
+    Q_UNUSED(gid);
+
+    if (mtime.isValid()) {
+        // 目录需要 FILE_FLAG_BACKUP_SEMANTICS 才能打开
+        HANDLE handle = CreateFileW(reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(path).utf16()),
+                                    FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                    nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        // FILETIME 以 1601-01-01 起的 100 纳秒为单位
+        const quint64 ticks = quint64(mtime.toMSecsSinceEpoch() + Q_INT64_C(11644473600000)) * 10000;
+        FILETIME fileTime;
+        fileTime.dwLowDateTime = static_cast<DWORD>(ticks & 0xFFFFFFFF);
+        fileTime.dwHighDateTime = static_cast<DWORD>(ticks >> 32);
+        ok = SetFileTime(handle, nullptr, nullptr, &fileTime) != 0;
+        CloseHandle(handle);
+    }
+#else
+    const QByteArray nativePath = QFile::encodeName(path);
+
+    // 所有者和权限先于修改时间设置
+    if (geteuid() == 0 && lchown(nativePath.constData(), static_cast<uid_t>(uid), static_cast<gid_t>(gid)) != 0) {
+        ok = false;
+    }
+
+    if (mode != 0 && chmod(nativePath.constData(), static_cast<mode_t>(mode & 07777)) != 0) {
+        ok = false;
+    }
+
+    if (mtime.isValid()) {
+        const qint64 msecs = mtime.toMSecsSinceEpoch();
+        struct timespec times[2];
+        times[0].tv_sec = 0;
+        times[0].tv_nsec = UTIME_OMIT;
+        times[1].tv_sec = static_cast<time_t>(msecs / 1000);
+        times[1].tv_nsec = static_cast<long>((msecs % 1000) * 1000000);
+        if (utimensat(AT_FDCWD, nativePath.constData(), times, AT_SYMLINK_NOFOLLOW) != 0) {
+            ok = false;
+        }
+    }
+#endif
+
+    return ok;
+}
+
+namespace {
+
+quint32 crc32(const QByteArray& data)
+{
+    static const std::array<quint32, 256> table = []() {
+        std::array<quint32, 256> t;
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (char byte : data) {
+        crc = table[(crc ^ static_cast<quint8>(byte)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void appendLittleEndian(QByteArray& out, quint32 value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+} // namespace
+
+bool FileSystemUtil::gzipFile(const QString& sourcePath, const QString& targetPath)
+{
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = source.readAll();
+    source.close();
+
+    // qCompress 输出：4 字节原始长度 + zlib 头（2 字节）+ deflate 数据 + adler32（4 字节）
+    const QByteArray compressed = qCompress(data, 9);
+    if (compressed.size() < 10) {
+        return false;
+    }
+
+    QByteArray gzip;
+    gzip.reserve(compressed.size() + 12);
+    gzip.append("\x1f\x8b\x08\x00", 4);                       // 魔数、deflate、无附加字段
+    appendLittleEndian(gzip, static_cast<quint32>(QFileInfo(sourcePath).lastModified().toSecsSinceEpoch()));
+    gzip.append("\x00\xff", 2);                                 // 压缩标志、未知操作系统
+    gzip.append(compressed.constData() + 6, compressed.size() - 10);
+    appendLittleEndian(gzip, crc32(data));
+    appendLittleEndian(gzip, static_cast<quint32>(data.size()));
+
+    QFile target(targetPath);
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    if (target.write(gzip) != gzip.size()) {
+        target.close();
+        target.remove();
+        return false;
+    }
+    target.close();
+    return true;
+}
+
 } // namespace Utils
 } // namespace ResticGUI
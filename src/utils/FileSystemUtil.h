@@ -2,6 +2,7 @@
 #define FILESYSTEMUTIL_H
 
 #include <QString>
+#include <QDateTime>
 
 namespace ResticGUI {
 namespace Utils {
@@ -14,6 +15,23 @@ public:
     static qint64 getDirectorySize(const QString& path);
     static bool isWritable(const QString& path);
 
+    /**
+     * @brief 按 restic restore 的方式设置目录的修改时间、权限和所有者
+     *
+     * 权限只在类 Unix 系统上设置，所有者只在以 root 运行时设置（与 restic 一致）。
+     * @param mode 权限位，0 表示未知，不修改
+     */
+    static bool restoreDirectoryMetadata(const QString& path, const QDateTime& mtime,
+                                         uint mode, int uid, int gid);
+
+    /**
+     * @brief 把文件压缩为 gzip 格式（可用 zcat/zgrep 读取）
+     *
+     * 压缩由 qCompress 完成，去掉 zlib 头尾后按 gzip 格式封装。整个文件读入内存，
+     * 只适合日志这样大小有限的文件。
+     */
+    static bool gzipFile(const QString& sourcePath, const QString& targetPath);
+
 private:
     FileSystemUtil() = delete;
 };
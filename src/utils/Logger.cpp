@@ -4,54 +4,101 @@
  */
 
 #include "Logger.h"
+#include "FileSystemUtil.h"
 #include <QDateTime>
 #include <QDebug>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QRegularExpression>
 
 namespace ResticGUI {
 namespace Utils {
 
 Logger* Logger::s_instance = nullptr;
+QMutex Logger::s_instanceMutex;
 
 Logger* Logger::instance()
 {
     if (!s_instance) {
-        s_instance = new Logger();
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new Logger();
+        }
     }
     return s_instance;
 }
 
 Logger::Logger(QObject *parent)
     : QObject(parent)
+    , m_queue(QueueCapacity)
     , m_level(Info)
+    , m_stopping(0)
+    , m_dropped(0)
+    , m_reportedDropped(0)
+    , m_writer(nullptr)
+    , m_fileBytes(0)
+    , m_format(Text)
+    , m_maxFileBytes(DefaultMaxFileBytes)
+    , m_retentionDays(30)
+    , m_compressRotated(true)
 {
+    m_writer = QThread::create([this]() { writerLoop(); });
+    m_writer->setObjectName("LogWriter");
+    m_writer->start(QThread::LowPriority);
 }
 
 Logger::~Logger()
 {
+    shutdown();
+    delete m_writer;
+
     if (m_logFile.isOpen()) {
-        m_logStream.flush();
         m_logFile.close();
     }
 }
 
 void Logger::setLogFile(const QString& filePath)
 {
-    QMutexLocker locker(&m_mutex);
+    QMutexLocker locker(&m_writeMutex);
+
+    // 之前的日志写入原来的文件
+    drainQueue();
 
     if (m_logFile.isOpen()) {
-        m_logStream.flush();
         m_logFile.close();
     }
 
-    m_logFile.setFileName(filePath);
-    if (m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        m_logStream.setDevice(&m_logFile);
-    }
+    m_logFilePath = filePath;
+    openLogFile();
+    removeExpiredLogs();
 }
 
 void Logger::setLevel(Level level)
 {
-    m_level = level;
+    m_level.storeRelaxed(level);
+}
+
+void Logger::setFormat(Format format)
+{
+    QMutexLocker locker(&m_writeMutex);
+    drainQueue();
+    m_format = format;
+}
+
+void Logger::setRotation(qint64 maxFileBytes, int retentionDays, bool compress)
+{
+    QMutexLocker locker(&m_writeMutex);
+    m_maxFileBytes = qMax<qint64>(0, maxFileBytes);
+    m_retentionDays = qMax(0, retentionDays);
+    m_compressRotated = compress;
+
+    if (!m_logFilePath.isEmpty()) {
+        removeExpiredLogs();
+    }
 }
 
 void Logger::debug(const QString& message)
@@ -81,22 +128,62 @@ void Logger::critical(const QString& message)
 
 void Logger::log(Level level, const QString& message)
 {
-    if (level < m_level) {
+    log(level, message, LogContext());
+}
+
+void Logger::log(Level level, const QString& message, const LogContext& context)
+{
+    if (!isEnabled(level)) {
         return;
     }
 
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
-    QString levelStr = levelToString(level);
-    QString formattedMessage = QString("[%1] [%2] %3").arg(timestamp, levelStr, message);
+    Entry entry;
+    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
+    entry.level = level;
+    entry.message = message;
+    entry.context = context;
+
+    if (!m_queue.tryPush(std::move(entry))) {
+        if (level < Warning) {
+            m_dropped.fetchAndAddRelaxed(1);
+            return;
+        }
+
+        // 重要日志等待写入线程腾出空间
+        m_wakeup.release();
+        QElapsedTimer timer;
+        timer.start();
+        while (!m_queue.tryPush(std::move(entry))) {
+            if (timer.elapsed() >= BlockTimeoutMs) {
+                m_dropped.fetchAndAddRelaxed(1);
+                return;
+            }
+            QThread::yieldCurrentThread();
+        }
+    }
 
-    // 输出到控制台
-    qDebug().noquote() << formattedMessage;
+    if (m_stopping.loadAcquire()) {
+        // 写入线程已停止，同步写出
+        flush();
+    } else if (level >= Error || m_queue.sizeApprox() >= QueueCapacity / 2) {
+        m_wakeup.release();
+    }
+}
 
-    // 写入文件
-    writeToFile(formattedMessage);
+void Logger::flush()
+{
+    QMutexLocker locker(&m_writeMutex);
+    drainQueue();
+}
 
-    // 发送信号
-    emit logMessage(static_cast<int>(level), message);
+void Logger::shutdown()
+{
+    if (m_stopping.testAndSetOrdered(0, 1)) {
+        m_wakeup.release();
+        m_writer->wait();
+    }
+    flush();
+    compressRotatedLogs();
 }
 
 QString Logger::levelToString(Level level)
@@ -111,13 +198,192 @@ QString Logger::levelToString(Level level)
     }
 }
 
-void Logger::writeToFile(const QString& message)
+void Logger::writerLoop()
 {
-    QMutexLocker locker(&m_mutex);
+    while (!m_stopping.loadAcquire()) {
+        // 定时唤醒，或被错误日志、队列过半提前唤醒
+        m_wakeup.tryAcquire(1, FlushIntervalMs);
+        m_wakeup.tryAcquire(m_wakeup.available());
 
-    if (m_logFile.isOpen()) {
-        m_logStream << message << "\n";
-        m_logStream.flush();
+        {
+            QMutexLocker locker(&m_writeMutex);
+            drainQueue();
+        }
+        compressRotatedLogs();
+    }
+}
+
+void Logger::drainQueue()
+{
+    // 调用者持有 m_writeMutex
+    Entry entry;
+    bool wrote = false;
+    while (m_queue.tryPop(entry)) {
+        const Level level = static_cast<Level>(entry.level);
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(entry.timestamp);
+        QString formattedMessage = QString("[%1] [%2] %3")
+            .arg(time.toString("yyyy-MM-dd HH:mm:ss"), levelToString(level), entry.message);
+        if (entry.context.durationMs >= 0) {
+            formattedMessage += QString(" (%1 ms)").arg(entry.context.durationMs);
+        }
+
+        // 输出到控制台
+        qDebug().noquote() << formattedMessage;
+
+        // 写入文件，整批写完后再刷新
+        writeLine(formatFileLine(entry, formattedMessage), time.date());
+        wrote = true;
+
+        // 发送信号
+        emit logMessage(entry.level, entry.message);
+    }
+
+    const quint64 dropped = m_dropped.loadRelaxed();
+    if (dropped != m_reportedDropped) {
+        Entry notice;
+        notice.timestamp = QDateTime::currentMSecsSinceEpoch();
+        notice.level = Warning;
+        notice.message = QString("日志队列已满，丢弃了 %1 条日志").arg(dropped - m_reportedDropped);
+        m_reportedDropped = dropped;
+
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(notice.timestamp);
+        const QString formattedMessage = QString("[%1] [%2] %3")
+            .arg(time.toString("yyyy-MM-dd HH:mm:ss"), levelToString(Warning), notice.message);
+        qDebug().noquote() << formattedMessage;
+        writeLine(formatFileLine(notice, formattedMessage), time.date());
+        wrote = true;
+    }
+
+    if (wrote && m_logFile.isOpen()) {
+        m_logFile.flush();
+    }
+}
+
+QByteArray Logger::formatFileLine(const Entry& entry, const QString& textLine) const
+{
+    if (m_format == Text) {
+        return textLine.toUtf8() + '\n';
+    }
+
+    static const char* const levelNames[] = {"debug", "info", "warning", "error", "critical"};
+
+    QJsonObject obj;
+    obj["time"] = QDateTime::fromMSecsSinceEpoch(entry.timestamp).toString(Qt::ISODateWithMs);
+    obj["level"] = QString(levelNames[qBound(0, entry.level, 4)]);
+    obj["message"] = entry.message;
+    if (entry.context.taskId >= 0) {
+        obj["task_id"] = entry.context.taskId;
+    }
+    if (entry.context.repoId >= 0) {
+        obj["repo_id"] = entry.context.repoId;
+    }
+    if (entry.context.durationMs >= 0) {
+        obj["duration_ms"] = static_cast<double>(entry.context.durationMs);
+    }
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact) + '\n';
+}
+
+void Logger::writeLine(const QByteArray& line, const QDate& date)
+{
+    if (!m_logFile.isOpen()) {
+        return;
+    }
+
+    // 文件中已有日志且超过大小或跨天时先轮转
+    if (m_fileBytes > 0
+        && ((m_maxFileBytes > 0 && m_fileBytes + line.size() > m_maxFileBytes) || date != m_fileDate)) {
+        rotateLogFile();
+        if (!m_logFile.isOpen()) {
+            return;
+        }
+    }
+    if (m_fileBytes == 0) {
+        m_fileDate = date;
+    }
+
+    m_logFile.write(line);
+    m_fileBytes += line.size();
+}
+
+void Logger::openLogFile()
+{
+    m_logFile.setFileName(m_logFilePath);
+    if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning().noquote() << QString("无法打开日志文件: %1").arg(m_logFilePath);
+        return;
+    }
+
+    m_fileBytes = m_logFile.size();
+    // 上次运行留下的文件按最后写入的日期判断是否跨天
+    m_fileDate = m_fileBytes > 0 ? QFileInfo(m_logFilePath).lastModified().date() : QDate::currentDate();
+}
+
+void Logger::rotateLogFile()
+{
+    m_logFile.flush();
+    m_logFile.close();
+
+    const QFileInfo info(m_logFilePath);
+    const QString base = info.absolutePath() + "/" + info.completeBaseName() + "-"
+                         + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss");
+    const QString suffix = info.suffix().isEmpty() ? QString() : "." + info.suffix();
+
+    QString rotated = base + suffix;
+    for (int i = 1; QFile::exists(rotated) || QFile::exists(rotated + ".gz"); ++i) {
+        rotated = QString("%1-%2%3").arg(base).arg(i).arg(suffix);
+    }
+
+    if (QFile::rename(m_logFilePath, rotated)) {
+        // 压缩耗时较长，只记下文件名，由写入线程释放锁后再压缩，不阻塞其他写入者
+        if (m_compressRotated) {
+            m_pendingCompress.append(rotated);
+        }
+    } else {
+        qWarning().noquote() << QString("日志文件轮转失败: %1").arg(rotated);
+    }
+
+    openLogFile();
+    removeExpiredLogs();
+}
+
+void Logger::compressRotatedLogs()
+{
+    QStringList files;
+    {
+        QMutexLocker locker(&m_writeMutex);
+        files.swap(m_pendingCompress);
+    }
+
+    for (const QString& file : files) {
+        if (FileSystemUtil::gzipFile(file, file + ".gz")) {
+            QFile::remove(file);
+        }
+    }
+}
+
+void Logger::removeExpiredLogs()
+{
+    if (m_retentionDays <= 0) {
+        return;
+    }
+
+    const QFileInfo info(m_logFilePath);
+    QDir dir(info.absolutePath());
+    const QDateTime cutoff = QDateTime::currentDateTime().addDays(-m_retentionDays);
+
+    // 只删除本日志轮转出来的文件（<名称>-yyyyMMdd-HHmmss[-n].<后缀>[.gz]）；
+    // 同一目录下其他以相同前缀开头的日志（例如 restic-gui-cli.log）不在匹配范围内
+    const QString suffix = info.suffix().isEmpty() ? QString() : "." + info.suffix();
+    const QRegularExpression pattern(
+        QString("^%1-\\d{8}-\\d{6}(-\\d+)?%2(\\.gz)?$")
+            .arg(QRegularExpression::escape(info.completeBaseName()), QRegularExpression::escape(suffix)));
+
+    const QFileInfoList candidates = dir.entryInfoList(QStringList() << info.completeBaseName() + "-*",
+                                                       QDir::Files);
+    for (const QFileInfo& file : candidates) {
+        if (pattern.match(file.fileName()).hasMatch() && file.lastModified() < cutoff) {
+            QFile::remove(file.absoluteFilePath());
+        }
     }
 }
 
@@ -8,12 +8,34 @@
 
 #include <QObject>
 #include <QFile>
-#include <QTextStream>
+#include <QDate>
 #include <QMutex>
+#include <QStringList>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include "MpscRingBuffer.h"
+
+class QThread;
 
 namespace ResticGUI {
 namespace Utils {
 
+/**
+ * @brief 异步日志（单例模式）
+ *
+ * log() 只检查级别、记录时间并把消息放入无锁队列，格式化、控制台输出、
+ * 写文件和 logMessage 信号都在后台写入线程中完成。写入线程每 FlushIntervalMs
+ * 批量写出一次并刷新文件；错误及以上级别的日志或队列过半时立即唤醒写入线程。
+ *
+ * 队列满时：调试和信息日志直接丢弃并计数，写入线程随后记录丢弃的条数；
+ * 警告及以上级别最多等待 BlockTimeoutMs 让写入线程腾出空间，超时才丢弃。
+ *
+ * 构造消息本身有开销，循环中的调试日志应先用 isEnabled() 判断。
+ *
+ * 日志文件超过设定大小或跨天时轮转：当前文件改名为 <名称>-<时间>.log，
+ * 可选压缩为 .gz，超过保留天数的轮转文件被删除。文件可以用纯文本或
+ * JSON Lines 格式写入，后者把 LogContext 中的任务、仓库和耗时作为独立字段。
+ */
 class Logger : public QObject
 {
     Q_OBJECT
@@ -27,11 +49,44 @@ public:
         Critical
     };
 
+    enum Format {
+        Text = 0,
+        JsonLines
+    };
+
+    /**
+     * @brief 日志的结构化字段，未设置的字段不输出
+     */
+    struct LogContext
+    {
+        int taskId = -1;
+        int repoId = -1;
+        qint64 durationMs = -1;
+    };
+
     static Logger* instance();
 
     void setLogFile(const QString& filePath);
     void setLevel(Level level);
 
+    /**
+     * @brief 设置日志文件格式（控制台始终为文本）
+     */
+    void setFormat(Format format);
+
+    /**
+     * @brief 设置轮转和保留策略
+     * @param maxFileBytes 单个文件的最大大小，0 表示不按大小轮转
+     * @param retentionDays 轮转文件的保留天数，0 表示不删除
+     * @param compress 是否把轮转文件压缩为 .gz
+     */
+    void setRotation(qint64 maxFileBytes, int retentionDays, bool compress);
+
+    /**
+     * @brief 该级别的日志是否会被记录（无锁，可在格式化消息前调用）
+     */
+    bool isEnabled(Level level) const { return level >= m_level.loadRelaxed(); }
+
     void debug(const QString& message);
     void info(const QString& message);
     void warning(const QString& message);
@@ -39,6 +94,27 @@ public:
     void critical(const QString& message);
 
     void log(Level level, const QString& message);
+    void log(Level level, const QString& message, const LogContext& context);
+
+    /**
+     * @brief 同步写出队列中的所有日志并刷新文件
+     */
+    void flush();
+
+    /**
+     * @brief 停止写入线程并写出剩余日志，之后的日志同步写入（程序退出前调用）
+     */
+    void shutdown();
+
+    /**
+     * @brief 因队列已满而丢弃的日志条数
+     */
+    quint64 droppedCount() const { return m_dropped.loadRelaxed(); }
+
+    static constexpr size_t QueueCapacity = 16384;
+    static constexpr qint64 DefaultMaxFileBytes = Q_INT64_C(10) * 1024 * 1024;
+    static constexpr int FlushIntervalMs = 200;
+    static constexpr int BlockTimeoutMs = 100;
 
 signals:
     void logMessage(int level, const QString& message);
@@ -46,16 +122,50 @@ signals:
 private:
     explicit Logger(QObject *parent = nullptr);
     ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    struct Entry
+    {
+        qint64 timestamp = 0;       // 毫秒，在调用线程中记录
+        int level = Info;
+        QString message;
+        LogContext context;
+    };
 
     static Logger* s_instance;
-
+    static QMutex s_instanceMutex;
+
+    MpscRingBuffer<Entry> m_queue;
+    QSemaphore m_wakeup;
+    QAtomicInt m_level;
+    QAtomicInt m_stopping;
+    QAtomicInteger<quint64> m_dropped;
+    quint64 m_reportedDropped;
+    QThread* m_writer;
+
+    // 队列的消费者互斥：写入线程、flush() 和 setLogFile() 同一时刻只有一个在写，
+    // 文件和轮转设置也由它保护
+    QMutex m_writeMutex;
     QFile m_logFile;
-    QTextStream m_logStream;
-    Level m_level;
-    QMutex m_mutex;
+    QString m_logFilePath;
+    qint64 m_fileBytes;
+    QDate m_fileDate;               // 当前文件中日志的日期，跨天时轮转
+    Format m_format;
+    qint64 m_maxFileBytes;
+    int m_retentionDays;
+    bool m_compressRotated;
+    QStringList m_pendingCompress;  // 已轮转、等待在锁外压缩的文件
 
     QString levelToString(Level level);
-    void writeToFile(const QString& message);
+    void writerLoop();
+    void drainQueue();
+    void writeLine(const QByteArray& line, const QDate& date);
+    QByteArray formatFileLine(const Entry& entry, const QString& textLine) const;
+    void openLogFile();
+    void rotateLogFile();
+    void compressRotatedLogs();
+    void removeExpiredLogs();
 };
 
 } // namespace Utils
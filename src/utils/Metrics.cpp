@@ -0,0 +1,213 @@
+/**
+ * @file Metrics.cpp
+ * @brief 指标注册表实现
+ */
+
+#include "Metrics.h"
+#include "Logger.h"
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+
+namespace ResticGUI {
+namespace Utils {
+
+namespace {
+
+void atomicAdd(std::atomic<double>& target, double delta)
+{
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+    }
+}
+
+QString escapeLabelValue(QString value)
+{
+    value.replace('\\', "\\\\");
+    value.replace('"', "\\\"");
+    value.replace('\n', "\\n");
+    return value;
+}
+
+} // namespace
+
+// ========== Gauge / Histogram ==========
+
+void Gauge::add(double delta)
+{
+    atomicAdd(m_value, delta);
+}
+
+Histogram::Histogram(const QVector<double>& bounds)
+    : m_bounds(bounds)
+    , m_buckets(new std::atomic<quint64>[bounds.size() + 1])
+{
+    std::sort(m_bounds.begin(), m_bounds.end());
+    for (int i = 0; i <= m_bounds.size(); ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value)
+{
+    const auto it = std::lower_bound(m_bounds.constBegin(), m_bounds.constEnd(), value);
+    m_buckets[static_cast<int>(it - m_bounds.constBegin())].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    atomicAdd(m_sum, value);
+}
+
+QVector<double> Histogram::durationBuckets()
+{
+    return {0.001, 0.01, 0.1, 0.5, 1, 5, 15, 30, 60, 300, 900, 1800, 3600};
+}
+
+QVector<double> Histogram::latencyBuckets()
+{
+    return {0.0001, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 1, 10};
+}
+
+// ========== MetricsRegistry ==========
+
+MetricsRegistry* MetricsRegistry::s_instance = nullptr;
+QMutex MetricsRegistry::s_instanceMutex;
+
+MetricsRegistry* MetricsRegistry::instance()
+{
+    if (!s_instance) {
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new MetricsRegistry();
+        }
+    }
+    return s_instance;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const QString& name, Type type, const QString& help)
+{
+    auto it = m_families.find(name);
+    if (it == m_families.end()) {
+        it = m_families.insert(name, Family());
+        it->type = type;
+        it->help = help;
+    } else if (it->type != type) {
+        Logger::instance()->log(Logger::Warning,
+            QString("指标 %1 以不同的类型重复注册").arg(name));
+    }
+    return *it;
+}
+
+Counter* MetricsRegistry::counter(const QString& name, const QString& help, const Labels& labels)
+{
+    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<Counter>& metric = family(name, CounterType, help).counters[formatLabels(labels)];
+    if (!metric) {
+        metric = std::make_shared<Counter>();
+    }
+    return metric.get();
+}
+
+Gauge* MetricsRegistry::gauge(const QString& name, const QString& help, const Labels& labels)
+{
+    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<Gauge>& metric = family(name, GaugeType, help).gauges[formatLabels(labels)];
+    if (!metric) {
+        metric = std::make_shared<Gauge>();
+    }
+    return metric.get();
+}
+
+Histogram* MetricsRegistry::histogram(const QString& name, const QString& help, const QVector<double>& bounds,
+                                      const Labels& labels)
+{
+    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<Histogram>& metric = family(name, HistogramType, help).histograms[formatLabels(labels)];
+    if (!metric) {
+        metric = std::make_shared<Histogram>(bounds);
+    }
+    return metric.get();
+}
+
+QByteArray MetricsRegistry::exposition() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    // 标签串为空时不输出花括号，直方图的 le 标签追加在已有标签之后
+    auto series = [](const QString& name, const QString& labels, const QString& extra = QString()) {
+        QStringList parts;
+        if (!labels.isEmpty()) {
+            parts << labels;
+        }
+        if (!extra.isEmpty()) {
+            parts << extra;
+        }
+        return parts.isEmpty() ? name : QString("%1{%2}").arg(name, parts.join(','));
+    };
+
+    QString out;
+    for (auto it = m_families.constBegin(); it != m_families.constEnd(); ++it) {
+        const QString& name = it.key();
+        const Family& entry = it.value();
+
+        QString help = entry.help;
+        help.replace('\\', "\\\\").replace('\n', "\\n");
+        out += QString("# HELP %1 %2\n").arg(name, help);
+
+        switch (entry.type) {
+        case CounterType:
+            out += QString("# TYPE %1 counter\n").arg(name);
+            for (auto m = entry.counters.constBegin(); m != entry.counters.constEnd(); ++m) {
+                out += QString("%1 %2\n").arg(series(name, m.key())).arg(m.value()->value());
+            }
+            break;
+        case GaugeType:
+            out += QString("# TYPE %1 gauge\n").arg(name);
+            for (auto m = entry.gauges.constBegin(); m != entry.gauges.constEnd(); ++m) {
+                out += QString("%1 %2\n").arg(series(name, m.key()), formatValue(m.value()->value()));
+            }
+            break;
+        case HistogramType:
+            out += QString("# TYPE %1 histogram\n").arg(name);
+            for (auto m = entry.histograms.constBegin(); m != entry.histograms.constEnd(); ++m) {
+                const Histogram& histogram = *m.value();
+                quint64 cumulative = 0;
+                for (int i = 0; i < histogram.bounds().size(); ++i) {
+                    cumulative += histogram.bucketCount(i);
+                    out += QString("%1 %2\n")
+                               .arg(series(name + "_bucket", m.key(),
+                                           QString("le=\"%1\"").arg(formatValue(histogram.bounds().at(i)))))
+                               .arg(cumulative);
+                }
+                cumulative += histogram.bucketCount(histogram.bounds().size());
+                out += QString("%1 %2\n").arg(series(name + "_bucket", m.key(), "le=\"+Inf\"")).arg(cumulative);
+                out += QString("%1 %2\n").arg(series(name + "_sum", m.key()), formatValue(histogram.sum()));
+                out += QString("%1 %2\n").arg(series(name + "_count", m.key())).arg(cumulative);
+            }
+            break;
+        }
+    }
+
+    return out.toUtf8();
+}
+
+QString MetricsRegistry::formatLabels(const Labels& labels)
+{
+    QStringList parts;
+    for (auto it = labels.constBegin(); it != labels.constEnd(); ++it) {
+        parts << QString("%1=\"%2\"").arg(it.key(), escapeLabelValue(it.value()));
+    }
+    return parts.join(',');
+}
+
+QString MetricsRegistry::formatValue(double value)
+{
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    return QString::number(value, 'g', 15);
+}
+
+} // namespace Utils
+} // namespace ResticGUI
@@ -0,0 +1,162 @@
+/**
+ * @file Metrics.h
+ * @brief 指标注册表：计数器、仪表和直方图，输出 Prometheus 文本格式
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QString>
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QVector>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
+
+namespace ResticGUI {
+namespace Utils {
+
+/**
+ * @brief 只增不减的计数器
+ */
+class Counter
+{
+public:
+    void inc(quint64 delta = 1) { m_value.fetch_add(delta, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{0};
+};
+
+/**
+ * @brief 可增可减的仪表
+ */
+class Gauge
+{
+public:
+    void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+    void add(double delta);
+    void inc() { add(1); }
+    void dec() { add(-1); }
+    double value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value{0};
+};
+
+/**
+ * @brief 固定桶的直方图
+ *
+ * 桶按上界升序排列，observe() 只增加值所在的一个桶，输出时再累加成
+ * Prometheus 要求的累计计数。
+ */
+class Histogram
+{
+public:
+    explicit Histogram(const QVector<double>& bounds);
+
+    void observe(double value);
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    double sum() const { return m_sum.load(std::memory_order_relaxed); }
+    const QVector<double>& bounds() const { return m_bounds; }
+    quint64 bucketCount(int index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 适合耗时（秒）的桶：1ms 到 1 小时
+     */
+    static QVector<double> durationBuckets();
+
+    /**
+     * @brief 适合数据库查询等短操作（秒）的桶：100us 到 10s
+     */
+    static QVector<double> latencyBuckets();
+
+private:
+    QVector<double> m_bounds;
+    std::unique_ptr<std::atomic<quint64>[]> m_buckets;     // 最后一个是 +Inf
+    std::atomic<quint64> m_count{0};
+    std::atomic<double> m_sum{0};
+};
+
+/**
+ * @brief 作用域计时，析构时把耗时（秒）记入直方图
+ */
+class HistogramTimer
+{
+public:
+    explicit HistogramTimer(Histogram* histogram) : m_histogram(histogram) { m_timer.start(); }
+    ~HistogramTimer() { m_histogram->observe(m_timer.nsecsElapsed() / 1e9); }
+
+    HistogramTimer(const HistogramTimer&) = delete;
+    HistogramTimer& operator=(const HistogramTimer&) = delete;
+
+private:
+    Histogram* m_histogram;
+    QElapsedTimer m_timer;
+};
+
+/**
+ * @brief 指标注册表（单例）
+ *
+ * 同名同标签的指标只创建一次，返回的指针在程序生命周期内有效，热路径上
+ * 应缓存该指针（例如函数内的 static 变量），更新时只有原子操作，不加锁。
+ * 指标名按 Prometheus 约定使用 resticgui_ 前缀和 snake_case。
+ */
+class MetricsRegistry
+{
+public:
+    using Labels = QMap<QString, QString>;
+
+    static MetricsRegistry* instance();
+
+    Counter* counter(const QString& name, const QString& help, const Labels& labels = Labels());
+    Gauge* gauge(const QString& name, const QString& help, const Labels& labels = Labels());
+    Histogram* histogram(const QString& name, const QString& help, const QVector<double>& bounds,
+                         const Labels& labels = Labels());
+
+    /**
+     * @brief 按 Prometheus 文本格式（version 0.0.4）输出所有指标
+     */
+    QByteArray exposition() const;
+
+private:
+    MetricsRegistry() = default;
+    ~MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    enum Type {
+        CounterType,
+        GaugeType,
+        HistogramType
+    };
+
+    struct Family
+    {
+        Type type = CounterType;
+        QString help;
+        // 标签串（已格式化为 a="b",c="d"）-> 指标，按标签串排序输出
+        QMap<QString, std::shared_ptr<Counter>> counters;
+        QMap<QString, std::shared_ptr<Gauge>> gauges;
+        QMap<QString, std::shared_ptr<Histogram>> histograms;
+    };
+
+    Family& family(const QString& name, Type type, const QString& help);
+    static QString formatLabels(const Labels& labels);
+    static QString formatValue(double value);
+
+    static MetricsRegistry* s_instance;
+    static QMutex s_instanceMutex;
+
+    mutable QMutex m_mutex;
+    QMap<QString, Family> m_families;
+};
+
+} // namespace Utils
+} // namespace ResticGUI
+
+#endif // METRICS_H
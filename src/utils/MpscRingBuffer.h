@@ -0,0 +1,125 @@
+/**
+ * @file MpscRingBuffer.h
+ * @brief 多生产者单消费者的无锁有界环形队列
+ */
+
+#ifndef MPSCRINGBUFFER_H
+#define MPSCRINGBUFFER_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace ResticGUI {
+namespace Utils {
+
+/**
+ * @brief 多生产者单消费者的无锁有界环形队列
+ *
+ * 基于 Vyukov 的有界队列：每个槽位带一个序号，生产者用 CAS 抢占写入位置，
+ * 写完后发布序号；消费者按序号判断槽位是否已写好。tryPush() 可从任意线程
+ * 并发调用，tryPop() 同一时刻只能有一个线程调用。
+ *
+ * 容量向上取整为 2 的幂。
+ */
+template <typename T>
+class MpscRingBuffer
+{
+public:
+    explicit MpscRingBuffer(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_enqueuePos.store(0, std::memory_order_relaxed);
+        m_dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    /**
+     * @brief 入队，队列已满时立即返回false
+     */
+    bool tryPush(T&& value)
+    {
+        Cell* cell = nullptr;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 出队（仅限单个消费者），队列为空时返回false
+     */
+    bool tryPop(T& value)
+    {
+        const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = &m_cells[pos & m_mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false;
+        }
+
+        value = std::move(cell->value);
+        cell->value = T();
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief 队列中的元素数（并发时只是近似值）
+     */
+    size_t sizeApprox() const
+    {
+        const size_t enqueue = m_enqueuePos.load(std::memory_order_relaxed);
+        const size_t dequeue = m_dequeuePos.load(std::memory_order_relaxed);
+        return enqueue > dequeue ? enqueue - dequeue : 0;
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+
+    // 生产者和消费者的位置放在不同的缓存行，避免伪共享
+    alignas(64) std::atomic<size_t> m_enqueuePos;
+    alignas(64) std::atomic<size_t> m_dequeuePos;
+};
+
+} // namespace Utils
+} // namespace ResticGUI
+
+#endif // MPSCRINGBUFFER_H
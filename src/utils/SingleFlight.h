@@ -0,0 +1,128 @@
+/**
+ * @file SingleFlight.h
+ * @brief 相同请求的合并执行：同一时刻只运行一次，并发调用者共享结果
+ */
+
+#ifndef SINGLEFLIGHT_H
+#define SINGLEFLIGHT_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QSharedPointer>
+#include <QElapsedTimer>
+#include <functional>
+#include "Logger.h"
+#include "Metrics.h"
+
+namespace ResticGUI {
+namespace Utils {
+
+/**
+ * @brief 按请求键合并并发调用（single-flight）
+ *
+ * 第一个调用者执行函数，执行期间到达的同键调用者阻塞等待，直接拿到同一个
+ * 结果；执行结束后键即被移除，之后的调用会重新执行（结果缓存由调用方负责）。
+ * 请求键应包含仓库、操作和参数，例如 "ls/3/<快照ID>/<路径>"。
+ *
+ * 耗时记入 resticgui_singleflight_duration_seconds：role="leader" 是实际执行
+ * 的耗时，role="shared" 是共享结果的调用者等待的耗时。键中的路径等取值无界，
+ * 指标只按操作名区分，单个键的耗时写入调试日志。
+ *
+ * 函数内不能再以同一个键调用 run()，否则会死锁。
+ */
+template <typename T>
+class SingleFlight
+{
+public:
+    explicit SingleFlight(const QString& operation) : m_operation(operation) {}
+
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    /**
+     * @brief 执行 fn；同键的调用正在执行时等待它并返回其结果
+     * @param shared 可选输出，结果来自其他调用者的执行时为 true
+     */
+    T run(const QString& key, const std::function<T()>& fn, bool* shared = nullptr)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        QMutexLocker locker(&m_mutex);
+        QSharedPointer<Call> call = m_calls.value(key);
+        if (call) {
+            while (!call->finished) {
+                call->done.wait(&m_mutex);
+            }
+            T result = call->result;
+            locker.unlock();
+
+            if (shared) {
+                *shared = true;
+            }
+            record("shared", key, timer.nsecsElapsed());
+            return result;
+        }
+
+        call.reset(new Call());
+        m_calls.insert(key, call);
+        locker.unlock();
+
+        T result = fn();
+
+        locker.relock();
+        call->result = result;
+        call->finished = true;
+        m_calls.remove(key);
+        call->done.wakeAll();
+        locker.unlock();
+
+        if (shared) {
+            *shared = false;
+        }
+        record("leader", key, timer.nsecsElapsed());
+        return result;
+    }
+
+    /**
+     * @brief 该键是否有调用正在执行
+     */
+    bool isInFlight(const QString& key) const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_calls.contains(key);
+    }
+
+private:
+    struct Call
+    {
+        QWaitCondition done;
+        bool finished = false;
+        T result;
+    };
+
+    void record(const char* role, const QString& key, qint64 nsecs) const
+    {
+        MetricsRegistry::instance()->histogram("resticgui_singleflight_duration_seconds",
+            "合并执行的查询耗时（秒）", Histogram::durationBuckets(),
+            {{"operation", m_operation}, {"role", role}})->observe(nsecs / 1e9);
+
+        // 每次查询都会经过这里，关闭调试日志时不构造消息
+        if (Logger::instance()->isEnabled(Logger::Debug)) {
+            Logger::instance()->log(Logger::Debug,
+                QString("合并执行 %1（%2）: %3 ms").arg(key).arg(role).arg(nsecs / 1000000));
+        }
+    }
+
+    const QString m_operation;
+    mutable QMutex m_mutex;
+    QHash<QString, QSharedPointer<Call>> m_calls;
+};
+
+} // namespace Utils
+} // namespace ResticGUI
+
+#endif // SINGLEFLIGHT_H
@@ -0,0 +1,190 @@
+/**
+ * @file Tracer.cpp
+ * @brief 性能跟踪实现
+ */
+
+#include "Tracer.h"
+#include "Logger.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QFile>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+namespace ResticGUI {
+namespace Utils {
+
+Tracer* Tracer::s_instance = nullptr;
+QMutex Tracer::s_instanceMutex;
+std::atomic<bool> Tracer::s_enabled(false);
+
+Tracer* Tracer::instance()
+{
+    if (!s_instance) {
+        QMutexLocker locker(&s_instanceMutex);
+        if (!s_instance) {
+            s_instance = new Tracer();
+        }
+    }
+    return s_instance;
+}
+
+Tracer::Tracer()
+{
+    m_clock.start();
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::complete(const char* name, const char* category, qint64 startUs, qint64 durationUs,
+                      const QString& detail)
+{
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.phase = 'X';
+    event.timestamp = startUs;
+    event.duration = durationUs;
+    event.detail = detail;
+    append(std::move(event));
+}
+
+void Tracer::instant(const char* name, const char* category, const QString& detail)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.phase = 'i';
+    event.timestamp = nowUs();
+    event.detail = detail;
+    append(std::move(event));
+}
+
+Tracer::ThreadBuffer* Tracer::currentBuffer()
+{
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer) {
+        return buffer;
+    }
+
+    auto created = std::make_shared<ThreadBuffer>();
+    QThread* thread = QThread::currentThread();
+    created->threadName = thread->objectName();
+    if (created->threadName.isEmpty()) {
+        QCoreApplication* app = QCoreApplication::instance();
+        created->threadName = (app && app->thread() == thread) ? QString("主线程") : QString("工作线程");
+    }
+
+    QMutexLocker locker(&m_buffersMutex);
+    created->threadId = static_cast<qint64>(m_buffers.size()) + 1;
+    m_buffers.push_back(created);
+    buffer = created.get();
+    return buffer;
+}
+
+void Tracer::append(Event&& event)
+{
+    ThreadBuffer* buffer = currentBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    if (buffer->events.size() >= MaxEventsPerThread) {
+        buffer->dropped++;
+        return;
+    }
+    buffer->events.append(std::move(event));
+}
+
+bool Tracer::exportChromeTrace(const QString& filePath)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        QMutexLocker locker(&m_buffersMutex);
+        buffers = m_buffers;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        Logger::instance()->log(Logger::Error,
+            QString("无法写入性能跟踪文件 %1: %2").arg(filePath).arg(file.errorString()));
+        return false;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    int eventCount = 0;
+    quint64 dropped = 0;
+    bool first = true;
+
+    auto writeEvent = [&file, &first](const QJsonObject& object) {
+        file.write(first ? "\n" : ",\n");
+        file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+        first = false;
+    };
+
+    file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (const std::shared_ptr<ThreadBuffer>& buffer : buffers) {
+        QVector<Event> events;
+        QString threadName;
+        {
+            // 只在复制期间持有锁，序列化时记录线程可以继续写入
+            QMutexLocker locker(&buffer->mutex);
+            events = buffer->events;
+            threadName = buffer->threadName;
+            dropped += buffer->dropped;
+        }
+
+        QJsonObject metadata;
+        metadata["name"] = "thread_name";
+        metadata["ph"] = "M";
+        metadata["pid"] = pid;
+        metadata["tid"] = buffer->threadId;
+        metadata["args"] = QJsonObject{{"name", threadName}};
+        writeEvent(metadata);
+
+        for (const Event& event : events) {
+            QJsonObject object;
+            object["name"] = QString::fromUtf8(event.name);
+            object["cat"] = QString::fromUtf8(event.category);
+            object["ph"] = QString(QLatin1Char(event.phase));
+            object["ts"] = event.timestamp;
+            object["pid"] = pid;
+            object["tid"] = buffer->threadId;
+            if (event.phase == 'X') {
+                object["dur"] = event.duration;
+            } else {
+                object["s"] = "t";
+            }
+            if (!event.detail.isEmpty()) {
+                object["args"] = QJsonObject{{"detail", event.detail}};
+            }
+            writeEvent(object);
+            eventCount++;
+        }
+    }
+
+    file.write("\n]}\n");
+    file.close();
+
+    Logger::instance()->log(Logger::Info,
+        QString("性能跟踪已导出到 %1，共 %2 个事件，丢弃 %3 个").arg(filePath).arg(eventCount).arg(dropped));
+    return true;
+}
+
+void Tracer::clear()
+{
+    QMutexLocker locker(&m_buffersMutex);
+    for (const std::shared_ptr<ThreadBuffer>& buffer : m_buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
+}
+
+} // namespace Utils
+} // namespace ResticGUI
@@ -0,0 +1,170 @@
+/**
+ * @file Tracer.h
+ * @brief 性能跟踪：作用域计时区间，导出为 Chrome trace-event 格式
+ */
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QMutex>
+#include <QVector>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace ResticGUI {
+namespace Utils {
+
+/**
+ * @brief 性能跟踪器（单例）
+ *
+ * 每个线程把事件写入自己的缓冲区，只在导出时才需要跨线程访问，记录时的锁
+ * 不会发生竞争。未启用时 TraceSpan 只读取一个原子标志，几乎没有开销。
+ *
+ * 导出的文件可以在 chrome://tracing 或 https://ui.perfetto.dev 中打开。
+ */
+class Tracer
+{
+public:
+    static Tracer* instance();
+
+    /**
+     * @brief 是否正在记录（无锁）
+     */
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief 记录一个已完成的区间
+     * @param name 区间名称，必须是静态字符串
+     * @param category 分类，必须是静态字符串
+     * @param detail 附加说明，显示在事件的 args 中
+     */
+    void complete(const char* name, const char* category, qint64 startUs, qint64 durationUs,
+                  const QString& detail = QString());
+
+    /**
+     * @brief 记录一个瞬时事件（例如进程输出第一个字节）
+     */
+    void instant(const char* name, const char* category, const QString& detail = QString());
+
+    /**
+     * @brief 把所有线程已记录的事件写成 Chrome trace-event JSON
+     */
+    bool exportChromeTrace(const QString& filePath);
+
+    /**
+     * @brief 清空已记录的事件
+     */
+    void clear();
+
+    /**
+     * @brief 自跟踪器创建以来的微秒数，所有事件共用这一时间基准
+     */
+    qint64 nowUs() const { return m_clock.nsecsElapsed() / 1000; }
+
+    // 每个线程最多保留的事件数，超出的事件丢弃并计数
+    static constexpr int MaxEventsPerThread = 200000;
+
+private:
+    Tracer();
+    ~Tracer() = default;
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    struct Event
+    {
+        const char* name = nullptr;
+        const char* category = nullptr;
+        char phase = 'X';           // 'X' 区间，'i' 瞬时事件
+        qint64 timestamp = 0;       // 微秒
+        qint64 duration = 0;
+        QString detail;
+    };
+
+    struct ThreadBuffer
+    {
+        QMutex mutex;               // 只在导出或清空时与记录线程竞争
+        QVector<Event> events;
+        quint64 dropped = 0;
+        qint64 threadId = 0;
+        QString threadName;
+    };
+
+    ThreadBuffer* currentBuffer();
+    void append(Event&& event);
+
+    static Tracer* s_instance;
+    static QMutex s_instanceMutex;
+    static std::atomic<bool> s_enabled;
+
+    QElapsedTimer m_clock;
+
+    // 缓冲区在线程退出后仍然保留，直到导出
+    QMutex m_buffersMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+};
+
+/**
+ * @brief 作用域计时区间，构造时开始，析构时记录
+ *
+ * 使用 TRACE_SCOPE("名称") 宏，或需要附加说明时直接构造并调用 setDetail()。
+ */
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char* name, const char* category = "app")
+        : m_name(name)
+        , m_category(category)
+        , m_start(Tracer::isEnabled() ? Tracer::instance()->nowUs() : -1)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (m_start >= 0) {
+            Tracer* tracer = Tracer::instance();
+            tracer->complete(m_name, m_category, m_start, tracer->nowUs() - m_start, m_detail);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    bool isActive() const { return m_start >= 0; }
+
+    /**
+     * @brief 设置附加说明，未启用跟踪时不复制字符串
+     */
+    void setDetail(const QString& detail)
+    {
+        if (m_start >= 0) {
+            m_detail = detail;
+        }
+    }
+
+private:
+    const char* m_name;
+    const char* m_category;
+    qint64 m_start;
+    QString m_detail;
+};
+
+} // namespace Utils
+} // namespace ResticGUI
+
+#define RESTICGUI_TRACE_CONCAT_INNER(a, b) a##b
+#define RESTICGUI_TRACE_CONCAT(a, b) RESTICGUI_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * @brief 跟踪当前作用域，名称和分类必须是静态字符串
+ */
+#define TRACE_SCOPE(name) \
+    ResticGUI::Utils::TraceSpan RESTICGUI_TRACE_CONCAT(traceSpan_, __LINE__)(name)
+#define TRACE_SCOPE_CAT(name, category) \
+    ResticGUI::Utils::TraceSpan RESTICGUI_TRACE_CONCAT(traceSpan_, __LINE__)(name, category)
+
+#endif // TRACER_H